@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief One three-axis sample in the chip's counts
+ */
+struct AccelSample {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+/**
+ * @brief Accelerometer with a hardware FIFO, drained in bursts
+ *
+ * The chip samples at its own rate into its FIFO; readFifo() takes
+ * everything waiting in as few transfers as possible, so the caller only
+ * has to come back before the FIFO fills.
+ */
+class Accelerometer {
+public:
+    virtual ~Accelerometer() = default;
+    
+    /**
+     * @brief Set rate, range and FIFO mode and start sampling
+     * @return false if the chip does not answer or is not the expected one
+     */
+    virtual bool begin() = 0;
+    
+    /**
+     * @brief Take the samples waiting in the FIFO, oldest first
+     * @param max Room in out
+     * @param overrun Set when the FIFO filled since the last read, so
+     *                samples before these may have been lost
+     * @return Samples read
+     */
+    virtual size_t readFifo(AccelSample* out, size_t max, bool* overrun) = 0;
+    
+    /**
+     * @brief Acceleration of one count, in g
+     */
+    virtual float getGPerCount() const = 0;
+    
+    /**
+     * @brief Nominal output data rate
+     */
+    virtual float getSampleRateHz() const = 0;
+};
+
+} // namespace BoatEngine
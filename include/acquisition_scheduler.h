@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "phase_scheduler.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Runs the sensor managers' periodic reads from one timer
+ *
+ * Independent repeat timers started together line up, so bus work,
+ * calibration and Signal K sends all land in the same tick every so often.
+ * Here each read is a task in a PhaseScheduler, which gives it its own
+ * phase within its period, and a single event loop timer is set for the
+ * next slot in which anything is due.
+ *
+ * Every tick that runs a task is timed. The longest and mean tick and the
+ * most tasks run in one tick since the last report are published under
+ * <prefix>peakTickUs, <prefix>meanTickUs and <prefix>peakTasks, so
+ * staggered and aligned phases (SCHEDULER_STAGGER) can be compared on the
+ * device.
+ */
+class AcquisitionScheduler {
+public:
+    /**
+     * @param slot_ms Slot width; periods are rounded to whole slots
+     * @param stagger false to start every task at phase 0, as separate
+     *        timers would
+     */
+    AcquisitionScheduler(unsigned int slot_ms, bool stagger);
+    
+    /**
+     * @brief Add a periodic task
+     * @param name Short name for the log
+     * @param period_ms Period; 0 adds it suspended
+     * @param callback Run once per period in the task's own slot
+     * @param weight Relative cost, for spreading heavy tasks apart
+     * @return Task index for setPeriod(), or -1 if no more tasks fit
+     */
+    int addTask(const char* name, unsigned int period_ms,
+                PhaseScheduler::Callback callback, uint16_t weight = 1);
+    
+    /**
+     * @brief Change a task's period; 0 suspends it
+     */
+    void setPeriod(int task, unsigned int period_ms);
+    
+    /**
+     * @brief Create the load outputs and start running tasks
+     * @param sk_prefix Signal K path prefix, ending in '.'
+     * @param report_ms Publish interval
+     */
+    void start(const char* sk_prefix, unsigned int report_ms);
+    
+    /**
+     * @brief Get the phase assignment (for testing/debugging)
+     */
+    const PhaseScheduler& getPhases() const { return phases_; }
+
+private:
+    void tick();
+    void reschedule();
+    void report();
+    void logTask(size_t task) const;
+    void logPhases() const;
+    
+    PhaseScheduler phases_;
+    const char* names_[PhaseScheduler::MAX_TASKS];
+    reactesp::DelayEvent* next_tick_;
+    bool started_;
+    
+    // Since the last report
+    uint32_t peak_tick_us_;
+    uint64_t total_tick_us_;
+    uint32_t ticks_;
+    uint32_t peak_tasks_;
+    
+    sensesp::SKOutputInt* peak_tick_output_;
+    sensesp::SKOutputInt* mean_tick_output_;
+    sensesp::SKOutputInt* peak_tasks_output_;
+};
+
+} // namespace BoatEngine
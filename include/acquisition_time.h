@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief When the value now travelling down a pipeline was sampled
+ *
+ * SensESP transforms only pass the value along, so the time travels beside
+ * it: the source marks its stamp just before emitting and, because a
+ * connect_to chain runs synchronously, the output at the end of the chain
+ * still sees that mark when the value arrives. Times are on the monotonic
+ * clock (milliseconds since boot), which never jumps when SNTP corrects the
+ * wall clock.
+ */
+struct AcquisitionStamp {
+    uint64_t monotonic_ms;   ///< 0 until the first sample
+    
+    AcquisitionStamp() : monotonic_ms(0) {}
+    
+    void mark(uint64_t now_ms) { monotonic_ms = now_ms; }
+    bool isSet() const { return monotonic_ms != 0; }
+};
+
+/**
+ * @brief Buffer size for formatSignalKTimestamp(), including the terminator
+ */
+static constexpr size_t SIGNALK_TIMESTAMP_SIZE = 25;
+
+/**
+ * @brief Earliest wall-clock time taken as set (2020-01-01), in ms since
+ * the Unix epoch; before SNTP syncs the ESP32 clock counts up from 1970
+ */
+static constexpr int64_t MIN_SYNCED_EPOCH_MS = 1577836800000LL;
+
+/**
+ * @brief Convert an acquisition stamp to wall-clock time
+ *
+ * The sample's age on the monotonic clock is subtracted from the current
+ * wall-clock time, so the result is only as good as the wall clock at the
+ * moment of conversion.
+ *
+ * @param stamp Acquisition time
+ * @param wall_now_ms Current wall-clock time, ms since the Unix epoch
+ * @param monotonic_now_ms Current monotonic time
+ * @param epoch_ms Acquisition time in ms since the Unix epoch
+ * @return false if the wall clock is not synchronized, or the stamp is
+ * unset or in the future
+ */
+bool acquisitionToEpochMs(const AcquisitionStamp& stamp, int64_t wall_now_ms,
+                          uint64_t monotonic_now_ms, int64_t* epoch_ms);
+
+/**
+ * @brief Format a time as a Signal K (RFC 3339, UTC) timestamp,
+ * e.g. "2024-06-01T12:34:56.789Z"
+ * @param epoch_ms Time in ms since the Unix epoch, years 1970 to 9999
+ * @param buffer At least SIGNALK_TIMESTAMP_SIZE bytes
+ */
+void formatSignalKTimestamp(int64_t epoch_ms, char* buffer);
+
+} // namespace BoatEngine
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief One raw conversion result as delivered by an ADC source
+ */
+struct AdcSample {
+    uint8_t channel;
+    uint16_t raw;
+};
+
+/**
+ * @brief Source of interleaved multi-channel ADC samples
+ *
+ * Abstracts the ESP32 continuous (DMA) ADC driver so the analog sensor
+ * pipeline can run against a simulated source on the host.
+ */
+class AdcSource {
+public:
+    virtual ~AdcSource() = default;
+
+    /**
+     * @brief Start continuous conversion of the given channels
+     * @param channels ADC1 channel numbers, scanned in this order
+     * @param count Number of entries in channels
+     * @param sample_rate_hz Total conversion rate across all channels
+     * @return true if the source is running
+     */
+    virtual bool begin(const uint8_t* channels, size_t count,
+                       uint32_t sample_rate_hz) = 0;
+
+    /**
+     * @brief Stop converting without releasing the driver
+     *
+     * Pending samples are kept; nothing new is produced until resume().
+     */
+    virtual void pause() = 0;
+
+    /**
+     * @brief Continue converting after pause()
+     */
+    virtual void resume() = 0;
+
+    /**
+     * @brief Copy out samples converted since the last call
+     *
+     * Never blocks. Returns 0 when nothing is pending.
+     * @return Number of samples written to out
+     */
+    virtual size_t read(AdcSample* out, size_t max_samples) = 0;
+
+    /**
+     * @brief Convert a (possibly oversampled, fractional) raw code to millivolts
+     */
+    virtual float toMillivolts(float raw) const = 0;
+
+    /**
+     * @brief Number of times the DMA buffer overflowed and samples were lost
+     */
+    virtual uint32_t getOverflowCount() const = 0;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "acquisition_scheduler.h"
+#include "acquisition_time.h"
+#include "adc_block_filter.h"
+#include "adc_source.h"
+#include "sampling_control.h"
+#include "sensor_config.h"
+#include "sensesp.h"
+#include "sensesp/system/observablevalue.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Manages analog sender initialization and acquisition
+ *
+ * Modelled on TemperatureSensorManager, but instead of one timer per
+ * sensor the ADC runs continuously in DMA mode across all channels. A
+ * single short-interval drain pulls whatever has been converted, feeds it
+ * through an AdcBlockFilter, and emits one calibrated value per channel
+ * every read interval into the usual Linear -> SKOutputFloat chain.
+ * Values are stamped with the drain that produced them, at most
+ * ANALOG_DRAIN_INTERVAL_MS after the last sample of the block.
+ */
+class AnalogSensorManager : public SamplingControl {
+public:
+    /**
+     * @brief Initialize the analog sensor manager
+     * @param source ADC sample source (continuous DMA on the device)
+     * @param scheduler Runs the periodic drain
+     * @param sample_rate_hz Total conversion rate across all channels
+     * @param read_delay_ms Interval between emitted values per channel
+     */
+    AnalogSensorManager(AdcSource* source, AcquisitionScheduler* scheduler,
+                        uint32_t sample_rate_hz, unsigned int read_delay_ms);
+    
+    /**
+     * @brief Set up all configured analog sensors and start acquisition
+     */
+    void setupSensors();
+    
+    /**
+     * @brief Add a single analog sensor
+     * @param config Sensor configuration definition
+     * @return false if the channel is out of range or already in use
+     */
+    bool addSensor(const BoatSensorConfig::AnalogSensorDef& config);
+    
+    /**
+     * @brief Start the ADC and the periodic drain
+     */
+    bool start();
+    
+    /**
+     * @brief Pull all pending samples from the source and emit results
+     *
+     * Called periodically from the event loop once started.
+     */
+    void drain();
+    
+    /**
+     * @brief Change the emit interval; 0 pauses the ADC and the drain
+     */
+    void setSamplingInterval(unsigned int interval_ms) override;
+    
+    /**
+     * @brief Get the number of configured channels
+     */
+    size_t getChannelCount() const { return channel_count_; }
+    
+    /**
+     * @brief Get the millivolt producer for an ADC channel (for testing/debugging)
+     */
+    sensesp::ObservableValue<float>* getChannelOutput(uint8_t adc_channel) const;
+
+private:
+    static constexpr size_t DRAIN_BATCH = 256;
+    static constexpr size_t MAX_RESULTS = DRAIN_BATCH / AdcBlockFilter::MIN_BLOCK_SIZE;
+    
+    void applyBlockSize();
+    
+    struct Channel {
+        uint8_t adc_channel;
+        sensesp::ObservableValue<float>* millivolts;
+    };
+    
+    AdcSource* source_;
+    uint32_t sample_rate_hz_;
+    unsigned int read_delay_ms_;
+    bool started_;
+    bool paused_;
+    AcquisitionScheduler* scheduler_;
+    int drain_task_;   ///< -1 before start()
+    AcquisitionStamp stamp_;   ///< Time of the drain emitting values
+    
+    AdcBlockFilter filter_;
+    Channel channels_[AdcBlockFilter::MAX_CHANNELS];
+    size_t channel_count_;
+    
+    AdcSample samples_[DRAIN_BATCH];
+    AdcBlockFilter::Result results_[MAX_RESULTS];
+};
+
+} // namespace BoatEngine
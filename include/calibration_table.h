@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Fixed-capacity piecewise-linear lookup table
+ *
+ * Holds up to MAX_POINTS breakpoints sorted by input. A uniform index over
+ * the input range, rebuilt whenever the points change, maps each bucket to
+ * the span of segments it overlaps, so evaluate() narrows to one or two
+ * candidate segments in constant time and only falls back to a binary
+ * search when breakpoints are clustered. Inputs outside the table clamp
+ * to the first or last output. No allocation after construction.
+ */
+class CalibrationTable {
+public:
+    static constexpr size_t MAX_POINTS = 16;
+    static constexpr size_t INDEX_BUCKETS = 32;
+    
+    struct Point {
+        float input;
+        float output;
+    };
+    
+    /**
+     * @brief Construct an identity table (0 -> 0, 1 -> 1)
+     */
+    CalibrationTable();
+    
+    /**
+     * @brief Replace the breakpoints
+     *
+     * Points may be given in any order; they are sorted by input.
+     * @return false (table unchanged) if count is outside 2..MAX_POINTS or
+     *         two points share the same input
+     */
+    bool setPoints(const Point* points, size_t count);
+    
+    /**
+     * @brief Interpolate the output for an input value
+     */
+    float evaluate(float input) const;
+    
+    size_t size() const { return count_; }
+    const Point& point(size_t i) const { return points_[i]; }
+
+private:
+    void buildIndex();
+    size_t findSegment(float input) const;
+    
+    Point points_[MAX_POINTS];
+    size_t count_;
+    
+    // Uniform index: bucket b covers [x0 + b / scale, x0 + (b + 1) / scale)
+    // and its input lies in segments first_segment_[b]..first_segment_[b + 1]
+    float index_origin_;
+    float index_scale_;
+    uint8_t first_segment_[INDEX_BUCKETS + 1];
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "calibration_table.h"
+#include "sensor_config.h"
+#include "sensesp/transforms/transform.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Piecewise-linear calibration transform editable in the config UI
+ *
+ * A drop-in alternative to Linear for non-linear senders and probes. Uses
+ * the same "samples" JSON layout as SensESP's CurveInterpolator, but keeps
+ * the breakpoints in a fixed CalibrationTable so set() does no allocation
+ * and no linear walk.
+ */
+class CalibrationTableTransform : public sensesp::FloatTransform {
+public:
+    /**
+     * @param points Default breakpoints, used until a saved config exists
+     * @param count Number of default breakpoints
+     * @param config_path Configuration path for the UI and persistence
+     */
+    CalibrationTableTransform(const CalibrationTable::Point* points, size_t count,
+                              const String& config_path = "");
+    
+    void set(const float& input) override;
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    const CalibrationTable& getTable() const { return table_; }
+
+private:
+    CalibrationTable table_;
+};
+
+const String ConfigSchema(const CalibrationTableTransform& obj);
+
+/**
+ * @brief Create the calibration stage selected by a sensor definition
+ *
+ * Also registers its ConfigItem, which has to be done on the concrete type
+ * for the UI to find the right schema. Linear stages are stored under
+ * "<base>/linear" so existing calibrations survive; tables are stored
+ * under "<base>/calibrationTable".
+ * @param def Calibration selection and defaults, nullptr for identity Linear
+ * @param base_config_path Sensor base path, e.g. "/coolantTemperature"
+ * @param human_label Sensor label used for the UI title and description
+ * @param sort_order UI sort order
+ */
+sensesp::FloatTransform* create_calibration(
+    const BoatSensorConfig::CalibrationDef* def, const char* base_config_path,
+    const char* human_label, int sort_order);
+
+} // namespace BoatEngine
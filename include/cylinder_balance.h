@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Cylinder balance from crank tooth intervals
+ *
+ * Each firing speeds the crank up a little and each compression slows it
+ * down, so the interval between evenly spaced teeth varies within an
+ * engine cycle (two revolutions for a four-stroke). Intervals are summed
+ * by tooth position over many cycles (synchronous averaging, which
+ * cancels noise that is not locked to the cycle), then two things are
+ * read from the averaged cycle:
+ *
+ * - Contribution: the cycle is cut into one sector per cylinder and each
+ *   sector's mean speed is given relative to the cycle mean. A weak or
+ *   misfiring cylinder leaves its sector slow, below 1.0.
+ * - Roughness: with identical cylinders the speed repeats every firing,
+ *   so its spectrum over the cycle holds only multiples of the firing
+ *   order. The orders below it (1 .. cylinders - 1 per cycle) come from
+ *   imbalance alone; roughness is their combined amplitude as a fraction
+ *   of the mean speed. It is computed with a fixed-point DFT at just those
+ *   orders.
+ *
+ * Without a cam or TDC reference the sectors are numbered from the first
+ * tooth seen after a resync, not by firing order, and the numbering moves
+ * after every resync, so a resync discards the cycles not yet analysed.
+ * Tooth spacing errors add a fixed roughness floor, so compare against the
+ * same engine when healthy. Hardware independent.
+ */
+class CylinderBalance {
+public:
+    static constexpr size_t MAX_TEETH_PER_CYCLE = 256;
+    static constexpr size_t MAX_CYLINDERS = 12;
+    static constexpr uint32_t MAX_INTERVAL_US = 200000;   // Longer: stopped, resync
+    
+    struct Settings {
+        uint16_t teeth_per_rev;
+        uint8_t cylinders;
+        bool four_stroke;
+    };
+    
+    struct Result {
+        float contribution[MAX_CYLINDERS];   ///< Sector speed / cycle mean speed
+        float roughness;     ///< Sub-firing-order speed amplitude / mean speed
+        float rpm;
+        uint32_t cycles;     ///< Cycles averaged
+    };
+    
+    explicit CylinderBalance(const Settings& settings);
+    
+    /**
+     * @brief Change the settings; restarts the analysis
+     */
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return settings_; }
+    
+    /**
+     * @brief Teeth in one engine cycle
+     * @return 0 unless the teeth divide evenly into sectors within the limits
+     */
+    static size_t teethPerCycle(const Settings& settings);
+    
+    bool isValid() const { return teeth_per_cycle_ > 0; }
+    
+    /**
+     * @brief Add consecutive tooth intervals
+     *
+     * An interval longer than MAX_INTERVAL_US resyncs.
+     */
+    void addIntervals(const uint32_t* intervals_us, size_t count);
+    
+    /**
+     * @brief Start over after a gap in the intervals
+     *
+     * The next interval becomes tooth 0. The partial cycle and the cycles
+     * completed since the last analyse() are dropped: their teeth are
+     * numbered from the old sync, and summing them with cycles numbered
+     * from the new one would average two cycles out of phase.
+     */
+    void resync();
+    
+    /**
+     * @brief Analyse the cycles completed since the last call
+     * @return false if no full cycle has been seen
+     */
+    bool analyse(Result* result);
+    
+    /**
+     * @brief Cycles completed since the last analyse()
+     */
+    uint32_t getCycleCount() const { return cycles_; }
+    
+    size_t getTeethPerCycle() const { return teeth_per_cycle_; }
+    
+    /**
+     * @brief Get the number of resyncs so far (for testing/debugging)
+     */
+    uint32_t getResyncCount() const { return resyncs_; }
+
+private:
+    void clearCycles();
+    
+    Settings settings_;
+    size_t teeth_per_cycle_;   ///< 0 if the settings are invalid
+    
+    // Q15 cos/sin over one cycle, indexed by (order * tooth) % teeth
+    int16_t cos_[MAX_TEETH_PER_CYCLE];
+    int16_t sin_[MAX_TEETH_PER_CYCLE];
+    
+    uint32_t current_[MAX_TEETH_PER_CYCLE];   ///< The cycle being filled
+    size_t position_;
+    uint64_t sums_[MAX_TEETH_PER_CYCLE];      ///< Completed cycles, by tooth
+    uint32_t cycles_;
+    uint32_t resyncs_;
+};
+
+} // namespace BoatEngine
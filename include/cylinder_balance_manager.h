@@ -0,0 +1,65 @@
+#pragma once
+
+#include "acquisition_scheduler.h"
+#include "cylinder_balance.h"
+#include "pulse_input_manager.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/saveable.h"
+#include "tooth_interval_ring.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Per-cylinder contribution and roughness from the RPM pickup
+ *
+ * Replaces the RPM channel's pin ISR with one that still counts the edge
+ * for RPM and also stores the interval since the previous edge in a
+ * ToothIntervalRing. A scheduler task hands each full buffer to a
+ * CylinderBalance, and every report interval the averaged cycles are
+ * analysed and published under <prefix>roughness and
+ * <prefix>cylinder<N>.contribution. Teeth per revolution, cylinders and
+ * stroke are set in the web configuration.
+ */
+class CylinderBalanceManager : public sensesp::FileSystemSaveable {
+public:
+    /**
+     * @param defaults Engine and pickup settings used until saved
+     * @param config_path Configuration path for the UI and persistence
+     */
+    CylinderBalanceManager(const CylinderBalance::Settings& defaults,
+                           const String& config_path);
+    
+    /**
+     * @brief Take over the RPM channel's ISR and start the analysis
+     *
+     * Call after the RPM channel is added and before pulses->start().
+     */
+    void start(PulseInputManager* pulses, const PulseInputManager::Channel* rpm,
+               AcquisitionScheduler* scheduler);
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    /**
+     * @brief Get the analyser (for testing/debugging)
+     */
+    const CylinderBalance& getBalance() const { return balance_; }
+
+private:
+    static void onToothEdge(void* arg);
+    void drain();
+    void report();
+    
+    CylinderBalance balance_;
+    ToothIntervalRing ring_;
+    volatile uint32_t* counter_;   ///< RPM channel's edge counter
+    uint32_t overruns_seen_;
+    
+    sensesp::SKOutputFloat* roughness_output_;
+    sensesp::SKOutputFloat* contribution_outputs_[CylinderBalance::MAX_CYLINDERS];
+};
+
+const String ConfigSchema(const CylinderBalanceManager& obj);
+
+} // namespace BoatEngine
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "sensesp_onewire/onewire_temperature.h"
+#include "temperature_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Temperature bus on SensESP's bit-banged OneWire driver
+ *
+ * Kept as the fallback for boards where no RMT channels are free. Every
+ * slot is timed by the CPU with interrupts masked, and each request runs
+ * to completion inside the call: a scratchpad read holds the loop for
+ * about 13 ms.
+ */
+class DallasTemperatureBus : public TemperatureBus {
+public:
+    explicit DallasTemperatureBus(uint8_t pin);
+    
+    bool begin() override;
+    bool startConversion() override;
+    bool requestRead(const OneWireAddress& address, uint8_t tag) override;
+    void service() override {}
+    bool isIdle() const override { return true; }
+    
+    sensesp::onewire::DallasTemperatureSensors* getDTS() const { return dts_; }
+
+private:
+    uint8_t pin_;
+    sensesp::onewire::DallasTemperatureSensors* dts_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "log_events.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Binary log records in a lock-free RAM ring
+ *
+ * Writing a record stores the event number, a microsecond timestamp and up
+ * to MAX_ARGS 32-bit arguments in a fixed slot: no formatting, no lock and
+ * no waiting, so it is safe from any task or ISR on either core. A writer
+ * claims a slot by advancing the write position with compare-and-swap and
+ * publishes it through the slot's sequence number; when the ring is full
+ * the new record is dropped and counted instead. Records are read back in
+ * order by one consumer at a time, at its own pace, and turned into text
+ * with format() using the event's format string.
+ *
+ * The wire form, for downloads decoded on the host, is "BELG", a version
+ * byte and the dropped count (uint32), then per record the timestamp
+ * (uint32), event (uint16), argument count (uint8) and the arguments
+ * (uint32 each), all little-endian.
+ */
+class DeferredLog {
+public:
+    static constexpr size_t CAPACITY = 128;        ///< Slots, a power of two
+    static constexpr size_t MAX_ARGS = 4;
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 9;
+    static constexpr size_t MAX_RECORD_SIZE = 7 + MAX_ARGS * 4;
+    
+    struct Record {
+        uint32_t time_us;
+        uint16_t event;
+        uint8_t arg_count;
+        uint32_t args[MAX_ARGS];
+    };
+    
+    DeferredLog();
+    
+    /**
+     * @brief Write a record (any task or ISR)
+     *
+     * Integer arguments are stored as 32 bits, floating point as float.
+     * @param time_us Free-running microsecond clock, wraps at 2^32
+     * @return false if the ring was full and the record was dropped
+     */
+    template <typename... Args>
+    inline __attribute__((always_inline)) bool write(uint32_t time_us, LogEvent event,
+                                                     Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        const uint32_t words[sizeof...(Args) + 1] = {toWord(args)..., 0};
+        return push(time_us, static_cast<uint16_t>(event), words,
+                    static_cast<uint8_t>(sizeof...(Args)));
+    }
+    
+    /**
+     * @brief Write a record from raw argument words (any task or ISR)
+     *
+     * Always inlined, so that it lands in the calling ISR's IRAM.
+     */
+    inline __attribute__((always_inline)) bool push(uint32_t time_us, uint16_t event,
+                                                    const uint32_t* args, uint8_t count) {
+        uint32_t position = write_position_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[position & (CAPACITY - 1)];
+            const uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const int32_t lag = static_cast<int32_t>(sequence - position);
+            if (lag == 0) {
+                if (write_position_.compare_exchange_weak(position, position + 1,
+                                                          std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                // Still holds a record the consumer has not read
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = write_position_.load(std::memory_order_relaxed);
+            }
+        }
+        if (count > MAX_ARGS) {
+            count = MAX_ARGS;
+        }
+        slot->record.time_us = time_us;
+        slot->record.event = event;
+        slot->record.arg_count = count;
+        for (uint8_t i = 0; i < count; i++) {
+            slot->record.args[i] = args[i];
+        }
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Take the oldest record (single consumer)
+     * @return false if there is none, or the oldest is still being written
+     */
+    bool pop(Record& record);
+    
+    /**
+     * @brief Records dropped because the ring was full, since boot
+     */
+    uint32_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Write the wire header
+     * @return HEADER_SIZE, or 0 if size is too small
+     */
+    size_t writeHeader(uint8_t* out, size_t size) const;
+    
+    /**
+     * @brief Read a wire header
+     * @return HEADER_SIZE, or 0 if it is not a header this version reads
+     */
+    static size_t readHeader(const uint8_t* data, size_t size, uint32_t& dropped);
+    
+    /**
+     * @brief Write one record in wire form
+     * @return Bytes written, 0 if size is too small
+     */
+    static size_t encode(const Record& record, uint8_t* out, size_t size);
+    
+    /**
+     * @brief Read one record in wire form
+     * @return Bytes read, 0 if the data ends early or is not a record
+     */
+    static size_t decode(const uint8_t* data, size_t size, Record& record);
+    
+    /**
+     * @brief Format a record as text, e.g. "[  12.345678] MemoryMonitor: ..."
+     *
+     * Unknown events and missing arguments are shown rather than skipped.
+     * @return Characters written, excluding the terminator
+     */
+    static size_t format(const Record& record, char* out, size_t size);
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        Record record;
+    };
+    
+    template <typename T>
+    static inline __attribute__((always_inline))
+    typename std::enable_if<std::is_integral<T>::value, uint32_t>::type toWord(T value) {
+        return static_cast<uint32_t>(value);
+    }
+    
+    static inline __attribute__((always_inline)) uint32_t toWord(double value) {
+        const float narrowed = static_cast<float>(value);
+        uint32_t word;
+        memcpy(&word, &narrowed, sizeof(word));
+        return word;
+    }
+    
+    Slot slots_[CAPACITY];
+    std::atomic<uint32_t> write_position_;
+    std::atomic<uint32_t> dropped_;
+    uint32_t read_position_;    ///< Consumer only
+    
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+};
+
+} // namespace BoatEngine
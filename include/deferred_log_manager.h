@@ -0,0 +1,52 @@
+#pragma once
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "deferred_log.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief The device's deferred log, written through logDeferred()
+ */
+extern DeferredLog deferred_log;
+
+/**
+ * @brief Log an event without formatting or waiting on the UART
+ *
+ * Safe from any task and from ISRs; for periodic and repeated messages
+ * that would otherwise stall the event loop at 115200 baud.
+ */
+template <typename... Args>
+inline __attribute__((always_inline)) void logDeferred(LogEvent event, Args... args) {
+    deferred_log.write(static_cast<uint32_t>(esp_timer_get_time()), event, args...);
+}
+
+/**
+ * @brief Drains the deferred log in idle time and on demand
+ *
+ * With DEFERRED_LOG_TO_SERIAL, a task at idle priority prints the records
+ * as text every DEFERRED_LOG_DRAIN_MS; it only runs when every other task
+ * is blocked, so a slow UART delays the log rather than the sensors.
+ * Without it, records wait in RAM (the newest are dropped once full) and
+ * DEFERRED_LOG_HTTP_PATH hands out everything waiting in wire form, to
+ * decode with scripts/deferred_log_decode.py on the host.
+ */
+class DeferredLogManager {
+public:
+    DeferredLogManager();
+    
+    /**
+     * @brief Start the drain task and serve the log
+     */
+    void start();
+
+private:
+    static void drainTask(void* arg);
+    
+    SemaphoreHandle_t read_lock_;   ///< One reader at a time
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "onewire_link.h"
+#include "temperature_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief DS18B20 protocol over an asynchronous OneWire link
+ *
+ * Each request becomes one or two link transfers (command, then the
+ * 9-byte scratchpad) that service() moves along as the link finishes
+ * them, so the CPU only spends a few microseconds per transfer and never
+ * masks interrupts. Written bits are checked against what the line
+ * carried, which catches collisions and shorts, and every scratchpad is
+ * CRC checked. Device discovery in begin() uses the ROM search and waits
+ * for each step; it only runs at boot.
+ */
+class Ds18b20Bus : public TemperatureBus {
+public:
+    /**
+     * @param link Transport, e.g. RmtOneWireLink or SimulatedOneWireBus
+     */
+    explicit Ds18b20Bus(OneWireLink* link);
+    
+    bool begin() override;
+    bool startConversion() override;
+    bool requestRead(const OneWireAddress& address, uint8_t tag) override;
+    void service() override;
+    bool isIdle() const override { return op_count_ == 0; }
+    
+    /**
+     * @brief Conversions that got no presence or a corrupted command
+     */
+    uint32_t getFailedConversions() const { return failed_conversions_; }
+
+private:
+    // One conversion plus a read and a retry for every device
+    static constexpr size_t MAX_OPS = 2 * MAX_DEVICES + 1;
+    static constexpr uint32_t BLOCKING_WAIT_MS = 10;
+    
+    enum class OpType : uint8_t { CONVERT, READ };
+    enum class Step : uint8_t { IDLE, COMMAND, SCRATCHPAD };
+    
+    struct Op {
+        OpType type;
+        uint8_t tag;
+        OneWireAddress address;
+    };
+    
+    bool queue(const Op& op);
+    void startNext();
+    void finish(TemperatureReadStatus status, const uint8_t* scratchpad = nullptr);
+    bool search();
+    bool transferBlocking(bool reset, const uint8_t* tx, size_t bit_count,
+                          OneWireLink::Result* result);
+    
+    OneWireLink* link_;
+    
+    Op ops_[MAX_OPS];
+    size_t op_head_;
+    size_t op_count_;
+    Step step_;
+    
+    uint8_t command_[OneWireLink::MAX_BYTES];
+    size_t command_bits_;
+    uint32_t failed_conversions_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Time spent in each band of a value, e.g. hours at each RPM
+ *
+ * Fixed-width bins from `lower`, plus one bin for everything below and
+ * one for everything above, so memory stays the same however long it
+ * runs. Each value is held until the next one arrives, and the time in
+ * between is added to its bin. A gap longer than max_gap_ms (the sensor
+ * paused, or the device was off) and the time after a NaN are not
+ * counted. Hardware independent; the caller supplies timestamps.
+ */
+class DurationHistogram {
+public:
+    static constexpr size_t MAX_BINS = 32;   ///< Fixed-width bins, not counting below/above
+    
+    struct Layout {
+        float lower;
+        float width;
+        uint8_t bins;
+    };
+    
+    DurationHistogram();
+    DurationHistogram(const Layout& layout, uint32_t max_gap_ms);
+    
+    /**
+     * @brief Whether width is positive and bins in 1..MAX_BINS
+     */
+    static bool isValid(const Layout& layout);
+    
+    const Layout& getLayout() const { return layout_; }
+    
+    /**
+     * @brief Feed a value in the layout's units
+     */
+    void update(float value, uint32_t now_ms);
+    
+    /**
+     * @brief Bins including below (0) and above (getBinCount() - 1)
+     */
+    size_t getBinCount() const { return static_cast<size_t>(layout_.bins) + 2; }
+    
+    /**
+     * @brief Bin a value falls in
+     */
+    size_t binFor(float value) const;
+    
+    /**
+     * @brief Lower edge of a bin; the below bin starts at -infinity
+     */
+    float getBinLower(size_t bin) const;
+    
+    /**
+     * @brief Upper edge of a bin; the above bin ends at +infinity
+     */
+    float getBinUpper(size_t bin) const;
+    
+    uint64_t getMs(size_t bin) const { return ms_[bin]; }
+    uint32_t getSeconds(size_t bin) const { return static_cast<uint32_t>(ms_[bin] / 1000); }
+    uint64_t getTotalMs() const;
+    
+    /**
+     * @brief Set a bin's time, e.g. when restoring saved totals
+     */
+    void setSeconds(size_t bin, uint32_t seconds) {
+        ms_[bin] = static_cast<uint64_t>(seconds) * 1000;
+    }
+    
+    void clear();
+
+private:
+    Layout layout_;
+    uint32_t max_gap_ms_;
+    uint64_t ms_[MAX_BINS + 2];
+    
+    float last_value_;
+    uint32_t last_ms_;
+    bool has_last_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "adc_source.h"
+
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+namespace BoatEngine {
+
+/**
+ * @brief ADC1 continuous-mode source backed by the ESP32 DMA engine
+ *
+ * The hardware scans the configured channel pattern at a fixed rate and
+ * DMA fills a driver-owned pool; read() only copies out what has already
+ * been converted, so the event loop never waits on a conversion. Only ADC1
+ * channels are usable because ADC2 is shared with the WiFi radio.
+ */
+class Esp32ContinuousAdcSource : public AdcSource {
+public:
+    /**
+     * @param attenuation Input attenuation applied to every channel
+     */
+    explicit Esp32ContinuousAdcSource(adc_atten_t attenuation = ADC_ATTEN_DB_11);
+    ~Esp32ContinuousAdcSource() override;
+
+    bool begin(const uint8_t* channels, size_t count,
+               uint32_t sample_rate_hz) override;
+    void pause() override;
+    void resume() override;
+    size_t read(AdcSample* out, size_t max_samples) override;
+    float toMillivolts(float raw) const override;
+    uint32_t getOverflowCount() const override { return overflows_; }
+
+private:
+    static constexpr size_t DMA_POOL_BYTES = 4096;
+    static constexpr size_t DMA_FRAME_BYTES = 256;
+
+    adc_atten_t attenuation_;
+    esp_adc_cal_characteristics_t characteristics_;
+    bool running_;
+    bool paused_;
+    uint32_t overflows_;
+    uint8_t frame_[DMA_FRAME_BYTES];
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "spi_device_bus.h"
+
+#include <driver/spi_master.h>
+
+namespace BoatEngine {
+
+/**
+ * @brief SPI master bus on the ESP-IDF driver, with DMA
+ *
+ * queue() hands the transfer to the driver's queue for its device and
+ * returns at once; the driver runs queued transfers back to back from its
+ * interrupt and DMA moves the data, so collect() only picks up results.
+ * Each host has three hardware chip selects.
+ */
+class Esp32SpiDeviceBus : public SpiDeviceBus {
+public:
+    static constexpr size_t MAX_DEVICES = 3;
+    static constexpr size_t QUEUE_DEPTH = 2;      ///< Transfers per device
+    static constexpr int MAX_TRANSFER_BYTES = 32;
+    
+    Esp32SpiDeviceBus(spi_host_device_t host, int sclk_pin, int miso_pin, int mosi_pin);
+    ~Esp32SpiDeviceBus() override;
+    
+    /**
+     * @brief Initialise the bus; call before adding devices
+     */
+    bool begin();
+    
+    int addDevice(uint8_t cs_pin, uint8_t mode, uint32_t clock_hz) override;
+    bool queue(int device, const uint8_t* tx, uint8_t* rx, size_t length) override;
+    bool collect(Completion* completion) override;
+    uint8_t* allocateBuffer(size_t length) override;
+    void freeBuffer(uint8_t* buffer) override;
+
+private:
+    spi_host_device_t host_;
+    int sclk_pin_;
+    int miso_pin_;
+    int mosi_pin_;
+    bool initialized_;
+    
+    spi_device_handle_t devices_[MAX_DEVICES];
+    spi_transaction_t transactions_[MAX_DEVICES][QUEUE_DEPTH];
+    bool in_use_[MAX_DEVICES][QUEUE_DEPTH];
+    size_t device_count_;
+    size_t next_collect_;   ///< Device to look at first, for fairness
+};
+
+} // namespace BoatEngine
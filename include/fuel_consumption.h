@@ -0,0 +1,43 @@
+#pragma once
+
+namespace BoatEngine {
+
+/**
+ * @brief Net fuel flow and consumption per distance from two flow meters
+ *
+ * Diesel engines return unburnt fuel to the tank, so consumption is the
+ * supply meter minus the return meter. Consumption per distance divides
+ * that by speed over ground and is only defined while making way.
+ * All values are SI: m3/s, m/s and m3/m.
+ */
+class FuelConsumptionCalculator {
+public:
+    /// Below this speed over ground (about 1 knot) per-distance is undefined
+    static constexpr float MIN_SPEED_MS = 0.5f;
+    static constexpr float METERS_PER_NAUTICAL_MILE = 1852.0f;
+    
+    FuelConsumptionCalculator();
+    
+    void setSupplyFlow(float m3_per_s) { supply_ = m3_per_s; }
+    void setReturnFlow(float m3_per_s) { return_ = m3_per_s; }
+    void setSpeedOverGround(float m_per_s) { speed_ = m_per_s; }
+    
+    /**
+     * @brief Fuel burnt per second; never negative
+     */
+    float getNetFlow() const;
+    
+    /**
+     * @brief Fuel burnt per metre travelled
+     * @param[out] value Consumption in m3/m, set only when valid
+     * @return false when the vessel is not making way
+     */
+    bool getConsumptionPerDistance(float* value) const;
+
+private:
+    float supply_;
+    float return_;
+    float speed_;
+};
+
+} // namespace BoatEngine
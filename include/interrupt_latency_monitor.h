@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include "sensesp/signalk/signalk_output.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Measures how long interrupts are held off on the loop core
+ *
+ * A hardware timer interrupt fires at a fixed period; its ISR timestamps
+ * itself with the CPU cycle counter. Any code that masks interrupts on
+ * this core (bit-banged OneWire slots, flash writes) delays the next ISR,
+ * so the longest gap beyond the period is the worst-case masked time in
+ * the window. Costs one short ISR per period; meant for diagnostics.
+ */
+class InterruptLatencyMonitor {
+public:
+    /**
+     * @param period_us Timer period; shorter catches shorter masked spans
+     */
+    explicit InterruptLatencyMonitor(uint32_t period_us);
+    
+    /**
+     * @brief Start the timer on the calling core and publish periodically
+     * @param sk_path Signal K path for the worst latency, in seconds
+     * @param report_ms Window length and publish interval
+     */
+    void start(const char* sk_path, unsigned int report_ms);
+    
+    /**
+     * @brief Worst lateness since the last call, in microseconds
+     */
+    uint32_t takeMaxLatencyUs();
+
+private:
+    static void onTimer();
+    
+    uint32_t period_us_;
+    sensesp::SKOutputFloat* output_;
+};
+
+} // namespace BoatEngine
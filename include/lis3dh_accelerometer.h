@@ -0,0 +1,100 @@
+#pragma once
+
+#include "accelerometer.h"
+#include "register_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief ST LIS3DH accelerometer in FIFO stream mode
+ *
+ * Runs in high-resolution mode (12 bits, left-justified in each 16-bit
+ * output register) with all three axes on and the 32-sample FIFO in
+ * stream mode, where a full FIFO overwrites its oldest sample. Reading
+ * OUT_X_L with auto-increment while the FIFO is on pops one sample for
+ * every six bytes, so readFifo() takes a whole burst with one read of
+ * FIFO_SRC and one or two data reads. The chip flags only that the FIFO is
+ * full, not whether a sample was overwritten, so a full FIFO is reported
+ * as an overrun.
+ */
+class Lis3dhAccelerometer : public Accelerometer {
+public:
+    static constexpr uint8_t WHO_AM_I = 0x0F;
+    static constexpr uint8_t WHO_AM_I_VALUE = 0x33;
+    static constexpr uint8_t CTRL_REG1 = 0x20;
+    static constexpr uint8_t CTRL_REG4 = 0x23;
+    static constexpr uint8_t CTRL_REG5 = 0x24;
+    static constexpr uint8_t OUT_X_L = 0x28;
+    static constexpr uint8_t FIFO_CTRL_REG = 0x2E;
+    static constexpr uint8_t FIFO_SRC_REG = 0x2F;
+    static constexpr uint8_t AUTO_INCREMENT = 0x80;   ///< I2C sub-address MSB
+    
+    static constexpr uint8_t AXES_ENABLED = 0x07;      ///< CTRL_REG1 Zen Yen Xen
+    static constexpr uint8_t HIGH_RESOLUTION = 0x08;   ///< CTRL_REG4 HR
+    static constexpr uint8_t FIFO_ENABLE = 0x40;       ///< CTRL_REG5 FIFO_EN
+    static constexpr uint8_t FIFO_STREAM = 0x80;       ///< FIFO_CTRL_REG FM = 10
+    static constexpr uint8_t FIFO_FULL = 0x40;         ///< FIFO_SRC_REG OVRN_FIFO
+    static constexpr uint8_t FIFO_EMPTY = 0x20;        ///< FIFO_SRC_REG EMPTY
+    static constexpr uint8_t FIFO_COUNT_MASK = 0x1F;   ///< FIFO_SRC_REG FSS
+    
+    static constexpr size_t FIFO_DEPTH = 32;
+    static constexpr size_t SAMPLE_BYTES = 6;
+    /// Samples per data read: 120 bytes fit the Arduino core's I2C buffer
+    static constexpr size_t MAX_BURST_SAMPLES = 20;
+    
+    /**
+     * @param bus The chip's registers, transport already started
+     * @param rate_hz Requested rate; the lowest supported rate at or
+     *                above it is used, up to 1344 Hz
+     * @param range_g Full scale: 2, 4, 8 or 16 g (others round up)
+     */
+    Lis3dhAccelerometer(RegisterBus* bus, uint16_t rate_hz, uint8_t range_g);
+    
+    bool begin() override;
+    size_t readFifo(AccelSample* out, size_t max, bool* overrun) override;
+    float getGPerCount() const override { return g_per_count_; }
+    float getSampleRateHz() const override { return static_cast<float>(rate_hz_); }
+    
+    /**
+     * @brief CTRL_REG1 ODR code for a requested rate
+     * @param actual_hz Set to the rate the code selects
+     */
+    static uint8_t rateCode(uint16_t rate_hz, uint16_t* actual_hz);
+    
+    /**
+     * @brief Rate selected by a CTRL_REG1 ODR code, 0 for power-down or
+     *        the low-power-only codes
+     */
+    static uint16_t rateForCode(uint8_t code);
+    
+    /**
+     * @brief CTRL_REG4 FS code for a range
+     * @param g_per_count Set to the high-resolution sensitivity
+     */
+    static uint8_t rangeCode(uint8_t range_g, float* g_per_count);
+    
+    /**
+     * @brief Sample from the six output register bytes
+     */
+    static AccelSample decodeSample(const uint8_t* bytes);
+    
+    /**
+     * @brief Output register bytes for a sample, for simulated chips
+     */
+    static void encodeSample(const AccelSample& sample, uint8_t* bytes);
+    
+    /**
+     * @brief Get the count of failed transfers (for testing/debugging)
+     */
+    uint32_t getBusErrors() const { return bus_errors_; }
+
+private:
+    RegisterBus* bus_;
+    uint8_t rate_code_;
+    uint16_t rate_hz_;
+    uint8_t range_code_;
+    float g_per_count_;
+    uint32_t bus_errors_;
+};
+
+} // namespace BoatEngine
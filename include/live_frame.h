@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Server-Sent Events frame of gauge values, kept ready to send
+ *
+ * The frame is one event, "data: v0,v1,...\n\n", in a fixed buffer where
+ * every value has a slot of FIELD_WIDTH characters, right aligned and
+ * space padded. Updating a value rewrites only its slot, so the same bytes
+ * go to every client with no formatting per client or per send, and the
+ * frame size never changes. A value that is NaN, infinite or too wide for
+ * its slot is sent as "-". Hardware independent.
+ */
+class LiveFrame {
+public:
+    static constexpr size_t MAX_FIELDS = 12;
+    static constexpr size_t FIELD_WIDTH = 8;
+    static constexpr size_t MAX_SIZE = 6 + MAX_FIELDS * (FIELD_WIDTH + 1) + 1;
+    
+    LiveFrame();
+    
+    /**
+     * @brief Append a field, initially "-"
+     * @param decimals Digits after the decimal point
+     * @return Field index, or -1 when MAX_FIELDS are in use
+     */
+    int addField(uint8_t decimals);
+    
+    /**
+     * @brief Format value into its slot
+     */
+    void set(size_t index, float value);
+    
+    size_t getFieldCount() const { return field_count_; }
+    
+    /**
+     * @brief The frame, ready to send; not NUL terminated
+     */
+    const char* data() const { return buffer_; }
+    size_t size() const { return size_; }
+
+private:
+    char* slot(size_t index) { return buffer_ + 6 + index * (FIELD_WIDTH + 1); }
+    
+    char buffer_[MAX_SIZE + 1];
+    size_t size_;
+    uint8_t decimals_[MAX_FIELDS];
+    size_t field_count_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "live_frame.h"
+#include "sensesp/net/http_server.h"
+#include "sensesp/system/valueproducer.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Live engine gauges served by the device itself
+ *
+ * For when the Signal K server is down: a small page at the page path
+ * shows one gauge per added value and follows the events path with
+ * Server-Sent Events. Every new sample updates its slot in a LiveFrame
+ * and the whole frame is pushed, unchanged, to each open stream from the
+ * HTTP server task, so a sample reaches the phones on the next server
+ * turn and the page needs no polling. Up to MAX_CLIENTS streams are open
+ * at once; memory is fixed when the server starts. Each stream holds one
+ * of the HTTP server's few sockets for as long as the page is open, so
+ * MAX_CLIENTS is kept small enough to leave the configuration UI room.
+ */
+class LiveGaugeServer {
+public:
+    static constexpr size_t MAX_CLIENTS = 2;
+    static constexpr unsigned int SEND_TIMEOUT_MS = 250;
+    
+    LiveGaugeServer();
+    
+    /**
+     * @brief Add a gauge showing source * scale + offset
+     * @return false when LiveFrame::MAX_FIELDS gauges are in use
+     */
+    bool addGauge(sensesp::ValueProducer<float>* source, const char* label,
+                  const char* unit, float scale, float offset, uint8_t decimals);
+    
+    /**
+     * @brief Serve the page and the event stream
+     * @param refresh_ms Resend interval while values are unchanged, which
+     * also finds streams whose phone has gone away
+     */
+    void start(const char* page_path, const char* events_path,
+               unsigned int refresh_ms);
+    
+    /**
+     * @brief Get the number of open streams (for testing/debugging)
+     */
+    int getClientCount() const { return open_clients_; }
+
+private:
+    struct Client {
+        LiveGaugeServer* owner;
+        int fd;          ///< -1 when free
+    };
+    
+    esp_err_t openStream(httpd_req_t* req);
+    void queueSend();
+    static void sendFrame(void* arg);
+    static void closeClient(void* ctx);
+    
+    LiveFrame frame_;
+    SemaphoreHandle_t frame_lock_;
+    char sending_[LiveFrame::MAX_SIZE];
+    String page_;
+    
+    // Streams, touched only by the HTTP server task
+    httpd_handle_t server_;
+    Client clients_[MAX_CLIENTS];
+    
+    std::atomic<int> open_clients_;
+    std::atomic<bool> send_queued_;
+};
+
+} // namespace BoatEngine
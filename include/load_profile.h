@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "duration_histogram.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Named duration histograms, saved and served as one unit
+ *
+ * The binary form is what is saved to flash and can be downloaded:
+ * "BELP", a version byte and the histogram count, then per histogram its
+ * name (length byte + characters), layout (lower and width as float32,
+ * bin count) and the whole seconds in every bin including below and
+ * above (uint32), all little-endian. restore() takes back the totals of
+ * each histogram whose name and layout still match, so changing a layout
+ * restarts only that histogram. The CSV form has one row per bin.
+ */
+class LoadProfile {
+public:
+    static constexpr size_t MAX_HISTOGRAMS = 4;
+    static constexpr size_t MAX_NAME = 31;
+    static constexpr uint8_t VERSION = 1;
+    
+    LoadProfile();
+    
+    /**
+     * @brief Add a histogram
+     * @param name Kept by pointer; at most MAX_NAME characters are saved
+     * @return Index, or -1 if full or the layout is invalid
+     */
+    int add(const char* name, const DurationHistogram::Layout& layout, uint32_t max_gap_ms);
+    
+    size_t getCount() const { return count_; }
+    const char* getName(size_t index) const { return names_[index]; }
+    DurationHistogram& get(size_t index) { return histograms_[index]; }
+    const DurationHistogram& get(size_t index) const { return histograms_[index]; }
+    
+    /**
+     * @brief Bytes serialize() needs
+     */
+    size_t serializedSize() const;
+    
+    /**
+     * @brief Write the binary form
+     * @return Bytes written, 0 if size is too small
+     */
+    size_t serialize(uint8_t* out, size_t size) const;
+    
+    /**
+     * @brief Take back totals from a binary form
+     * @return Histograms restored
+     */
+    size_t restore(const uint8_t* data, size_t size);
+    
+    /**
+     * @brief The CSV header row, with line ending
+     */
+    static const char* csvHeader();
+    
+    /**
+     * @brief One CSV row: histogram,from,to,seconds
+     *
+     * The below bin has no "from" and the above bin no "to".
+     * @return Characters written, as snprintf
+     */
+    int formatCsvRow(size_t index, size_t bin, char* out, size_t size) const;
+    
+    /**
+     * @brief Whether any total moved by a second since markSaved()
+     */
+    bool hasChanged() const;
+    void markSaved();
+
+private:
+    const char* names_[MAX_HISTOGRAMS];
+    DurationHistogram histograms_[MAX_HISTOGRAMS];
+    size_t count_;
+    uint64_t saved_seconds_;
+};
+
+} // namespace BoatEngine
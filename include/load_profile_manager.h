@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "load_profile.h"
+#include "sensesp.h"
+#include "sensesp/system/valueproducer.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Engine load profile: time spent in each RPM and temperature band
+ *
+ * Each input feeds a DurationHistogram as values arrive, in display units
+ * (value * scale + offset). The totals are saved to LOAD_PROFILE_FILE on
+ * SPIFFS every LOAD_PROFILE_SAVE_MS if they changed, so at most that much
+ * running time is lost at power-off, and restored at boot. They are
+ * served as CSV at LOAD_PROFILE_CSV_HTTP_PATH and in the saved binary form
+ * at LOAD_PROFILE_BIN_HTTP_PATH, from a copy taken under profile_lock_
+ * since the histograms keep updating on the event loop.
+ */
+class LoadProfileManager {
+public:
+    LoadProfileManager();
+    
+    /**
+     * @brief Add a histogram fed by a producer
+     * @param name Histogram name in the saved file and the CSV
+     * @param layout Bands, in display units
+     * @return false if no more histograms fit or the layout is invalid
+     */
+    bool addInput(const char* name, const DurationHistogram::Layout& layout,
+                  sensesp::ValueProducer<float>* source, float scale, float offset);
+    
+    /**
+     * @brief Restore the saved totals and start saving and serving them
+     *
+     * Call once all inputs are added.
+     */
+    void start();
+    
+    /**
+     * @brief Get the histograms (for testing/debugging)
+     */
+    const LoadProfile& getProfile() const { return profile_; }
+
+private:
+    void restore();
+    void save();
+    void serve();
+    std::unique_ptr<LoadProfile> snapshot();
+    
+    SemaphoreHandle_t profile_lock_;   ///< Held by the event loop while updating
+    LoadProfile profile_;
+    std::vector<uint8_t> buffer_;   ///< Binary form, sized once at start()
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Messages written to the DeferredLog
+ *
+ * A record carries only the event number and its arguments; the format
+ * string is looked up when the record is turned back into text, on the
+ * device or on the host. Append new events at the end and never reuse a
+ * number, so older dumps still decode.
+ */
+enum class LogEvent : uint16_t {
+    SCHEDULER_TICKS = 0,        ///< ticks, peak tick us, peak tasks
+    HEAP = 1,                   ///< free, minimum, largest block
+    CYLINDER_BALANCE = 2,       ///< cycles, rpm, roughness, overruns
+    TEMPERATURE_INVALID = 3,    ///< address high, address low, status, celsius
+    VIBRATION = 4,              ///< rms g, peak Hz, rpm, overruns
+    COUNT
+};
+
+/**
+ * @brief printf format of an event number
+ *
+ * Conversions take one 32-bit argument each: %d %i for signed, %u %x %X
+ * %c for unsigned, %f %e %g for float. Flags, width and precision are
+ * allowed; length modifiers and %s are not.
+ * @return nullptr for an unknown event
+ */
+const char* logEventFormat(uint16_t event);
+
+} // namespace BoatEngine
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+
+#include "sensesp/signalk/signalk_output.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Publishes heap and task stack headroom for diagnosing slow leaks
+ *
+ * Reports free heap, the lowest free heap since boot, the largest block
+ * that can still be allocated (free heap minus fragmentation) and, for
+ * each named FreeRTOS task, its stack high-water mark: the fewest bytes
+ * that have ever been left unused. All values are in bytes under
+ * <prefix>freeHeap, <prefix>minimumFreeHeap, <prefix>largestFreeBlock and
+ * <prefix>stackHighWaterMark.<task>. A minimum that keeps falling over
+ * days points to a leak; a largest block well below free heap to
+ * fragmentation.
+ */
+class MemoryMonitor {
+public:
+    static constexpr size_t MAX_TASKS = 12;
+    
+    MemoryMonitor();
+    
+    /**
+     * @brief Create the outputs and publish periodically
+     * @param sk_prefix Signal K path prefix, ending in '.'
+     * @param tasks FreeRTOS task names to report stacks for
+     * @param task_count Number of names; at most MAX_TASKS are used
+     * @param report_ms Publish interval
+     */
+    void start(const char* sk_prefix, const char* const* tasks, size_t task_count,
+               unsigned int report_ms);
+    
+    /**
+     * @brief Publish the current figures
+     */
+    void report();
+
+private:
+    sensesp::SKOutputInt* free_heap_;
+    sensesp::SKOutputInt* minimum_free_heap_;
+    sensesp::SKOutputInt* largest_free_block_;
+    
+    const char* task_names_[MAX_TASKS];
+    sensesp::SKOutputInt* stack_outputs_[MAX_TASKS];
+    size_t task_count_;
+};
+
+} // namespace BoatEngine
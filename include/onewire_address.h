@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief 64-bit OneWire ROM code: family, 48-bit serial, CRC
+ *
+ * Same layout as sensesp::onewire::OWDevAddr.
+ */
+typedef std::array<uint8_t, 8> OneWireAddress;
+
+/// Characters needed for "xx:xx:xx:xx:xx:xx:xx:xx" plus terminator
+static constexpr size_t ONEWIRE_ADDRESS_STRING_SIZE = 24;
+
+/**
+ * @brief Format an address as colon-separated hex
+ */
+void formatOneWireAddress(const OneWireAddress& address, char* out);
+
+/**
+ * @brief Parse a colon-separated hex address
+ * @return false if the string is malformed (address unchanged)
+ */
+bool parseOneWireAddress(const char* text, OneWireAddress* address);
+
+/**
+ * @brief True for the all-zero placeholder of an unassigned sensor
+ */
+bool isNullOneWireAddress(const OneWireAddress& address);
+
+} // namespace BoatEngine
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief One OneWire time slot as driven by the master
+ *
+ * The master pulls the line low for low_us, then releases it for high_us.
+ * A reset is one long slot; write-1 and read slots are identical on the
+ * wire (a short low), the difference is whether a device holds the line
+ * low afterwards. This maps one-to-one onto an RMT item.
+ */
+struct OneWireSymbol {
+    uint16_t low_us;
+    uint16_t high_us;
+};
+
+/**
+ * @brief Standard-speed OneWire slot timings and their encoding
+ *
+ * A transfer is an optional reset followed by a sequence of bit slots,
+ * least significant bit of each byte first. To read, the master writes
+ * 1-bits and samples the line: every slot's captured low time tells
+ * whether the line was held low (0) or released (1). Written bits come
+ * back the same way, so a write can be checked against what the bus saw.
+ */
+class OneWireCodec {
+public:
+    static constexpr uint16_t RESET_LOW_US = 480;
+    static constexpr uint16_t RESET_HIGH_US = 480;
+    static constexpr uint16_t WRITE_1_LOW_US = 6;
+    static constexpr uint16_t WRITE_1_HIGH_US = 64;
+    static constexpr uint16_t WRITE_0_LOW_US = 60;
+    static constexpr uint16_t WRITE_0_HIGH_US = 10;
+    
+    static constexpr uint16_t RESET_DETECT_US = 400;  ///< Shortest low read as a reset
+    static constexpr uint16_t SAMPLE_US = 15;         ///< Low longer than this reads 0
+    
+    /**
+     * @brief Status of a decoded capture
+     */
+    enum class Decode { OK, FRAMING_ERROR };
+    
+    /**
+     * @brief Encode a transfer into master slot symbols
+     * @param reset Start with a reset pulse
+     * @param tx Bits to send, LSB of tx[0] first; 1 doubles as a read slot
+     * @param bit_count Number of bit slots
+     * @param out Symbol buffer, at least bit_count + 1 entries
+     * @return Number of symbols written
+     */
+    static size_t encode(bool reset, const uint8_t* tx, size_t bit_count,
+                         OneWireSymbol* out);
+    
+    /**
+     * @brief Decode the low pulse widths captured on the line
+     *
+     * The capture holds every low pulse in order: the reset, the presence
+     * pulse if any device answered, then one per bit slot.
+     * @param lows_us Captured low widths
+     * @param count Number of captured lows
+     * @param reset Whether the transfer started with a reset
+     * @param bit_count Number of bit slots sent
+     * @param presence Set to whether a presence pulse was seen
+     * @param rx Sampled bits, LSB first; (bit_count + 7) / 8 bytes
+     */
+    static Decode decode(const uint16_t* lows_us, size_t count, bool reset,
+                         size_t bit_count, bool* presence, uint8_t* rx);
+    
+    /**
+     * @brief Total duration of a symbol sequence in microseconds
+     */
+    static uint32_t duration(const OneWireSymbol* symbols, size_t count);
+};
+
+/**
+ * @brief Dallas/Maxim CRC-8 (polynomial x^8 + x^5 + x^4 + 1)
+ *
+ * Over a ROM code or scratchpad including its trailing CRC byte, the
+ * result is 0 when the data is intact.
+ */
+uint8_t oneWireCrc8(const uint8_t* data, size_t length);
+
+} // namespace BoatEngine
@@ -2,15 +2,27 @@
 
 #include <cstdint>
 
-namespace sensesp {
-namespace onewire {
-class DallasTemperatureSensors;
-}  // namespace onewire
-}  // namespace sensesp
+#include "onewire_temperature_channel.h"
+#include "sensor_config.h"
+#include "sensesp/transforms/transform.h"
+#include "timestamped_sk_output.h"
 
-// Add a one-wire temperature sensor + Linear calibration + SK output
+// Pipeline built by add_onewire_temp, for callers that attach further
+// consumers to it
+struct OneWireTempChain {
+  BoatEngine::OneWireTemperatureChannel* sensor;
+  sensesp::FloatTransform* calibration;
+  BoatEngine::TimestampedSKOutputFloat* sk_output;
+};
+
+// Add a one-wire temperature sensor + calibration + SK output
+// The calibration stage is Linear (identity by default) or a lookup table,
+// as selected by `calibration`. The sensor has no timer of its own; the
+// caller starts conversions, passes completed readings to
+// sensor->publish() and retries when it asks to.
 // See implementation in src/onewire_helper.cpp
-void add_onewire_temp(sensesp::onewire::DallasTemperatureSensors* dts,
-                      unsigned int read_delay, const char* base_name,
-                      const char* signal_k_path, const char* human_label,
-                      int sensor_sort, int linear_sort, int sk_sort);
+OneWireTempChain add_onewire_temp(
+    BoatEngine::TemperatureBus* bus, const char* base_name,
+    const char* signal_k_path, const char* human_label, int sensor_sort,
+    int linear_sort, int sk_sort,
+    const BoatEngine::BoatSensorConfig::CalibrationDef* calibration = nullptr);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "onewire_codec.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Asynchronous OneWire transport
+ *
+ * start() hands a whole transfer (reset plus bit slots) to the transport
+ * and returns at once; poll() later reports whether it has finished and,
+ * if so, what the bus answered. The slot timing is generated by hardware
+ * (RMT on the ESP32) or a simulation, never by the CPU with interrupts
+ * masked. Implementations only replay symbols and capture low pulses;
+ * the encoding is shared.
+ */
+class OneWireLink {
+public:
+    /// Largest transfer, in bytes: match ROM plus a function command
+    static constexpr size_t MAX_BYTES = 10;
+    static constexpr size_t MAX_BITS = MAX_BYTES * 8;
+    
+    enum class Status { BUSY, DONE, TIMEOUT, FRAMING_ERROR };
+    
+    /**
+     * @brief Outcome of a finished transfer
+     */
+    struct Result {
+        bool presence;            ///< A device answered the reset
+        uint8_t rx[MAX_BYTES];    ///< Sampled bits, LSB first
+    };
+    
+    OneWireLink();
+    virtual ~OneWireLink() = default;
+    
+    /**
+     * @brief Claim and configure the transport
+     */
+    virtual bool begin() = 0;
+    
+    /**
+     * @brief Start a transfer without waiting for it
+     * @param reset Start with a reset pulse
+     * @param tx Bits to send, LSB first; send 1-bits to read
+     * @param bit_count Number of bit slots, at most MAX_BITS
+     * @return false if a transfer is still in flight or the size is invalid
+     */
+    bool start(bool reset, const uint8_t* tx, size_t bit_count);
+    
+    /**
+     * @brief Check for completion of the transfer in flight
+     * @param result Filled when DONE is returned
+     * @param wait_ms How long to wait for completion; 0 never blocks
+     */
+    Status poll(Result* result, uint32_t wait_ms = 0);
+    
+    bool isBusy() const { return busy_; }
+
+protected:
+    /**
+     * @brief Begin replaying symbols on the line
+     */
+    virtual bool transmit(const OneWireSymbol* symbols, size_t count) = 0;
+    
+    /**
+     * @brief Collect the captured low pulse widths once the line is idle
+     * @param count Set to the number of lows captured on DONE
+     * @return BUSY, DONE or TIMEOUT
+     */
+    virtual Status capture(uint16_t* lows_us, size_t max, size_t* count,
+                           uint32_t wait_ms) = 0;
+    
+    /// Capture capacity: every slot plus reset and presence
+    static constexpr size_t MAX_LOWS = MAX_BITS + 2;
+
+private:
+    bool busy_;
+    bool reset_;
+    size_t bit_count_;
+    OneWireSymbol symbols_[MAX_BITS + 1];
+    uint16_t lows_[MAX_LOWS];
+};
+
+} // namespace BoatEngine
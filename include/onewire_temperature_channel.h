@@ -0,0 +1,76 @@
+#pragma once
+
+#include "acquisition_time.h"
+#include "onewire_address.h"
+#include "sensesp/sensors/sensor.h"
+#include "temperature_bus.h"
+#include "temperature_health.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief One DS18B20 on a shared bus, read on demand
+ *
+ * Stores its ROM address under the same config path and JSON keys as
+ * SensESP's OneWireTemperature, so existing sensor assignments carry over,
+ * but has no timer of its own: TemperatureSensorManager starts one
+ * conversion for the whole bus, queues a read per channel and hands each
+ * completed reading to publish(), which lets the sampling period change
+ * at runtime and keeps the transport behind TemperatureBus.
+ *
+ * Every reading is first judged by the channel's TemperatureHealth. Only
+ * valid readings are emitted; when a cycle ends without one, NaN is
+ * emitted so Signal K shows the value as missing (null) instead of a
+ * stale or garbage temperature.
+ */
+class OneWireTemperatureChannel : public sensesp::FloatSensor {
+public:
+    /**
+     * @param bus Bus the sensor is attached to, already begun
+     * @param limits Plausibility range and retry budget
+     * @param config_path Configuration path, e.g. "/coolantTemperature/oneWire"
+     */
+    OneWireTemperatureChannel(TemperatureBus* bus,
+                              const TemperatureHealth::Limits& limits,
+                              const String& config_path = "");
+    
+    /**
+     * @brief Emit a completed reading in Kelvin if it is valid
+     * @param reading Completed read from the bus
+     * @param acquired_ms Monotonic time the conversion finished; the
+     * channel's stamp is marked with it before emitting
+     * @return What the caller should do next: nothing, retry the read, or
+     * convert again before retrying
+     */
+    TemperatureHealth::Verdict publish(const TemperatureReading& reading,
+                                       uint64_t acquired_ms);
+    
+    const TemperatureHealth& getHealth() const { return health_; }
+    
+    /**
+     * @brief When the last emitted value was sampled
+     */
+    const AcquisitionStamp* getStamp() const { return &stamp_; }
+    
+    /**
+     * @brief Short health summary: "ok", "invalid", "waiting" or "notFound"
+     */
+    const char* getStatusText() const;
+    
+    bool isFound() const { return found_; }
+    const OneWireAddress& getAddress() const { return address_; }
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+
+private:
+    TemperatureBus* bus_;
+    TemperatureHealth health_;
+    AcquisitionStamp stamp_;
+    OneWireAddress address_;
+    bool found_;
+};
+
+const String ConfigSchema(const OneWireTemperatureChannel& obj);
+
+} // namespace BoatEngine
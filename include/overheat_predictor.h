@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+#include "trend_estimator.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Warns of overheating from the coolant trend, before the limit
+ *
+ * A threshold alarm only fires once the engine is hot. When raw-water
+ * cooling fails (impeller, blocked intake), coolant climbs steeply for
+ * minutes first. This fits a TrendEstimator to the coolant temperature
+ * and projects when the fitted line reaches the limit; a projection
+ * shorter than the horizon raises WARNING. It clears with hysteresis once
+ * the projection is clear_factor times the horizon away, or the rise
+ * flattens below min_rate. Reaching the limit is OVER_LIMIT, which clears
+ * limit_hysteresis below it. Normal warm-up approaches its thermostat
+ * temperature ever more slowly and stays NORMAL with sensible settings.
+ * Hardware independent; the caller supplies timestamps.
+ */
+class OverheatPredictor {
+public:
+    enum class State : uint8_t {
+        NORMAL = 0,
+        WARNING,      ///< Projected to reach the limit within the horizon
+        OVER_LIMIT,
+    };
+    
+    struct Settings {
+        float limit_k;
+        float horizon_s;          ///< Warn when the limit is this close
+        uint32_t window_ms;       ///< Trend window
+        uint8_t min_samples;      ///< Fewer samples give no projection
+        float min_rate_k_per_s;   ///< Slower rises are not projected
+        float clear_factor;       ///< WARNING clears beyond horizon x this
+        float limit_hysteresis_k;
+    };
+    
+    explicit OverheatPredictor(const Settings& settings);
+    
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return settings_; }
+    
+    /**
+     * @brief Feed a coolant temperature in Kelvin
+     *
+     * NaN (an invalid reading) restarts the trend but keeps the state.
+     * @return true if the state changed
+     */
+    bool update(float kelvin, uint32_t now_ms);
+    
+    State getState() const { return state_; }
+    
+    /**
+     * @brief Fitted rise rate in K/s, 0 without enough samples
+     */
+    float getRate() const { return rate_k_per_s_; }
+    
+    /**
+     * @brief Projected seconds until the limit; INFINITY when not rising
+     * fast enough to project, 0 at or over the limit
+     */
+    float getTimeToLimit() const { return time_to_limit_s_; }
+    
+    static const char* stateName(State state);
+
+private:
+    Settings settings_;
+    TrendEstimator trend_;
+    State state_;
+    float rate_k_per_s_;
+    float time_to_limit_s_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "onewire_helper.h"
+#include "overheat_predictor.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/saveable.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Raises a Signal K notification when coolant is heading for its limit
+ *
+ * Follows the calibrated output of the coolant chain built by
+ * add_onewire_temp and runs an OverheatPredictor on it, timed by the
+ * sensor's acquisition stamp rather than arrival. Every state change
+ * sends a notification: "warn" with the rise rate and projected time when
+ * the limit is less than the horizon away, "alarm" at the limit, and
+ * "normal" when it clears. The fitted rate and time to limit are published
+ * with each reading. Limit, horizon and trend window are set in the web
+ * configuration.
+ */
+class OverheatWarningManager : public sensesp::FileSystemSaveable {
+public:
+    /**
+     * @param defaults Predictor settings used until saved
+     * @param config_path Configuration path for the UI and persistence
+     */
+    OverheatWarningManager(const OverheatPredictor::Settings& defaults,
+                           const String& config_path);
+    
+    /**
+     * @brief Create the outputs and follow the coolant chain
+     */
+    void start(const OneWireTempChain* coolant);
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    /**
+     * @brief Get the predictor (for testing/debugging)
+     */
+    const OverheatPredictor& getPredictor() const { return predictor_; }
+
+private:
+    void onCoolant(float kelvin);
+    void notify();
+    
+    OverheatPredictor predictor_;
+    const OneWireTempChain* coolant_;
+    
+    sensesp::SKOutputRawJson* notification_;
+    sensesp::SKOutputFloat* rate_output_;
+    sensesp::SKOutputFloat* time_to_limit_output_;
+};
+
+const String ConfigSchema(const OverheatWarningManager& obj);
+
+} // namespace BoatEngine
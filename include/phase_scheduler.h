@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace BoatEngine {
+
+/**
+ * @brief Periodic tasks on a shared slot grid, each at its own phase
+ *
+ * Time is divided into slots of slot_ms, counted from the monotonic clock,
+ * and a task with a period of P slots runs in the slots where
+ * slot % P == phase. Whenever a task is added or its period changes it is
+ * given the phase that collides least with the other tasks: two tasks
+ * meet exactly when their phases are equal modulo the gcd of their
+ * periods, so the cost of each candidate phase is the weight of the tasks
+ * it would meet. With staggering off every phase is 0, which is what
+ * independent timers started together amount to.
+ *
+ * Phases are absolute, so they do not drift however late the caller is.
+ * A task whose slot was missed runs once on the next call, not once per
+ * missed slot. No allocation after construction, except what the
+ * callbacks capture.
+ */
+class PhaseScheduler {
+public:
+    static constexpr size_t MAX_TASKS = 8;
+    static constexpr uint64_t NEVER = UINT64_MAX;
+    static constexpr uint32_t MAX_HORIZON_SLOTS = 65536;   // getPeakLoad() search limit
+    
+    using Callback = std::function<void()>;
+    
+    /**
+     * @param slot_ms Slot width; periods are rounded to whole slots
+     * @param stagger false to put every task at phase 0
+     */
+    PhaseScheduler(uint32_t slot_ms, bool stagger);
+    
+    /**
+     * @brief Add a task
+     * @param period_ms Period; 0 adds it suspended
+     * @param callback Run in each of the task's slots
+     * @param weight Relative cost, for spreading heavy tasks apart
+     * @return Task index, or -1 if all slots are in use
+     */
+    int addTask(uint32_t period_ms, Callback callback, uint16_t weight = 1);
+    
+    /**
+     * @brief Change a task's period and choose its phase again
+     * @param period_ms New period; 0 suspends the task
+     */
+    void setPeriod(size_t task, uint32_t period_ms);
+    
+    /**
+     * @brief Run every task due in a slot since the last call, up to now
+     * @return Number of tasks run
+     */
+    size_t runDue(uint64_t now_ms);
+    
+    /**
+     * @brief Start of the next slot in which any task is due
+     * @return Monotonic milliseconds, or NEVER if every task is suspended
+     */
+    uint64_t nextDueMs(uint64_t now_ms) const;
+    
+    /**
+     * @brief Summed weight of the tasks due in a slot
+     */
+    uint32_t getSlotLoad(uint64_t slot) const;
+    
+    /**
+     * @brief Highest slot load over the common period of all tasks
+     *
+     * Only the first MAX_HORIZON_SLOTS are searched if the common period
+     * is longer.
+     */
+    uint32_t getPeakLoad() const;
+    
+    /**
+     * @brief Slot load if every task were at phase 0
+     */
+    uint32_t getAlignedLoad() const;
+    
+    size_t getTaskCount() const { return task_count_; }
+    uint32_t getSlotMs() const { return slot_ms_; }
+    
+    /**
+     * @brief Get a task's period in slots, 0 while suspended (for testing/debugging)
+     */
+    uint32_t getPeriodSlots(size_t task) const { return tasks_[task].period_slots; }
+    
+    /**
+     * @brief Get a task's phase in slots (for testing/debugging)
+     */
+    uint32_t getPhase(size_t task) const { return tasks_[task].phase; }
+
+private:
+    struct Task {
+        uint32_t period_slots;   ///< 0 while suspended
+        uint32_t phase;
+        uint16_t weight;
+        Callback callback;
+    };
+    
+    uint32_t toSlots(uint32_t period_ms) const;
+    uint32_t choosePhase(size_t task) const;
+    uint64_t firstDueFrom(const Task& task, uint64_t slot) const;
+    
+    uint32_t slot_ms_;
+    bool stagger_;
+    Task tasks_[MAX_TASKS];
+    size_t task_count_;
+    uint64_t next_slot_;   ///< First slot not yet run
+    bool running_;
+};
+
+} // namespace BoatEngine
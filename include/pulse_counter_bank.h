@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Lock-free edge counters shared between pulse ISRs and the event loop
+ *
+ * Each channel is a free-running 32-bit counter that only its ISR writes.
+ * The event loop never resets it; it remembers the value seen at the last
+ * read and takes the (wrap-safe) difference. Aligned 32-bit loads and
+ * stores are atomic on the ESP32, so neither side needs a critical section.
+ */
+class PulseCounterBank {
+public:
+    static constexpr size_t MAX_CHANNELS = 8;
+    
+    PulseCounterBank();
+    
+    /**
+     * @brief Address of a channel's counter, passed as the ISR argument
+     */
+    volatile uint32_t* counterFor(size_t channel) { return &counts_[channel]; }
+    
+    /**
+     * @brief Count one edge (ISR side, also used by simulations)
+     */
+    void recordEdge(size_t channel) { counts_[channel] = counts_[channel] + 1; }
+    
+    /**
+     * @brief Edges seen on a channel since the previous call
+     */
+    uint32_t takeDelta(size_t channel);
+    
+    /**
+     * @brief Edges seen on a channel since start-up (wraps at 2^32)
+     */
+    uint32_t getTotal(size_t channel) const { return counts_[channel]; }
+    
+    /**
+     * @brief Convert an edge count over an interval to a rate in Hz
+     */
+    static float toFrequency(uint32_t edges, uint32_t elapsed_ms) {
+        if (elapsed_ms == 0) {
+            return 0.0f;
+        }
+        return static_cast<float>(edges) * 1000.0f / static_cast<float>(elapsed_ms);
+    }
+
+private:
+    volatile uint32_t counts_[MAX_CHANNELS];
+    uint32_t last_[MAX_CHANNELS];
+};
+
+/**
+ * @brief Scale a pulse frequency to engineering units
+ *
+ * value = frequency / pulses_per_unit * ratio, e.g. pulses per revolution
+ * and gear ratio for RPM, or the meter K-factor for fuel flow. Inline so
+ * that it folds into the pulse pipeline.
+ */
+inline float scalePulseFrequency(float frequency_hz, float pulses_per_unit, float ratio) {
+    if (pulses_per_unit <= 0.0f) {
+        return 0.0f;
+    }
+    return frequency_hz / pulses_per_unit * ratio;
+}
+
+} // namespace BoatEngine
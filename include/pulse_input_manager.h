@@ -0,0 +1,145 @@
+#pragma once
+
+#include "acquisition_scheduler.h"
+#include "acquisition_time.h"
+#include "fuel_consumption.h"
+#include "pulse_counter_bank.h"
+#include "pulse_pipeline.h"
+#include "pulse_rate_scaling.h"
+#include "sampling_control.h"
+#include "sensor_config.h"
+#include "sensor_recording.h"
+#include "sensor_topology.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "timestamped_sk_output.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Manages all pulse-counting inputs: RPM pickup and fuel flow meters
+ *
+ * Every channel's pin interrupt goes to one shared IRAM handler whose
+ * argument is the channel's slot in a PulseCounterBank, so an edge costs a
+ * single increment. One scheduled task then reads all channels and runs each
+ * edge delta through the channel's StaticPipeline: frequency over the
+ * measured interval, then scaling with the PulseRateScaling settings, all
+ * inlined into the read loop. The last stage sets the channel's
+ * SKOutputFloat directly; the scaled value is also emitted from the
+ * PulseRateScaling for the other consumers of the channel. Net fuel flow
+ * and consumption per distance are derived on the device from the two meters.
+ * Every output is stamped with the end of the counting interval it was
+ * computed from.
+ */
+class PulseInputManager : public SamplingControl {
+public:
+    /**
+     * @brief A registered pulse channel and its pipeline
+     */
+    using Pipeline = PulseRatePipeline<PulseRateScaling, TimestampedSKOutputFloat>;
+    using EdgeHandler = void (*)(void* arg);
+    
+    struct Channel {
+        size_t index;        ///< Slot in the counter bank
+        uint8_t pin;
+        const char* signal_k_path;  ///< Default path, defines the channel in recordings
+        PulseRateScaling* scaling;  ///< Settings, and producer for other consumers
+        TimestampedSKOutputFloat* sk_output;
+        Pipeline pipeline;   ///< Counter read -> scaling -> outputs
+        EdgeHandler edge_handler;   ///< Pin ISR
+        void* edge_arg;
+    };
+    
+    /**
+     * @brief Initialize the pulse input manager
+     * @param scheduler Runs the periodic reads
+     * @param read_delay_ms Interval between frequency updates
+     */
+    PulseInputManager(AcquisitionScheduler* scheduler, unsigned int read_delay_ms);
+    
+    /**
+     * @brief Set up a topology's pulse channels and derived fuel outputs
+     *
+     * Channels are added in topology order, except the RPM channel, which
+     * is added by RPMSensorManager. The fuel outputs need both meters.
+     * The topology must outlive the manager.
+     */
+    void setupSensors(const SensorTopology& topology);
+    
+    /**
+     * @brief Add a pulse channel and build its pipeline
+     * @param config Channel definition
+     * @return The channel, or nullptr if all slots are in use
+     */
+    const Channel* addChannel(const BoatSensorConfig::PulseChannelDef& config);
+    
+    /**
+     * @brief Use another pin ISR for a channel, e.g. to timestamp its edges
+     *
+     * The handler must still count every edge, through
+     * getCounterBank()->counterFor(). Call before start().
+     * @return false if the channel does not exist or the pins are attached
+     */
+    bool setEdgeHandler(size_t index, EdgeHandler handler, void* arg);
+    
+    /**
+     * @brief Attach the pin interrupts and start the periodic reads
+     */
+    void start();
+    
+    /**
+     * @brief Read all counters and emit the scaled values
+     *
+     * Called periodically from the event loop once started.
+     */
+    void update();
+    
+    /**
+     * @brief Change the read interval; 0 stops emitting values
+     *
+     * Edges keep being counted while suspended, so totals stay exact.
+     */
+    void setSamplingInterval(unsigned int interval_ms) override;
+    
+    /**
+     * @brief Also record every counter read; nullptr to stop
+     */
+    void setRecorder(SensorRecorder* recorder);
+    
+    /**
+     * @brief Get the number of registered channels
+     */
+    size_t getChannelCount() const { return channel_count_; }
+    
+    /**
+     * @brief Get a registered channel (for testing/debugging)
+     */
+    const Channel* getChannel(size_t index) const;
+    
+    /**
+     * @brief Get the edge counters (for testing/debugging)
+     */
+    PulseCounterBank* getCounterBank() { return &counters_; }
+
+private:
+    void setupFuelConsumption(const Channel* supply, const Channel* fuel_return);
+    void publishFuelConsumption();
+    
+    unsigned int read_delay_ms_;
+    uint32_t last_update_ms_;
+    bool started_;
+    AcquisitionScheduler* scheduler_;
+    int task_;   ///< Read task, -1 before start()
+    SensorRecorder* recorder_;
+    AcquisitionStamp stamp_;   ///< End of the last counting interval
+    
+    PulseCounterBank counters_;
+    Channel channels_[PulseCounterBank::MAX_CHANNELS];
+    size_t channel_count_;
+    
+    FuelConsumptionCalculator fuel_;
+    TimestampedSKOutputFloat* net_rate_output_;       ///< nullptr without both meters
+    TimestampedSKOutputFloat* per_distance_output_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+
+#include "pulse_counter_bank.h"
+#include "static_pipeline.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Edges counted on one channel over a measured interval
+ */
+struct PulseSample {
+    uint32_t edges;
+    uint32_t elapsed_ms;
+};
+
+/**
+ * @brief Pipeline stage: edge count -> frequency in Hz
+ */
+struct EdgeRateStage {
+    float operator()(const PulseSample& sample) const {
+        return PulseCounterBank::toFrequency(sample.edges, sample.elapsed_ms);
+    }
+};
+
+/**
+ * @brief Pipeline stage: frequency -> engineering units
+ *
+ * The settings are read on every sample, so edits made in the config UI
+ * apply from the next read. Settings needs non-virtual getPulsesPerUnit()
+ * and getRatio(), as PulseRateScaling has.
+ */
+template <typename Settings>
+struct PulseScaleStage {
+    const Settings* settings;
+    
+    float operator()(float frequency_hz) const {
+        return scalePulseFrequency(frequency_hz, settings->getPulsesPerUnit(),
+                                   settings->getRatio());
+    }
+};
+
+/**
+ * @brief Pipeline stage: hand the value to a producer's observers
+ *
+ * Where the value joins the regular SensESP graph, for the consumers
+ * connected at run time. Passes the value through unchanged.
+ */
+template <typename Target>
+struct EmitStage {
+    Target* target;
+    
+    float operator()(float value) const {
+        target->emit(value);
+        return value;
+    }
+};
+
+/**
+ * @brief Pipeline stage: set one consumer directly
+ *
+ * The end of the static chain: the value goes straight to its output,
+ * without a hop through a producer's observer list. Passes the value
+ * through unchanged.
+ */
+template <typename Output>
+struct OutputStage {
+    Output* output;
+    
+    float operator()(float value) const {
+        output->set(value);
+        return value;
+    }
+};
+
+/**
+ * @brief Counter read -> scaled value -> emitted to the scaling's
+ * observers and set on the output
+ */
+template <typename Scaling, typename Output>
+using PulseRatePipeline = StaticPipeline<EdgeRateStage, PulseScaleStage<Scaling>,
+                                         EmitStage<Scaling>, OutputStage<Output>>;
+
+} // namespace BoatEngine
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "sensesp/transforms/transform.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Scales a pulse frequency (Hz) to engineering units
+ *
+ * output = input / pulses_per_unit * ratio. For an RPM pickup that is
+ * pulses per revolution and the gear ratio between the pickup and the
+ * crankshaft; for a turbine flow meter it is the K-factor in pulses/m3.
+ * Both settings are editable in the config UI. Nothing is set on it: the
+ * channel's pipeline reads the settings, scales each sample and emits the
+ * result from here to the consumers connected to the channel.
+ */
+class PulseRateScaling : public sensesp::FloatTransform {
+public:
+    PulseRateScaling(float pulses_per_unit, float ratio,
+                     const String& config_path = "");
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    float getPulsesPerUnit() const { return pulses_per_unit_; }
+    float getRatio() const { return ratio_; }
+
+private:
+    float pulses_per_unit_;
+    float ratio_;
+};
+
+const String ConfigSchema(const PulseRateScaling& obj);
+
+} // namespace BoatEngine
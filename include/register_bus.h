@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Register access to one chip on a serial bus
+ *
+ * Abstracts the I2C (or SPI) transport of register-based sensors such as
+ * the LIS3DH accelerometer, so their drivers can run against simulated
+ * chips on the host. The register address is passed on unchanged; setting
+ * a chip's auto-increment bit is up to its driver.
+ */
+class RegisterBus {
+public:
+    virtual ~RegisterBus() = default;
+    
+    /**
+     * @brief Write one register
+     * @return false if the chip did not acknowledge
+     */
+    virtual bool writeRegister(uint8_t reg, uint8_t value) = 0;
+    
+    /**
+     * @brief Read length bytes starting at reg in one transfer
+     * @return false if the chip did not answer with all of them
+     */
+    virtual bool readRegisters(uint8_t reg, uint8_t* data, size_t length) = 0;
+};
+
+} // namespace BoatEngine
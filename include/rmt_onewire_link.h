@@ -0,0 +1,57 @@
+#pragma once
+
+#include "onewire_link.h"
+
+#include <driver/rmt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/ringbuf.h>
+
+namespace BoatEngine {
+
+/**
+ * @brief OneWire transport on the ESP32 RMT peripheral
+ *
+ * A TX channel replays the slot symbols and an RX channel on the same
+ * open-drain pin records every low pulse, including those stretched by
+ * the devices. The CPU only queues the symbols and later collects the
+ * capture from the RX ring buffer, so no interrupts are masked for the
+ * duration of a slot. TX refills from its ISR, so one memory block is
+ * enough; RX cannot wrap on the ESP32 and gets two blocks, which also
+ * consumes the channel after it.
+ */
+class RmtOneWireLink : public OneWireLink {
+public:
+    /**
+     * @param pin Bus GPIO, with an external pull-up
+     * @param tx_channel RMT channel driving the bus
+     * @param rx_channel RMT channel capturing the bus (uses rx_channel + 1 too)
+     */
+    RmtOneWireLink(uint8_t pin, rmt_channel_t tx_channel, rmt_channel_t rx_channel);
+    ~RmtOneWireLink() override;
+    
+    bool begin() override;
+
+protected:
+    bool transmit(const OneWireSymbol* symbols, size_t count) override;
+    Status capture(uint16_t* lows_us, size_t max, size_t* count,
+                   uint32_t wait_ms) override;
+
+private:
+    /// Line high for longer than this ends a capture; must exceed the
+    /// release after a reset that saw no presence pulse
+    static constexpr uint16_t IDLE_THRESHOLD_US = OneWireCodec::RESET_HIGH_US + 80;
+    static constexpr uint8_t GLITCH_FILTER_TICKS = 100;  // 1.25 us at APB 80 MHz
+    static constexpr size_t RX_RINGBUF_BYTES = 1024;
+    static constexpr uint32_t TIMEOUT_MARGIN_US = 5000;
+    
+    uint8_t pin_;
+    rmt_channel_t tx_channel_;
+    rmt_channel_t rx_channel_;
+    RingbufHandle_t rx_ringbuf_;
+    bool installed_;
+    int64_t deadline_us_;
+    
+    rmt_item32_t items_[MAX_BITS + 1];
+};
+
+} // namespace BoatEngine
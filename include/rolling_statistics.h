@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BoatEngine {
+
+/**
+ * @brief Min, max, mean and standard deviation over a sliding time window,
+ * O(1) per sample
+ *
+ * Samples live in a ring sized once at construction. Min and max come from
+ * monotonic deques of ring positions: a new sample first drops every
+ * queued sample it dominates, so the front is always the window's extreme
+ * and each sample is queued and dropped at most once. Mean and variance
+ * are Welford sums with the matching removal step when a sample expires.
+ * Samples older than window_ms expire; when the ring is full the oldest is
+ * dropped early and counted. Hardware independent; the caller supplies
+ * timestamps.
+ */
+class RollingStatistics {
+public:
+    /**
+     * @param window_ms Window length
+     * @param capacity Most samples held, e.g. window_ms times the highest
+     * sample rate
+     */
+    RollingStatistics(uint32_t window_ms, uint16_t capacity);
+    
+    /**
+     * @brief Add a sample; NaN is ignored
+     * @param time_ms Sample time, not earlier than the previous one (wraps
+     * at 2^32 like millis())
+     */
+    void add(float value, uint32_t time_ms);
+    
+    /**
+     * @brief Expire samples that have left the window by now_ms
+     *
+     * Call before reading the statistics when samples may have stopped.
+     */
+    void expire(uint32_t now_ms);
+    
+    /**
+     * @brief Forget all samples
+     */
+    void reset();
+    
+    uint32_t getWindow() const { return window_ms_; }
+    uint16_t getCapacity() const { return capacity_; }
+    size_t getCount() const { return count_; }
+    
+    /**
+     * @brief Samples dropped before their time because the ring was full
+     */
+    uint32_t getOverflowCount() const { return overflows_; }
+    
+    /**
+     * @brief Statistics of the samples in the window; NaN when empty
+     */
+    float getMin() const;
+    float getMax() const;
+    float getMean() const;
+    
+    /**
+     * @brief Sample standard deviation; 0 for a single sample
+     */
+    float getStdDev() const;
+
+private:
+    struct Sample {
+        uint32_t time_ms;
+        float value;
+    };
+    
+    /**
+     * @brief Ring of ring positions, front to back
+     */
+    class Deque {
+    public:
+        explicit Deque(uint16_t capacity);
+        
+        void clear() { head_ = 0; count_ = 0; }
+        bool empty() const { return count_ == 0; }
+        uint16_t front() const { return slots_[head_]; }
+        uint16_t back() const { return slots_[(head_ + count_ - 1) % slots_.size()]; }
+        void popFront();
+        void popBack() { count_--; }
+        void pushBack(uint16_t position);
+        
+    private:
+        std::vector<uint16_t> slots_;
+        size_t head_;
+        size_t count_;
+    };
+    
+    void removeOldest();
+    
+    uint32_t window_ms_;
+    uint16_t capacity_;
+    std::vector<Sample> samples_;
+    size_t head_;     ///< Oldest sample
+    size_t count_;
+    uint32_t overflows_;
+    
+    Deque min_;       ///< Increasing values; front is the minimum
+    Deque max_;       ///< Decreasing values; front is the maximum
+    
+    double mean_;
+    double m2_;       ///< Sum of squared deviations from the mean
+};
+
+} // namespace BoatEngine
@@ -1,9 +1,7 @@
 #pragma once
 
+#include "pulse_input_manager.h"
 #include "sensor_config.h"
-#include "sensesp/sensors/digital_input.h"
-#include "sensesp/transforms/frequency.h"
-#include "sensesp/signalk/signalk_output.h"
 
 namespace BoatEngine {
 
@@ -11,51 +9,54 @@ namespace BoatEngine {
  * @brief Manages RPM sensor initialization and configuration
  * 
  * This class encapsulates all RPM sensor logic, following the Single
- * Responsibility Principle. It makes RPM sensor configuration independent
- * from other sensors.
+ * Responsibility Principle. The pickup itself is one channel of the shared
+ * PulseInputManager; this class owns its definition and exposes the RPM
+ * pipeline to the rest of the application.
  */
 class RPMSensorManager {
 public:
     /**
      * @brief Initialize the RPM sensor manager
-     * @param pin GPIO pin for RPM input
-     * @param read_delay_ms Read interval in milliseconds
-     * @param multiplier Frequency to RPM multiplier
+     * @param pulses Pulse input manager that will count the pickup edges
+     * @param config Channel definition, pin and gear ratio included
      */
-    RPMSensorManager(uint8_t pin, unsigned int read_delay_ms, float multiplier);
+    RPMSensorManager(PulseInputManager* pulses,
+                     const BoatSensorConfig::PulseChannelDef& config);
     
     /**
      * @brief Set up the RPM sensor and its data pipeline
      * 
-     * Creates the sensor, frequency converter, and SignalK output,
-     * then connects them together.
+     * Registers the RPM channel with the pulse input manager, which
+     * creates the scaling, SignalK output and the static pipeline that
+     * feeds them.
      */
     void setupSensor();
     
     /**
-     * @brief Get the digital input counter (for testing/debugging)
+     * @brief Get the RPM channel, or nullptr before setupSensor()
      */
-    sensesp::DigitalInputCounter* getCounter() const { return counter_; }
+    const PulseInputManager::Channel* getChannel() const { return channel_; }
     
     /**
-     * @brief Get the frequency transform (for testing/debugging)
+     * @brief Get the RPM scaling transform (for testing/debugging)
      */
-    sensesp::Frequency* getFrequency() const { return frequency_; }
+    PulseRateScaling* getScaling() const {
+        return channel_ ? channel_->scaling : nullptr;
+    }
     
     /**
      * @brief Get the SignalK output (for testing/debugging)
      */
-    sensesp::SKOutputFloat* getSKOutput() const { return sk_output_; }
+    TimestampedSKOutputFloat* getSKOutput() const {
+        return channel_ ? channel_->sk_output : nullptr;
+    }
 
 private:
-    uint8_t pin_;
-    unsigned int read_delay_ms_;
-    float multiplier_;
+    PulseInputManager* pulses_;
+    BoatSensorConfig::PulseChannelDef config_;
     
-    // Pipeline components
-    sensesp::DigitalInputCounter* counter_;
-    sensesp::Frequency* frequency_;
-    sensesp::SKOutputFloat* sk_output_;
+    // Pipeline components, owned by the pulse input manager
+    const PulseInputManager::Channel* channel_;
 };
 
 } // namespace BoatEngine
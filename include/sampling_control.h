@@ -0,0 +1,23 @@
+#pragma once
+
+namespace BoatEngine {
+
+/**
+ * @brief An acquisition whose sampling period can be changed at runtime
+ *
+ * Implemented by the sensor managers that own their read timer, so the
+ * SamplingGovernor can slow them down or suspend them while the engine is
+ * stopped.
+ */
+class SamplingControl {
+public:
+    virtual ~SamplingControl() = default;
+    
+    /**
+     * @brief Change the sampling period
+     * @param interval_ms New period; 0 suspends sampling entirely
+     */
+    virtual void setSamplingInterval(unsigned int interval_ms) = 0;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Engine operating state as seen by the sampling governor
+ */
+enum class EngineState : uint8_t {
+    STOPPED = 0,
+    WARMING_UP,
+    RUNNING,
+    COOLING_DOWN,   ///< Just stopped; heat soak still moves temperatures
+};
+
+/**
+ * @brief Sampling periods for one engine state, 0 meaning suspended
+ */
+struct SamplingProfile {
+    unsigned int pulse_ms;
+    unsigned int temperature_ms;
+    unsigned int analog_ms;
+};
+
+/**
+ * @brief Chooses sampling rates from the engine state
+ *
+ * Driven by the RPM pipeline: a speed above the running threshold, or any
+ * pickup edge while stopped, switches to fast sampling immediately. When
+ * the speed stays below the threshold for stop_detect_ms the engine is
+ * considered stopped; temperatures keep being watched at the cooling-down
+ * rate for cooldown_ms, then everything drops to the stopped profile.
+ * Hardware independent; the caller supplies timestamps.
+ */
+class SamplingGovernor {
+public:
+    static constexpr int STATE_COUNT = 4;
+    
+    struct Settings {
+        float running_rev_per_s;   ///< Speed above which the engine runs
+        float warm_coolant_k;      ///< Coolant below this is warming up
+        uint32_t stop_detect_ms;   ///< Time below running speed to call it stopped
+        uint32_t cooldown_ms;      ///< Heat-soak watch period after stopping
+        SamplingProfile profiles[STATE_COUNT];  ///< Indexed by EngineState
+    };
+    
+    explicit SamplingGovernor(const Settings& settings);
+    
+    void setSettings(const Settings& settings) { settings_ = settings; }
+    const Settings& getSettings() const { return settings_; }
+    
+    /**
+     * @brief Feed the scaled engine speed
+     * @return true if the state changed
+     */
+    bool onEngineSpeed(float rev_per_s, uint32_t now_ms);
+    
+    /**
+     * @brief Report pickup edges seen while sampling slowly
+     * @return true if the state changed (the engine woke up)
+     */
+    bool onEdgeActivity(uint32_t now_ms);
+    
+    /**
+     * @brief Feed the coolant temperature in Kelvin; NaN is ignored
+     * @return true if the state changed
+     */
+    bool onCoolantTemperature(float kelvin);
+    
+    /**
+     * @brief Advance time-based transitions
+     * @return true if the state changed
+     */
+    bool update(uint32_t now_ms);
+    
+    EngineState getState() const { return state_; }
+    const SamplingProfile& getProfile() const;
+    
+    static const char* stateName(EngineState state);
+
+private:
+    EngineState runningState() const;
+    bool setState(EngineState state);
+    
+    Settings settings_;
+    EngineState state_;
+    bool engine_on_;
+    bool reached_running_;     ///< False while only woken by a stray edge
+    bool coolant_known_;
+    float coolant_k_;
+    uint32_t last_running_ms_;
+    uint32_t stopped_ms_;
+};
+
+/**
+ * @brief Splits main-loop wall time into busy, spinning, yielded and asleep
+ *
+ * Busy is time inside event loop ticks that did real work (longer than a
+ * threshold); short ticks are idle spinning, which still draws active
+ * current because the CPU never halts. Yielded time is spent in delay(),
+ * where the idle task halts the CPU, and sleep is light sleep.
+ */
+class DutyCycleMeter {
+public:
+    /**
+     * @brief Supply current in each activity class, in milliamps
+     */
+    struct CurrentModel {
+        float active_ma;
+        float idle_ma;
+        float sleep_ma;
+    };
+    
+    explicit DutyCycleMeter(uint32_t busy_threshold_us);
+    
+    void recordTick(uint32_t duration_us);
+    void recordYield(uint32_t duration_us) { yield_us_ += duration_us; }
+    void recordSleep(uint32_t duration_us) { sleep_us_ += duration_us; }
+    
+    /**
+     * @brief Fraction of wall time spent doing real work
+     */
+    float getDutyCycle() const;
+    
+    /**
+     * @brief Time-weighted average supply current
+     */
+    float getEstimatedCurrentMa(const CurrentModel& model) const;
+    
+    uint64_t getTotalUs() const;
+    
+    /**
+     * @brief Start a new measurement window
+     */
+    void reset();
+
+private:
+    uint32_t busy_threshold_us_;
+    uint64_t busy_us_;
+    uint64_t spin_us_;
+    uint64_t yield_us_;
+    uint64_t sleep_us_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "pulse_input_manager.h"
+#include "sampling_control.h"
+#include "sampling_governor.h"
+#include "sensor_config.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/saveable.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Adapts all sampling rates to the engine state
+ *
+ * Listens to the RPM and coolant pipelines, runs a SamplingGovernor and
+ * pushes the active profile to every registered SamplingControl. While
+ * the engine is stopped it also polls the RPM edge counter so the first
+ * crank edge switches back to fast sampling without waiting for the slow
+ * read timer, and lets the main loop yield (or light sleep) between
+ * ticks. A duty-cycle and estimated supply current report is published to
+ * Signal K so the savings can be checked on the boat.
+ */
+class SamplingGovernorManager : public sensesp::FileSystemSaveable {
+public:
+    /**
+     * @brief Which rate of the active profile an input follows
+     */
+    enum class InputKind { PULSE, TEMPERATURE, ANALOG };
+    
+    /**
+     * @param defaults Governor thresholds and profiles used until saved
+     * @param config_path Configuration path for the UI and persistence
+     */
+    SamplingGovernorManager(const SamplingGovernor::Settings& defaults,
+                            const String& config_path);
+    
+    /**
+     * @brief Register an acquisition whose rate the governor controls
+     */
+    void addSampledInput(SamplingControl* input, InputKind kind);
+    
+    /**
+     * @brief Follow engine speed from the RPM channel
+     * @param pulses Pulse input manager that owns the channel
+     * @param rpm RPM channel; its scaled output must be in rev/s
+     */
+    void setEngineSpeedSource(PulseInputManager* pulses,
+                              const PulseInputManager::Channel* rpm);
+    
+    /**
+     * @brief Follow coolant temperature in Kelvin
+     */
+    void setCoolantSource(sensesp::ValueProducer<float>* coolant_k);
+    
+    /**
+     * @brief Create the report outputs, apply the initial profile and start
+     */
+    void start();
+    
+    /**
+     * @brief Account for one event loop tick and idle until the next
+     *
+     * Call from loop() with the duration of event_loop->tick().
+     */
+    void afterTick(uint32_t tick_us);
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    /**
+     * @brief Get the governor state machine (for testing/debugging)
+     */
+    const SamplingGovernor& getGovernor() const { return governor_; }
+
+private:
+    static constexpr size_t MAX_INPUTS = 8;
+    
+    struct SampledInput {
+        SamplingControl* control;
+        InputKind kind;
+    };
+    
+    void applyProfile();
+    void pollEdges();
+    void report();
+    void lightSleep();
+    
+    SamplingGovernor governor_;
+    DutyCycleMeter duty_;
+    bool suspend_when_stopped_;
+    bool light_sleep_;
+    
+    SampledInput inputs_[MAX_INPUTS];
+    size_t input_count_;
+    
+    PulseInputManager* pulses_;
+    const PulseInputManager::Channel* rpm_;
+    uint32_t last_edge_total_;
+    
+    sensesp::SKOutputFloat* duty_output_;
+    sensesp::SKOutputFloat* current_output_;
+    sensesp::SKOutput<String>* state_output_;
+};
+
+const String ConfigSchema(const SamplingGovernorManager& obj);
+
+} // namespace BoatEngine
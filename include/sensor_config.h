@@ -1,7 +1,17 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+#include "calibration_table.h"
+#include "cylinder_balance.h"
+#include "duration_histogram.h"
+#include "overheat_predictor.h"
+#include "sampling_governor.h"
+#include "stress_ramp.h"
+#include "temperature_health.h"
+#include "thermocouple_codec.h"
+
 namespace BoatEngine {
 
 /**
@@ -14,12 +24,216 @@ namespace BoatEngine {
 class BoatSensorConfig {
 public:
     // Hardware Pin Assignments
-    static constexpr uint8_t ONEWIRE_PIN = 25;
+    static constexpr uint8_t ONEWIRE_PIN = 25;           // Engine bus
+    static constexpr uint8_t ONEWIRE_EXHAUST_PIN = 33;   // Exhaust elbow run
     static constexpr uint8_t RPM_PIN = 16;
+    static constexpr uint8_t FUEL_SUPPLY_PIN = 26;
+    static constexpr uint8_t FUEL_RETURN_PIN = 27;
+    static constexpr uint8_t THERMOCOUPLE_SCLK_PIN = 18;   // VSPI
+    static constexpr uint8_t THERMOCOUPLE_MISO_PIN = 19;
+    static constexpr uint8_t THERMOCOUPLE_MOSI_PIN = 23;   // Only the MAX31856 listens
+    static constexpr uint8_t EXHAUST_GAS_CS_PIN = 5;
+    static constexpr uint8_t VIBRATION_SDA_PIN = 21;       // I2C, engine-mount accelerometer
+    static constexpr uint8_t VIBRATION_SCL_PIN = 22;
+    
+    // OneWire Transport
+    // RMT times the slots in hardware; BITBANG is SensESP's driver, which
+    // masks interrupts for every slot
+    enum class OneWireTransport : uint8_t {
+        RMT,
+        BITBANG
+    };
+    
+    // OneWire Buses
+    // Sensors name the bus they are wired to by index. Each RMT bus takes
+    // three RMT channels (TX, RX and the RX overflow block), so at most two
+    // buses can use RMT; any further bus must be BITBANG.
+    struct OneWireBusDef {
+        uint8_t pin;
+        OneWireTransport transport;
+        uint8_t rmt_tx_channel;
+        uint8_t rmt_rx_channel;
+    };
+    static constexpr size_t ONEWIRE_BUS_COUNT = 2;
+    static const OneWireBusDef ONEWIRE_BUSES[ONEWIRE_BUS_COUNT];
+    
+    // OneWire Sensor Health
+    // Readings outside the DS18B20 range are rejected; failed reads are
+    // retried at once. Counters go to <prefix><base_name>.<counter>.
+    static const TemperatureHealth::Limits ONEWIRE_HEALTH_LIMITS;
+    static const char ONEWIRE_HEALTH_SK_PREFIX[];
+    
+    // Analog inputs (ADC1 only - ADC2 is unavailable while WiFi is active)
+    static constexpr uint8_t OIL_PRESSURE_ADC_CHANNEL = 6;        // GPIO 34
+    static constexpr uint8_t ALTERNATOR_VOLTAGE_ADC_CHANNEL = 7;  // GPIO 35
+    static constexpr uint8_t FUEL_LEVEL_ADC_CHANNEL = 0;          // GPIO 36
     
     // Timing Constants
     static constexpr unsigned int RPM_READ_DELAY_MS = 500;
     static constexpr unsigned int TEMPERATURE_READ_DELAY_MS = 2000;
+    static constexpr unsigned int ONEWIRE_CONVERSION_TIME_MS = 750;  // 12-bit DS18B20
+    static constexpr unsigned int ONEWIRE_SERVICE_MS = 2;   // While transfers are in flight
+    static constexpr unsigned int ONEWIRE_HEALTH_REPORT_MS = 10000;
+    static constexpr unsigned int ANALOG_READ_DELAY_MS = 500;
+    static constexpr unsigned int ANALOG_DRAIN_INTERVAL_MS = 50;
+    static constexpr unsigned int THERMOCOUPLE_READ_DELAY_MS = 100;      // 10 Hz
+    // A batch is done in well under 1 ms
+    static constexpr unsigned int THERMOCOUPLE_COLLECT_DELAY_MS = 2;
+    
+    // Acquisition Scheduler
+    // The periodic reads share one slot grid, each at its own phase, so
+    // they do not pile up in one tick; see AcquisitionScheduler. Turn
+    // staggering off to measure the aligned tick cost for comparison.
+    static constexpr unsigned int SCHEDULER_SLOT_MS = 10;
+    static constexpr bool SCHEDULER_STAGGER = true;
+    static constexpr unsigned int SCHEDULER_REPORT_MS = 10000;
+    static const char SCHEDULER_SK_PREFIX[];
+    
+    // Sampling Governor
+    // RPM_READ_DELAY_MS, TEMPERATURE_READ_DELAY_MS and ANALOG_READ_DELAY_MS
+    // are the running rates; the governor switches profiles by engine state.
+    static constexpr unsigned int GOVERNOR_POLL_MS = 100;
+    static constexpr unsigned int GOVERNOR_REPORT_MS = 10000;
+    static constexpr unsigned int GOVERNOR_IDLE_YIELD_MS = 10;
+    static constexpr unsigned int GOVERNOR_LIGHT_SLEEP_MS = 200;
+    static constexpr uint32_t GOVERNOR_BUSY_TICK_US = 50;
+    static constexpr unsigned int GOVERNOR_WARMING_TEMPERATURE_MS = 1000;
+    static constexpr unsigned int GOVERNOR_STOPPED_TEMPERATURE_MS = 60000;  // Slowest read
+    static const SamplingGovernor::Settings GOVERNOR_DEFAULTS;
+    // Fastest temperature read of any GOVERNOR_DEFAULTS profile
+    static constexpr unsigned int MIN_TEMPERATURE_READ_DELAY_MS =
+        GOVERNOR_WARMING_TEMPERATURE_MS < TEMPERATURE_READ_DELAY_MS
+            ? GOVERNOR_WARMING_TEMPERATURE_MS : TEMPERATURE_READ_DELAY_MS;
+    
+    // Supply current estimates for the duty-cycle report (ESP32 + WiFi)
+    static constexpr float CURRENT_ACTIVE_MA = 110.0f;
+    static constexpr float CURRENT_IDLE_MA = 40.0f;
+    static constexpr float CURRENT_LIGHT_SLEEP_MA = 1.0f;
+    
+    // Interrupt latency probe, for comparing OneWire transports
+    static constexpr bool LATENCY_PROBE_ENABLED = false;
+    static constexpr uint32_t LATENCY_PROBE_PERIOD_US = 100;
+    static const char MAX_INTERRUPT_LATENCY_SK_PATH[];
+    
+    // Raw input recording, see SensorRecordingManager
+    static constexpr unsigned int RECORDING_DEFAULT_MAX_KB = 64;
+    static constexpr unsigned int RECORDING_FLUSH_MS = 1000;
+    static const char RECORDING_CONFIG_PATH[];
+    static const char RECORDING_FILE[];
+    static const char RECORDING_HTTP_PATH[];
+    
+    // Sensor topology, see SensorTopologyManager. The built-in sensor
+    // definitions below are the defaults when no valid file is saved.
+    static const char TOPOLOGY_CONFIG_PATH[];
+    
+    // Wall clock for delta timestamps; until it syncs the server stamps
+    // values on arrival
+    static const char SNTP_SERVER[];
+    
+    // Memory telemetry, see MemoryMonitor. Stack high-water marks are
+    // reported for the named FreeRTOS tasks that exist.
+    static constexpr unsigned int MEMORY_REPORT_MS = 60000;
+    static const char MEMORY_SK_PREFIX[];
+    static constexpr size_t MEMORY_TASK_COUNT = 10;
+    static const char* const MEMORY_TASKS[MEMORY_TASK_COUNT];
+    
+    // Deferred binary log for periodic diagnostics, see DeferredLogManager.
+    // With DEFERRED_LOG_TO_SERIAL the records are printed as text in idle
+    // time; without it they wait for a download from DEFERRED_LOG_HTTP_PATH.
+    static constexpr bool DEFERRED_LOG_TO_SERIAL = true;
+    static constexpr unsigned int DEFERRED_LOG_DRAIN_MS = 100;
+    static constexpr uint32_t DEFERRED_LOG_TASK_STACK = 3072;
+    static const char DEFERRED_LOG_TASK_NAME[];
+    static const char DEFERRED_LOG_HTTP_PATH[];
+    
+    // Predictive overheat warning on the coolant temperature, see
+    // OverheatWarningManager. Longer trend windows are clamped to what the
+    // estimator holds at the fastest temperature read interval.
+    static const OverheatPredictor::Settings OVERHEAT_DEFAULTS;
+    static constexpr unsigned int OVERHEAT_MAX_WINDOW_S =
+        TrendEstimator::maxWindowMs(MIN_TEMPERATURE_READ_DELAY_MS) / 1000;   // 63 s
+    static const char OVERHEAT_CONFIG_PATH[];
+    static const char OVERHEAT_NOTIFICATION_SK_PATH[];
+    static const char COOLANT_RATE_SK_PATH[];
+    static const char COOLANT_TIME_TO_LIMIT_SK_PATH[];
+    
+    // Cylinder balance from per-tooth crank timing, see
+    // CylinderBalanceManager. Needs a multi-tooth pickup (flywheel ring
+    // gear or trigger wheel) on the RPM input, and every tooth then costs
+    // a timestamping interrupt, so it is off by default.
+    static constexpr bool CYLINDER_BALANCE_ENABLED = false;
+    static constexpr unsigned int CYLINDER_BALANCE_DRAIN_MS = 20;   // Well inside one buffer
+    static constexpr unsigned int CYLINDER_BALANCE_REPORT_MS = 10000;
+    static const CylinderBalance::Settings CYLINDER_BALANCE_DEFAULTS;
+    static const char CYLINDER_BALANCE_CONFIG_PATH[];
+    static const char CYLINDER_BALANCE_SK_PREFIX[];
+    
+    // Engine-mount vibration from a LIS3DH on I2C, see
+    // VibrationSensorManager. The chip's 32-sample FIFO lasts 24 ms at
+    // 1344 Hz, so VIBRATION_DRAIN_MS must stay well below that. The drain
+    // task is pinned to core 0, away from loopTask (priority 1 on core 1),
+    // and runs above everything there except the WiFi and lwIP tasks, so
+    // the event loop or a slow handler can never delay a drain.
+    static constexpr bool VIBRATION_ENABLED = false;
+    static constexpr uint8_t VIBRATION_I2C_ADDRESS = 0x18;   // 0x19 with SA0 high
+    static constexpr uint32_t VIBRATION_I2C_HZ = 400000;
+    static constexpr uint16_t VIBRATION_RATE_HZ = 1344;  // Nyquist 672 Hz
+    static constexpr uint8_t VIBRATION_RANGE_G = 4;
+    static constexpr unsigned int VIBRATION_DRAIN_MS = 15;
+    static constexpr unsigned int VIBRATION_REPORT_MS = 5000;
+    static constexpr uint32_t VIBRATION_TASK_STACK = 4096;
+    static constexpr unsigned int VIBRATION_TASK_PRIORITY = 10;
+    static constexpr int VIBRATION_TASK_CORE = 0;
+    static const char VIBRATION_TASK_NAME[];
+    static const char VIBRATION_SK_PREFIX[];
+    
+    // Rolling min/max/mean/stddev of selected channels, see
+    // StatisticsPublisher. Each window holds up to `capacity` samples
+    // (12 bytes each), so size it for the fastest sampling rate.
+    struct StatisticsWindowDef {
+        const char* name;        ///< Path segment, e.g. "1min"
+        uint32_t window_ms;
+        uint16_t capacity;
+    };
+    static constexpr size_t STATISTICS_WINDOW_COUNT = 2;
+    static const StatisticsWindowDef STATISTICS_WINDOWS[STATISTICS_WINDOW_COUNT];
+    static constexpr unsigned int STATISTICS_PUBLISH_MS = 60000;
+    static const char STATISTICS_SK_PREFIX[];
+    
+    // Engine load profile for maintenance planning, see
+    // LoadProfileManager: time in each RPM (rpm) and coolant (C) band,
+    // saved to flash every LOAD_PROFILE_SAVE_MS and kept across restarts.
+    // Changing a layout restarts that histogram.
+    static const DurationHistogram::Layout LOAD_PROFILE_RPM;
+    static const DurationHistogram::Layout LOAD_PROFILE_COOLANT;
+    // A gap longer than LOAD_PROFILE_MAX_GAP_MS is not counted; it allows
+    // one missed read at the slowest governor period.
+    static constexpr uint32_t LOAD_PROFILE_MAX_GAP_MS = 2 * GOVERNOR_STOPPED_TEMPERATURE_MS;
+    static constexpr unsigned int LOAD_PROFILE_SAVE_MS = 900000;  // 15 min
+    static const char LOAD_PROFILE_FILE[];
+    static const char LOAD_PROFILE_CSV_HTTP_PATH[];
+    static const char LOAD_PROFILE_BIN_HTTP_PATH[];
+    
+    // Live gauge page for when the Signal K server is down, see
+    // LiveGaugeServer. Unchanged values are resent every LIVE_REFRESH_MS.
+    static const char LIVE_PAGE_HTTP_PATH[];
+    static const char LIVE_EVENTS_HTTP_PATH[];
+    static constexpr unsigned int LIVE_REFRESH_MS = 10000;
+    
+    // Synthetic channel stress mode, see StressTestManager. Bench use only:
+    // it replaces nothing, but floods Signal K with synthetic paths.
+    static constexpr bool STRESS_TEST_ENABLED = false;
+    static constexpr unsigned int STRESS_UPDATE_MS = 100;
+    static const StressRamp::Settings STRESS_SETTINGS;
+    static const char STRESS_SK_PREFIX[];
+    
+    static const char GOVERNOR_CONFIG_PATH[];
+    static const char GOVERNOR_STATE_SK_PATH[];
+    static const char DUTY_CYCLE_SK_PATH[];
+    static const char ESTIMATED_CURRENT_SK_PATH[];
+    
+    // Analog Acquisition
+    static constexpr uint32_t ANALOG_SAMPLE_RATE_HZ = 20000;  // Total, all channels
     
     // RPM Configuration
     static constexpr float RPM_MULTIPLIER = 1.0f;
@@ -27,6 +241,52 @@ public:
     static const char RPM_CONFIG_PATH_SKPATH[];
     static const char RPM_SK_PATH[];
     
+    // Pulse Input Configuration
+    // All pulse channels share one counter bank and one read timer
+    // (RPM_READ_DELAY_MS). Each is scaled as
+    // frequency / pulses_per_unit * ratio.
+    struct PulseChannelDef {
+        const char* signal_k_path;
+        const char* human_label;
+        const char* scaling_config_path;
+        const char* sk_config_path;
+        uint8_t pin;
+        float pulses_per_unit;
+        float ratio;
+        int scaling_sort_order;
+        int sk_sort_order;
+    };
+    
+    // Engine RPM pickup
+    static const PulseChannelDef ENGINE_RPM;
+    
+    // Fuel flow meters (turbine, K-factor in pulses per m3)
+    static const PulseChannelDef FUEL_SUPPLY_FLOW;
+    static const PulseChannelDef FUEL_RETURN_FLOW;
+    
+    // Derived fuel outputs
+    static const char FUEL_NET_RATE_SK_PATH[];
+    static const char FUEL_NET_RATE_CONFIG_PATH[];
+    static const char FUEL_PER_DISTANCE_SK_PATH[];
+    static const char FUEL_PER_DISTANCE_CONFIG_PATH[];
+    static const char SPEED_OVER_GROUND_SK_PATH[];
+    
+    // Calibration Stage Selection
+    // Every sensor chain has one calibration stage between the raw sensor
+    // and the Signal K output: either Linear or a lookup table.
+    enum class Calibration : uint8_t {
+        LINEAR,
+        TABLE
+    };
+    
+    struct CalibrationDef {
+        Calibration type;
+        float multiplier;                     // LINEAR default
+        float offset;                         // LINEAR default
+        const CalibrationTable::Point* table; // TABLE default breakpoints
+        size_t table_size;
+    };
+    
     // Temperature Sensor Configuration
     struct TemperatureSensorDef {
         const char* base_name;
@@ -35,6 +295,8 @@ public:
         int sensor_sort_order;
         int linear_sort_order;
         int sk_sort_order;
+        CalibrationDef calibration;
+        uint8_t onewire_bus;   ///< Index into ONEWIRE_BUSES
     };
     
     // Coolant Temperature Sensor
@@ -46,9 +308,62 @@ public:
     // Sea Water Outlet Temperature Sensor
     static const TemperatureSensorDef SEAWATER_OUT_TEMP;
     
+    // Exhaust Elbow Temperature Sensor, on its own bus
+    static const TemperatureSensorDef EXHAUST_TEMP;
+    
+    // Thermocouple Configuration
+    // Hot junction readings are emitted in kelvin; the calibration stage
+    // maps them to the Signal K value and is editable in the UI.
+    struct ThermocoupleSensorDef {
+        const char* base_name;
+        const char* signal_k_path;
+        const char* human_label;
+        ThermocoupleChip chip;
+        uint8_t cs_pin;
+        uint8_t tc_type;       ///< MAX31856 type code; the MAX31855 is fixed
+        int linear_sort_order;
+        int sk_sort_order;
+        CalibrationDef calibration;
+    };
+    
+    // Exhaust Gas Temperature, type K probe in the exhaust manifold
+    static const ThermocoupleSensorDef EXHAUST_GAS_TEMP;
+    static const char THERMOCOUPLE_HEALTH_SK_PREFIX[];
+    
+    // Analog Sensor Configuration
+    // The ADC value is converted to millivolts at the pin; the calibration
+    // stage maps that to the Signal K unit and is editable in the UI.
+    struct AnalogSensorDef {
+        const char* base_name;
+        const char* signal_k_path;
+        const char* human_label;
+        uint8_t adc_channel;
+        int linear_sort_order;
+        int sk_sort_order;
+        CalibrationDef calibration;
+    };
+    
+    // Oil Pressure Sender (0.5-4.5 V, 0-10 bar, via 2:3 divider)
+    static const AnalogSensorDef OIL_PRESSURE;
+    
+    // Alternator Output Voltage (via 47k/10k divider)
+    static const AnalogSensorDef ALTERNATOR_VOLTAGE;
+    
+    // VDO Fuel Level Sender (10-180 ohm, non-linear at the pin)
+    static const AnalogSensorDef FUEL_LEVEL;
+    static const CalibrationTable::Point FUEL_LEVEL_TABLE[];
+    static const size_t FUEL_LEVEL_TABLE_SIZE;
+    
     // UI Sort Orders
     static constexpr int RPM_CONFIG_SORT_ORDER = 200;
     static constexpr int RPM_SK_PATH_SORT_ORDER = 210;
+    static constexpr int CYLINDER_BALANCE_SORT_ORDER = 220;
+    static constexpr int FUEL_NET_RATE_SORT_ORDER = 260;
+    static constexpr int FUEL_PER_DISTANCE_SORT_ORDER = 270;
+    static constexpr int GOVERNOR_SORT_ORDER = 500;
+    static constexpr int RECORDING_SORT_ORDER = 510;
+    static constexpr int TOPOLOGY_SORT_ORDER = 520;
+    static constexpr int OVERHEAT_SORT_ORDER = 135;   // Right after the coolant sensor
 
 private:
     // Prevent instantiation - this is a configuration class
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sensor_config.h"
+#include "temperature_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Where a recording's bytes go: a file on the device, memory in tests
+ */
+class RecordingSink {
+public:
+    virtual ~RecordingSink() = default;
+    
+    /**
+     * @return false if the bytes could not all be stored
+     */
+    virtual bool write(const uint8_t* data, size_t size) = 0;
+};
+
+/**
+ * @brief Kinds of record in a sensor recording
+ */
+enum class RecordType : uint8_t {
+    CHANNEL = 1,        ///< Defines a channel index: kind, Signal K path, scaling
+    PULSES = 2,         ///< Edges counted on a pulse channel over an interval
+    SCRATCHPAD = 3,     ///< Raw DS18B20 scratchpad as read, unchecked
+    READ_FAILURE = 4,   ///< A temperature read that returned no scratchpad
+};
+
+enum class RecordChannelKind : uint8_t {
+    PULSE = 1,
+    TEMPERATURE = 2,
+};
+
+/**
+ * @brief One decoded record; only the fields of its type are set
+ */
+struct SensorRecord {
+    static constexpr size_t MAX_PATH = 63;
+    
+    RecordType type;
+    uint32_t time_ms;              ///< Since the recording started
+    uint8_t channel;               ///< Pulse channel or temperature sensor index
+    RecordChannelKind kind;        ///< CHANNEL
+    char sk_path[MAX_PATH + 1];    ///< CHANNEL
+    float pulses_per_unit;         ///< CHANNEL, PULSE
+    float ratio;                   ///< CHANNEL, PULSE
+    BoatSensorConfig::Calibration calibration;   ///< CHANNEL, TEMPERATURE
+    float multiplier;              ///< CHANNEL, TEMPERATURE with LINEAR
+    float offset;                  ///< CHANNEL, TEMPERATURE with LINEAR
+    uint8_t table_size;            ///< CHANNEL, TEMPERATURE with TABLE
+    CalibrationTable::Point table[CalibrationTable::MAX_POINTS];
+    uint32_t edges;                ///< PULSES
+    uint32_t elapsed_ms;           ///< PULSES
+    uint8_t scratchpad[9];         ///< SCRATCHPAD
+    TemperatureReadStatus status;  ///< READ_FAILURE
+};
+
+/**
+ * @brief Records raw sensor inputs in a compact binary stream
+ *
+ * The stream starts with a 5-byte header ("BERC" and a version byte).
+ * Each record is its type byte, the milliseconds since the previous record
+ * as a LEB128 varint, then the payload, so a pulse read takes about 7
+ * bytes and a scratchpad 12. Each channel is defined once, with its
+ * Signal K path and the scaling or calibration it had when recording
+ * started, so a recording replays without the device's configuration.
+ * Records are built in a small RAM buffer and handed to the sink when it
+ * fills up or on flush(), so the event loop never waits on flash for a
+ * single record. Recording stops for good once max_bytes
+ * would be exceeded; later records are counted as dropped.
+ */
+class SensorRecorder : public ScratchpadObserver {
+public:
+    static constexpr uint8_t VERSION = 2;
+    static constexpr size_t HEADER_SIZE = 5;
+    static constexpr size_t BUFFER_SIZE = 256;
+    
+    typedef uint32_t (*Clock)();
+    
+    /**
+     * @param sink Destination of the stream
+     * @param clock Millisecond clock, e.g. millis
+     * @param max_bytes Size limit of the whole recording
+     */
+    SensorRecorder(RecordingSink* sink, Clock clock, size_t max_bytes);
+    
+    /**
+     * @brief Write the header; records before this are ignored
+     */
+    bool begin();
+    
+    /**
+     * @brief Define a pulse channel for the replay
+     */
+    void declarePulseChannel(uint8_t channel, const char* sk_path,
+                             float pulses_per_unit, float ratio);
+    
+    /**
+     * @brief Define a temperature sensor for the replay
+     *
+     * A table calibration with more than CalibrationTable::MAX_POINTS
+     * points is recorded as its first MAX_POINTS.
+     */
+    void declareTemperatureChannel(uint8_t channel, const char* sk_path,
+                                   const BoatSensorConfig::CalibrationDef& calibration);
+    
+    /**
+     * @brief Record one pulse counter read
+     */
+    void recordPulses(uint8_t channel, uint32_t edges, uint32_t elapsed_ms);
+    
+    void onScratchpad(uint8_t tag, const uint8_t* scratchpad) override;
+    void onReadFailure(uint8_t tag, TemperatureReadStatus status) override;
+    
+    /**
+     * @brief Hand buffered records to the sink
+     * @return false if the sink failed; recording stops
+     */
+    bool flush();
+    
+    bool isRecording() const { return recording_; }
+    size_t getBytesRecorded() const { return recorded_; }
+    uint32_t getRecordCount() const { return records_; }
+    uint32_t getDroppedRecords() const { return dropped_; }
+
+private:
+    bool startRecord(RecordType type, size_t size);
+    bool startChannel(RecordChannelKind kind, uint8_t channel, const char* sk_path,
+                      size_t definition_size);
+    void put(uint8_t byte) { buffer_[used_++] = byte; }
+    void putFloat(float value);
+    void putVarint(uint32_t value);
+    static size_t varintSize(uint32_t value);
+    
+    RecordingSink* sink_;
+    Clock clock_;
+    size_t max_bytes_;
+    bool recording_;
+    uint32_t last_ms_;
+    
+    uint8_t buffer_[BUFFER_SIZE];
+    size_t used_;
+    size_t recorded_;    ///< Bytes accepted, buffered ones included
+    uint32_t records_;
+    uint32_t dropped_;
+};
+
+/**
+ * @brief Parses a recording produced by SensorRecorder
+ */
+class SensorRecordingReader {
+public:
+    SensorRecordingReader(const uint8_t* data, size_t size);
+    
+    /**
+     * @brief Check the header
+     */
+    bool begin();
+    
+    /**
+     * @brief Decode the next record
+     * @return false at the end, or if the rest of the data is unreadable
+     */
+    bool next(SensorRecord* record);
+    
+    /**
+     * @brief True if reading stopped on malformed data rather than the end
+     */
+    bool isCorrupt() const { return corrupt_; }
+
+private:
+    bool get(uint8_t* byte);
+    bool getFloat(float* value);
+    bool getVarint(uint32_t* value);
+    bool getDefinition(SensorRecord* record);
+    
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+    uint32_t time_ms_;
+    bool corrupt_;
+};
+
+} // namespace BoatEngine
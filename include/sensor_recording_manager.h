@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+
+#include "pulse_input_manager.h"
+#include "sensor_recording.h"
+#include "sensesp.h"
+#include "sensesp/system/saveable.h"
+#include "temperature_sensor_manager.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Records raw sensor inputs to flash for replay on the host
+ *
+ * When enabled in the web configuration, every pulse counter read and
+ * every DS18B20 scratchpad (or failed read) from boot onwards is written
+ * to RECORDING_FILE on SPIFFS, up to the configured size, replacing the
+ * previous recording. The file can be downloaded from RECORDING_HTTP_PATH
+ * at any time, up to the last flush, and replayed with test_sensor_replay.
+ * Enabling or disabling takes effect at the next restart.
+ */
+class SensorRecordingManager : public sensesp::FileSystemSaveable {
+public:
+    /**
+     * @param config_path Configuration path for the UI and persistence
+     */
+    explicit SensorRecordingManager(const String& config_path);
+    
+    /**
+     * @brief Start recording if enabled and serve the recording file
+     *
+     * Call once all sensors have been added to both managers.
+     */
+    void start(PulseInputManager* pulses, TemperatureSensorManager* temperatures);
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    /**
+     * @brief Get the recorder, nullptr when disabled (for testing/debugging)
+     */
+    const SensorRecorder* getRecorder() const { return recorder_; }
+
+private:
+    void serveRecording();
+    
+    bool enabled_;
+    unsigned int max_kb_;
+    RecordingSink* sink_;
+    SensorRecorder* recorder_;
+    std::atomic<size_t> servable_bytes_;   ///< Flushed part of RECORDING_FILE; SIZE_MAX: all
+};
+
+const String ConfigSchema(const SensorRecordingManager& obj);
+
+} // namespace BoatEngine
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "calibration_table.h"
+#include "sensor_config.h"
+#include "sensor_recording.h"
+#include "temperature_health.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Runs a sensor recording through the sensor pipelines on the host
+ *
+ * Each channel is rebuilt from the definition the recording carries (its
+ * Signal K path and scaling or calibration), so channels from a sensor
+ * topology replay like the built-in ones. It gets the processing its
+ * device pipeline does, using the same code: pulse reads go through
+ * PulseCounterBank::toFrequency and scalePulseFrequency as in the chain
+ * RPMSensorManager builds, scratchpads through decodeDs18b20Scratchpad,
+ * TemperatureHealth and the sensor's calibration as in add_onewire_temp.
+ * Records are processed as fast as they can be read, with the recorded
+ * timestamps, so the same recording always gives the same outputs.
+ * Temperature calibrations edited in the web UI are not in the
+ * recording; the topology's defaults are used.
+ */
+class SensorReplay {
+public:
+    static constexpr size_t MAX_CHANNELS = 8;
+    
+    /**
+     * @brief A value that would have gone to Signal K
+     */
+    struct Output {
+        const char* sk_path;
+        uint32_t time_ms;
+        float value;   ///< NaN where the device sends null
+    };
+    
+    typedef void (*OutputHandler)(const Output& output, void* context);
+    
+    SensorReplay(OutputHandler handler, void* context);
+    
+    /**
+     * @brief Replay a whole recording
+     * @return false if the header is wrong or the data ends mid-record;
+     *         everything before the damage is still replayed
+     */
+    bool run(const uint8_t* data, size_t size);
+    
+    uint32_t getRecordCount() const { return records_; }
+    uint32_t getOutputCount() const { return outputs_; }
+    
+    /**
+     * @brief Records for channels the recording never defined
+     */
+    uint32_t getUnmatchedRecords() const { return unmatched_; }
+    
+    /**
+     * @brief Health of a replayed temperature sensor, or nullptr
+     */
+    const TemperatureHealth* getHealth(uint8_t sensor) const;
+
+private:
+    struct PulsePipeline {
+        bool defined;
+        char sk_path[SensorRecord::MAX_PATH + 1];
+        float pulses_per_unit;
+        float ratio;
+    };
+    
+    struct TemperaturePipeline {
+        TemperaturePipeline();
+        
+        bool defined;
+        char sk_path[SensorRecord::MAX_PATH + 1];
+        BoatSensorConfig::Calibration calibration;
+        float multiplier;
+        float offset;
+        TemperatureHealth health;
+        CalibrationTable table;   ///< Used for Calibration::TABLE
+    };
+    
+    void declare(const SensorRecord& record);
+    void replayPulses(const SensorRecord& record);
+    void replayTemperature(const SensorRecord& record, const TemperatureReading& reading);
+    void emit(const char* sk_path, uint32_t time_ms, float value);
+    
+    OutputHandler handler_;
+    void* context_;
+    
+    PulsePipeline pulses_[MAX_CHANNELS];
+    TemperaturePipeline temperatures_[MAX_CHANNELS];
+    
+    uint32_t records_;
+    uint32_t outputs_;
+    uint32_t unmatched_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pulse_counter_bank.h"
+#include "sensor_config.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief The set of temperature and pulse channels to build at boot
+ *
+ * A flat, fixed-capacity table of sensor definitions in the same form as
+ * the built-in ones in BoatSensorConfig, so the managers are driven from
+ * it unchanged. Strings are copied into an internal pool; nothing is
+ * allocated after construction, and the definitions (and the strings they
+ * point to) stay valid until the table is cleared.
+ *
+ * Entries are checked as they are added. The first failure is kept as the
+ * table's error and later additions are refused, so a caller can fill the
+ * table from untrusted input and check isValid() once at the end.
+ */
+class SensorTopology {
+public:
+    static constexpr size_t MAX_TEMPERATURE_SENSORS = 8;   // TemperatureSensorManager::MAX_SENSORS
+    static constexpr size_t MAX_PULSE_CHANNELS = PulseCounterBank::MAX_CHANNELS;
+    static constexpr size_t STRING_POOL_SIZE = 2048;
+    
+    /**
+     * @brief What a pulse channel is used for
+     *
+     * RPM feeds the governor and the RPM outputs, the two fuel meters feed
+     * the derived consumption outputs. At most one channel per role except
+     * OTHER, and exactly one RPM channel.
+     */
+    enum class PulseRole : uint8_t {
+        RPM,
+        FUEL_SUPPLY,
+        FUEL_RETURN,
+        OTHER
+    };
+    
+    enum class Error : uint8_t {
+        NONE,
+        TOO_MANY_SENSORS,
+        POOL_FULL,
+        MISSING_FIELD,
+        DUPLICATE_NAME,
+        DUPLICATE_PIN,
+        DUPLICATE_ROLE,
+        MISSING_RPM,
+        BAD_BUS,
+        BAD_SCALING,
+        BAD_PIN
+    };
+    
+    struct PulseEntry {
+        PulseRole role;
+        BoatSensorConfig::PulseChannelDef def;
+    };
+    
+    SensorTopology();
+    
+    SensorTopology(const SensorTopology&) = delete;
+    SensorTopology& operator=(const SensorTopology&) = delete;
+    
+    /**
+     * @brief Remove all entries and strings and clear the error
+     */
+    void clear();
+    
+    /**
+     * @brief Replace the table with the built-in sensor definitions
+     */
+    void loadDefaults();
+    
+    /**
+     * @brief Copy a string into the pool
+     * @return The copy, or nullptr if the pool is full (error set)
+     */
+    const char* intern(const char* text);
+    
+    /**
+     * @brief Add a temperature sensor, copying its strings
+     *
+     * The base name must be unique; it also names the sensor's
+     * configuration paths.
+     * @return false if refused; the table keeps the first error
+     */
+    bool addTemperature(const BoatSensorConfig::TemperatureSensorDef& def);
+    
+    /**
+     * @brief Add a pulse channel, copying its strings
+     * @return false if refused; the table keeps the first error
+     */
+    bool addPulse(PulseRole role, const BoatSensorConfig::PulseChannelDef& def);
+    
+    /**
+     * @brief Check the table as a whole once all entries are added
+     * @return true if no entry was refused and an RPM channel exists
+     */
+    bool finish();
+    
+    /**
+     * @brief Mark the table invalid, for input the caller could not read
+     * @return false; the table keeps the first error
+     */
+    bool reject(Error error);
+    
+    bool isValid() const { return error_ == Error::NONE; }
+    Error getError() const { return error_; }
+    
+    size_t getTemperatureCount() const { return temperature_count_; }
+    const BoatSensorConfig::TemperatureSensorDef& getTemperature(size_t index) const {
+        return temperatures_[index];
+    }
+    
+    size_t getPulseCount() const { return pulse_count_; }
+    const PulseEntry& getPulse(size_t index) const { return pulses_[index]; }
+    
+    /**
+     * @brief Find the channel with a role other than OTHER
+     * @return The definition, or nullptr if none has that role
+     */
+    const BoatSensorConfig::PulseChannelDef* findPulse(PulseRole role) const;
+    
+    /**
+     * @brief Find a temperature sensor by its base name
+     */
+    const BoatSensorConfig::TemperatureSensorDef* findTemperature(const char* base_name) const;
+    
+    /**
+     * @brief Bytes of the string pool in use (for testing/debugging)
+     */
+    size_t getPoolUsed() const { return pool_used_; }
+    
+    /**
+     * @brief Whether a OneWire bus exists in ONEWIRE_BUSES
+     *
+     * Takes an int so values read from JSON are checked before they are
+     * narrowed.
+     */
+    static bool isValidBus(int bus);
+    
+    /**
+     * @brief Whether a GPIO can take a pulse input
+     *
+     * Refuses numbers the ESP32 does not have (GPIO_IS_VALID_GPIO), the
+     * flash pins 6-11 and the input-only pins 34-39, which lack the
+     * internal pull-up the pulse inputs enable. Takes an int so values
+     * read from JSON are checked before they are narrowed.
+     */
+    static bool isUsablePulsePin(int pin);
+    
+    /**
+     * @brief Whether another BoatSensorConfig peripheral claims a GPIO
+     *
+     * OneWire buses, the thermocouple SPI bus and chip select, the
+     * accelerometer I2C bus and the analog inputs.
+     */
+    static bool isReservedPin(uint8_t pin);
+    
+    static const char* roleName(PulseRole role);
+    static bool parseRole(const char* name, PulseRole* role);
+    static const char* errorName(Error error);
+
+private:
+    bool pinInUse(uint8_t pin) const;
+    
+    BoatSensorConfig::TemperatureSensorDef temperatures_[MAX_TEMPERATURE_SENSORS];
+    size_t temperature_count_;
+    PulseEntry pulses_[MAX_PULSE_CHANNELS];
+    size_t pulse_count_;
+    
+    char pool_[STRING_POOL_SIZE];
+    size_t pool_used_;
+    Error error_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "sensesp.h"
+#include "sensesp/system/saveable.h"
+#include "sensor_topology.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Loads the sensor topology from flash and makes it editable
+ *
+ * The temperature sensors and pulse channels to build are one JSON
+ * document, editable in the web configuration. It is parsed once, in the
+ * constructor, into a SensorTopology that the managers are then built
+ * from. A missing file, unparseable JSON or any refused entry falls back
+ * to the built-in definitions as a whole. Arrays longer than the table are
+ * refused before they are read, so the boot cost is bounded by the table
+ * size; it is measured and logged.
+ *
+ * The running channels point into the table, so edits made after boot are
+ * parsed into a second table that is only saved. They take effect at the
+ * next restart.
+ */
+class SensorTopologyManager : public sensesp::FileSystemSaveable {
+public:
+    /**
+     * @param config_path Configuration path for the UI and persistence
+     */
+    explicit SensorTopologyManager(const String& config_path);
+    
+    /**
+     * @brief The topology to build the sensors from
+     */
+    const SensorTopology& getTopology() const { return topology_; }
+    
+    /**
+     * @brief Add the configuration item to the web UI
+     */
+    void start();
+    
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    /**
+     * @brief Whether the topology came from the saved file (for testing/debugging)
+     */
+    bool isFromFile() const { return from_file_; }
+    
+    /**
+     * @brief Time taken to load and parse the file at boot
+     * @return Microseconds (for testing/debugging)
+     */
+    uint32_t getLoadTimeUs() const { return load_time_us_; }
+
+private:
+    static bool parse(const JsonObject& config, SensorTopology* topology);
+    static void write(const SensorTopology& topology, JsonObject& root);
+    
+    SensorTopology topology_;   ///< Built at boot, in use
+    SensorTopology pending_;    ///< Saved after boot, used from the next restart
+    bool booted_;
+    bool has_pending_;
+    bool from_file_;
+    uint32_t load_time_us_;
+};
+
+const String ConfigSchema(const SensorTopologyManager& obj);
+
+} // namespace BoatEngine
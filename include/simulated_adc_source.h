@@ -0,0 +1,77 @@
+#pragma once
+
+#include "adc_source.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Host-side stand-in for the continuous DMA ADC
+ *
+ * Conversions accrue at the configured sample rate as simulated time is
+ * advanced and sit in a bounded buffer until read, just like the DMA pool
+ * on the device: reading too slowly overflows and loses samples. Each
+ * channel has a settable level plus deterministic noise and optional
+ * full-scale spikes.
+ */
+class SimulatedAdcSource : public AdcSource {
+public:
+    static constexpr size_t MAX_CHANNELS = 8;
+    static constexpr uint16_t FULL_SCALE = 4095;
+
+    /**
+     * @param buffer_samples Capacity of the simulated DMA buffer
+     * @param seed Seed for the noise generator
+     */
+    explicit SimulatedAdcSource(size_t buffer_samples = 1024, uint32_t seed = 1);
+
+    bool begin(const uint8_t* channels, size_t count,
+               uint32_t sample_rate_hz) override;
+    void pause() override { paused_ = true; }
+    void resume() override { paused_ = false; }
+    size_t read(AdcSample* out, size_t max_samples) override;
+    float toMillivolts(float raw) const override;
+    uint32_t getOverflowCount() const override { return overflows_; }
+
+    /**
+     * @brief Let simulated time pass, producing conversions unless paused
+     */
+    void advance(uint32_t elapsed_ms);
+
+    /**
+     * @brief Set the noise-free level of a channel in raw counts
+     */
+    void setLevel(uint8_t channel, uint16_t raw);
+
+    /**
+     * @brief Uniform noise of +/- amplitude counts on every sample
+     */
+    void setNoise(uint16_t amplitude) { noise_ = amplitude; }
+
+    /**
+     * @brief Force every Nth sample to full scale (0 disables)
+     */
+    void setSpikeInterval(uint32_t every_n) { spike_interval_ = every_n; }
+
+    size_t getPendingCount() const { return pending_; }
+
+private:
+    uint16_t nextSample(uint8_t channel);
+
+    size_t capacity_;
+    size_t pending_;
+    uint32_t overflows_;
+    uint32_t rng_;
+    uint32_t sample_rate_hz_;
+    uint32_t fractional_;  // Sub-millisecond remainder, in Hz*ms units
+    uint32_t produced_;
+    uint16_t noise_;
+    uint32_t spike_interval_;
+    bool paused_;
+
+    uint8_t pattern_[MAX_CHANNELS];
+    size_t pattern_len_;
+    size_t pattern_pos_;
+    uint16_t level_[MAX_CHANNELS];
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "accelerometer.h"
+#include "register_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Host-side LIS3DH for driving Lis3dhAccelerometer without hardware
+ *
+ * Keeps the chip's register file and, once an output rate is set,
+ * produces samples as simulated time is advanced: 1 g on Z (the chip lying
+ * flat) plus the sine components and noise it has been given, at the
+ * chip's rate times (1 + rate error). In FIFO stream mode the samples go
+ * into a 32-deep FIFO that overwrites its oldest sample when full, and an
+ * auto-increment read of OUT_X_L pops one sample per six bytes, as on the
+ * chip.
+ */
+class SimulatedLis3dh : public RegisterBus {
+public:
+    static constexpr size_t MAX_COMPONENTS = 4;
+    
+    /**
+     * @brief A vibration at one frequency, amplitude per axis in g
+     */
+    struct Component {
+        float frequency_hz;
+        float x_g;
+        float y_g;
+        float z_g;
+    };
+    
+    SimulatedLis3dh();
+    
+    bool writeRegister(uint8_t reg, uint8_t value) override;
+    bool readRegisters(uint8_t reg, uint8_t* data, size_t length) override;
+    
+    /**
+     * @return false when MAX_COMPONENTS are in use
+     */
+    bool addComponent(const Component& component);
+    void clearComponents() { component_count_ = 0; }
+    
+    /**
+     * @brief Gaussian-ish noise on every axis, RMS in g
+     */
+    void setNoise(float rms_g) { noise_g_ = rms_g; }
+    
+    /**
+     * @brief Oscillator error, e.g. 0.02 runs 2% fast
+     */
+    void setRateError(float fraction) { rate_error_ = fraction; }
+    
+    /**
+     * @brief Stop answering, as a missing or unpowered chip
+     */
+    void setPresent(bool present) { present_ = present; }
+    
+    /**
+     * @brief Let simulated time pass, producing samples
+     */
+    void advance(uint32_t elapsed_us);
+    
+    size_t getFifoCount() const { return fifo_count_; }
+    uint32_t getProducedCount() const { return produced_; }
+    uint32_t getOverwrittenCount() const { return overwritten_; }
+    uint32_t getReadCount() const { return reads_; }
+
+private:
+    static constexpr size_t FIFO_DEPTH = 32;
+    
+    float rateHz() const;
+    bool streaming() const;
+    AccelSample sampleAt(double time_s);
+    float noise();
+    
+    uint8_t registers_[0x40];
+    Component components_[MAX_COMPONENTS];
+    size_t component_count_;
+    float noise_g_;
+    float rate_error_;
+    bool present_;
+    
+    AccelSample fifo_[FIFO_DEPTH];   ///< Ring
+    size_t fifo_head_;               ///< Oldest
+    size_t fifo_count_;
+    AccelSample latest_;             ///< Output registers outside stream mode
+    
+    double now_s_;
+    double next_sample_s_;
+    uint32_t noise_state_;
+    uint32_t produced_;
+    uint32_t overwritten_;
+    uint32_t reads_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "onewire_address.h"
+#include "onewire_link.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Bit-level simulation of a OneWire bus with DS18B20 devices
+ *
+ * Every master slot is run through each attached device's ROM and
+ * function command state machine, and the line is the wired AND of the
+ * master and all devices, exactly as on a real bus. The captured low
+ * widths are then decoded by the shared codec, so the whole protocol
+ * stack above the RMT driver runs unchanged on the host. A transfer
+ * completes only once enough simulated time has passed for its slots.
+ */
+class SimulatedOneWireBus : public OneWireLink {
+public:
+    static constexpr size_t MAX_DEVICES = 8;
+    static constexpr uint16_t PRESENCE_US = 120;
+    static constexpr uint16_t DEVICE_ZERO_US = 30;  ///< Hold time when a device sends 0
+    
+    /**
+     * @brief Faults a device can be given for the next few operations
+     */
+    enum class DeviceFault : uint8_t {
+        NONE,
+        CORRUPT_READ,   ///< Scratchpad reads arrive with a flipped bit
+        ABSENT,         ///< Device ignores resets, as if disconnected
+        POWER_ON,       ///< Device resets instead of converting: reads 85 C
+    };
+    
+    SimulatedOneWireBus();
+    
+    bool begin() override { return true; }
+    
+    /**
+     * @brief Attach a DS18B20 with the given 48-bit serial number
+     * @return Index of the device, or -1 if the bus is full
+     */
+    int addDevice(uint64_t serial);
+    
+    /**
+     * @brief Set the temperature a device reports after its next conversion
+     */
+    void setTemperature(size_t device, float celsius);
+    
+    /**
+     * @brief Make a device misbehave
+     * @param count Number of affected reads, resets or conversions
+     */
+    void injectFault(size_t device, DeviceFault fault, uint8_t count);
+    
+    const OneWireAddress& getAddress(size_t device) const {
+        return devices_[device].rom;
+    }
+    size_t getDeviceCount() const { return device_count_; }
+    
+    /**
+     * @brief Let simulated time pass
+     */
+    void advance(uint32_t elapsed_us) { now_us_ += elapsed_us; }
+    uint64_t getTimeUs() const { return now_us_; }
+    
+    /**
+     * @brief Bus time spent in transfers so far
+     */
+    uint64_t getBusyUs() const { return busy_us_; }
+    
+    uint32_t getTransferCount() const { return transfers_; }
+
+protected:
+    bool transmit(const OneWireSymbol* symbols, size_t count) override;
+    Status capture(uint16_t* lows_us, size_t max, size_t* count,
+                   uint32_t wait_ms) override;
+
+private:
+    enum class DeviceState : uint8_t {
+        IDLE,           ///< Not selected; ignores slots until the next reset
+        ROM_COMMAND,
+        MATCH_ROM,
+        SEARCH_ROM,
+        FUNCTION_COMMAND,
+        SEND_SCRATCHPAD,
+    };
+    
+    struct Device {
+        OneWireAddress rom;
+        uint8_t scratchpad[9];
+        int16_t pending_raw;   ///< Value latched by the next conversion
+        DeviceState state;
+        uint8_t shift;         ///< Command byte being received
+        uint8_t bit;           ///< Bit position within the current state
+        uint8_t search_phase;  ///< 0: send bit, 1: send complement, 2: read
+        DeviceFault fault;
+        uint8_t fault_count;   ///< Operations the fault still applies to
+        bool corrupt;          ///< Current scratchpad read goes out corrupted
+    };
+    
+    static bool romBit(const Device& device, size_t bit);
+    static void resetDevice(Device& device);
+    static bool consumeFault(Device& device, DeviceFault fault);
+    static bool deviceOutput(const Device& device);
+    void deviceSlot(Device& device, bool line);
+    static void onFunctionCommand(Device& device, uint8_t command);
+    
+    Device devices_[MAX_DEVICES];
+    size_t device_count_;
+    
+    uint64_t now_us_;
+    uint64_t done_at_us_;
+    uint64_t busy_us_;
+    uint32_t transfers_;
+    
+    uint16_t captured_[MAX_LOWS];
+    size_t captured_count_;
+};
+
+} // namespace BoatEngine
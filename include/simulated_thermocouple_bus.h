@@ -0,0 +1,91 @@
+#pragma once
+
+#include "spi_device_bus.h"
+#include "thermocouple_codec.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Host-side SPI bus with simulated MAX31855/MAX31856 chips
+ *
+ * Queued transfers run one after another, each taking its bit time at the
+ * device's clock plus a fixed setup overhead, and complete only as
+ * simulated time is advanced, as they would under DMA. Each device answers
+ * with the frame its chip would send for the temperatures and fault it has
+ * been given. A MAX31856 returns zeros until it has been set to convert.
+ */
+class SimulatedThermocoupleBus : public SpiDeviceBus {
+public:
+    static constexpr size_t MAX_DEVICES = 8;
+    static constexpr size_t QUEUE_DEPTH = 2;         ///< Per device, as configured on the device
+    static constexpr uint32_t OVERHEAD_US = 20;      ///< Per transfer
+    
+    SimulatedThermocoupleBus();
+    
+    int addDevice(uint8_t cs_pin, uint8_t mode, uint32_t clock_hz) override;
+    bool queue(int device, const uint8_t* tx, uint8_t* rx, size_t length) override;
+    bool collect(Completion* completion) override;
+    uint8_t* allocateBuffer(size_t length) override;
+    void freeBuffer(uint8_t* buffer) override;
+    
+    /**
+     * @brief Choose which chip answers on a device
+     */
+    void setChip(int device, ThermocoupleChip chip);
+    
+    /**
+     * @brief Temperatures and fault the chip reports from now on
+     */
+    void setReading(int device, const ThermocoupleReading& reading);
+    
+    /**
+     * @brief Reset a chip's registers, as a brown-out would
+     */
+    void powerCycle(int device);
+    
+    /**
+     * @brief Let simulated time pass, finishing transfers
+     */
+    void advance(uint32_t elapsed_us);
+    
+    size_t getPendingCount() const { return pending_; }
+    uint32_t getTransferCount() const { return transfers_; }
+    
+    /**
+     * @brief Whether a MAX31856 has been set to convert continuously
+     */
+    bool isConverting(int device) const;
+
+private:
+    static constexpr size_t MAX_TRANSFERS = MAX_DEVICES * QUEUE_DEPTH;
+    
+    struct Device {
+        uint32_t clock_hz;
+        ThermocoupleChip chip;
+        ThermocoupleReading reading;
+        uint8_t registers[16];   ///< MAX31856 register file
+        size_t queued;
+    };
+    
+    struct Transfer {
+        int device;
+        const uint8_t* tx;
+        uint8_t* rx;
+        size_t length;
+    };
+    
+    void run(const Transfer& transfer);
+    uint32_t durationUs(const Transfer& transfer) const;
+    
+    Device devices_[MAX_DEVICES];
+    size_t device_count_;
+    
+    Transfer queue_[MAX_TRANSFERS];   ///< Ring, in issue order
+    size_t head_;
+    size_t pending_;                  ///< Queued, not yet finished
+    size_t finished_;                 ///< Finished, not yet collected
+    uint32_t elapsed_us_;             ///< Into the transfer at the head
+    uint32_t transfers_;
+};
+
+} // namespace BoatEngine
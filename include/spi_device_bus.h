@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief SPI bus with queued, non-blocking transfers to several devices
+ *
+ * Abstracts the ESP-IDF SPI master driver, where queued transfers run
+ * back to back under DMA while the CPU does other work, so the
+ * thermocouple pipeline can run against simulated chips on the host.
+ * Buffers passed to queue() must come from allocateBuffer() and stay
+ * valid until the transfer has been collected.
+ */
+class SpiDeviceBus {
+public:
+    /**
+     * @brief A transfer that has finished
+     */
+    struct Completion {
+        int device;
+        uint8_t* rx;   ///< As passed to queue()
+    };
+    
+    virtual ~SpiDeviceBus() = default;
+    
+    /**
+     * @brief Attach a device on its own chip select
+     * @param mode SPI mode 0-3
+     * @return Device handle, or -1 if it could not be added
+     */
+    virtual int addDevice(uint8_t cs_pin, uint8_t mode, uint32_t clock_hz) = 0;
+    
+    /**
+     * @brief Start a full-duplex transfer; never blocks
+     * @return false if the device's queue is full
+     */
+    virtual bool queue(int device, const uint8_t* tx, uint8_t* rx, size_t length) = 0;
+    
+    /**
+     * @brief Take one finished transfer, oldest first; never blocks
+     * @return false when none has finished
+     */
+    virtual bool collect(Completion* completion) = 0;
+    
+    /**
+     * @brief Allocate zeroed, word-aligned memory the bus can transfer directly
+     * @return nullptr when out of memory
+     */
+    virtual uint8_t* allocateBuffer(size_t length) = 0;
+    
+    virtual void freeBuffer(uint8_t* buffer) = 0;
+};
+
+} // namespace BoatEngine
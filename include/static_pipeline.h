@@ -0,0 +1,66 @@
+#pragma once
+
+#include <utility>
+
+namespace BoatEngine {
+
+/**
+ * @brief A chain of processing stages composed at compile time
+ *
+ * Each stage is any copyable type with an operator() that takes the
+ * previous stage's result; a stage may change the value type. The stages
+ * are held by value and called directly, so with optimisation the whole
+ * chain inlines into its caller: no heap node, observer list or virtual
+ * call per hop, unlike a chain of connected ValueProducers. The price is
+ * that the chain is fixed at compile time and nothing can observe the
+ * values between stages.
+ *
+ * @code
+ * auto pipeline = makePipeline(EdgeRateStage(), PulseScaleStage<Settings>{&settings});
+ * float rpm = pipeline(PulseSample{edges, elapsed_ms});
+ * @endcode
+ */
+template <typename... Stages>
+class StaticPipeline;
+
+template <typename Last>
+class StaticPipeline<Last> {
+public:
+    StaticPipeline() = default;
+    explicit StaticPipeline(const Last& last) : stage_(last) {}
+    
+    template <typename In>
+    auto operator()(const In& input) -> decltype(std::declval<Last&>()(input)) {
+        return stage_(input);
+    }
+
+private:
+    Last stage_;
+};
+
+template <typename First, typename... Rest>
+class StaticPipeline<First, Rest...> {
+public:
+    StaticPipeline() = default;
+    StaticPipeline(const First& first, const Rest&... rest) : stage_(first), rest_(rest...) {}
+    
+    template <typename In>
+    auto operator()(const In& input)
+        -> decltype(std::declval<StaticPipeline<Rest...>&>()(std::declval<First&>()(input))) {
+        return rest_(stage_(input));
+    }
+
+private:
+    First stage_;
+    StaticPipeline<Rest...> rest_;
+};
+
+/**
+ * @brief Build a pipeline, deducing the stage types
+ */
+template <typename... Stages>
+StaticPipeline<Stages...> makePipeline(const Stages&... stages) {
+    return StaticPipeline<Stages...>(stages...);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+
+#include "rolling_statistics.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/valueproducer.h"
+#include "sensor_config.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Publishes rolling statistics of one value chain at a low rate
+ *
+ * Follows any float producer, such as the scaling of the RPM channel or
+ * the calibration of a chain made by add_onewire_temp, and keeps a
+ * RollingStatistics per configured window. Every publish interval it
+ * sends <prefix><name>.<window>.min, .max, .mean and .stdDev in the
+ * source's units, so dashboards and logs upstream need not take every
+ * raw sample. Memory is fixed when the publisher is created.
+ */
+class StatisticsPublisher {
+public:
+    static constexpr size_t MAX_WINDOWS = 4;
+    
+    /**
+     * @param windows Window definitions; at most MAX_WINDOWS are used
+     * @param window_count Number of definitions
+     */
+    StatisticsPublisher(const BoatSensorConfig::StatisticsWindowDef* windows,
+                        size_t window_count);
+    
+    /**
+     * @brief Create the outputs and follow source
+     * @param source Value chain to summarise
+     * @param sk_prefix Signal K path prefix, ending in '.'
+     * @param name Path segment for this channel
+     * @param publish_ms Publish interval
+     */
+    void start(sensesp::ValueProducer<float>* source, const char* sk_prefix,
+               const char* name, unsigned int publish_ms);
+    
+    /**
+     * @brief Publish the statistics of every window that has samples
+     */
+    void publish();
+    
+    /**
+     * @brief Get a window's statistics (for testing/debugging)
+     */
+    const RollingStatistics* getStatistics(size_t index) const {
+        return index < window_count_ ? windows_[index].statistics : nullptr;
+    }
+
+private:
+    struct Window {
+        RollingStatistics* statistics;
+        sensesp::SKOutputFloat* min;
+        sensesp::SKOutputFloat* max;
+        sensesp::SKOutputFloat* mean;
+        sensesp::SKOutputFloat* stddev;
+        uint32_t reported_overflows;
+    };
+    
+    const BoatSensorConfig::StatisticsWindowDef* defs_;
+    Window windows_[MAX_WINDOWS];
+    size_t window_count_;
+    const char* name_;
+};
+
+} // namespace BoatEngine
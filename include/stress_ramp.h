@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Ramps synthetic channels until the pipeline saturates
+ *
+ * Starts with start_channels synthetic sensors, each emitting at rate_hz,
+ * and adds channel_step more after every step until one of the step's
+ * measurements shows saturation:
+ *  - a tick overrun: one event loop tick took longer than the emission
+ *    period, so timers could not fire on time;
+ *  - dropped values: fewer than min_delivery of the values the channels
+ *    should have produced reached the end of their chains.
+ * Each step first settles for settle_ms (new channels are allocated and
+ * connected at its start), then measures for step_ms. Hardware
+ * independent; the caller supplies timestamps, tick durations and heap
+ * readings, and creates channels when update() asks for more.
+ */
+class StressRamp {
+public:
+    struct Settings {
+        uint16_t start_channels;
+        uint16_t channel_step;
+        uint16_t max_channels;
+        float rate_hz;          ///< Emissions per second per channel
+        uint32_t settle_ms;     ///< Ignored time after channels are added
+        uint32_t step_ms;       ///< Measured time per step
+        float min_delivery;     ///< Fraction of expected values that must arrive
+    };
+    
+    /**
+     * @brief Measurements of one step
+     */
+    struct Step {
+        uint16_t channels;
+        uint32_t expected;      ///< Values the channels should have emitted
+        uint32_t delivered;     ///< Values that reached the outputs
+        uint32_t overruns;      ///< Ticks longer than the emission period
+        uint32_t max_tick_us;
+        float cpu_load;         ///< Fraction of the step spent in ticks
+        uint32_t min_free_heap; ///< Bytes
+        bool saturated;
+    };
+    
+    explicit StressRamp(const Settings& settings);
+    
+    /**
+     * @brief Start the first step
+     */
+    void begin(uint32_t now_ms);
+    
+    /**
+     * @brief Count values that reached the end of a chain
+     */
+    void onDelivered(uint32_t count = 1);
+    
+    /**
+     * @brief Report one event loop tick
+     * @param busy_us Time the tick took
+     */
+    void onTick(uint32_t busy_us);
+    
+    /**
+     * @brief Report the current free heap
+     */
+    void onFreeHeap(uint32_t bytes);
+    
+    /**
+     * @brief Advance the ramp
+     * @return true if a new step started; the caller then brings the
+     * number of channels up to getChannels()
+     */
+    bool update(uint32_t now_ms);
+    
+    bool isRunning() const { return running_; }
+    
+    /**
+     * @brief Whether the ramp ended by saturating rather than at max_channels
+     */
+    bool isSaturated() const { return failed_.saturated; }
+    
+    /**
+     * @brief Channels the current step runs
+     */
+    uint16_t getChannels() const { return current_.channels; }
+    
+    const Settings& getSettings() const { return settings_; }
+    
+    /**
+     * @brief The last step that kept up (channels 0 if none did)
+     */
+    const Step& getLastGoodStep() const { return last_good_; }
+    
+    /**
+     * @brief The step that saturated, valid once isSaturated()
+     */
+    const Step& getSaturatedStep() const { return failed_; }
+    
+    /**
+     * @brief Highest sustained load: channels x Hz of the last good step
+     */
+    float getSaturationChannelHz() const;
+
+private:
+    void startStep(uint16_t channels, uint32_t now_ms);
+    void finishStep(uint32_t now_ms);
+    
+    Settings settings_;
+    bool running_;
+    bool measuring_;
+    uint32_t step_start_ms_;
+    uint32_t measure_start_ms_;
+    uint64_t busy_us_;
+    uint32_t period_us_;
+    
+    Step current_;
+    Step last_good_;
+    Step failed_;
+};
+
+} // namespace BoatEngine
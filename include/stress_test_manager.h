@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/observablevalue.h"
+#include "stress_ramp.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Finds how many channels x Hz this controller can sustain
+ *
+ * Runs a StressRamp over synthetic sensors built like the real ones: a
+ * source with its own repeat timer -> Linear -> SKOutputFloat, publishing
+ * under <prefix>channel<N>. Every value reaching an output counts as
+ * delivered; the main loop reports each tick's duration through
+ * afterTick(). Each step is logged, and when the ramp ends the synthetic
+ * channels stop and the saturation point is published as
+ * <prefix>saturation (channels x Hz), with <prefix>channels,
+ * <prefix>cpuLoad (ratio) and <prefix>minimumFreeHeap (bytes) of the last
+ * step that kept up.
+ *
+ * Meant for a bench unit, not a boat: the synthetic deltas load the Signal
+ * K server as much as the controller.
+ */
+class StressTestManager {
+public:
+    explicit StressTestManager(const StressRamp::Settings& settings);
+    
+    /**
+     * @brief Create the first channels and start ramping
+     * @param sk_prefix Signal K path prefix, ending in '.'
+     */
+    void start(const char* sk_prefix);
+    
+    /**
+     * @brief Report the duration of one event loop tick
+     */
+    void afterTick(uint32_t busy_us) { ramp_.onTick(busy_us); }
+    
+    const StressRamp& getRamp() const { return ramp_; }
+
+private:
+    /**
+     * @brief A synthetic sensor; its timer starts after a phase offset
+     */
+    struct Channel {
+        sensesp::ObservableValue<float>* source;
+        reactesp::RepeatEvent* timer;
+        float value;
+    };
+    
+    void addChannels(uint16_t count);
+    void update();
+    void logStep(const StressRamp::Step& step) const;
+    void finish();
+    
+    StressRamp ramp_;
+    String prefix_;
+    reactesp::RepeatEvent* update_timer_;
+    bool stopped_;
+    std::vector<Channel*> channels_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "onewire_address.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Outcome of one temperature read
+ */
+enum class TemperatureReadStatus : uint8_t {
+    OK,
+    NO_DEVICE,     ///< Nobody answered the reset
+    CRC_ERROR,     ///< Scratchpad arrived corrupted
+    TIMEOUT,       ///< The transfer never completed
+    BUS_ERROR,     ///< Line stuck low or otherwise unreadable
+    DROPPED,       ///< The bus refused the request; its queue was full
+};
+
+/**
+ * @brief A completed read, matched to its request by tag
+ */
+struct TemperatureReading {
+    uint8_t tag;
+    TemperatureReadStatus status;
+    float celsius;
+};
+
+/**
+ * @brief Sees every read on a bus before it is decoded, e.g. to record it
+ */
+class ScratchpadObserver {
+public:
+    virtual ~ScratchpadObserver() = default;
+    
+    /**
+     * @brief A scratchpad arrived, as read and before any checks
+     */
+    virtual void onScratchpad(uint8_t tag, const uint8_t* scratchpad) = 0;
+    
+    /**
+     * @brief A read failed before any scratchpad arrived
+     */
+    virtual void onReadFailure(uint8_t tag, TemperatureReadStatus status) = 0;
+};
+
+/**
+ * @brief A bus of DS18B20 temperature sensors
+ *
+ * Conversions and reads are requested and complete later: the caller
+ * queues work, calls service() until isIdle(), and collects results with
+ * takeReading(). Implementations that can only block complete the work
+ * inside the request call. The base class keeps the list of devices found
+ * on the bus and which of them have been assigned to a channel.
+ */
+class TemperatureBus {
+public:
+    static constexpr size_t MAX_DEVICES = 8;
+    
+    TemperatureBus();
+    virtual ~TemperatureBus() = default;
+    
+    /**
+     * @brief Configure the transport and discover the devices on the bus
+     */
+    virtual bool begin() = 0;
+    
+    /**
+     * @brief Start a temperature conversion on every device at once
+     * @return false if the request could not be queued
+     */
+    virtual bool startConversion() = 0;
+    
+    /**
+     * @brief Queue a scratchpad read of one device
+     * @param tag Returned with the reading to identify it
+     * @return false if the request could not be queued
+     */
+    virtual bool requestRead(const OneWireAddress& address, uint8_t tag) = 0;
+    
+    /**
+     * @brief Advance transfers in flight; never blocks
+     */
+    virtual void service() = 0;
+    
+    /**
+     * @brief True when no request is queued or in flight
+     */
+    virtual bool isIdle() const = 0;
+    
+    /**
+     * @brief Pop the oldest completed reading
+     * @return false if none is waiting
+     */
+    bool takeReading(TemperatureReading* reading);
+    
+    /**
+     * @brief Assign the first discovered device not yet in use
+     * @return false if every device is already assigned
+     */
+    bool claimNextAddress(OneWireAddress* address);
+    
+    /**
+     * @brief Mark a configured device as in use
+     * @return false if it was not found on the bus
+     */
+    bool registerAddress(const OneWireAddress& address);
+    
+    size_t getDeviceCount() const { return device_count_; }
+    const OneWireAddress& getDeviceAddress(size_t index) const {
+        return devices_[index];
+    }
+    
+    /**
+     * @brief Pass raw reads to an observer as well; nullptr to stop
+     */
+    void setObserver(ScratchpadObserver* observer) { observer_ = observer; }
+
+protected:
+    /**
+     * @brief Record a device found during discovery
+     */
+    bool addDevice(const OneWireAddress& address);
+    
+    /**
+     * @brief Queue a read that failed before a scratchpad arrived
+     */
+    bool pushReading(const TemperatureReading& reading);
+    
+    /**
+     * @brief Decode a scratchpad and queue the reading
+     */
+    bool pushScratchpad(uint8_t tag, const uint8_t* scratchpad);
+
+private:
+    bool queueReading(const TemperatureReading& reading);
+    
+    ScratchpadObserver* observer_;
+    static constexpr size_t MAX_READINGS = 2 * MAX_DEVICES;
+    
+    OneWireAddress devices_[MAX_DEVICES];
+    bool claimed_[MAX_DEVICES];
+    size_t device_count_;
+    
+    TemperatureReading readings_[MAX_READINGS];
+    size_t reading_head_;
+    size_t reading_count_;
+};
+
+/**
+ * @brief Check and convert a DS18B20 scratchpad
+ * @param scratchpad The 9 bytes as read, including the CRC
+ * @param celsius Set to the temperature when OK is returned
+ * @return OK, CRC_ERROR, or BUS_ERROR for a floating or shorted line
+ */
+TemperatureReadStatus decodeDs18b20Scratchpad(const uint8_t* scratchpad,
+                                              float* celsius);
+
+} // namespace BoatEngine
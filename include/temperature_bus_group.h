@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "temperature_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Several temperature buses acquired as one
+ *
+ * Conversions start on every bus at once and each bus works through its
+ * own read queue, so with asynchronous transports the buses transfer in
+ * parallel and a cycle takes about as long as the busiest bus rather than
+ * the sum of all of them. Reads are tagged by the caller; the tag comes
+ * back with the reading whichever bus it was on.
+ */
+class TemperatureBusGroup {
+public:
+    static constexpr size_t MAX_BUSES = 4;
+    
+    TemperatureBusGroup();
+    
+    /**
+     * @brief Add a bus that has already been begun
+     * @return Index of the bus, or -1 if the group is full
+     */
+    int addBus(TemperatureBus* bus);
+    
+    size_t getBusCount() const { return bus_count_; }
+    TemperatureBus* getBus(size_t index) const {
+        return index < bus_count_ ? buses_[index] : nullptr;
+    }
+    
+    /**
+     * @brief Start a conversion on every bus
+     * @return Number of buses that accepted the request
+     */
+    size_t startConversions();
+    
+    /**
+     * @brief Queue a read on one bus
+     */
+    bool requestRead(size_t bus, const OneWireAddress& address, uint8_t tag);
+    
+    /**
+     * @brief Advance every bus; never blocks
+     */
+    void service();
+    
+    /**
+     * @brief True when every bus is idle
+     */
+    bool isIdle() const;
+    
+    /**
+     * @brief Pop a completed reading from any bus
+     * @param bus Set to the bus it came from
+     */
+    bool takeReading(TemperatureReading* reading, size_t* bus);
+
+private:
+    TemperatureBus* buses_[MAX_BUSES];
+    size_t bus_count_;
+    size_t next_take_;   ///< Round-robin start so no bus starves the others
+};
+
+} // namespace BoatEngine
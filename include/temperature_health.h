@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#include "temperature_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Failure counts for one temperature sensor since boot
+ */
+struct TemperatureHealthCounters {
+    uint32_t reads;          ///< Every reading assessed, retries included
+    uint32_t crc_errors;
+    uint32_t timeouts;
+    uint32_t disconnects;    ///< No presence, or a floating or shorted line
+    uint32_t implausible;    ///< Out of range, or the 85 C power-on value
+    uint32_t dropped;        ///< Requests the bus had no room for
+    uint32_t retries;
+    uint32_t invalid;        ///< Cycles that ended without a usable value
+};
+
+/**
+ * @brief Judges each reading of one sensor and decides how to recover
+ *
+ * A loose probe shows up as a CRC error, a missing presence pulse, the
+ * all-ones scratchpad that DallasTemperature reports as -127 C, or the
+ * 85 C power-on value after a brown-out reset the device mid-conversion.
+ * Each failure is counted and answered with an immediate retry, up to
+ * max_retries per cycle; the power-on value needs a fresh conversion
+ * rather than another read. Once the retries are used up the value is
+ * invalid for the cycle. A reading of exactly 85 C is accepted when the
+ * previous good value was close to it, so a hot engine still reads, or
+ * when it comes back power_on_confirm_reads times in a row: each one asked
+ * for a fresh conversion, so a repeat is a measurement, even at boot.
+ * Hardware independent.
+ */
+class TemperatureHealth {
+public:
+    enum class Verdict : uint8_t {
+        VALID,       ///< Publish the reading
+        RETRY,       ///< Read the scratchpad again now
+        RECONVERT,   ///< Start a conversion, then read again
+        INVALID,     ///< Retries used up; publish no value
+    };
+    
+    struct Limits {
+        float min_c;                ///< Below this the reading is implausible
+        float max_c;                ///< Above this the reading is implausible
+        float power_on_window_c;    ///< 85 C is trusted within this of the last value
+        uint8_t power_on_confirm_reads;   ///< Or after this many 85 C reads in a row
+        uint8_t max_retries;        ///< Per cycle
+    };
+    
+    explicit TemperatureHealth(const Limits& limits);
+    
+    /**
+     * @brief Assess one completed read
+     */
+    Verdict assess(const TemperatureReading& reading);
+    
+    const TemperatureHealthCounters& getCounters() const { return counters_; }
+    
+    /**
+     * @brief True while the last completed cycle gave a usable value
+     */
+    bool isValid() const { return valid_; }
+    
+    /**
+     * @brief Retries taken so far in the current cycle
+     */
+    uint8_t getAttempt() const { return attempt_; }
+
+private:
+    bool isPlausible(float celsius) const;
+    Verdict fail(Verdict retry);
+    
+    Limits limits_;
+    TemperatureHealthCounters counters_;
+    uint8_t attempt_;
+    bool valid_;
+    bool have_last_;
+    float last_c_;
+    uint8_t power_on_reads_;   ///< Consecutive readings of exactly 85 C
+};
+
+} // namespace BoatEngine
@@ -1,7 +1,14 @@
 #pragma once
 
+#include "acquisition_scheduler.h"
+#include "onewire_helper.h"
+#include "sampling_control.h"
 #include "sensor_config.h"
-#include "sensesp_onewire/onewire_temperature.h"
+#include "sensor_recording.h"
+#include "sensor_topology.h"
+#include "sensesp.h"
+#include "temperature_bus.h"
+#include "temperature_bus_group.h"
 
 namespace BoatEngine {
 
@@ -11,23 +18,47 @@ namespace BoatEngine {
  * This class follows the Single Responsibility Principle by handling
  * only temperature sensor setup. It also demonstrates the Open/Closed
  * Principle - you can extend sensor types without modifying this class.
+ *
+ * The manager owns the bus timing: each cycle starts one conversion on
+ * every bus and queues a read of each sensor on its own bus once the
+ * conversion completes, so the sampling period can be changed or suspended
+ * at runtime. Transfers run in the background on asynchronous buses, all
+ * buses at once; a short service timer collects the readings while any
+ * are in flight.
+ *
+ * A failed or implausible reading is retried straight away, within the
+ * same cycle, as each channel's health check asks; the power-on value gets
+ * a fresh conversion on that bus first. Per-sensor health counters are
+ * published to Signal K every ONEWIRE_HEALTH_REPORT_MS.
  */
-class TemperatureSensorManager {
+class TemperatureSensorManager : public SamplingControl {
 public:
+    static constexpr size_t MAX_SENSORS = 8;
+    
     /**
      * @brief Initialize the temperature sensor manager
-     * @param onewire_pin GPIO pin for the OneWire bus
+     * @param scheduler Runs the conversion cycles
      * @param read_delay_ms Read interval in milliseconds
      */
-    TemperatureSensorManager(uint8_t onewire_pin, unsigned int read_delay_ms);
+    TemperatureSensorManager(AcquisitionScheduler* scheduler, unsigned int read_delay_ms);
+    
+    /**
+     * @brief Add a OneWire bus; discovery runs here
+     * 
+     * Buses must be added in ONEWIRE_BUSES order, as sensor definitions
+     * refer to them by index.
+     * @return Index of the bus, or -1 if no more buses fit
+     */
+    int addBus(TemperatureBus* bus);
     
     /**
-     * @brief Set up all configured temperature sensors
+     * @brief Set up the temperature sensors of a topology
      * 
-     * This method iterates through all defined temperature sensors
-     * and initializes them using the helper function.
+     * This method iterates through the topology's temperature sensors,
+     * initializes them using the helper function and starts sampling.
+     * The topology must outlive the manager.
      */
-    void setupSensors();
+    void setupSensors(const SensorTopology& topology);
     
     /**
      * @brief Add a single temperature sensor
@@ -36,14 +67,92 @@ public:
     void addSensor(const BoatSensorConfig::TemperatureSensorDef& config);
     
     /**
-     * @brief Get the Dallas Temperature Sensors instance
-     * @return Pointer to DTS instance (for testing/debugging)
+     * @brief Start periodic conversions
+     */
+    void start();
+    
+    /**
+     * @brief Start one conversion cycle for all sensors
      */
-    sensesp::onewire::DallasTemperatureSensors* getDTS() const { return dts_; }
+    void update();
+    
+    /**
+     * @brief Change the conversion period; 0 suspends bus activity
+     */
+    void setSamplingInterval(unsigned int interval_ms) override;
+    
+    /**
+     * @brief Also record every raw read on every bus; nullptr to stop
+     */
+    void setRecorder(SensorRecorder* recorder);
+    
+    /**
+     * @brief Find a sensor pipeline by its base name
+     * @return The pipeline, or nullptr if no such sensor was added
+     */
+    const OneWireTempChain* findSensor(const char* base_name) const;
+    
+    /**
+     * @brief Get a temperature bus
+     * @return Pointer to the bus, or nullptr (for testing/debugging)
+     */
+    TemperatureBus* getBus(size_t index = 0) const { return buses_.getBus(index); }
+    
+    /**
+     * @brief Duration of the last complete cycle, conversion start to
+     * last reading
+     * @return Cycle time in milliseconds (for testing/debugging)
+     */
+    unsigned long getLastCycleMs() const { return last_cycle_ms_; }
 
 private:
-    sensesp::onewire::DallasTemperatureSensors* dts_;
+    /**
+     * @brief Signal K outputs for one sensor's health counters
+     */
+    struct HealthOutputs {
+        sensesp::SKOutputInt* crc_errors;
+        sensesp::SKOutputInt* timeouts;
+        sensesp::SKOutputInt* disconnects;
+        sensesp::SKOutputInt* implausible;
+        sensesp::SKOutputInt* retries;
+        sensesp::SKOutputInt* dropped;
+        sensesp::SKOutput<String>* status;
+    };
+    
+    static unsigned int cyclePeriod(unsigned int interval_ms);
+    void readAll();
+    void service();
+    void startServicing();
+    void requestRead(size_t sensor);
+    void handleDropped(size_t sensor);
+    void retryAfterConversion(size_t sensor);
+    void readReconverted();
+    void startHealthReports();
+    void reportHealth();
+    
+    TemperatureBusGroup buses_;
     unsigned int read_delay_ms_;
+    AcquisitionScheduler* scheduler_;
+    int task_;   ///< Conversion cycle task, -1 before start()
+    reactesp::RepeatEvent* service_timer_;
+    bool cycle_pending_;   ///< Conversion running, reads not yet queued
+    bool cycle_active_;    ///< Conversion or reads still in flight
+    unsigned long cycle_start_ms_;
+    unsigned long last_cycle_ms_;
+    
+    OneWireTempChain sensors_[MAX_SENSORS];
+    const char* base_names_[MAX_SENSORS];
+    // Definitions written to recordings
+    const char* sk_paths_[MAX_SENSORS];
+    const BoatSensorConfig::CalibrationDef* calibrations_[MAX_SENSORS];
+    uint8_t sensor_bus_[MAX_SENSORS];
+    uint64_t acquired_ms_[MAX_SENSORS];  ///< End of the conversion being read
+    size_t sensor_count_;
+    
+    HealthOutputs health_outputs_[MAX_SENSORS];
+    size_t health_output_count_;
+    uint8_t reconvert_sensors_;   ///< Bit per sensor waiting on a reconversion
+    uint8_t reconvert_buses_;     ///< Bit per bus already reconverting
 };
 
 } // namespace BoatEngine
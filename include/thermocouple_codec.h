@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Thermocouple amplifier chips on the SPI bus
+ */
+enum class ThermocoupleChip : uint8_t {
+    MAX31855,   ///< Fixed type (K for the -K part), read-only 32-bit frame
+    MAX31856,   ///< Any type, register based, converts continuously once set up
+};
+
+/**
+ * @brief Why a conversion has no usable temperature
+ */
+enum class ThermocoupleFault : uint8_t {
+    NONE = 0,
+    OPEN,            ///< Thermocouple open circuit
+    SHORT_TO_GND,
+    SHORT_TO_VCC,
+    OUT_OF_RANGE,    ///< Over/under voltage, or outside the type's range
+    NO_RESPONSE,     ///< MISO stuck high (chip missing), or a MAX31856 not converting
+};
+
+/**
+ * @brief One decoded conversion
+ */
+struct ThermocoupleReading {
+    ThermocoupleFault fault;
+    float hot_c;     ///< Thermocouple junction; NAN when faulted
+    float cold_c;    ///< Chip (cold junction) temperature
+};
+
+/**
+ * @brief SPI transfers and frame layouts of the MAX31855 and MAX31856
+ *
+ * The MAX31855 is read by clocking out 32 bits: a 14-bit signed hot
+ * junction value in 0.25 C steps, a fault flag, a 12-bit signed cold
+ * junction value in 0.0625 C steps and three fault bits. The MAX31856 is
+ * set once to convert continuously and is then read in one transfer from
+ * CJTO: the offset (ignored, it pads the transfer to 8 bytes, whole DMA
+ * words), cold junction (14 bits, 0.015625 C), linearised hot junction
+ * (19 bits, 0.0078125 C) and the fault status register. The encoders build the
+ * same frames from temperatures, for simulated devices.
+ */
+class ThermocoupleCodec {
+public:
+    static constexpr size_t MAX_FRAME = 8;
+    
+    static constexpr uint8_t MAX31856_CR0 = 0x00;
+    static constexpr uint8_t MAX31856_CJTO = 0x09;
+    static constexpr uint8_t MAX31856_WRITE = 0x80;
+    static constexpr uint8_t MAX31856_AUTO_CONVERT = 0x80;   ///< CR0.CMODE
+    static constexpr uint8_t MAX31856_OPEN_DETECT = 0x10;    ///< CR0.OCFAULT = 01
+    static constexpr uint8_t MAX31856_TYPE_K = 3;            ///< CR1.TC_TYPE
+    
+    /**
+     * @brief Bytes in one read transfer, address byte included
+     */
+    static size_t readLength(ThermocoupleChip chip);
+    
+    /**
+     * @brief Fill the bytes to send for a read
+     * @param tx At least readLength(chip) bytes
+     */
+    static void prepareRead(ThermocoupleChip chip, uint8_t* tx);
+    
+    /**
+     * @brief Build the one-time setup write; empty for the MAX31855
+     * @param tc_type MAX31856 CR1.TC_TYPE code, e.g. MAX31856_TYPE_K
+     * @param tx At least MAX_FRAME bytes
+     * @return Bytes to send, 0 when nothing needs setting up
+     */
+    static size_t prepareSetup(ThermocoupleChip chip, uint8_t tc_type, uint8_t* tx);
+    
+    /**
+     * @brief Decode the bytes received during a read
+     */
+    static ThermocoupleReading decode(ThermocoupleChip chip, const uint8_t* rx);
+    
+    /**
+     * @brief Build the bytes a healthy or faulted chip would return
+     * @param rx At least readLength(chip) bytes
+     */
+    static void encode(ThermocoupleChip chip, const ThermocoupleReading& reading,
+                       uint8_t* rx);
+    
+    static const char* faultName(ThermocoupleFault fault);
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "spi_device_bus.h"
+#include "thermocouple_codec.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Reads a set of thermocouple amplifiers in one batch of SPI transfers
+ *
+ * Each scan queues a read of every chip back to back; the transfers run
+ * under DMA while the caller carries on, and takeResult() hands back each
+ * decoded conversion as it finishes. A chip whose previous read has not
+ * finished is skipped for that scan and counted as missed. MAX31856 chips
+ * are set to convert continuously before their first read, and set up
+ * again if they stop answering, e.g. after a brown-out. Hardware
+ * independent.
+ */
+class ThermocoupleScanner {
+public:
+    static constexpr size_t MAX_SENSORS = 8;
+    static constexpr uint32_t CLOCK_HZ = 4000000;   ///< Both chips allow 5 MHz
+    static constexpr uint8_t SETUP_AFTER_FAULTS = 10;   ///< No-response reads before set up again
+    
+    struct Result {
+        uint8_t index;    ///< As returned by addSensor()
+        ThermocoupleReading reading;
+    };
+    
+    struct Counters {
+        uint32_t reads;
+        uint32_t faults;   ///< Reads without a usable temperature
+        uint32_t missed;   ///< Scans that found the previous read unfinished
+    };
+    
+    explicit ThermocoupleScanner(SpiDeviceBus* bus);
+    ~ThermocoupleScanner();
+    
+    ThermocoupleScanner(const ThermocoupleScanner&) = delete;
+    ThermocoupleScanner& operator=(const ThermocoupleScanner&) = delete;
+    
+    /**
+     * @brief Attach a chip on its chip select
+     * @param tc_type MAX31856 thermocouple type code; ignored by the MAX31855
+     * @return Sensor index, or -1 if it could not be added
+     */
+    int addSensor(ThermocoupleChip chip, uint8_t cs_pin, uint8_t tc_type);
+    
+    size_t getSensorCount() const { return sensor_count_; }
+    
+    /**
+     * @brief Queue a read of every sensor that is not still busy
+     * @return Number of reads queued
+     */
+    size_t startScan();
+    
+    /**
+     * @brief Take the next finished read; never blocks
+     * @return false when none is ready
+     */
+    bool takeResult(Result* result);
+    
+    /**
+     * @brief True while any transfer is queued or running
+     */
+    bool isBusy() const { return in_flight_ > 0; }
+    
+    ThermocoupleFault getFault(size_t index) const;
+    const Counters& getCounters(size_t index) const { return sensors_[index].counters; }
+
+private:
+    struct Sensor {
+        ThermocoupleChip chip;
+        uint8_t tc_type;
+        int device;
+        bool needs_setup;
+        bool setup_busy;
+        bool read_busy;
+        uint8_t no_response;   ///< Consecutive no-response reads
+        ThermocoupleFault fault;
+        Counters counters;
+        // MAX_FRAME bytes each, in buffers_
+        uint8_t* setup_tx;
+        uint8_t* setup_rx;
+        uint8_t* read_tx;
+        uint8_t* read_rx;
+    };
+    
+    static constexpr size_t BUFFERS_PER_SENSOR = 4;
+    
+    Sensor* findSensor(int device);
+    
+    SpiDeviceBus* bus_;
+    uint8_t* buffers_;   ///< From the bus, so DMA reaches them without a bounce buffer
+    Sensor sensors_[MAX_SENSORS];
+    size_t sensor_count_;
+    size_t in_flight_;
+};
+
+} // namespace BoatEngine
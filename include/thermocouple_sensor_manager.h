@@ -0,0 +1,87 @@
+#pragma once
+
+#include "acquisition_scheduler.h"
+#include "acquisition_time.h"
+#include "sensor_config.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/observablevalue.h"
+#include "sensesp/transforms/transform.h"
+#include "spi_device_bus.h"
+#include "thermocouple_scanner.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Manages the MAX31855/MAX31856 thermocouple amplifiers
+ *
+ * Modelled on AnalogSensorManager. Every read interval one scan queues a
+ * read of every chip on the SPI bus and returns; a short delay later the
+ * finished transfers are decoded and emitted, in kelvin, into the usual
+ * calibration -> SKOutputFloat chain, stamped with the time of the scan.
+ * A faulted thermocouple emits NaN, and its status (ok, open,
+ * shortToGround, ...) and fault count are published under
+ * THERMOCOUPLE_HEALTH_SK_PREFIX whenever the status changes.
+ */
+class ThermocoupleSensorManager {
+public:
+    static constexpr size_t MAX_SENSORS = ThermocoupleScanner::MAX_SENSORS;
+    
+    /**
+     * @param bus SPI bus the chips are on, already started
+     * @param scheduler Runs the periodic scans
+     * @param read_delay_ms Scan interval; the chips convert about every 100 ms
+     */
+    ThermocoupleSensorManager(SpiDeviceBus* bus, AcquisitionScheduler* scheduler,
+                              unsigned int read_delay_ms);
+    
+    /**
+     * @brief Set up all configured thermocouples and start scanning
+     */
+    void setupSensors();
+    
+    /**
+     * @brief Add a single thermocouple
+     * @return false if the chip could not be added to the bus
+     */
+    bool addSensor(const BoatSensorConfig::ThermocoupleSensorDef& config);
+    
+    /**
+     * @brief Start the periodic scan
+     */
+    bool start();
+    
+    /**
+     * @brief Get a sensor's calibrated output by base name, or nullptr
+     */
+    sensesp::FloatTransform* findSensor(const char* base_name) const;
+    
+    /**
+     * @brief Get the scanner (for testing/debugging)
+     */
+    const ThermocoupleScanner& getScanner() const { return scanner_; }
+
+private:
+    struct Channel {
+        const char* base_name;
+        sensesp::ObservableValue<float>* kelvin;
+        sensesp::FloatTransform* calibration;
+        sensesp::SKOutput<String>* status;
+        sensesp::SKOutputInt* faults;
+        ThermocoupleFault reported;
+        bool status_sent;
+    };
+    
+    void scan();
+    void collect();
+    
+    ThermocoupleScanner scanner_;
+    AcquisitionScheduler* scheduler_;
+    unsigned int read_delay_ms_;
+    AcquisitionStamp stamp_;   ///< Time of the scan being collected
+    
+    Channel channels_[MAX_SENSORS];
+    size_t channel_count_;
+};
+
+} // namespace BoatEngine
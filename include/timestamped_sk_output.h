@@ -0,0 +1,63 @@
+#pragma once
+
+#include "acquisition_time.h"
+#include "sensesp/transforms/transform.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Current monotonic time, for AcquisitionStamp::mark()
+ */
+uint64_t acquisitionNowMs();
+
+/**
+ * @brief Float Signal K output whose delta carries the acquisition time
+ *
+ * SKOutputFloat sends values without a timestamp, so the server stamps
+ * them on arrival: a temperature can then be a full conversion plus a tick
+ * late. This output reads the stamp its source marked before emitting and,
+ * once SNTP has set the wall clock, sends the value in an update whose
+ * timestamp is that acquisition time; until then the update has no
+ * timestamp and the server stamps it as before.
+ *
+ * It is not an SKEmitter, so every value takes this one path, under the
+ * same source label as SensESP's own deltas, and never shows up under a
+ * second source through the SensESP delta queue. Values are still emitted
+ * to anything connected downstream. The latest value of every timestamped
+ * output set during one event loop tick goes out in a single delta, with
+ * one update per distinct timestamp. While the websocket is down each
+ * output keeps its latest value, which is sent once it is back. The Signal
+ * K path is editable in the web configuration under the same key as
+ * SKOutput's, so saved paths carry over.
+ */
+class TimestampedSKOutputFloat : public sensesp::FloatTransform {
+public:
+    /**
+     * @param sk_path Default Signal K path
+     * @param config_path Configuration path for the Signal K path
+     * @param stamp Marked by the pipeline's source before each emit
+     */
+    TimestampedSKOutputFloat(const String& sk_path, const String& config_path,
+                             const AcquisitionStamp* stamp);
+    
+    void set(const float& value) override;
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& config) override;
+    
+    const String& get_sk_path() const { return sk_path_; }
+
+private:
+    friend class TimestampedDeltaBatch;
+    
+    String sk_path_;
+    const AcquisitionStamp* stamp_;
+    
+    // Latest value not sent yet, for TimestampedDeltaBatch
+    float pending_value_;
+    int64_t pending_epoch_ms_;   ///< -1: no timestamp
+    bool pending_;
+};
+
+const String ConfigSchema(const TimestampedSKOutputFloat& obj);
+
+} // namespace BoatEngine
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Double-buffered tooth intervals, written by an edge ISR
+ *
+ * The ISR stamps every edge and stores the interval since the previous one
+ * in the active buffer. When that fills, it is handed over and the ISR
+ * moves to the other buffer, so the consumer always reads a complete,
+ * contiguous run of BUFFER_SIZE intervals without a critical section.
+ * If the consumer still holds the other buffer when the active one fills,
+ * the active buffer is discarded and refilled and the overrun count goes
+ * up; the intervals either side of an overrun are not contiguous.
+ */
+class ToothIntervalRing {
+public:
+    static constexpr size_t BUFFER_SIZE = 256;
+    
+    ToothIntervalRing();
+    
+    /**
+     * @brief Record an edge (ISR side)
+     *
+     * Always inlined, so that it lands in the calling ISR's IRAM. The first
+     * edge after a stop gives one long interval; CylinderBalance resyncs
+     * on it.
+     * @param now_us Free-running microsecond clock, wraps at 2^32
+     */
+    inline __attribute__((always_inline)) void recordEdge(uint32_t now_us) {
+        if (!has_last_) {
+            has_last_ = true;
+            last_us_ = now_us;
+            return;
+        }
+        const uint8_t active = active_;
+        buffers_[active][fill_++] = now_us - last_us_;
+        last_us_ = now_us;
+        if (fill_ < BUFFER_SIZE) {
+            return;
+        }
+        fill_ = 0;
+        if (full_[active ^ 1]) {
+            overruns_ = overruns_ + 1;
+            return;
+        }
+        full_[active] = true;
+        active_ = active ^ 1;
+    }
+    
+    /**
+     * @brief Take the filled buffer, if there is one (consumer side)
+     * @return BUFFER_SIZE intervals in microseconds, valid until release(),
+     *         or nullptr if nothing is waiting
+     */
+    const uint32_t* takeFull() const;
+    
+    /**
+     * @brief Give back the buffer from takeFull()
+     */
+    void release();
+    
+    /**
+     * @brief Buffers discarded because the consumer was too slow
+     */
+    uint32_t getOverruns() const { return overruns_; }
+
+private:
+    uint32_t buffers_[2][BUFFER_SIZE];
+    volatile bool full_[2];
+    volatile uint8_t active_;
+    volatile uint32_t overruns_;
+    
+    // ISR only
+    size_t fill_;
+    uint32_t last_us_;
+    bool has_last_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoatEngine {
+
+/**
+ * @brief Least-squares slope over a sliding time window, O(1) per sample
+ *
+ * Keeps the running sums n, St, Sy, Stt and Sty of the samples in the
+ * window: adding a sample adds its terms, expiring one subtracts them, so
+ * neither walks the window. Times are kept relative to a base that moves
+ * forward with the window (the sums are shifted when it does), so the
+ * double sums stay accurate over months of uptime. Samples older than
+ * window_ms, or beyond MAX_SAMPLES, expire, so a window longer than
+ * maxWindowMs() of the sample period is cut short. Hardware independent;
+ * the caller supplies timestamps.
+ */
+class TrendEstimator {
+public:
+    static constexpr size_t MAX_SAMPLES = 64;
+    
+    explicit TrendEstimator(uint32_t window_ms);
+    
+    /**
+     * @brief Longest window that MAX_SAMPLES cover at this sample period
+     */
+    static constexpr uint32_t maxWindowMs(uint32_t sample_period_ms) {
+        return (MAX_SAMPLES - 1) * sample_period_ms;
+    }
+    
+    void setWindow(uint32_t window_ms) { window_ms_ = window_ms; }
+    uint32_t getWindow() const { return window_ms_; }
+    
+    /**
+     * @brief Add a sample; NaN is ignored
+     * @param time_ms Sample time, not earlier than the previous one (wraps
+     * at 2^32 like millis())
+     */
+    void add(float value, uint32_t time_ms);
+    
+    /**
+     * @brief Forget all samples
+     */
+    void reset();
+    
+    size_t getCount() const { return count_; }
+    
+    /**
+     * @brief Time spanned by the samples in the window
+     */
+    uint32_t getSpanMs() const;
+    
+    /**
+     * @brief Fitted slope in value units per second
+     * @return false with fewer than two samples or no time spread
+     */
+    bool getSlope(float* per_second) const;
+    
+    /**
+     * @brief Fitted line's value at the newest sample, smoother than the
+     * raw value
+     * @return false when getSlope() would
+     */
+    bool getFittedLatest(float* value) const;
+
+private:
+    struct Sample {
+        uint32_t time_ms;
+        float value;
+    };
+    
+    void expire(uint32_t now_ms);
+    void removeOldest();
+    void rebase(uint32_t base_ms);
+    bool fit(double* slope, double* intercept) const;
+    
+    uint32_t window_ms_;
+    Sample samples_[MAX_SAMPLES];
+    size_t head_;     ///< Oldest sample
+    size_t count_;
+    
+    uint32_t base_ms_;   ///< Time the sums' t is measured from
+    double sum_t_;       ///< Seconds since base_ms_
+    double sum_y_;
+    double sum_tt_;
+    double sum_ty_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "accelerometer.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Vibration level and dominant frequency from accelerometer samples
+ *
+ * Samples are collected into windows of WINDOW consecutive samples. Each
+ * full window has its per-axis mean (gravity and offset) removed, adds
+ * its mean square to the RMS, and is Hann-windowed and transformed with a
+ * radix-2 FFT per axis, the three power spectra being summed into a
+ * running average (Welch's method). takeResult() reports the averages
+ * since the last call: the RMS of the vector acceleration, and the
+ * strongest spectral peak above MIN_PEAK_HZ with its frequency refined
+ * between bins, also as an engine order (peak / revolutions per second)
+ * against the mean RPM given during those windows. A gap in the samples
+ * must be reported with resync(), which discards the partial window.
+ * Memory is fixed: about 12 KB.
+ */
+class VibrationAnalyser {
+public:
+    static constexpr size_t WINDOW = 512;   ///< Power of two
+    static constexpr float MIN_PEAK_HZ = 3.0f;
+    
+    struct Result {
+        float rms_g;
+        float peak_hz;
+        float order;      ///< peak_hz per engine revolution/s; NAN when stopped
+        float rpm;        ///< Mean over the windows; 0 when unknown
+        uint32_t windows;
+    };
+    
+    /**
+     * @param sample_rate_hz Rate of the samples passed to add()
+     */
+    explicit VibrationAnalyser(float sample_rate_hz);
+    
+    /**
+     * @brief Correct the sample rate, e.g. to the measured one
+     */
+    void setSampleRate(float sample_rate_hz) { sample_rate_hz_ = sample_rate_hz; }
+    
+    /**
+     * @brief Engine speed while the following samples were taken
+     */
+    void setRpm(float rpm) { rpm_ = rpm; }
+    
+    /**
+     * @brief Add consecutive samples, analysing each window as it fills
+     * @param g_per_count Scale of the samples
+     */
+    void add(const AccelSample* samples, size_t count, float g_per_count);
+    
+    /**
+     * @brief Samples before the next one are missing: restart the window
+     */
+    void resync();
+    
+    /**
+     * @brief Take the averages since the last call and start new ones
+     * @return false if no window completed since then
+     */
+    bool takeResult(Result* result);
+    
+    /**
+     * @brief Get the windows analysed since boot (for testing/debugging)
+     */
+    uint32_t getWindowCount() const { return total_windows_; }
+    
+    /**
+     * @brief Get the partial windows discarded by resync() (for testing/debugging)
+     */
+    uint32_t getResyncCount() const { return resyncs_; }
+
+private:
+    static constexpr size_t BINS = WINDOW / 2 + 1;
+    
+    void analyseWindow();
+    void transform(float* re, float* im) const;
+    
+    float sample_rate_hz_;
+    float rpm_;
+    float g_per_count_;
+    
+    int16_t samples_[3][WINDOW];
+    size_t fill_;
+    
+    // Work buffers and tables, sized once
+    float re_[WINDOW];
+    float im_[WINDOW];
+    float hann_[WINDOW];
+    float cos_[WINDOW / 2];
+    float sin_[WINDOW / 2];
+    
+    // Averages since the last result
+    float power_[BINS];
+    double sum_square_g_;
+    double rpm_sum_;
+    uint32_t windows_;
+    
+    uint32_t total_windows_;
+    uint32_t resyncs_;
+};
+
+} // namespace BoatEngine
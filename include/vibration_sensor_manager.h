@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "accelerometer.h"
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/system/valueproducer.h"
+#include "vibration_analyser.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief Engine-mount vibration from an accelerometer's FIFO
+ *
+ * Modelled on RPMSensorManager, but the samples never reach the event
+ * loop: a task on core 0 drains the accelerometer's hardware FIFO in
+ * bursts every VIBRATION_DRAIN_MS and feeds a VibrationAnalyser, which
+ * runs its FFTs in the same task as windows fill. Every
+ * VIBRATION_REPORT_MS the task hands over the averaged result, tagged
+ * with the engine speed from the RPM chain, and the event loop publishes
+ * <prefix>rms (m/s2), <prefix>dominantFrequency (Hz) and
+ * <prefix>dominantOrder (peak per revolution: 1 for imbalance, 2 for
+ * misalignment, the firing order for mounts). The analyser's sample rate
+ * is corrected to the rate measured over each report.
+ */
+class VibrationSensorManager {
+public:
+    /**
+     * @param accelerometer Chip on its bus, not yet started
+     */
+    explicit VibrationSensorManager(Accelerometer* accelerometer);
+    
+    /**
+     * @brief Start the accelerometer, the drain task and publishing
+     * @param revolutions Engine speed in revolutions per second
+     * @return false if the accelerometer does not answer
+     */
+    bool start(sensesp::ValueProducer<float>* revolutions);
+    
+    /**
+     * @brief Get the analyser (for testing/debugging)
+     */
+    const VibrationAnalyser& getAnalyser() const { return analyser_; }
+
+private:
+    static void drainTask(void* arg);
+    void drain();
+    void handOver(uint32_t now_ms);
+    void publish();
+    
+    Accelerometer* accelerometer_;
+    std::atomic<float> revolutions_;
+    
+    // Drain task only
+    VibrationAnalyser analyser_;
+    uint32_t overruns_;
+    uint32_t report_samples_;
+    uint32_t report_start_ms_;
+    
+    SemaphoreHandle_t result_lock_;
+    VibrationAnalyser::Result result_;   ///< Guarded by result_lock_
+    uint32_t result_overruns_;           ///< Guarded by result_lock_
+    bool has_result_;                    ///< Guarded by result_lock_
+    
+    sensesp::SKOutputFloat* rms_output_;
+    sensesp::SKOutputFloat* frequency_output_;
+    sensesp::SKOutputFloat* order_output_;
+};
+
+} // namespace BoatEngine
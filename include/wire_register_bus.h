@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Wire.h>
+
+#include "register_bus.h"
+
+namespace BoatEngine {
+
+/**
+ * @brief RegisterBus on an Arduino TwoWire (I2C) port
+ *
+ * A register read is a write of the register address followed by a
+ * repeated start and the read, so no other master can slip in between.
+ * Reads are limited by the core's I2C buffer (128 bytes).
+ */
+class WireRegisterBus : public RegisterBus {
+public:
+    /**
+     * @param wire Port, already started with begin()
+     * @param address 7-bit device address
+     */
+    WireRegisterBus(TwoWire* wire, uint8_t address);
+
+    bool writeRegister(uint8_t reg, uint8_t value) override;
+    bool readRegisters(uint8_t reg, uint8_t* data, size_t length) override;
+
+private:
+    TwoWire* wire_;
+    uint8_t address_;
+};
+
+} // namespace BoatEngine
@@ -0,0 +1,104 @@
+"""Print a deferred log dump from the device as text.
+
+    curl http://<device-ip>/api/log -o log.bin
+    python scripts/deferred_log_decode.py log.bin
+
+The dump is the wire form written by DeferredLog: a header ("BELG", the
+version and the number of records dropped since boot) followed by the
+records, each a timestamp, an event and its 32-bit arguments, all little
+endian. The message formats are read from src/log_events.cpp, so the
+script always matches the firmware built from the same tree, and the text
+is the same as DeferredLog::format prints on the device.
+"""
+
+import os
+import re
+import struct
+import sys
+
+MAGIC = b"BELG"
+VERSION = 1
+HEADER = struct.Struct("<4sBI")
+RECORD = struct.Struct("<IHB")
+MAX_ARGS = 4
+
+EVENTS_SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             os.pardir, "src", "log_events.cpp")
+
+FORMAT_TABLE = re.compile(r"LOG_EVENT_FORMATS\[\]\s*=\s*\{(.*?)\};", re.S)
+STRING = re.compile(r'"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r"%%|%([-+ #0-9.]*)([diuxXcfeEgG])?")
+
+
+def read_formats(path):
+    """Load the format of each event, in LogEvent order."""
+    with open(path) as source:
+        table = FORMAT_TABLE.search(source.read())
+    if table is None:
+        raise ValueError("no LOG_EVENT_FORMATS in %s" % path)
+    return [text.encode().decode("unicode_escape")
+            for text in STRING.findall(table.group(1))]
+
+
+def format_record(formats, time_us, event, args):
+    """Render one record the way DeferredLog::format does."""
+    prefix = "[%4u.%06u] " % (time_us // 1000000, time_us % 1000000)
+    if event >= len(formats):
+        return (prefix + "Unknown event %u" % event +
+                "".join(" %08x" % word for word in args))
+
+    remaining = list(args)
+
+    def convert(match):
+        if match.group(0) == "%%":
+            return "%"
+        if match.group(2) is None:
+            # Not one we can print; show it as written
+            return match.group(0)
+        if not remaining:
+            return "?"
+        word = remaining.pop(0)
+        spec = "%" + match.group(1) + match.group(2)
+        if match.group(2) in "di":
+            return spec % struct.unpack("<i", struct.pack("<I", word))[0]
+        if match.group(2) in "feEgG":
+            return spec % struct.unpack("<f", struct.pack("<I", word))[0]
+        if match.group(2) == "c":
+            return spec % chr(word & 0xff)
+        return spec % word
+
+    return prefix + CONVERSION.sub(convert, formats[event])
+
+
+def decode(data, formats):
+    """Print every record in a dump; returns the exit status."""
+    if len(data) < HEADER.size:
+        print("not a deferred log dump: too short")
+        return 1
+    magic, version, dropped = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        print("not a deferred log dump (version %u expected)" % VERSION)
+        return 1
+    print("%u records dropped since boot" % dropped)
+
+    offset = HEADER.size
+    while offset + RECORD.size <= len(data):
+        time_us, event, count = RECORD.unpack_from(data, offset)
+        length = RECORD.size + count * 4
+        if count > MAX_ARGS or offset + length > len(data):
+            break
+        args = struct.unpack_from("<%uI" % count, data, offset + RECORD.size)
+        print(format_record(formats, time_us, event, args))
+        offset += length
+    if offset != len(data):
+        print("%u bytes at the end could not be decoded" % (len(data) - offset))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("usage: deferred_log_decode.py <log.bin>")
+        sys.exit(2)
+    with open(sys.argv[1], "rb") as dump:
+        sys.exit(decode(dump.read(), read_formats(EVENTS_SOURCE)))
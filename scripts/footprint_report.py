@@ -0,0 +1,179 @@
+"""Static RAM and flash footprint per module, from the linker map.
+
+Runs after every firmware link as a PlatformIO post script, and on demand:
+
+    pio run -t footprint
+    python scripts/footprint_report.py .pio/build/<env>/firmware.map
+
+Project sources are reported per file (rpm_sensor_manager, onewire_helper,
+...), libraries by name (SensESP, ArduinoJson, ...) and the framework in a
+few groups (WiFi, lwIP, Arduino core, ...). DRAM is static data and bss,
+IRAM is code and data placed in instruction RAM; flash counts everything
+stored in the image, including the initial values of DRAM data and IRAM
+code. Heap and stacks are not included: see the memory telemetry
+(sensors.engineController.memory.*) for those at runtime.
+
+The table is printed and also written as CSV next to the map file.
+"""
+
+import csv
+import os
+import re
+import sys
+
+# Output section -> (DRAM, IRAM, flash code, flash data) it counts towards
+SECTIONS = {
+    ".dram0.data": (True, False, False, True),
+    ".dram0.bss": (True, False, False, False),
+    ".noinit": (True, False, False, False),
+    ".iram0.vectors": (False, True, True, False),
+    ".iram0.text": (False, True, True, False),
+    ".iram0.data": (False, True, False, True),
+    ".iram0.bss": (False, True, False, False),
+    ".flash.text": (False, False, True, False),
+    ".flash.rodata": (False, False, False, True),
+    ".flash.appdesc": (False, False, False, True),
+    ".rtc.text": (False, False, True, False),
+    ".rtc.data": (False, False, False, True),
+}
+
+# Framework archives, grouped by subsystem
+GROUPS = {
+    "WiFi": {"net80211", "pp", "wpa_supplicant", "esp_wifi", "phy", "coexist",
+             "core", "espnow", "mesh", "smartconfig", "rtc", "wapi"},
+    "lwIP": {"lwip", "esp_netif", "tcpip_adapter", "dhcpserver"},
+    "mbedTLS": {"mbedtls", "mbedcrypto", "mbedx509", "esp-tls"},
+    "Bluetooth": {"bt", "btdm_app"},
+    "FreeRTOS": {"freertos"},
+    "Arduino core": {"FrameworkArduino"},
+    "C/C++ runtime": {"c", "m", "gcc", "stdc++", "c_nano", "g", "newlib",
+                      "cxx", "supc++"},
+}
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+)(?:\s+0x[0-9a-f]+\s+0x[0-9a-f]+)?\s*$")
+INPUT_SECTION = re.compile(r"^ (\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+))?$")
+WRAPPED_INPUT = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$")
+ARCHIVE_MEMBER = re.compile(r"^(.*?)([^/\\]+)\.a\((.+)\)$")
+
+
+def module_of(path):
+    """Name the module an input file belongs to."""
+    path = path.strip()
+    member = ARCHIVE_MEMBER.match(path)
+    if member:
+        directory, archive = member.group(1), member.group(2)
+        name = archive[3:] if archive.startswith("lib") else archive
+        for group, archives in GROUPS.items():
+            if name in archives:
+                return group
+        if "framework-" in directory or "toolchain-" in directory:
+            return "ESP-IDF"
+        return name
+    base = os.path.basename(path.replace("\\", "/"))
+    for suffix in (".cpp.o", ".c.o", ".S.o", ".o"):
+        if base.endswith(suffix):
+            return base[: -len(suffix)]
+    return "other"
+
+
+def parse_map(lines):
+    """Sum input section sizes per module: {module: [dram, iram, code, data]}."""
+    totals = {}
+    in_memory_map = False
+    current = None
+    pending_name = None
+
+    def add(size, path):
+        if current not in SECTIONS or size == 0:
+            return
+        row = totals.setdefault(module_of(path), [0, 0, 0, 0])
+        for column, counts in enumerate(SECTIONS[current]):
+            if counts:
+                row[column] += size
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if not in_memory_map:
+            in_memory_map = line.startswith("Linker script and memory map")
+            continue
+        if not line.strip():
+            continue
+        if not line[0].isspace():
+            output = OUTPUT_SECTION.match(line)
+            current = output.group(1) if output else None
+            pending_name = None
+            continue
+        if pending_name is not None:
+            wrapped = WRAPPED_INPUT.match(line)
+            pending_name = None
+            if wrapped:
+                add(int(wrapped.group(2), 16), wrapped.group(3))
+                continue
+        entry = INPUT_SECTION.match(line)
+        if not entry or entry.group(1) == "*fill*" or entry.group(1).startswith("*"):
+            continue
+        if entry.group(2) is None:
+            pending_name = entry.group(1)   # Address, size and file follow
+        else:
+            add(int(entry.group(3), 16), entry.group(4))
+    return totals
+
+
+def format_report(totals):
+    header = ("Module", "DRAM", "IRAM", "Flash code", "Flash data", "Flash total")
+    rows = []
+    for module, (dram, iram, code, data) in totals.items():
+        rows.append((module, dram, iram, code, data, code + data))
+    rows.sort(key=lambda row: (row[5] + row[1], row[0]), reverse=True)
+    total = ["Total"] + [sum(row[i] for row in rows) for i in range(1, 6)]
+
+    width = max([len(header[0])] + [len(row[0]) for row in rows])
+    line = "{:<%d} {:>8} {:>8} {:>11} {:>11} {:>12}" % width
+    text = [line.format(*header)]
+    for row in rows + [total]:
+        text.append(line.format(*row))
+    return "\n".join(text), [header] + rows + [total]
+
+
+def write_report(map_path):
+    with open(map_path, encoding="utf-8", errors="replace") as map_file:
+        totals = parse_map(map_file)
+    if not totals:
+        print("footprint: no sections found in %s" % map_path)
+        return 1
+    text, rows = format_report(totals)
+    print("Static footprint per module (bytes):")
+    print(text)
+    csv_path = os.path.splitext(map_path)[0] + "_footprint.csv"
+    with open(csv_path, "w", newline="") as csv_file:
+        csv.writer(csv_file).writerows(rows)
+    print("Written to %s" % csv_path)
+    return 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("usage: footprint_report.py <firmware.map>")
+        sys.exit(2)
+    sys.exit(write_report(sys.argv[1]))
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+except NameError:
+    env = None
+
+if env is not None:
+    MAP_PATH = env.subst("$BUILD_DIR/${PROGNAME}.map")
+    env.Append(LINKFLAGS=["-Wl,-Map," + MAP_PATH])
+
+    def report_action(*args, **kwargs):
+        write_report(MAP_PATH)
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report_action)
+    env.AddCustomTarget(
+        name="footprint",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=report_action,
+        title="Footprint",
+        description="Static RAM and flash per module",
+    )
@@ -2,6 +2,29 @@
 #include "sensor_config.h"
 #include "temperature_sensor_manager.h"
 #include "rpm_sensor_manager.h"
+#include "acquisition_scheduler.h"
+#include "analog_sensor_manager.h"
+#include "cylinder_balance_manager.h"
+#include "dallas_temperature_bus.h"
+#include "deferred_log_manager.h"
+#include "ds18b20_bus.h"
+#include "esp32_continuous_adc_source.h"
+#include "esp32_spi_device_bus.h"
+#include "interrupt_latency_monitor.h"
+#include "lis3dh_accelerometer.h"
+#include "live_gauge_server.h"
+#include "load_profile_manager.h"
+#include "memory_monitor.h"
+#include "overheat_warning_manager.h"
+#include "rmt_onewire_link.h"
+#include "sampling_governor_manager.h"
+#include "sensor_recording_manager.h"
+#include "sensor_topology_manager.h"
+#include "statistics_publisher.h"
+#include "stress_test_manager.h"
+#include "thermocouple_sensor_manager.h"
+#include "vibration_sensor_manager.h"
+#include "wire_register_bus.h"
 
 #include "sensesp_app_builder.h"
 
@@ -9,32 +32,242 @@ using namespace reactesp;
 using namespace sensesp;
 using namespace BoatEngine;
 
+// Adjusts sampling rates to the engine state; also paces loop()
+static SamplingGovernorManager* governor = nullptr;
+
+// Synthetic channel ramp, only when STRESS_TEST_ENABLED
+static StressTestManager* stress = nullptr;
+
 void setup() {
-  SetupLogging();
+  // ESP_LOG output from SensESP and the framework waits for the UART, so
+  // only INFO and above; periodic diagnostics use the deferred log
+  SetupLogging(ESP_LOG_INFO);
 
   // Create the global SensESPApp() object.
   SensESPAppBuilder builder;
   sensesp_app = builder.get_app();
 
+  // UTC wall clock for Signal K delta timestamps, set once WiFi is up
+  configTime(0, 0, BoatSensorConfig::SNTP_SERVER);
+
+  // Measure worst-case interrupt masking on this core before the
+  // drivers start, so boot-time activity is included too
+  if (BoatSensorConfig::LATENCY_PROBE_ENABLED) {
+    auto* latency = new InterruptLatencyMonitor(
+        BoatSensorConfig::LATENCY_PROBE_PERIOD_US);
+    latency->start(BoatSensorConfig::MAX_INTERRUPT_LATENCY_SK_PATH,
+                   BoatSensorConfig::GOVERNOR_REPORT_MS);
+  }
+
+  // Heap and stack headroom, to catch slow leaks before they reboot the
+  // device
+  auto* memory = new MemoryMonitor();
+  memory->start(BoatSensorConfig::MEMORY_SK_PREFIX, BoatSensorConfig::MEMORY_TASKS,
+                BoatSensorConfig::MEMORY_TASK_COUNT, BoatSensorConfig::MEMORY_REPORT_MS);
+
+  // Periodic diagnostics go to the deferred log, printed in idle time
+  auto* deferredLog = new DeferredLogManager();
+  deferredLog->start();
+
+  // Load the sensor topology
+  // Which temperature sensors and pulse channels exist; the built-in set
+  // unless a valid one is saved. The managers below keep pointing into it.
+  auto* topologyManager = new SensorTopologyManager(
+      BoatSensorConfig::TOPOLOGY_CONFIG_PATH
+  );
+  topologyManager->start();
+  const SensorTopology& topology = topologyManager->getTopology();
+
+  // Periodic sensor reads run from one scheduler, each at its own phase
+  auto* scheduler = new AcquisitionScheduler(
+      BoatSensorConfig::SCHEDULER_SLOT_MS,
+      BoatSensorConfig::SCHEDULER_STAGGER
+  );
+
   // Initialize Temperature Sensor Manager
-  // All temperature sensors share the same OneWire bus
-  TemperatureSensorManager tempManager(
-      BoatSensorConfig::ONEWIRE_PIN,
+  // Sensors on one bus convert together; separate buses transfer in parallel
+  auto* tempManager = new TemperatureSensorManager(
+      scheduler,
       BoatSensorConfig::TEMPERATURE_READ_DELAY_MS
   );
-  tempManager.setupSensors();
+  for (size_t i = 0; i < BoatSensorConfig::ONEWIRE_BUS_COUNT; i++) {
+    const BoatSensorConfig::OneWireBusDef& def = BoatSensorConfig::ONEWIRE_BUSES[i];
+    TemperatureBus* tempBus;
+    if (def.transport == BoatSensorConfig::OneWireTransport::RMT) {
+      tempBus = new Ds18b20Bus(new RmtOneWireLink(
+          def.pin,
+          static_cast<rmt_channel_t>(def.rmt_tx_channel),
+          static_cast<rmt_channel_t>(def.rmt_rx_channel)));
+    } else {
+      tempBus = new DallasTemperatureBus(def.pin);
+    }
+    tempManager->addBus(tempBus);
+  }
+  tempManager->setupSensors(topology);
+
+  // Initialize Pulse Input Manager
+  // RPM and both fuel flow meters share one counter bank and read timer
+  auto* pulseManager = new PulseInputManager(
+      scheduler,
+      BoatSensorConfig::RPM_READ_DELAY_MS
+  );
 
   // Initialize RPM Sensor Manager
+  // The topology always has an RPM channel
   RPMSensorManager rpmManager(
-      BoatSensorConfig::RPM_PIN,
-      BoatSensorConfig::RPM_READ_DELAY_MS,
-      BoatSensorConfig::RPM_MULTIPLIER
+      pulseManager,
+      *topology.findPulse(SensorTopology::PulseRole::RPM)
   );
   rpmManager.setupSensor();
+
+  pulseManager->setupSensors(topology);
+
+  // Per-cylinder contribution from the RPM pickup's tooth timing; takes
+  // over the RPM pin interrupt, so before the pulse inputs start
+  if (BoatSensorConfig::CYLINDER_BALANCE_ENABLED) {
+    auto* balance = new CylinderBalanceManager(
+        BoatSensorConfig::CYLINDER_BALANCE_DEFAULTS,
+        BoatSensorConfig::CYLINDER_BALANCE_CONFIG_PATH
+    );
+    balance->start(pulseManager, rpmManager.getChannel(), scheduler);
+  }
+  pulseManager->start();
+
+  // Engine-mount vibration; its own task drains the accelerometer FIFO
+  if (BoatSensorConfig::VIBRATION_ENABLED) {
+    Wire.begin(BoatSensorConfig::VIBRATION_SDA_PIN, BoatSensorConfig::VIBRATION_SCL_PIN,
+               BoatSensorConfig::VIBRATION_I2C_HZ);
+    auto* vibration = new VibrationSensorManager(new Lis3dhAccelerometer(
+        new WireRegisterBus(&Wire, BoatSensorConfig::VIBRATION_I2C_ADDRESS),
+        BoatSensorConfig::VIBRATION_RATE_HZ,
+        BoatSensorConfig::VIBRATION_RANGE_G
+    ));
+    vibration->start(rpmManager.getScaling());
+  }
+
+  // Initialize Analog Sensor Manager
+  // The ADC and the manager drain timer live for the lifetime of the app
+  auto* analogManager = new AnalogSensorManager(
+      new Esp32ContinuousAdcSource(),
+      scheduler,
+      BoatSensorConfig::ANALOG_SAMPLE_RATE_HZ,
+      BoatSensorConfig::ANALOG_READ_DELAY_MS
+  );
+  analogManager->setupSensors();
+
+  // Initialize Thermocouple Sensor Manager
+  // Exhaust gas is far beyond DS18B20 range; the amplifiers share one SPI
+  // bus and are read in a DMA batch
+  auto* spiBus = new Esp32SpiDeviceBus(
+      SPI3_HOST,
+      BoatSensorConfig::THERMOCOUPLE_SCLK_PIN,
+      BoatSensorConfig::THERMOCOUPLE_MISO_PIN,
+      BoatSensorConfig::THERMOCOUPLE_MOSI_PIN
+  );
+  ThermocoupleSensorManager* thermocoupleManager = nullptr;
+  if (spiBus->begin()) {
+    thermocoupleManager = new ThermocoupleSensorManager(
+        spiBus, scheduler, BoatSensorConfig::THERMOCOUPLE_READ_DELAY_MS);
+    thermocoupleManager->setupSensors();
+  }
+
+  // All periodic reads are registered; assign phases and start them
+  scheduler->start(BoatSensorConfig::SCHEDULER_SK_PREFIX,
+                   BoatSensorConfig::SCHEDULER_REPORT_MS);
+
+  // Initialize Sensor Recording
+  // Off unless enabled in the web configuration; needs all channels added
+  auto* recording = new SensorRecordingManager(
+      BoatSensorConfig::RECORDING_CONFIG_PATH
+  );
+  recording->start(pulseManager, tempManager);
+
+  // Initialize Sampling Governor
+  // Fast sampling while the engine runs, slow (or none) while stopped
+  governor = new SamplingGovernorManager(
+      BoatSensorConfig::GOVERNOR_DEFAULTS,
+      BoatSensorConfig::GOVERNOR_CONFIG_PATH
+  );
+  governor->addSampledInput(pulseManager, SamplingGovernorManager::InputKind::PULSE);
+  governor->addSampledInput(tempManager, SamplingGovernorManager::InputKind::TEMPERATURE);
+  governor->addSampledInput(analogManager, SamplingGovernorManager::InputKind::ANALOG);
+  governor->setEngineSpeedSource(pulseManager, rpmManager.getChannel());
+
+  const OneWireTempChain* coolant =
+      tempManager->findSensor(BoatSensorConfig::COOLANT_TEMP.base_name);
+  if (coolant != nullptr) {
+    governor->setCoolantSource(coolant->calibration);
+  }
+  governor->start();
+
+  // Warn of overheating from the coolant trend, minutes before the limit
+  if (coolant != nullptr) {
+    auto* overheat = new OverheatWarningManager(
+        BoatSensorConfig::OVERHEAT_DEFAULTS,
+        BoatSensorConfig::OVERHEAT_CONFIG_PATH
+    );
+    overheat->start(coolant);
+  }
+
+  // Minute and ten-minute summaries for logging and dashboards upstream
+  auto* rpmStatistics = new StatisticsPublisher(
+      BoatSensorConfig::STATISTICS_WINDOWS, BoatSensorConfig::STATISTICS_WINDOW_COUNT);
+  rpmStatistics->start(rpmManager.getScaling(), BoatSensorConfig::STATISTICS_SK_PREFIX,
+                       "revolutions", BoatSensorConfig::STATISTICS_PUBLISH_MS);
+  if (coolant != nullptr) {
+    auto* coolantStatistics = new StatisticsPublisher(
+        BoatSensorConfig::STATISTICS_WINDOWS, BoatSensorConfig::STATISTICS_WINDOW_COUNT);
+    coolantStatistics->start(coolant->calibration, BoatSensorConfig::STATISTICS_SK_PREFIX,
+                             "coolantTemperature", BoatSensorConfig::STATISTICS_PUBLISH_MS);
+  }
+
+  // Hours in each RPM and coolant band, for maintenance planning
+  auto* loadProfile = new LoadProfileManager();
+  loadProfile->addInput("rpm", BoatSensorConfig::LOAD_PROFILE_RPM,
+                        rpmManager.getScaling(), 60.0f, 0.0f);
+  if (coolant != nullptr) {
+    loadProfile->addInput("coolantTemperature", BoatSensorConfig::LOAD_PROFILE_COOLANT,
+                          coolant->calibration, 1.0f, -273.15f);
+  }
+  loadProfile->start();
+
+  // Live gauges on the device itself, for when the Signal K server is down
+  auto* gauges = new LiveGaugeServer();
+  gauges->addGauge(rpmManager.getScaling(), "RPM", "rpm", 60.0f, 0.0f, 0);
+  for (size_t i = 0; i < topology.getTemperatureCount(); i++) {
+    const BoatSensorConfig::TemperatureSensorDef& def = topology.getTemperature(i);
+    const OneWireTempChain* chain = tempManager->findSensor(def.base_name);
+    if (chain != nullptr) {
+      gauges->addGauge(chain->calibration, def.human_label, "\u00b0C", 1.0f, -273.15f, 1);
+    }
+  }
+  if (thermocoupleManager != nullptr) {
+    FloatTransform* egt =
+        thermocoupleManager->findSensor(BoatSensorConfig::EXHAUST_GAS_TEMP.base_name);
+    if (egt != nullptr) {
+      gauges->addGauge(egt, BoatSensorConfig::EXHAUST_GAS_TEMP.human_label, "\u00b0C",
+                       1.0f, -273.15f, 0);
+    }
+  }
+  gauges->start(BoatSensorConfig::LIVE_PAGE_HTTP_PATH,
+                BoatSensorConfig::LIVE_EVENTS_HTTP_PATH, BoatSensorConfig::LIVE_REFRESH_MS);
+
+  // Ramp synthetic channels on top of the real ones to find where the
+  // pipeline saturates
+  if (BoatSensorConfig::STRESS_TEST_ENABLED) {
+    stress = new StressTestManager(BoatSensorConfig::STRESS_SETTINGS);
+    stress->start(BoatSensorConfig::STRESS_SK_PREFIX);
+  }
 }
 
 // main program loop
 void loop() {
   static auto event_loop = sensesp_app->get_event_loop();
+  const uint32_t start = micros();
   event_loop->tick();
+  const uint32_t busy_us = micros() - start;
+  if (stress != nullptr) {
+    stress->afterTick(busy_us);
+  }
+  governor->afterTick(busy_us);
 }
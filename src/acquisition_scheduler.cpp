@@ -0,0 +1,125 @@
+#include "acquisition_scheduler.h"
+
+#include "deferred_log_manager.h"
+#include "timestamped_sk_output.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+AcquisitionScheduler::AcquisitionScheduler(unsigned int slot_ms, bool stagger)
+    : phases_(slot_ms, stagger)
+    , next_tick_(nullptr)
+    , started_(false)
+    , peak_tick_us_(0)
+    , total_tick_us_(0)
+    , ticks_(0)
+    , peak_tasks_(0)
+    , peak_tick_output_(nullptr)
+    , mean_tick_output_(nullptr)
+    , peak_tasks_output_(nullptr) {
+}
+
+int AcquisitionScheduler::addTask(const char* name, unsigned int period_ms,
+                                  PhaseScheduler::Callback callback, uint16_t weight) {
+    const int task = phases_.addTask(period_ms, callback, weight);
+    if (task < 0) {
+        ESP_LOGE("AcquisitionScheduler", "Cannot add %s", name);
+        return task;
+    }
+    names_[task] = name;
+    if (started_) {
+        // Only the new task: the peak load scans the whole horizon, so it is
+        // worked out again only when debug logging is compiled in
+        logTask(static_cast<size_t>(task));
+        ESP_LOGD("AcquisitionScheduler", "Peak load now %u",
+                 static_cast<unsigned>(phases_.getPeakLoad()));
+        reschedule();
+    }
+    return task;
+}
+
+void AcquisitionScheduler::setPeriod(int task, unsigned int period_ms) {
+    if (task < 0) {
+        return;
+    }
+    phases_.setPeriod(static_cast<size_t>(task), period_ms);
+    if (started_) {
+        reschedule();
+    }
+}
+
+void AcquisitionScheduler::start(const char* sk_prefix, unsigned int report_ms) {
+    const String prefix(sk_prefix);
+    peak_tick_output_ = new SKOutputInt(prefix + "peakTickUs");
+    mean_tick_output_ = new SKOutputInt(prefix + "meanTickUs");
+    peak_tasks_output_ = new SKOutputInt(prefix + "peakTasks");
+    
+    started_ = true;
+    logPhases();
+    reschedule();
+    event_loop()->onRepeat(report_ms, [this]() { this->report(); });
+}
+
+void AcquisitionScheduler::reschedule() {
+    if (next_tick_ != nullptr) {
+        event_loop()->remove(next_tick_);
+        next_tick_ = nullptr;
+    }
+    const uint64_t now = acquisitionNowMs();
+    const uint64_t due = phases_.nextDueMs(now);
+    if (due == PhaseScheduler::NEVER) {
+        return;
+    }
+    const uint32_t delay_ms = due > now ? static_cast<uint32_t>(due - now) : 0;
+    next_tick_ = event_loop()->onDelay(delay_ms, [this]() { this->tick(); });
+}
+
+void AcquisitionScheduler::tick() {
+    next_tick_ = nullptr;
+    const uint32_t start = micros();
+    const size_t run = phases_.runDue(acquisitionNowMs());
+    const uint32_t busy_us = micros() - start;
+    
+    if (run > 0) {
+        ticks_++;
+        total_tick_us_ += busy_us;
+        if (busy_us > peak_tick_us_) {
+            peak_tick_us_ = busy_us;
+        }
+        if (run > peak_tasks_) {
+            peak_tasks_ = static_cast<uint32_t>(run);
+        }
+    }
+    // A task may have changed periods; reschedule() clears any timer it set
+    reschedule();
+}
+
+void AcquisitionScheduler::report() {
+    peak_tick_output_->set(static_cast<int>(peak_tick_us_));
+    mean_tick_output_->set(ticks_ > 0 ? static_cast<int>(total_tick_us_ / ticks_) : 0);
+    peak_tasks_output_->set(static_cast<int>(peak_tasks_));
+    logDeferred(LogEvent::SCHEDULER_TICKS, ticks_, peak_tick_us_, peak_tasks_);
+    peak_tick_us_ = 0;
+    total_tick_us_ = 0;
+    ticks_ = 0;
+    peak_tasks_ = 0;
+}
+
+void AcquisitionScheduler::logTask(size_t task) const {
+    ESP_LOGI("AcquisitionScheduler", "%s: every %u slots at phase %u", names_[task],
+             static_cast<unsigned>(phases_.getPeriodSlots(task)),
+             static_cast<unsigned>(phases_.getPhase(task)));
+}
+
+void AcquisitionScheduler::logPhases() const {
+    for (size_t i = 0; i < phases_.getTaskCount(); i++) {
+        logTask(i);
+    }
+    ESP_LOGI("AcquisitionScheduler", "%u ms slots, peak load %u (%u if aligned)",
+             static_cast<unsigned>(phases_.getSlotMs()),
+             static_cast<unsigned>(phases_.getPeakLoad()),
+             static_cast<unsigned>(phases_.getAlignedLoad()));
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,43 @@
+#include "acquisition_time.h"
+
+#include <cstdio>
+
+namespace BoatEngine {
+
+bool acquisitionToEpochMs(const AcquisitionStamp& stamp, int64_t wall_now_ms,
+                          uint64_t monotonic_now_ms, int64_t* epoch_ms) {
+    if (!stamp.isSet() || wall_now_ms < MIN_SYNCED_EPOCH_MS ||
+        stamp.monotonic_ms > monotonic_now_ms) {
+        return false;
+    }
+    *epoch_ms = wall_now_ms - static_cast<int64_t>(monotonic_now_ms - stamp.monotonic_ms);
+    return true;
+}
+
+void formatSignalKTimestamp(int64_t epoch_ms, char* buffer) {
+    const uint64_t ms = static_cast<uint64_t>(epoch_ms);
+    const unsigned millis = static_cast<unsigned>(ms % 1000);
+    const unsigned second_of_day = static_cast<unsigned>(ms / 1000 % 86400);
+    const int64_t days = static_cast<int64_t>(ms / 86400000);
+    
+    // Civil date from days since 1970-01-01 (proleptic Gregorian), without
+    // gmtime() so the result does not depend on the C library
+    const int64_t z = days + 719468;
+    const int64_t era = z / 146097;
+    const int64_t day_of_era = z - era * 146097;
+    const int64_t year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int64_t day_of_year =
+        day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int64_t mp = (5 * day_of_year + 2) / 153;
+    const unsigned day = static_cast<unsigned>(day_of_year - (153 * mp + 2) / 5 + 1) % 32;
+    const unsigned month = static_cast<unsigned>(mp < 10 ? mp + 3 : mp - 9) % 13;
+    const unsigned year =
+        static_cast<unsigned>(year_of_era + era * 400 + (month <= 2 ? 1 : 0)) % 10000;
+    
+    snprintf(buffer, SIGNALK_TIMESTAMP_SIZE, "%04u-%02u-%02uT%02u:%02u:%02u.%03uZ",
+             year, month, day, second_of_day / 3600, second_of_day / 60 % 60,
+             second_of_day % 60, millis);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,65 @@
+#include "adc_block_filter.h"
+
+namespace BoatEngine {
+
+constexpr size_t AdcBlockFilter::MAX_CHANNELS;
+constexpr uint16_t AdcBlockFilter::MIN_BLOCK_SIZE;
+
+AdcBlockFilter::AdcBlockFilter(uint16_t block_size)
+    : block_size_(block_size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : block_size)
+    , rejected_(0) {
+    reset();
+}
+
+void AdcBlockFilter::setBlockSize(uint16_t block_size) {
+    block_size_ = block_size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : block_size;
+    reset();
+}
+
+void AdcBlockFilter::reset() {
+    for (size_t i = 0; i < MAX_CHANNELS; i++) {
+        acc_[i].sum = 0;
+        acc_[i].min = UINT16_MAX;
+        acc_[i].max = 0;
+        acc_[i].count = 0;
+    }
+}
+
+size_t AdcBlockFilter::process(const AdcSample* samples, size_t count,
+                               Result* results, size_t max_results) {
+    size_t produced = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const AdcSample& sample = samples[i];
+        if (sample.channel >= MAX_CHANNELS) {
+            rejected_++;
+            continue;
+        }
+
+        Accumulator& acc = acc_[sample.channel];
+        acc.sum += sample.raw;
+        if (sample.raw < acc.min) acc.min = sample.raw;
+        if (sample.raw > acc.max) acc.max = sample.raw;
+
+        if (++acc.count < block_size_) {
+            continue;
+        }
+
+        // Block complete: trimmed mean, then start the next block
+        if (produced < max_results) {
+            const uint32_t trimmed = acc.sum - acc.min - acc.max;
+            results[produced].channel = sample.channel;
+            results[produced].raw =
+                static_cast<float>(trimmed) / static_cast<float>(acc.count - 2);
+            produced++;
+        }
+        acc.sum = 0;
+        acc.min = UINT16_MAX;
+        acc.max = 0;
+        acc.count = 0;
+    }
+
+    return produced;
+}
+
+} // namespace BoatEngine
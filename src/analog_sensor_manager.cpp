@@ -0,0 +1,150 @@
+#include "analog_sensor_manager.h"
+#include "calibration_transform.h"
+
+#include <string>
+
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_output.h"
+#include "sensesp/ui/config_item.h"
+#include "timestamped_sk_output.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+constexpr size_t AnalogSensorManager::DRAIN_BATCH;
+constexpr size_t AnalogSensorManager::MAX_RESULTS;
+
+AnalogSensorManager::AnalogSensorManager(AdcSource* source,
+                                         AcquisitionScheduler* scheduler,
+                                         uint32_t sample_rate_hz,
+                                         unsigned int read_delay_ms)
+    : source_(source)
+    , sample_rate_hz_(sample_rate_hz)
+    , read_delay_ms_(read_delay_ms)
+    , started_(false)
+    , paused_(false)
+    , scheduler_(scheduler)
+    , drain_task_(-1)
+    , channel_count_(0) {
+}
+
+void AnalogSensorManager::setupSensors() {
+    // Set up all pre-configured analog sensors
+    addSensor(BoatSensorConfig::OIL_PRESSURE);
+    addSensor(BoatSensorConfig::ALTERNATOR_VOLTAGE);
+    addSensor(BoatSensorConfig::FUEL_LEVEL);
+    
+    start();
+}
+
+bool AnalogSensorManager::addSensor(const BoatSensorConfig::AnalogSensorDef& config) {
+    if (config.adc_channel >= AdcBlockFilter::MAX_CHANNELS ||
+        channel_count_ >= AdcBlockFilter::MAX_CHANNELS ||
+        getChannelOutput(config.adc_channel) != nullptr) {
+        ESP_LOGE("AnalogSensorManager", "Cannot add %s on ADC channel %u",
+                 config.base_name, config.adc_channel);
+        return false;
+    }
+    
+    const std::string base_cfg = std::string("/") + config.base_name;
+    const std::string sk_cfg = std::string("/") + config.base_name + "/skPath";
+    
+    auto* millivolts = new ObservableValue<float>();
+    
+    auto* calibration = create_calibration(&config.calibration, base_cfg.c_str(),
+                                           config.human_label,
+                                           config.linear_sort_order);
+    
+    auto* sk_output = new TimestampedSKOutputFloat(config.signal_k_path, sk_cfg.c_str(),
+                                                   &stamp_);
+    ConfigItem(sk_output)
+        ->set_title((std::string(config.human_label) + " Signal K Path").c_str())
+        ->set_description((std::string("Signal K path for the ") +
+                           config.human_label).c_str())
+        ->set_sort_order(config.sk_sort_order);
+    
+    millivolts->connect_to(calibration)->connect_to(sk_output);
+    
+    channels_[channel_count_].adc_channel = config.adc_channel;
+    channels_[channel_count_].millivolts = millivolts;
+    channel_count_++;
+    return true;
+}
+
+bool AnalogSensorManager::start() {
+    if (channel_count_ == 0) {
+        return false;
+    }
+    
+    uint8_t pattern[AdcBlockFilter::MAX_CHANNELS];
+    for (size_t i = 0; i < channel_count_; i++) {
+        pattern[i] = channels_[i].adc_channel;
+    }
+    
+    applyBlockSize();
+    
+    if (!source_->begin(pattern, channel_count_, sample_rate_hz_)) {
+        ESP_LOGE("AnalogSensorManager", "ADC source failed to start");
+        return false;
+    }
+    started_ = true;
+    
+    drain_task_ = scheduler_->addTask("analog", BoatSensorConfig::ANALOG_DRAIN_INTERVAL_MS,
+                                      [this]() { this->drain(); });
+    return true;
+}
+
+void AnalogSensorManager::applyBlockSize() {
+    // One output per channel per read interval
+    const uint32_t per_channel_rate = sample_rate_hz_ / channel_count_;
+    const uint32_t block = per_channel_rate * read_delay_ms_ / 1000;
+    filter_.setBlockSize(block > UINT16_MAX ? UINT16_MAX
+                                            : static_cast<uint16_t>(block));
+}
+
+void AnalogSensorManager::setSamplingInterval(unsigned int interval_ms) {
+    if (interval_ms == 0) {
+        if (started_ && !paused_) {
+            source_->pause();
+            scheduler_->setPeriod(drain_task_, 0);
+            paused_ = true;
+        }
+        return;
+    }
+    
+    read_delay_ms_ = interval_ms;
+    if (!started_) {
+        return;
+    }
+    // Partial blocks were averaged for the old interval; start afresh
+    applyBlockSize();
+    if (paused_) {
+        paused_ = false;
+        source_->resume();
+        scheduler_->setPeriod(drain_task_, BoatSensorConfig::ANALOG_DRAIN_INTERVAL_MS);
+    }
+}
+
+void AnalogSensorManager::drain() {
+    stamp_.mark(acquisitionNowMs());
+    filter_.drain(source_, samples_, DRAIN_BATCH, results_, MAX_RESULTS,
+                  [this](const AdcBlockFilter::Result& result) {
+        auto* output = getChannelOutput(result.channel);
+        if (output != nullptr) {
+            output->set(source_->toMillivolts(result.raw));
+        }
+    });
+}
+
+sensesp::ObservableValue<float>* AnalogSensorManager::getChannelOutput(
+    uint8_t adc_channel) const {
+    for (size_t i = 0; i < channel_count_; i++) {
+        if (channels_[i].adc_channel == adc_channel) {
+            return channels_[i].millivolts;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,97 @@
+#include "calibration_table.h"
+
+namespace BoatEngine {
+
+constexpr size_t CalibrationTable::MAX_POINTS;
+constexpr size_t CalibrationTable::INDEX_BUCKETS;
+
+CalibrationTable::CalibrationTable()
+    : count_(0)
+    , index_origin_(0.0f)
+    , index_scale_(0.0f) {
+    const Point identity[] = {{0.0f, 0.0f}, {1.0f, 1.0f}};
+    setPoints(identity, 2);
+}
+
+bool CalibrationTable::setPoints(const Point* points, size_t count) {
+    if (count < 2 || count > MAX_POINTS) {
+        return false;
+    }
+    
+    // Insertion sort into a scratch copy; the table is tiny
+    Point sorted[MAX_POINTS];
+    for (size_t i = 0; i < count; i++) {
+        size_t j = i;
+        while (j > 0 && sorted[j - 1].input > points[i].input) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = points[i];
+    }
+    for (size_t i = 1; i < count; i++) {
+        if (!(sorted[i].input > sorted[i - 1].input)) {
+            return false;
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        points_[i] = sorted[i];
+    }
+    count_ = count;
+    buildIndex();
+    return true;
+}
+
+void CalibrationTable::buildIndex() {
+    const float x0 = points_[0].input;
+    const float x1 = points_[count_ - 1].input;
+    index_origin_ = x0;
+    index_scale_ = static_cast<float>(INDEX_BUCKETS) / (x1 - x0);
+    
+    // first_segment_[b] is the segment containing the left edge of bucket b
+    size_t segment = 0;
+    for (size_t b = 0; b <= INDEX_BUCKETS; b++) {
+        const float edge = x0 + static_cast<float>(b) / index_scale_;
+        while (segment < count_ - 2 && points_[segment + 1].input <= edge) {
+            segment++;
+        }
+        first_segment_[b] = static_cast<uint8_t>(segment);
+    }
+}
+
+size_t CalibrationTable::findSegment(float input) const {
+    size_t bucket = static_cast<size_t>((input - index_origin_) * index_scale_);
+    if (bucket >= INDEX_BUCKETS) {
+        bucket = INDEX_BUCKETS - 1;
+    }
+    
+    size_t lo = first_segment_[bucket];
+    size_t hi = first_segment_[bucket + 1];
+    // Usually lo == hi or hi == lo + 1; binary search covers clustered points
+    while (lo < hi) {
+        const size_t mid = (lo + hi + 1) / 2;
+        if (points_[mid].input <= input) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+float CalibrationTable::evaluate(float input) const {
+    if (!(input > points_[0].input)) {
+        // Also catches NaN
+        return input == input ? points_[0].output : input;
+    }
+    if (input >= points_[count_ - 1].input) {
+        return points_[count_ - 1].output;
+    }
+    
+    const size_t s = findSegment(input);
+    const Point& a = points_[s];
+    const Point& b = points_[s + 1];
+    return a.output + (input - a.input) * (b.output - a.output) / (b.input - a.input);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,85 @@
+#include "calibration_transform.h"
+
+#include <string>
+
+#include "sensesp/transforms/linear.h"
+#include "sensesp/ui/config_item.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+CalibrationTableTransform::CalibrationTableTransform(
+    const CalibrationTable::Point* points, size_t count, const String& config_path)
+    : FloatTransform(config_path) {
+    table_.setPoints(points, count);
+    this->load();
+}
+
+void CalibrationTableTransform::set(const float& input) {
+    this->emit(table_.evaluate(input));
+}
+
+bool CalibrationTableTransform::to_json(JsonObject& root) {
+    JsonArray samples = root["samples"].to<JsonArray>();
+    for (size_t i = 0; i < table_.size(); i++) {
+        JsonObject sample = samples.add<JsonObject>();
+        sample["input"] = table_.point(i).input;
+        sample["output"] = table_.point(i).output;
+    }
+    return true;
+}
+
+bool CalibrationTableTransform::from_json(const JsonObject& config) {
+    if (!config["samples"].is<JsonArray>()) {
+        return false;
+    }
+    JsonArray samples = config["samples"];
+    if (samples.size() > CalibrationTable::MAX_POINTS) {
+        return false;
+    }
+    
+    CalibrationTable::Point points[CalibrationTable::MAX_POINTS];
+    size_t count = 0;
+    for (JsonObject sample : samples) {
+        if (!sample["input"].is<float>() || !sample["output"].is<float>()) {
+            return false;
+        }
+        points[count].input = sample["input"].as<float>();
+        points[count].output = sample["output"].as<float>();
+        count++;
+    }
+    return table_.setPoints(points, count);
+}
+
+const String ConfigSchema(const CalibrationTableTransform& obj) {
+    return R"###({"type":"object","properties":{"samples":{"title":"Calibration points","description":"Input/output breakpoints (2-16), interpolated linearly and clamped at the ends","type":"array","format":"table","maxItems":16,"items":{"type":"object","properties":{"input":{"type":"number","title":"Input"},"output":{"type":"number","title":"Output"}}}}}})###";
+}
+
+template <typename T>
+static T* with_config_item(T* calibration, const char* human_label, int sort_order) {
+    ConfigItem(calibration)
+        ->set_title((std::string(human_label) + " Calibration").c_str())
+        ->set_description((std::string("Calibration for the ") + human_label).c_str())
+        ->set_sort_order(sort_order);
+    return calibration;
+}
+
+FloatTransform* create_calibration(const BoatSensorConfig::CalibrationDef* def,
+                                   const char* base_config_path,
+                                   const char* human_label, int sort_order) {
+    if (def != nullptr && def->type == BoatSensorConfig::Calibration::TABLE) {
+        const std::string cfg = std::string(base_config_path) + "/calibrationTable";
+        return with_config_item(
+            new CalibrationTableTransform(def->table, def->table_size, cfg.c_str()),
+            human_label, sort_order);
+    }
+    
+    const std::string cfg = std::string(base_config_path) + "/linear";
+    const float multiplier = def != nullptr ? def->multiplier : 1.0f;
+    const float offset = def != nullptr ? def->offset : 0.0f;
+    return with_config_item(new Linear(multiplier, offset, cfg.c_str()),
+                            human_label, sort_order);
+}
+
+} // namespace BoatEngine
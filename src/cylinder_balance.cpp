@@ -0,0 +1,138 @@
+#include "cylinder_balance.h"
+
+#include <cmath>
+
+namespace BoatEngine {
+
+constexpr size_t CylinderBalance::MAX_TEETH_PER_CYCLE;
+constexpr size_t CylinderBalance::MAX_CYLINDERS;
+constexpr uint32_t CylinderBalance::MAX_INTERVAL_US;
+
+// Averaged intervals carry 4 fractional bits
+static constexpr unsigned AVERAGE_SHIFT = 4;
+static constexpr double TWO_PI = 6.283185307179586;
+
+CylinderBalance::CylinderBalance(const Settings& settings)
+    : settings_(settings)
+    , teeth_per_cycle_(0)
+    , position_(0)
+    , cycles_(0)
+    , resyncs_(0) {
+    setSettings(settings);
+}
+
+size_t CylinderBalance::teethPerCycle(const Settings& settings) {
+    const size_t teeth = static_cast<size_t>(settings.teeth_per_rev) *
+                         (settings.four_stroke ? 2 : 1);
+    const size_t cylinders = settings.cylinders;
+    const bool valid = cylinders > 0 && cylinders <= MAX_CYLINDERS && teeth > 0 &&
+                       teeth <= MAX_TEETH_PER_CYCLE && teeth % cylinders == 0;
+    return valid ? teeth : 0;
+}
+
+void CylinderBalance::setSettings(const Settings& settings) {
+    settings_ = settings;
+    teeth_per_cycle_ = teethPerCycle(settings);
+    
+    for (size_t n = 0; n < teeth_per_cycle_; n++) {
+        const double angle = TWO_PI * static_cast<double>(n) / teeth_per_cycle_;
+        cos_[n] = static_cast<int16_t>(lround(32767.0 * cos(angle)));
+        sin_[n] = static_cast<int16_t>(lround(32767.0 * sin(angle)));
+    }
+    position_ = 0;
+    clearCycles();
+}
+
+void CylinderBalance::clearCycles() {
+    for (size_t n = 0; n < MAX_TEETH_PER_CYCLE; n++) {
+        sums_[n] = 0;
+    }
+    cycles_ = 0;
+}
+
+void CylinderBalance::resync() {
+    position_ = 0;
+    clearCycles();
+    resyncs_++;
+}
+
+void CylinderBalance::addIntervals(const uint32_t* intervals_us, size_t count) {
+    if (!isValid()) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t interval = intervals_us[i];
+        if (interval == 0 || interval > MAX_INTERVAL_US) {
+            resync();
+            continue;
+        }
+        current_[position_++] = interval;
+        if (position_ < teeth_per_cycle_) {
+            continue;
+        }
+        for (size_t n = 0; n < teeth_per_cycle_; n++) {
+            sums_[n] += current_[n];
+        }
+        cycles_++;
+        position_ = 0;
+    }
+}
+
+bool CylinderBalance::analyse(Result* result) {
+    if (!isValid() || cycles_ == 0) {
+        return false;
+    }
+    const size_t teeth = teeth_per_cycle_;
+    const size_t cylinders = settings_.cylinders;
+    const size_t teeth_per_sector = teeth / cylinders;
+    
+    uint64_t total = 0;
+    for (size_t n = 0; n < teeth; n++) {
+        total += sums_[n];
+    }
+    
+    // Sector speed relative to the mean is the inverse of its share of
+    // the cycle time
+    const double sector_mean = static_cast<double>(total) / cylinders;
+    for (size_t k = 0; k < cylinders; k++) {
+        uint64_t sector = 0;
+        for (size_t n = k * teeth_per_sector; n < (k + 1) * teeth_per_sector; n++) {
+            sector += sums_[n];
+        }
+        result->contribution[k] =
+            sector > 0 ? static_cast<float>(sector_mean / static_cast<double>(sector)) : 0.0f;
+    }
+    
+    // Deviation of each averaged interval from the mean, in 1/16 us: a
+    // short interval is a fast tooth, so positive means faster than average
+    const int64_t mean_q = static_cast<int64_t>(
+        (total << AVERAGE_SHIFT) / (static_cast<uint64_t>(cycles_) * teeth));
+    double sum_squares = 0.0;
+    for (size_t order = 1; order < cylinders; order++) {
+        int64_t re = 0;
+        int64_t im = 0;
+        for (size_t n = 0; n < teeth; n++) {
+            const int64_t x =
+                mean_q - static_cast<int64_t>((sums_[n] << AVERAGE_SHIFT) / cycles_);
+            const size_t index = (order * n) % teeth;
+            re += x * cos_[index];
+            im += x * sin_[index];
+        }
+        // Single-sided amplitude over the mean, undoing the Q15 scale
+        const double amplitude = 2.0 * sqrt(static_cast<double>(re) * re +
+                                            static_cast<double>(im) * im) /
+                                 (static_cast<double>(teeth) * 32767.0);
+        const double fraction = mean_q > 0 ? amplitude / static_cast<double>(mean_q) : 0.0;
+        sum_squares += fraction * fraction;
+    }
+    result->roughness = static_cast<float>(sqrt(sum_squares));
+    
+    const double cycle_us = static_cast<double>(total) / cycles_;
+    result->rpm = static_cast<float>(60.0e6 * (settings_.four_stroke ? 2 : 1) / cycle_us);
+    result->cycles = cycles_;
+    
+    clearCycles();
+    return true;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,133 @@
+#include "cylinder_balance_manager.h"
+
+#include <esp_timer.h>
+
+#include "deferred_log_manager.h"
+#include "sensesp/ui/config_item.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+CylinderBalanceManager::CylinderBalanceManager(
+    const CylinderBalance::Settings& defaults, const String& config_path)
+    : FileSystemSaveable(config_path)
+    , balance_(defaults)
+    , counter_(nullptr)
+    , overruns_seen_(0)
+    , roughness_output_(nullptr) {
+    for (size_t i = 0; i < CylinderBalance::MAX_CYLINDERS; i++) {
+        contribution_outputs_[i] = nullptr;
+    }
+    this->load();
+}
+
+// Counts the edge for RPM as the default ISR would, then stamps it
+void IRAM_ATTR CylinderBalanceManager::onToothEdge(void* arg) {
+    CylinderBalanceManager* self = static_cast<CylinderBalanceManager*>(arg);
+    *self->counter_ = *self->counter_ + 1;
+    self->ring_.recordEdge(static_cast<uint32_t>(esp_timer_get_time()));
+}
+
+void CylinderBalanceManager::start(PulseInputManager* pulses,
+                                   const PulseInputManager::Channel* rpm,
+                                   AcquisitionScheduler* scheduler) {
+    ConfigItem(this)
+        ->set_title("Cylinder Balance")
+        ->set_description("Engine and pickup for per-cylinder analysis of the RPM input")
+        ->set_sort_order(BoatSensorConfig::CYLINDER_BALANCE_SORT_ORDER);
+    
+    if (!balance_.isValid()) {
+        ESP_LOGW("CylinderBalanceManager", "%u teeth/rev do not divide into %u cylinders",
+                 static_cast<unsigned>(balance_.getSettings().teeth_per_rev),
+                 static_cast<unsigned>(balance_.getSettings().cylinders));
+    }
+    
+    counter_ = pulses->getCounterBank()->counterFor(rpm->index);
+    if (!pulses->setEdgeHandler(rpm->index, onToothEdge, this)) {
+        ESP_LOGE("CylinderBalanceManager", "Pulse inputs already started");
+        return;
+    }
+    
+    roughness_output_ = new SKOutputFloat(
+        String(BoatSensorConfig::CYLINDER_BALANCE_SK_PREFIX) + "roughness");
+    scheduler->addTask("balance", BoatSensorConfig::CYLINDER_BALANCE_DRAIN_MS,
+                       [this]() { this->drain(); });
+    event_loop()->onRepeat(BoatSensorConfig::CYLINDER_BALANCE_REPORT_MS,
+                           [this]() { this->report(); });
+}
+
+void CylinderBalanceManager::drain() {
+    const uint32_t* intervals = ring_.takeFull();
+    if (intervals == nullptr) {
+        return;
+    }
+    balance_.addIntervals(intervals, ToothIntervalRing::BUFFER_SIZE);
+    ring_.release();
+    
+    // A buffer was dropped while this one was held; the next is not
+    // contiguous with it
+    const uint32_t overruns = ring_.getOverruns();
+    if (overruns != overruns_seen_) {
+        overruns_seen_ = overruns;
+        balance_.resync();
+    }
+}
+
+void CylinderBalanceManager::report() {
+    CylinderBalance::Result result;
+    if (!balance_.analyse(&result)) {
+        return;
+    }
+    
+    const size_t cylinders = balance_.getSettings().cylinders;
+    for (size_t i = 0; i < cylinders; i++) {
+        if (contribution_outputs_[i] == nullptr) {
+            contribution_outputs_[i] = new SKOutputFloat(
+                String(BoatSensorConfig::CYLINDER_BALANCE_SK_PREFIX) + "cylinder" +
+                String(static_cast<int>(i + 1)) + ".contribution");
+        }
+        contribution_outputs_[i]->set(result.contribution[i]);
+    }
+    roughness_output_->set(result.roughness);
+    logDeferred(LogEvent::CYLINDER_BALANCE, result.cycles, result.rpm, result.roughness,
+                overruns_seen_);
+}
+
+bool CylinderBalanceManager::to_json(JsonObject& root) {
+    const CylinderBalance::Settings& settings = balance_.getSettings();
+    root["teeth_per_rev"] = settings.teeth_per_rev;
+    root["cylinders"] = settings.cylinders;
+    root["four_stroke"] = settings.four_stroke;
+    return true;
+}
+
+bool CylinderBalanceManager::from_json(const JsonObject& config) {
+    if (!config["teeth_per_rev"].is<unsigned int>() ||
+        !config["cylinders"].is<unsigned int>() || !config["four_stroke"].is<bool>()) {
+        return false;
+    }
+    const unsigned int teeth = config["teeth_per_rev"].as<unsigned int>();
+    const unsigned int cylinders = config["cylinders"].as<unsigned int>();
+    if (teeth > UINT16_MAX || cylinders > CylinderBalance::MAX_CYLINDERS) {
+        return false;
+    }
+    
+    CylinderBalance::Settings settings;
+    settings.teeth_per_rev = static_cast<uint16_t>(teeth);
+    settings.cylinders = static_cast<uint8_t>(cylinders);
+    settings.four_stroke = config["four_stroke"].as<bool>();
+    if (CylinderBalance::teethPerCycle(settings) == 0) {
+        return false;
+    }
+    // The sectors restart from the next full buffer
+    balance_.setSettings(settings);
+    return true;
+}
+
+const String ConfigSchema(const CylinderBalanceManager& obj) {
+    return R"###({"type":"object","properties":{"teeth_per_rev":{"title":"Teeth per revolution","description":"Evenly spaced teeth the RPM pickup sees per crank revolution; the teeth in one engine cycle must divide evenly by the cylinders","type":"integer"},"cylinders":{"title":"Cylinders","type":"integer"},"four_stroke":{"title":"Four-stroke","description":"One engine cycle is two revolutions; off for a two-stroke","type":"boolean"}}})###";
+}
+
+} // namespace BoatEngine
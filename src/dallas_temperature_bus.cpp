@@ -0,0 +1,43 @@
+#include "dallas_temperature_bus.h"
+
+namespace BoatEngine {
+
+DallasTemperatureBus::DallasTemperatureBus(uint8_t pin)
+    : pin_(pin)
+    , dts_(nullptr) {
+}
+
+bool DallasTemperatureBus::begin() {
+    // The SensESP bus searches for devices when constructed
+    dts_ = new sensesp::onewire::DallasTemperatureSensors(pin_);
+    dts_->sensors_->setWaitForConversion(false);
+    
+    const uint8_t count = dts_->sensors_->getDeviceCount();
+    for (uint8_t i = 0; i < count; i++) {
+        OneWireAddress address;
+        if (dts_->sensors_->getAddress(address.data(), i)) {
+            addDevice(address);
+        }
+    }
+    return getDeviceCount() > 0;
+}
+
+bool DallasTemperatureBus::startConversion() {
+    dts_->sensors_->requestTemperatures();
+    return true;
+}
+
+bool DallasTemperatureBus::requestRead(const OneWireAddress& address, uint8_t tag) {
+    uint8_t scratchpad[9];
+    if (dts_->sensors_->readScratchPad(address.data(), scratchpad)) {
+        return pushScratchpad(tag, scratchpad);
+    }
+    
+    TemperatureReading reading;
+    reading.tag = tag;
+    reading.status = TemperatureReadStatus::NO_DEVICE;
+    reading.celsius = 0.0f;
+    return pushReading(reading);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,217 @@
+#include "deferred_log.h"
+
+#include <cstdio>
+
+namespace BoatEngine {
+
+constexpr size_t DeferredLog::CAPACITY;
+constexpr size_t DeferredLog::MAX_ARGS;
+constexpr uint8_t DeferredLog::VERSION;
+constexpr size_t DeferredLog::HEADER_SIZE;
+constexpr size_t DeferredLog::MAX_RECORD_SIZE;
+
+static const uint8_t MAGIC[4] = {'B', 'E', 'L', 'G'};
+
+static void putU32(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static uint32_t getU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+DeferredLog::DeferredLog()
+    : write_position_(0)
+    , dropped_(0)
+    , read_position_(0) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        slots_[i].sequence.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+    }
+}
+
+bool DeferredLog::pop(Record& record) {
+    Slot& slot = slots_[read_position_ & (CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != read_position_ + 1) {
+        return false;
+    }
+    record = slot.record;
+    // Free the slot for the writer one lap ahead
+    slot.sequence.store(read_position_ + static_cast<uint32_t>(CAPACITY),
+                        std::memory_order_release);
+    read_position_++;
+    return true;
+}
+
+size_t DeferredLog::writeHeader(uint8_t* out, size_t size) const {
+    if (size < HEADER_SIZE) {
+        return 0;
+    }
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out[4] = VERSION;
+    putU32(&out[5], getDropped());
+    return HEADER_SIZE;
+}
+
+size_t DeferredLog::readHeader(const uint8_t* data, size_t size, uint32_t& dropped) {
+    if (size < HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || data[4] != VERSION) {
+        return 0;
+    }
+    dropped = getU32(&data[5]);
+    return HEADER_SIZE;
+}
+
+size_t DeferredLog::encode(const Record& record, uint8_t* out, size_t size) {
+    const size_t length = 7 + static_cast<size_t>(record.arg_count) * 4;
+    if (record.arg_count > MAX_ARGS || size < length) {
+        return 0;
+    }
+    putU32(out, record.time_us);
+    out[4] = static_cast<uint8_t>(record.event);
+    out[5] = static_cast<uint8_t>(record.event >> 8);
+    out[6] = record.arg_count;
+    for (uint8_t i = 0; i < record.arg_count; i++) {
+        putU32(&out[7 + i * 4], record.args[i]);
+    }
+    return length;
+}
+
+size_t DeferredLog::decode(const uint8_t* data, size_t size, Record& record) {
+    if (size < 7 || data[6] > MAX_ARGS) {
+        return 0;
+    }
+    const size_t length = 7 + static_cast<size_t>(data[6]) * 4;
+    if (size < length) {
+        return 0;
+    }
+    record.time_us = getU32(data);
+    record.event = static_cast<uint16_t>(data[4] | (data[5] << 8));
+    record.arg_count = data[6];
+    for (uint8_t i = 0; i < record.arg_count; i++) {
+        record.args[i] = getU32(&data[7 + i * 4]);
+    }
+    return length;
+}
+
+/**
+ * @brief Appends to a fixed buffer, truncating at its end
+ */
+class TextOut {
+public:
+    TextOut(char* out, size_t size) : out_(out), size_(size), length_(0) {
+        if (size_ > 0) {
+            out_[0] = '\0';
+        }
+    }
+    
+    void put(char c) {
+        if (length_ + 1 < size_) {
+            out_[length_++] = c;
+            out_[length_] = '\0';
+        }
+    }
+    
+    template <typename T>
+    void print(const char* spec, T value) {
+        if (length_ + 1 < size_) {
+            const int written = snprintf(&out_[length_], size_ - length_, spec, value);
+            if (written > 0) {
+                length_ += static_cast<size_t>(written);
+                if (length_ >= size_) {
+                    length_ = size_ - 1;
+                }
+            }
+        }
+    }
+    
+    size_t length() const { return length_; }
+
+private:
+    char* out_;
+    size_t size_;
+    size_t length_;
+};
+
+static bool isConversion(char c) {
+    return strchr("diuxXcfeEgG", c) != nullptr;
+}
+
+static bool isSpecChar(char c) {
+    return strchr("-+ #0123456789.", c) != nullptr;
+}
+
+size_t DeferredLog::format(const Record& record, char* out, size_t size) {
+    TextOut text(out, size);
+    text.print("[%4lu.", static_cast<unsigned long>(record.time_us / 1000000));
+    text.print("%06lu] ", static_cast<unsigned long>(record.time_us % 1000000));
+    
+    const char* format = logEventFormat(record.event);
+    if (format == nullptr) {
+        text.print("Unknown event %u", static_cast<unsigned>(record.event));
+        for (uint8_t i = 0; i < record.arg_count; i++) {
+            text.print(" %08x", static_cast<unsigned>(record.args[i]));
+        }
+        return text.length();
+    }
+    
+    uint8_t next = 0;
+    for (const char* c = format; *c != '\0'; c++) {
+        if (*c != '%') {
+            text.put(*c);
+            continue;
+        }
+        if (c[1] == '%') {
+            text.put('%');
+            c++;
+            continue;
+        }
+        
+        // Copy one conversion, e.g. "%08x", to print its argument with
+        char spec[16];
+        size_t length = 0;
+        spec[length++] = '%';
+        const char* end = c + 1;
+        while (isSpecChar(*end) && length < sizeof(spec) - 2) {
+            spec[length++] = *end++;
+        }
+        if (!isConversion(*end)) {
+            // Not one we can print; show it as written
+            text.put('%');
+            continue;
+        }
+        spec[length++] = *end;
+        spec[length] = '\0';
+        c = end;
+        
+        if (next >= record.arg_count) {
+            text.put('?');
+            continue;
+        }
+        const uint32_t word = record.args[next++];
+        switch (*end) {
+            case 'd':
+            case 'i':
+                text.print(spec, static_cast<int>(static_cast<int32_t>(word)));
+                break;
+            case 'f':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G': {
+                float value;
+                memcpy(&value, &word, sizeof(value));
+                text.print(spec, static_cast<double>(value));
+                break;
+            }
+            default:
+                text.print(spec, static_cast<unsigned>(word));
+                break;
+        }
+    }
+    return text.length();
+}
+
+} // namespace BoatEngine
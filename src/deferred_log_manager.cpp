@@ -0,0 +1,94 @@
+#include "deferred_log_manager.h"
+
+#include <Arduino.h>
+#include <freertos/task.h>
+
+#include "sensesp/net/http_server.h"
+#include "sensesp_app.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+DeferredLog deferred_log;
+
+DeferredLogManager::DeferredLogManager()
+    : read_lock_(xSemaphoreCreateMutex()) {
+}
+
+void DeferredLogManager::start() {
+    if (BoatSensorConfig::DEFERRED_LOG_TO_SERIAL) {
+        xTaskCreate(drainTask, BoatSensorConfig::DEFERRED_LOG_TASK_NAME,
+                    BoatSensorConfig::DEFERRED_LOG_TASK_STACK, this, tskIDLE_PRIORITY,
+                    nullptr);
+    }
+    
+    auto handler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, BoatSensorConfig::DEFERRED_LOG_HTTP_PATH,
+        [this](httpd_req_t* req) {
+            httpd_resp_set_type(req, "application/octet-stream");
+            httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"log.bin\"");
+            
+            xSemaphoreTake(read_lock_, portMAX_DELAY);
+            uint8_t chunk[512];
+            size_t length = deferred_log.writeHeader(chunk, sizeof(chunk));
+            DeferredLog::Record record;
+            esp_err_t result = ESP_OK;
+            while (result == ESP_OK && deferred_log.pop(record)) {
+                length += DeferredLog::encode(record, &chunk[length], sizeof(chunk) - length);
+                if (sizeof(chunk) - length < DeferredLog::MAX_RECORD_SIZE) {
+                    result = httpd_resp_send_chunk(req, reinterpret_cast<const char*>(chunk),
+                                                   length);
+                    length = 0;
+                }
+            }
+            xSemaphoreGive(read_lock_);
+            
+            if (result == ESP_OK && length > 0) {
+                result = httpd_resp_send_chunk(req, reinterpret_cast<const char*>(chunk),
+                                               length);
+            }
+            if (result != ESP_OK) {
+                return ESP_FAIL;
+            }
+            return httpd_resp_send_chunk(req, nullptr, 0);
+        });
+    sensesp_app->get_http_server()->add_handler(handler);
+}
+
+void DeferredLogManager::drainTask(void* arg) {
+    DeferredLogManager* self = static_cast<DeferredLogManager*>(arg);
+    DeferredLog::Record records[8];
+    char text[160];
+    uint32_t dropped_seen = 0;
+    for (;;) {
+        // Copy a few records out and print them without the lock, so a
+        // download never waits for the UART behind this idle-priority task
+        size_t count;
+        do {
+            xSemaphoreTake(self->read_lock_, portMAX_DELAY);
+            count = 0;
+            while (count < sizeof(records) / sizeof(records[0]) &&
+                   deferred_log.pop(records[count])) {
+                count++;
+            }
+            xSemaphoreGive(self->read_lock_);
+            
+            for (size_t i = 0; i < count; i++) {
+                DeferredLog::format(records[i], text, sizeof(text));
+                Serial.println(text);
+            }
+        } while (count > 0);
+        
+        const uint32_t dropped = deferred_log.getDropped();
+        if (dropped != dropped_seen) {
+            Serial.printf("[deferred log] %u records dropped\n",
+                          static_cast<unsigned>(dropped - dropped_seen));
+            dropped_seen = dropped;
+        }
+        vTaskDelay(pdMS_TO_TICKS(BoatSensorConfig::DEFERRED_LOG_DRAIN_MS));
+    }
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,229 @@
+#include "ds18b20_bus.h"
+
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr size_t Ds18b20Bus::MAX_OPS;
+constexpr uint32_t Ds18b20Bus::BLOCKING_WAIT_MS;
+
+static const uint8_t CMD_SKIP_ROM = 0xCC;
+static const uint8_t CMD_MATCH_ROM = 0x55;
+static const uint8_t CMD_SEARCH_ROM = 0xF0;
+static const uint8_t CMD_CONVERT_T = 0x44;
+static const uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+
+static const uint8_t FAMILY_DS18B20 = 0x28;
+static const uint8_t FAMILY_DS1822 = 0x22;
+
+static const size_t SCRATCHPAD_BYTES = 9;
+
+Ds18b20Bus::Ds18b20Bus(OneWireLink* link)
+    : link_(link)
+    , op_head_(0)
+    , op_count_(0)
+    , step_(Step::IDLE)
+    , command_bits_(0)
+    , failed_conversions_(0) {
+}
+
+bool Ds18b20Bus::begin() {
+    if (!link_->begin()) {
+        return false;
+    }
+    return search();
+}
+
+bool Ds18b20Bus::startConversion() {
+    Op op;
+    op.type = OpType::CONVERT;
+    op.tag = 0;
+    op.address.fill(0);
+    return queue(op);
+}
+
+bool Ds18b20Bus::requestRead(const OneWireAddress& address, uint8_t tag) {
+    Op op;
+    op.type = OpType::READ;
+    op.tag = tag;
+    op.address = address;
+    return queue(op);
+}
+
+bool Ds18b20Bus::queue(const Op& op) {
+    if (op_count_ >= MAX_OPS) {
+        return false;
+    }
+    ops_[(op_head_ + op_count_) % MAX_OPS] = op;
+    op_count_++;
+    if (step_ == Step::IDLE) {
+        startNext();
+    }
+    return true;
+}
+
+void Ds18b20Bus::startNext() {
+    step_ = Step::IDLE;
+    if (op_count_ == 0) {
+        return;
+    }
+    
+    const Op& op = ops_[op_head_];
+    if (op.type == OpType::CONVERT) {
+        command_[0] = CMD_SKIP_ROM;
+        command_[1] = CMD_CONVERT_T;
+        command_bits_ = 16;
+    } else {
+        command_[0] = CMD_MATCH_ROM;
+        memcpy(&command_[1], op.address.data(), op.address.size());
+        command_[9] = CMD_READ_SCRATCHPAD;
+        command_bits_ = 80;
+    }
+    
+    if (link_->start(true, command_, command_bits_)) {
+        step_ = Step::COMMAND;
+    } else {
+        finish(TemperatureReadStatus::BUS_ERROR);
+    }
+}
+
+void Ds18b20Bus::finish(TemperatureReadStatus status, const uint8_t* scratchpad) {
+    const Op& op = ops_[op_head_];
+    if (op.type == OpType::READ && scratchpad != nullptr) {
+        pushScratchpad(op.tag, scratchpad);
+    } else if (op.type == OpType::READ) {
+        TemperatureReading reading;
+        reading.tag = op.tag;
+        reading.status = status;
+        reading.celsius = 0.0f;
+        pushReading(reading);
+    } else if (status != TemperatureReadStatus::OK) {
+        failed_conversions_++;
+    }
+    
+    op_head_ = (op_head_ + 1) % MAX_OPS;
+    op_count_--;
+    startNext();
+}
+
+void Ds18b20Bus::service() {
+    if (step_ == Step::IDLE) {
+        return;
+    }
+    
+    OneWireLink::Result result;
+    const OneWireLink::Status status = link_->poll(&result);
+    if (status == OneWireLink::Status::BUSY) {
+        return;
+    }
+    if (status == OneWireLink::Status::TIMEOUT) {
+        finish(TemperatureReadStatus::TIMEOUT);
+        return;
+    }
+    if (status != OneWireLink::Status::DONE) {
+        finish(TemperatureReadStatus::BUS_ERROR);
+        return;
+    }
+    
+    if (step_ == Step::COMMAND) {
+        if (!result.presence) {
+            finish(TemperatureReadStatus::NO_DEVICE);
+            return;
+        }
+        // Every written bit must read back as written
+        if (memcmp(result.rx, command_, command_bits_ / 8) != 0) {
+            finish(TemperatureReadStatus::BUS_ERROR);
+            return;
+        }
+        if (ops_[op_head_].type == OpType::CONVERT) {
+            finish(TemperatureReadStatus::OK);
+            return;
+        }
+        
+        uint8_t ones[SCRATCHPAD_BYTES];
+        memset(ones, 0xFF, sizeof(ones));
+        if (link_->start(false, ones, SCRATCHPAD_BYTES * 8)) {
+            step_ = Step::SCRATCHPAD;
+        } else {
+            finish(TemperatureReadStatus::BUS_ERROR);
+        }
+        return;
+    }
+    
+    finish(TemperatureReadStatus::OK, result.rx);
+}
+
+bool Ds18b20Bus::transferBlocking(bool reset, const uint8_t* tx, size_t bit_count,
+                                  OneWireLink::Result* result) {
+    if (!link_->start(reset, tx, bit_count)) {
+        return false;
+    }
+    OneWireLink::Status status;
+    do {
+        status = link_->poll(result, BLOCKING_WAIT_MS);
+    } while (status == OneWireLink::Status::BUSY);
+    return status == OneWireLink::Status::DONE;
+}
+
+bool Ds18b20Bus::search() {
+    // Maxim application note 187: walk the ROM binary tree, taking the 1
+    // branch at the last discrepancy on each pass
+    OneWireAddress rom;
+    rom.fill(0);
+    size_t last_discrepancy = 0;
+    bool last_device = false;
+    
+    while (!last_device && getDeviceCount() < MAX_DEVICES) {
+        OneWireLink::Result result;
+        const uint8_t search_command = CMD_SEARCH_ROM;
+        if (!transferBlocking(true, &search_command, 8, &result) ||
+            !result.presence) {
+            return getDeviceCount() > 0;
+        }
+        
+        size_t last_zero = 0;
+        for (size_t bit = 1; bit <= 64; bit++) {
+            const uint8_t read_two = 0x03;
+            if (!transferBlocking(false, &read_two, 2, &result)) {
+                return false;
+            }
+            const bool id_bit = result.rx[0] & 0x01;
+            const bool complement = result.rx[0] & 0x02;
+            if (id_bit && complement) {
+                return getDeviceCount() > 0;  // Everybody dropped out
+            }
+            
+            uint8_t& byte = rom[(bit - 1) / 8];
+            const uint8_t mask = static_cast<uint8_t>(1u << ((bit - 1) % 8));
+            bool direction;
+            if (id_bit != complement) {
+                direction = id_bit;
+            } else if (bit < last_discrepancy) {
+                direction = (byte & mask) != 0;
+            } else {
+                direction = bit == last_discrepancy;
+            }
+            if (id_bit == complement && !direction) {
+                last_zero = bit;
+            }
+            
+            byte = direction ? (byte | mask) : (byte & ~mask);
+            const uint8_t write_direction = direction ? 1 : 0;
+            if (!transferBlocking(false, &write_direction, 1, &result)) {
+                return false;
+            }
+        }
+        
+        if (oneWireCrc8(rom.data(), rom.size()) != 0) {
+            return getDeviceCount() > 0;
+        }
+        if (rom[0] == FAMILY_DS18B20 || rom[0] == FAMILY_DS1822) {
+            addDevice(rom);
+        }
+        last_discrepancy = last_zero;
+        last_device = last_discrepancy == 0;
+    }
+    return true;
+}
+
+} // namespace BoatEngine
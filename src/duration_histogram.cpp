@@ -0,0 +1,87 @@
+#include "duration_histogram.h"
+
+#include <cmath>
+
+namespace BoatEngine {
+
+constexpr size_t DurationHistogram::MAX_BINS;
+
+DurationHistogram::DurationHistogram()
+    : layout_{0.0f, 1.0f, 1}
+    , max_gap_ms_(0)
+    , last_value_(0.0f)
+    , last_ms_(0)
+    , has_last_(false) {
+    clear();
+}
+
+DurationHistogram::DurationHistogram(const Layout& layout, uint32_t max_gap_ms)
+    : layout_(layout)
+    , max_gap_ms_(max_gap_ms)
+    , last_value_(0.0f)
+    , last_ms_(0)
+    , has_last_(false) {
+    if (!isValid(layout_)) {
+        layout_ = Layout{0.0f, 1.0f, 1};
+    }
+    clear();
+}
+
+bool DurationHistogram::isValid(const Layout& layout) {
+    return layout.width > 0.0f && std::isfinite(layout.lower) && std::isfinite(layout.width) &&
+           layout.bins >= 1 && layout.bins <= MAX_BINS;
+}
+
+void DurationHistogram::clear() {
+    for (size_t i = 0; i < MAX_BINS + 2; i++) {
+        ms_[i] = 0;
+    }
+    has_last_ = false;
+}
+
+size_t DurationHistogram::binFor(float value) const {
+    if (value < layout_.lower) {
+        return 0;
+    }
+    const float index = floorf((value - layout_.lower) / layout_.width);
+    if (index >= layout_.bins) {
+        return getBinCount() - 1;
+    }
+    return static_cast<size_t>(index) + 1;
+}
+
+float DurationHistogram::getBinLower(size_t bin) const {
+    if (bin == 0) {
+        return -INFINITY;
+    }
+    return layout_.lower + static_cast<float>(bin - 1) * layout_.width;
+}
+
+float DurationHistogram::getBinUpper(size_t bin) const {
+    if (bin >= getBinCount() - 1) {
+        return INFINITY;
+    }
+    return layout_.lower + static_cast<float>(bin) * layout_.width;
+}
+
+uint64_t DurationHistogram::getTotalMs() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < getBinCount(); i++) {
+        total += ms_[i];
+    }
+    return total;
+}
+
+void DurationHistogram::update(float value, uint32_t now_ms) {
+    if (has_last_) {
+        const uint32_t elapsed = now_ms - last_ms_;
+        if (elapsed <= max_gap_ms_) {
+            ms_[binFor(last_value_)] += elapsed;
+        }
+    }
+    last_value_ = value;
+    last_ms_ = now_ms;
+    has_last_ = !std::isnan(value);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,144 @@
+#include "esp32_continuous_adc_source.h"
+
+#include <esp_log.h>
+
+namespace BoatEngine {
+
+static const char* LOG_TAG = "ContinuousAdc";
+
+constexpr size_t Esp32ContinuousAdcSource::DMA_POOL_BYTES;
+constexpr size_t Esp32ContinuousAdcSource::DMA_FRAME_BYTES;
+
+Esp32ContinuousAdcSource::Esp32ContinuousAdcSource(adc_atten_t attenuation)
+    : attenuation_(attenuation)
+    , running_(false)
+    , paused_(false)
+    , overflows_(0) {
+    esp_adc_cal_characterize(ADC_UNIT_1, attenuation_, ADC_WIDTH_BIT_12,
+                             1100, &characteristics_);
+}
+
+Esp32ContinuousAdcSource::~Esp32ContinuousAdcSource() {
+    if (running_) {
+        if (!paused_) {
+            adc_digi_stop();
+        }
+        adc_digi_deinitialize();
+    }
+}
+
+bool Esp32ContinuousAdcSource::begin(const uint8_t* channels, size_t count,
+                                     uint32_t sample_rate_hz) {
+    if (count == 0 || count > SOC_ADC_PATT_LEN_MAX) {
+        return false;
+    }
+
+    uint16_t channel_mask = 0;
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX] = {};
+    for (size_t i = 0; i < count; i++) {
+        channel_mask |= static_cast<uint16_t>(1u << channels[i]);
+        pattern[i].atten = attenuation_;
+        pattern[i].channel = channels[i];
+        pattern[i].unit = 0;  // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_init_config_t init_config = {};
+    init_config.max_store_buf_size = DMA_POOL_BYTES;
+    init_config.conv_num_each_intr = DMA_FRAME_BYTES;
+    init_config.adc1_chan_mask = channel_mask;
+    init_config.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init_config) != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "adc_digi_initialize failed");
+        return false;
+    }
+
+    adc_digi_configuration_t digi_config = {};
+    digi_config.conv_limit_en = 1;  // Required on the original ESP32
+    digi_config.conv_limit_num = 250;
+    digi_config.pattern_num = count;
+    digi_config.adc_pattern = pattern;
+    digi_config.sample_freq_hz = sample_rate_hz;
+    digi_config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digi_config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&digi_config) != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "adc_digi_controller_configure failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    if (adc_digi_start() != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "adc_digi_start failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    running_ = true;
+    ESP_LOGI(LOG_TAG, "Scanning %u channel(s) at %u Hz",
+             static_cast<unsigned>(count), static_cast<unsigned>(sample_rate_hz));
+    return true;
+}
+
+void Esp32ContinuousAdcSource::pause() {
+    if (running_ && !paused_) {
+        adc_digi_stop();
+        paused_ = true;
+    }
+}
+
+void Esp32ContinuousAdcSource::resume() {
+    if (running_ && paused_) {
+        adc_digi_start();
+        paused_ = false;
+    }
+}
+
+size_t Esp32ContinuousAdcSource::read(AdcSample* out, size_t max_samples) {
+    if (!running_ || max_samples == 0) {
+        return 0;
+    }
+
+    // The driver hands out at most one DMA frame per call, so keep going
+    // until the caller's buffer is full or the pool is empty
+    size_t produced = 0;
+    while (produced < max_samples) {
+        size_t want_bytes = (max_samples - produced) * SOC_ADC_DIGI_RESULT_BYTES;
+        if (want_bytes > DMA_FRAME_BYTES) {
+            want_bytes = DMA_FRAME_BYTES;
+        }
+        
+        uint32_t got_bytes = 0;
+        esp_err_t err = adc_digi_read_bytes(frame_, want_bytes, &got_bytes, 0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            // Pool overflowed since the last drain; the data returned is still valid
+            overflows_++;
+        } else if (err != ESP_OK) {
+            break;
+        }
+        if (got_bytes == 0) {
+            break;
+        }
+        
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= got_bytes;
+             i += SOC_ADC_DIGI_RESULT_BYTES) {
+            const adc_digi_output_data_t* result =
+                reinterpret_cast<const adc_digi_output_data_t*>(&frame_[i]);
+            out[produced].channel = result->type1.channel;
+            out[produced].raw = result->type1.data;
+            produced++;
+        }
+    }
+    return produced;
+}
+
+float Esp32ContinuousAdcSource::toMillivolts(float raw) const {
+    // The eFuse-calibrated curve is integer-only; interpolate between codes
+    // to keep the extra resolution gained by oversampling.
+    const uint32_t code = static_cast<uint32_t>(raw);
+    const float fraction = raw - static_cast<float>(code);
+    const uint32_t lo = esp_adc_cal_raw_to_voltage(code, &characteristics_);
+    const uint32_t hi = esp_adc_cal_raw_to_voltage(code + 1, &characteristics_);
+    return static_cast<float>(lo) + fraction * static_cast<float>(hi - lo);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,125 @@
+#include "esp32_spi_device_bus.h"
+
+#include <cstring>
+
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+namespace BoatEngine {
+
+static const char* LOG_TAG = "SpiDeviceBus";
+
+constexpr size_t Esp32SpiDeviceBus::MAX_DEVICES;
+constexpr size_t Esp32SpiDeviceBus::QUEUE_DEPTH;
+constexpr int Esp32SpiDeviceBus::MAX_TRANSFER_BYTES;
+
+Esp32SpiDeviceBus::Esp32SpiDeviceBus(spi_host_device_t host, int sclk_pin,
+                                     int miso_pin, int mosi_pin)
+    : host_(host)
+    , sclk_pin_(sclk_pin)
+    , miso_pin_(miso_pin)
+    , mosi_pin_(mosi_pin)
+    , initialized_(false)
+    , device_count_(0)
+    , next_collect_(0) {
+    memset(in_use_, 0, sizeof(in_use_));
+}
+
+Esp32SpiDeviceBus::~Esp32SpiDeviceBus() {
+    for (size_t i = 0; i < device_count_; i++) {
+        spi_bus_remove_device(devices_[i]);
+    }
+    if (initialized_) {
+        spi_bus_free(host_);
+    }
+}
+
+bool Esp32SpiDeviceBus::begin() {
+    spi_bus_config_t bus_config = {};
+    bus_config.sclk_io_num = sclk_pin_;
+    bus_config.miso_io_num = miso_pin_;
+    bus_config.mosi_io_num = mosi_pin_;
+    bus_config.quadwp_io_num = -1;
+    bus_config.quadhd_io_num = -1;
+    bus_config.max_transfer_sz = MAX_TRANSFER_BYTES;
+    const esp_err_t err = spi_bus_initialize(host_, &bus_config, SPI_DMA_CH_AUTO);
+    if (err != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "spi_bus_initialize failed: %d", err);
+        return false;
+    }
+    // An absent or unpowered chip then reads all ones, which the codecs
+    // report as no response, rather than a floating line reading as 0 C
+    gpio_set_pull_mode(static_cast<gpio_num_t>(miso_pin_), GPIO_PULLUP_ONLY);
+    initialized_ = true;
+    return true;
+}
+
+int Esp32SpiDeviceBus::addDevice(uint8_t cs_pin, uint8_t mode, uint32_t clock_hz) {
+    if (!initialized_ || device_count_ == MAX_DEVICES) {
+        return -1;
+    }
+    spi_device_interface_config_t device_config = {};
+    device_config.mode = mode;
+    device_config.clock_speed_hz = static_cast<int>(clock_hz);
+    device_config.spics_io_num = cs_pin;
+    device_config.queue_size = QUEUE_DEPTH;
+    if (spi_bus_add_device(host_, &device_config, &devices_[device_count_]) != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "Cannot add SPI device on CS %u", cs_pin);
+        return -1;
+    }
+    return static_cast<int>(device_count_++);
+}
+
+bool Esp32SpiDeviceBus::queue(int device, const uint8_t* tx, uint8_t* rx, size_t length) {
+    if (device < 0 || static_cast<size_t>(device) >= device_count_ ||
+        length > static_cast<size_t>(MAX_TRANSFER_BYTES)) {
+        return false;
+    }
+    for (size_t slot = 0; slot < QUEUE_DEPTH; slot++) {
+        if (in_use_[device][slot]) {
+            continue;
+        }
+        spi_transaction_t& transaction = transactions_[device][slot];
+        memset(&transaction, 0, sizeof(transaction));
+        transaction.length = length * 8;
+        transaction.tx_buffer = tx;
+        transaction.rx_buffer = rx;
+        transaction.user = reinterpret_cast<void*>(slot);
+        // Zero ticks: fail rather than wait if the driver queue is full
+        if (spi_device_queue_trans(devices_[device], &transaction, 0) != ESP_OK) {
+            return false;
+        }
+        in_use_[device][slot] = true;
+        return true;
+    }
+    return false;
+}
+
+bool Esp32SpiDeviceBus::collect(Completion* completion) {
+    for (size_t i = 0; i < device_count_; i++) {
+        const size_t device = (next_collect_ + i) % device_count_;
+        spi_transaction_t* transaction;
+        if (spi_device_get_trans_result(devices_[device], &transaction, 0) != ESP_OK) {
+            continue;
+        }
+        in_use_[device][reinterpret_cast<size_t>(transaction->user)] = false;
+        completion->device = static_cast<int>(device);
+        completion->rx = static_cast<uint8_t*>(transaction->rx_buffer);
+        next_collect_ = (device + 1) % device_count_;
+        return true;
+    }
+    return false;
+}
+
+uint8_t* Esp32SpiDeviceBus::allocateBuffer(size_t length) {
+    // DMA-capable internal RAM; heap blocks are always word aligned, so the
+    // driver needs no bounce buffer for transfers of whole words
+    return static_cast<uint8_t*>(heap_caps_calloc(1, length, MALLOC_CAP_DMA));
+}
+
+void Esp32SpiDeviceBus::freeBuffer(uint8_t* buffer) {
+    heap_caps_free(buffer);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,28 @@
+#include "fuel_consumption.h"
+
+namespace BoatEngine {
+
+constexpr float FuelConsumptionCalculator::MIN_SPEED_MS;
+constexpr float FuelConsumptionCalculator::METERS_PER_NAUTICAL_MILE;
+
+FuelConsumptionCalculator::FuelConsumptionCalculator()
+    : supply_(0.0f)
+    , return_(0.0f)
+    , speed_(0.0f) {
+}
+
+float FuelConsumptionCalculator::getNetFlow() const {
+    const float net = supply_ - return_;
+    // A negative difference is meter mismatch, not fuel being made
+    return net > 0.0f ? net : 0.0f;
+}
+
+bool FuelConsumptionCalculator::getConsumptionPerDistance(float* value) const {
+    if (!(speed_ >= MIN_SPEED_MS)) {
+        return false;
+    }
+    *value = getNetFlow() / speed_;
+    return true;
+}
+
+} // namespace BoatEngine
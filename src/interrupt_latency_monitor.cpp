@@ -0,0 +1,52 @@
+#include "interrupt_latency_monitor.h"
+
+#include <Arduino.h>
+#include <hal/cpu_hal.h>
+
+#include "sensesp.h"
+
+namespace BoatEngine {
+
+// Only one hardware timer ISR without an argument exists, so its state
+// lives at file scope
+static volatile uint32_t last_ccount = 0;
+static volatile uint32_t max_late_cycles = 0;
+static uint32_t period_cycles = 0;
+
+void IRAM_ATTR InterruptLatencyMonitor::onTimer() {
+    const uint32_t now = cpu_hal_get_cycle_count();
+    const uint32_t gap = now - last_ccount;
+    last_ccount = now;
+    if (gap > period_cycles && gap - period_cycles > max_late_cycles) {
+        max_late_cycles = gap - period_cycles;
+    }
+}
+
+InterruptLatencyMonitor::InterruptLatencyMonitor(uint32_t period_us)
+    : period_us_(period_us)
+    , output_(nullptr) {
+}
+
+void InterruptLatencyMonitor::start(const char* sk_path, unsigned int report_ms) {
+    period_cycles = period_us_ * getCpuFrequencyMhz();
+    last_ccount = cpu_hal_get_cycle_count();
+    
+    // Timer 0 at 1 MHz; the interrupt is allocated on the calling core
+    hw_timer_t* timer = timerBegin(0, 80, true);
+    timerAttachInterrupt(timer, &InterruptLatencyMonitor::onTimer, true);
+    timerAlarmWrite(timer, period_us_, true);
+    timerAlarmEnable(timer);
+    
+    output_ = new sensesp::SKOutputFloat(sk_path);
+    sensesp::event_loop()->onRepeat(report_ms, [this]() {
+        output_->set(takeMaxLatencyUs() / 1.0e6f);  // s
+    });
+}
+
+uint32_t InterruptLatencyMonitor::takeMaxLatencyUs() {
+    const uint32_t late = max_late_cycles;
+    max_late_cycles = 0;
+    return late / getCpuFrequencyMhz();
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,123 @@
+#include "lis3dh_accelerometer.h"
+
+namespace BoatEngine {
+
+constexpr size_t Lis3dhAccelerometer::FIFO_DEPTH;
+constexpr size_t Lis3dhAccelerometer::SAMPLE_BYTES;
+constexpr size_t Lis3dhAccelerometer::MAX_BURST_SAMPLES;
+
+// Normal and high-resolution rates by ODR code; 8 and above 9 are
+// low-power only
+static const uint16_t RATE_BY_CODE[10] = {0, 1, 10, 25, 50, 100, 200, 400, 0, 1344};
+
+// High-resolution sensitivity by FS code, g per 12-bit count
+static const float G_PER_COUNT[4] = {0.001f, 0.002f, 0.004f, 0.012f};
+
+Lis3dhAccelerometer::Lis3dhAccelerometer(RegisterBus* bus, uint16_t rate_hz,
+                                         uint8_t range_g)
+    : bus_(bus)
+    , rate_code_(rateCode(rate_hz, &rate_hz_))
+    , range_code_(rangeCode(range_g, &g_per_count_))
+    , bus_errors_(0) {
+}
+
+uint8_t Lis3dhAccelerometer::rateCode(uint16_t rate_hz, uint16_t* actual_hz) {
+    for (uint8_t code = 1; code < 10; code++) {
+        if (RATE_BY_CODE[code] != 0 && RATE_BY_CODE[code] >= rate_hz) {
+            *actual_hz = RATE_BY_CODE[code];
+            return code;
+        }
+    }
+    *actual_hz = RATE_BY_CODE[9];
+    return 9;
+}
+
+uint16_t Lis3dhAccelerometer::rateForCode(uint8_t code) {
+    return code < 10 ? RATE_BY_CODE[code] : 0;
+}
+
+uint8_t Lis3dhAccelerometer::rangeCode(uint8_t range_g, float* g_per_count) {
+    uint8_t code = 3;
+    if (range_g <= 2) {
+        code = 0;
+    } else if (range_g <= 4) {
+        code = 1;
+    } else if (range_g <= 8) {
+        code = 2;
+    }
+    *g_per_count = G_PER_COUNT[code];
+    return code;
+}
+
+AccelSample Lis3dhAccelerometer::decodeSample(const uint8_t* bytes) {
+    // Left-justified: the low four bits are not part of the value
+    AccelSample sample;
+    sample.x = static_cast<int16_t>(static_cast<int16_t>(bytes[0] | (bytes[1] << 8)) / 16);
+    sample.y = static_cast<int16_t>(static_cast<int16_t>(bytes[2] | (bytes[3] << 8)) / 16);
+    sample.z = static_cast<int16_t>(static_cast<int16_t>(bytes[4] | (bytes[5] << 8)) / 16);
+    return sample;
+}
+
+void Lis3dhAccelerometer::encodeSample(const AccelSample& sample, uint8_t* bytes) {
+    const int16_t values[3] = {sample.x, sample.y, sample.z};
+    for (size_t i = 0; i < 3; i++) {
+        const uint16_t raw = static_cast<uint16_t>(values[i] * 16);
+        bytes[i * 2] = static_cast<uint8_t>(raw & 0xFF);
+        bytes[i * 2 + 1] = static_cast<uint8_t>(raw >> 8);
+    }
+}
+
+bool Lis3dhAccelerometer::begin() {
+    uint8_t id = 0;
+    if (!bus_->readRegisters(WHO_AM_I, &id, 1) || id != WHO_AM_I_VALUE) {
+        return false;
+    }
+    // Bypass first empties the FIFO, then stream starts filling it
+    return bus_->writeRegister(CTRL_REG1, static_cast<uint8_t>(rate_code_ << 4) | AXES_ENABLED) &&
+           bus_->writeRegister(CTRL_REG4, static_cast<uint8_t>(range_code_ << 4) |
+                                              HIGH_RESOLUTION) &&
+           bus_->writeRegister(CTRL_REG5, FIFO_ENABLE) &&
+           bus_->writeRegister(FIFO_CTRL_REG, 0) &&
+           bus_->writeRegister(FIFO_CTRL_REG, FIFO_STREAM);
+}
+
+size_t Lis3dhAccelerometer::readFifo(AccelSample* out, size_t max, bool* overrun) {
+    *overrun = false;
+    uint8_t source = 0;
+    if (!bus_->readRegisters(FIFO_SRC_REG, &source, 1)) {
+        bus_errors_++;
+        return 0;
+    }
+    size_t waiting = source & FIFO_COUNT_MASK;
+    if (source & FIFO_FULL) {
+        waiting = FIFO_DEPTH;
+        *overrun = true;
+    } else if (source & FIFO_EMPTY) {
+        waiting = 0;
+    }
+    if (waiting > max) {
+        waiting = max;
+    }
+    
+    uint8_t bytes[MAX_BURST_SAMPLES * SAMPLE_BYTES];
+    size_t taken = 0;
+    while (taken < waiting) {
+        size_t burst = waiting - taken;
+        if (burst > MAX_BURST_SAMPLES) {
+            burst = MAX_BURST_SAMPLES;
+        }
+        if (!bus_->readRegisters(OUT_X_L | AUTO_INCREMENT, bytes, burst * SAMPLE_BYTES)) {
+            // Unknown how many were popped: the next samples may not follow on
+            bus_errors_++;
+            *overrun = true;
+            break;
+        }
+        for (size_t i = 0; i < burst; i++) {
+            out[taken + i] = decodeSample(&bytes[i * SAMPLE_BYTES]);
+        }
+        taken += burst;
+    }
+    return taken;
+}
+
+} // namespace BoatEngine
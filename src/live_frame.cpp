@@ -0,0 +1,56 @@
+#include "live_frame.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr size_t LiveFrame::MAX_FIELDS;
+constexpr size_t LiveFrame::FIELD_WIDTH;
+constexpr size_t LiveFrame::MAX_SIZE;
+
+LiveFrame::LiveFrame()
+    : field_count_(0) {
+    memcpy(buffer_, "data: \n\n", 8);
+    size_ = 8;
+}
+
+int LiveFrame::addField(uint8_t decimals) {
+    if (field_count_ == MAX_FIELDS) {
+        return -1;
+    }
+    const size_t index = field_count_++;
+    decimals_[index] = decimals;
+    
+    // Slots are followed by ',' and the last by the blank line
+    char* field = slot(index);
+    if (index > 0) {
+        field[-1] = ',';
+    }
+    memcpy(field + FIELD_WIDTH, "\n\n", 2);
+    size_ = (field - buffer_) + FIELD_WIDTH + 2;
+    set(index, NAN);
+    return static_cast<int>(index);
+}
+
+void LiveFrame::set(size_t index, float value) {
+    if (index >= field_count_) {
+        return;
+    }
+    char text[24];
+    int length = -1;
+    if (std::isfinite(value)) {
+        length = snprintf(text, sizeof(text), "%.*f", decimals_[index], value);
+    }
+    if (length < 0 || static_cast<size_t>(length) > FIELD_WIDTH) {
+        text[0] = '-';
+        length = 1;
+    }
+    
+    char* field = slot(index);
+    memset(field, ' ', FIELD_WIDTH - length);
+    memcpy(field + FIELD_WIDTH - length, text, length);
+}
+
+} // namespace BoatEngine
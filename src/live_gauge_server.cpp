@@ -0,0 +1,181 @@
+#include "live_gauge_server.h"
+
+#include <cstring>
+
+#include <lwip/sockets.h>
+
+#include "sensesp.h"
+#include "sensesp/system/lambda_consumer.h"
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+constexpr size_t LiveGaugeServer::MAX_CLIENTS;
+constexpr unsigned int LiveGaugeServer::SEND_TIMEOUT_MS;
+
+static const char PAGE_HEAD[] =
+    "<!DOCTYPE html><html><head><meta charset=\"utf-8\">"
+    "<meta name=\"viewport\" content=\"width=device-width,initial-scale=1\">"
+    "<title>Engine</title><style>"
+    "body{margin:0;padding:8px;background:#000;color:#fff;font-family:sans-serif}"
+    ".g{display:inline-block;box-sizing:border-box;width:48%;margin:1%;padding:8px;"
+    "border:1px solid #444;border-radius:8px;text-align:center}"
+    ".g b{display:block;font-size:2.5em}.g small{color:#aaa}#s{color:#f80}"
+    "</style></head><body><div id=\"s\">Connecting</div>";
+
+// Each event is the frame: values in gauge order, separated by commas
+static const char PAGE_SCRIPT[] =
+    "<script>var s=document.getElementById('s'),e=new EventSource('%s');"
+    "e.onmessage=function(m){m.data.split(',').forEach(function(v,i){"
+    "document.getElementById('v'+i).textContent=v.trim()});s.textContent=''};"
+    "e.onerror=function(){s.textContent='Reconnecting'};</script></body></html>";
+
+static const char STREAM_HEADER[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "\r\n"
+    "retry: 2000\n\n";
+
+// Labels come from the sensor topology, which anyone on the network can edit
+static String htmlEscape(const char* text) {
+    String escaped;
+    for (const char* c = text; *c != '\0'; c++) {
+        switch (*c) {
+            case '&': escaped += "&amp;"; break;
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '"': escaped += "&quot;"; break;
+            case '\'': escaped += "&#39;"; break;
+            default: escaped += *c; break;
+        }
+    }
+    return escaped;
+}
+
+LiveGaugeServer::LiveGaugeServer()
+    : frame_lock_(xSemaphoreCreateMutex())
+    , server_(nullptr)
+    , open_clients_(0)
+    , send_queued_(false) {
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        clients_[i] = Client{this, -1};
+    }
+    page_ = PAGE_HEAD;
+}
+
+bool LiveGaugeServer::addGauge(ValueProducer<float>* source, const char* label,
+                               const char* unit, float scale, float offset,
+                               uint8_t decimals) {
+    const int index = frame_.addField(decimals);
+    if (index < 0) {
+        ESP_LOGW("LiveGaugeServer", "No room for gauge %s", label);
+        return false;
+    }
+    page_ += String("<div class=\"g\"><b id=\"v") + String(index) + "\">-</b><small>" +
+             htmlEscape(label) + " (" + htmlEscape(unit) + ")</small></div>";
+    
+    source->connect_to(new LambdaConsumer<float>(
+        [this, index, scale, offset](float value) {
+            xSemaphoreTake(frame_lock_, portMAX_DELAY);
+            frame_.set(index, value * scale + offset);
+            xSemaphoreGive(frame_lock_);
+            queueSend();
+        }));
+    return true;
+}
+
+void LiveGaugeServer::start(const char* page_path, const char* events_path,
+                            unsigned int refresh_ms) {
+    char script[sizeof(PAGE_SCRIPT) + 64];
+    snprintf(script, sizeof(script), PAGE_SCRIPT, events_path);
+    page_ += script;
+    
+    auto page = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, page_path,
+        [this](httpd_req_t* req) {
+            httpd_resp_set_type(req, "text/html");
+            return httpd_resp_send(req, page_.c_str(), page_.length());
+        });
+    sensesp_app->get_http_server()->add_handler(page);
+    
+    auto events = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, events_path,
+        [this](httpd_req_t* req) { return this->openStream(req); });
+    sensesp_app->get_http_server()->add_handler(events);
+    
+    event_loop()->onRepeat(refresh_ms, [this]() { this->queueSend(); });
+}
+
+esp_err_t LiveGaugeServer::openStream(httpd_req_t* req) {
+    Client* client = nullptr;
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients_[i].fd < 0) {
+            client = &clients_[i];
+            break;
+        }
+    }
+    if (client == nullptr) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "Too many gauge pages open");
+    }
+    
+    // The response never ends: headers go out by hand and the socket is
+    // kept for the frames
+    if (httpd_send(req, STREAM_HEADER, sizeof(STREAM_HEADER) - 1) < 0) {
+        return ESP_FAIL;
+    }
+    const int fd = httpd_req_to_sockfd(req);
+    // A phone that stops reading must not hold up the server task
+    struct timeval timeout = {0, SEND_TIMEOUT_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    server_ = req->handle;
+    client->fd = fd;
+    open_clients_++;
+    // Called by the server when the session closes, whichever end closed it
+    req->sess_ctx = client;
+    req->free_ctx = closeClient;
+    ESP_LOGI("LiveGaugeServer", "Gauge stream opened, %d open", open_clients_.load());
+    
+    queueSend();
+    return ESP_OK;
+}
+
+void LiveGaugeServer::closeClient(void* ctx) {
+    Client* client = static_cast<Client*>(ctx);
+    client->fd = -1;
+    client->owner->open_clients_--;
+}
+
+void LiveGaugeServer::queueSend() {
+    if (open_clients_ == 0 || send_queued_.exchange(true)) {
+        return;
+    }
+    if (httpd_queue_work(server_, sendFrame, this) != ESP_OK) {
+        send_queued_ = false;
+    }
+}
+
+void LiveGaugeServer::sendFrame(void* arg) {
+    LiveGaugeServer* self = static_cast<LiveGaugeServer*>(arg);
+    // Cleared first, so a sample arriving during the send queues another
+    self->send_queued_ = false;
+    
+    xSemaphoreTake(self->frame_lock_, portMAX_DELAY);
+    const size_t size = self->frame_.size();
+    memcpy(self->sending_, self->frame_.data(), size);
+    xSemaphoreGive(self->frame_lock_);
+    
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        const int fd = self->clients_[i].fd;
+        if (fd >= 0 && httpd_socket_send(self->server_, fd, self->sending_, size, 0) !=
+                static_cast<int>(size)) {
+            httpd_sess_trigger_close(self->server_, fd);
+        }
+    }
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,186 @@
+#include "load_profile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr size_t LoadProfile::MAX_HISTOGRAMS;
+constexpr size_t LoadProfile::MAX_NAME;
+constexpr uint8_t LoadProfile::VERSION;
+
+static const uint8_t MAGIC[4] = {'B', 'E', 'L', 'P'};
+static const size_t HEADER_SIZE = sizeof(MAGIC) + 2;
+static const size_t LAYOUT_SIZE = 4 + 4 + 1;
+
+static void putU32(uint8_t* out, uint32_t value) {
+    for (size_t i = 0; i < 4; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static uint32_t getU32(const uint8_t* data) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+static void putFloat(uint8_t* out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU32(out, bits);
+}
+
+static float getFloat(const uint8_t* data) {
+    const uint32_t bits = getU32(data);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static size_t nameLength(const char* name) {
+    const size_t length = strlen(name);
+    return length > LoadProfile::MAX_NAME ? LoadProfile::MAX_NAME : length;
+}
+
+LoadProfile::LoadProfile()
+    : count_(0)
+    , saved_seconds_(0) {
+}
+
+int LoadProfile::add(const char* name, const DurationHistogram::Layout& layout,
+                     uint32_t max_gap_ms) {
+    if (count_ >= MAX_HISTOGRAMS || !DurationHistogram::isValid(layout)) {
+        return -1;
+    }
+    names_[count_] = name;
+    histograms_[count_] = DurationHistogram(layout, max_gap_ms);
+    return static_cast<int>(count_++);
+}
+
+size_t LoadProfile::serializedSize() const {
+    size_t size = HEADER_SIZE;
+    for (size_t i = 0; i < count_; i++) {
+        size += 1 + nameLength(names_[i]) + LAYOUT_SIZE + 4 * histograms_[i].getBinCount();
+    }
+    return size;
+}
+
+size_t LoadProfile::serialize(uint8_t* out, size_t size) const {
+    if (size < serializedSize()) {
+        return 0;
+    }
+    size_t pos = 0;
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    pos += sizeof(MAGIC);
+    out[pos++] = VERSION;
+    out[pos++] = static_cast<uint8_t>(count_);
+    
+    for (size_t i = 0; i < count_; i++) {
+        const DurationHistogram& histogram = histograms_[i];
+        const size_t length = nameLength(names_[i]);
+        out[pos++] = static_cast<uint8_t>(length);
+        memcpy(&out[pos], names_[i], length);
+        pos += length;
+        putFloat(&out[pos], histogram.getLayout().lower);
+        putFloat(&out[pos + 4], histogram.getLayout().width);
+        out[pos + 8] = histogram.getLayout().bins;
+        pos += LAYOUT_SIZE;
+        for (size_t bin = 0; bin < histogram.getBinCount(); bin++) {
+            putU32(&out[pos], histogram.getSeconds(bin));
+            pos += 4;
+        }
+    }
+    return pos;
+}
+
+size_t LoadProfile::restore(const uint8_t* data, size_t size) {
+    if (size < HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+        data[sizeof(MAGIC)] != VERSION) {
+        return 0;
+    }
+    const size_t saved = data[sizeof(MAGIC) + 1];
+    size_t pos = HEADER_SIZE;
+    size_t restored = 0;
+    
+    for (size_t s = 0; s < saved; s++) {
+        if (pos + 1 > size) {
+            break;
+        }
+        const size_t length = data[pos++];
+        if (pos + length + LAYOUT_SIZE > size) {
+            break;
+        }
+        const char* name = reinterpret_cast<const char*>(&data[pos]);
+        pos += length;
+        DurationHistogram::Layout layout;
+        layout.lower = getFloat(&data[pos]);
+        layout.width = getFloat(&data[pos + 4]);
+        layout.bins = data[pos + 8];
+        pos += LAYOUT_SIZE;
+        const size_t bins = static_cast<size_t>(layout.bins) + 2;
+        if (pos + 4 * bins > size) {
+            break;
+        }
+        
+        for (size_t i = 0; i < count_; i++) {
+            const DurationHistogram::Layout& current = histograms_[i].getLayout();
+            if (nameLength(names_[i]) != length || memcmp(names_[i], name, length) != 0 ||
+                current.lower != layout.lower || current.width != layout.width ||
+                current.bins != layout.bins) {
+                continue;
+            }
+            for (size_t bin = 0; bin < bins; bin++) {
+                histograms_[i].setSeconds(bin, getU32(&data[pos + 4 * bin]));
+            }
+            restored++;
+            break;
+        }
+        pos += 4 * bins;
+    }
+    markSaved();
+    return restored;
+}
+
+const char* LoadProfile::csvHeader() {
+    return "histogram,from,to,seconds\n";
+}
+
+int LoadProfile::formatCsvRow(size_t index, size_t bin, char* out, size_t size) const {
+    const DurationHistogram& histogram = histograms_[index];
+    char from[16] = "";
+    char to[16] = "";
+    const float lower = histogram.getBinLower(bin);
+    const float upper = histogram.getBinUpper(bin);
+    if (!std::isinf(lower)) {
+        snprintf(from, sizeof(from), "%g", lower);
+    }
+    if (!std::isinf(upper)) {
+        snprintf(to, sizeof(to), "%g", upper);
+    }
+    return snprintf(out, size, "%s,%s,%s,%lu\n", names_[index], from, to,
+                    static_cast<unsigned long>(histogram.getSeconds(bin)));
+}
+
+static uint64_t totalSeconds(const DurationHistogram* histograms, size_t count) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t bin = 0; bin < histograms[i].getBinCount(); bin++) {
+            total += histograms[i].getSeconds(bin);
+        }
+    }
+    return total;
+}
+
+bool LoadProfile::hasChanged() const {
+    return totalSeconds(histograms_, count_) != saved_seconds_;
+}
+
+void LoadProfile::markSaved() {
+    saved_seconds_ = totalSeconds(histograms_, count_);
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,137 @@
+#include "load_profile_manager.h"
+
+#include <SPIFFS.h>
+
+#include "sensesp/net/http_server.h"
+#include "sensesp/system/lambda_consumer.h"
+#include "sensesp_app.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+// Written first and renamed over LOAD_PROFILE_FILE
+static String temporaryPath() {
+    return String(BoatSensorConfig::LOAD_PROFILE_FILE) + ".tmp";
+}
+
+LoadProfileManager::LoadProfileManager()
+    : profile_lock_(xSemaphoreCreateMutex()) {
+}
+
+bool LoadProfileManager::addInput(const char* name, const DurationHistogram::Layout& layout,
+                                  ValueProducer<float>* source, float scale, float offset) {
+    const int index = profile_.add(name, layout, BoatSensorConfig::LOAD_PROFILE_MAX_GAP_MS);
+    if (index < 0) {
+        ESP_LOGE("LoadProfileManager", "Cannot add %s", name);
+        return false;
+    }
+    DurationHistogram* histogram = &profile_.get(static_cast<size_t>(index));
+    source->connect_to(new LambdaConsumer<float>(
+        [this, histogram, scale, offset](float value) {
+            xSemaphoreTake(profile_lock_, portMAX_DELAY);
+            histogram->update(value * scale + offset, millis());
+            xSemaphoreGive(profile_lock_);
+        }));
+    return true;
+}
+
+void LoadProfileManager::start() {
+    buffer_.resize(profile_.serializedSize());
+    restore();
+    serve();
+    event_loop()->onRepeat(BoatSensorConfig::LOAD_PROFILE_SAVE_MS, [this]() { this->save(); });
+}
+
+void LoadProfileManager::restore() {
+    fs::File file = SPIFFS.open(BoatSensorConfig::LOAD_PROFILE_FILE, FILE_READ);
+    if (!file) {
+        // A reset between removing the old file and renaming the new one
+        // leaves only the complete temporary file
+        file = SPIFFS.open(temporaryPath(), FILE_READ);
+        if (!file) {
+            ESP_LOGI("LoadProfileManager", "No saved load profile");
+            return;
+        }
+        ESP_LOGW("LoadProfileManager", "Restoring from %s", temporaryPath().c_str());
+    }
+    // A file from an older layout may be longer; read what fits
+    const size_t size = file.read(buffer_.data(), buffer_.size());
+    file.close();
+    const size_t restored = profile_.restore(buffer_.data(), size);
+    ESP_LOGI("LoadProfileManager", "Restored %u of %u histograms",
+             static_cast<unsigned>(restored), static_cast<unsigned>(profile_.getCount()));
+}
+
+void LoadProfileManager::save() {
+    if (!profile_.hasChanged()) {
+        return;
+    }
+    const size_t size = profile_.serialize(buffer_.data(), buffer_.size());
+    
+    // Write beside the old file and swap, so a reset mid-write keeps the
+    // previous totals, and a reset mid-swap the new ones (see restore())
+    const String temporary = temporaryPath();
+    fs::File file = SPIFFS.open(temporary, FILE_WRITE);
+    if (!file || file.write(buffer_.data(), size) != size) {
+        ESP_LOGE("LoadProfileManager", "Cannot write %s", temporary.c_str());
+        return;
+    }
+    file.close();
+    SPIFFS.remove(BoatSensorConfig::LOAD_PROFILE_FILE);
+    if (!SPIFFS.rename(temporary, BoatSensorConfig::LOAD_PROFILE_FILE)) {
+        ESP_LOGE("LoadProfileManager", "Cannot replace %s", BoatSensorConfig::LOAD_PROFILE_FILE);
+        return;
+    }
+    profile_.markSaved();
+}
+
+std::unique_ptr<LoadProfile> LoadProfileManager::snapshot() {
+    xSemaphoreTake(profile_lock_, portMAX_DELAY);
+    std::unique_ptr<LoadProfile> copy(new LoadProfile(profile_));
+    xSemaphoreGive(profile_lock_);
+    return copy;
+}
+
+void LoadProfileManager::serve() {
+    auto csv = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, BoatSensorConfig::LOAD_PROFILE_CSV_HTTP_PATH,
+        [this](httpd_req_t* req) {
+            // Runs on the httpd task; send from a copy rather than hold
+            // the lock for the whole response
+            const std::unique_ptr<LoadProfile> profile = snapshot();
+            httpd_resp_set_type(req, "text/csv");
+            if (httpd_resp_send_chunk(req, LoadProfile::csvHeader(), HTTPD_RESP_USE_STRLEN) !=
+                ESP_OK) {
+                return ESP_FAIL;
+            }
+            char row[80];
+            for (size_t i = 0; i < profile->getCount(); i++) {
+                for (size_t bin = 0; bin < profile->get(i).getBinCount(); bin++) {
+                    profile->formatCsvRow(i, bin, row, sizeof(row));
+                    if (httpd_resp_send_chunk(req, row, HTTPD_RESP_USE_STRLEN) != ESP_OK) {
+                        return ESP_FAIL;
+                    }
+                }
+            }
+            return httpd_resp_send_chunk(req, nullptr, 0);
+        });
+    sensesp_app->get_http_server()->add_handler(csv);
+    
+    auto binary = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, BoatSensorConfig::LOAD_PROFILE_BIN_HTTP_PATH,
+        [this](httpd_req_t* req) {
+            // Its own buffer: the save timer uses buffer_ on the other task
+            const std::unique_ptr<LoadProfile> profile = snapshot();
+            std::vector<uint8_t> data(profile->serializedSize());
+            const size_t size = profile->serialize(data.data(), data.size());
+            httpd_resp_set_type(req, "application/octet-stream");
+            httpd_resp_set_hdr(req, "Content-Disposition",
+                               "attachment; filename=\"loadProfile.bin\"");
+            return httpd_resp_send(req, reinterpret_cast<const char*>(data.data()), size);
+        });
+    sensesp_app->get_http_server()->add_handler(binary);
+}
+
+} // namespace BoatEngine
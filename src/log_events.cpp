@@ -0,0 +1,26 @@
+#include "log_events.h"
+
+#include <cstddef>
+
+namespace BoatEngine {
+
+static const char* const LOG_EVENT_FORMATS[] = {
+    "AcquisitionScheduler: %u ticks, peak %u us, %u tasks at most",
+    "MemoryMonitor: Heap free %u, minimum %u, largest block %u",
+    "CylinderBalanceManager: %u cycles at %.0f rpm, roughness %.4f, %u overruns",
+    "OneWireTemperatureChannel: Sensor %08x%08x invalid (status %d, %.2f C)",
+    "VibrationSensorManager: rms %.3f g, peak %.1f Hz at %.0f rpm, %u overruns",
+};
+
+static_assert(sizeof(LOG_EVENT_FORMATS) / sizeof(LOG_EVENT_FORMATS[0]) ==
+                  static_cast<size_t>(LogEvent::COUNT),
+              "One format per LogEvent");
+
+const char* logEventFormat(uint16_t event) {
+    if (event >= static_cast<uint16_t>(LogEvent::COUNT)) {
+        return nullptr;
+    }
+    return LOG_EVENT_FORMATS[event];
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,59 @@
+#include "memory_monitor.h"
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "deferred_log_manager.h"
+#include "sensesp.h"
+
+namespace BoatEngine {
+
+constexpr size_t MemoryMonitor::MAX_TASKS;
+
+MemoryMonitor::MemoryMonitor()
+    : free_heap_(nullptr)
+    , minimum_free_heap_(nullptr)
+    , largest_free_block_(nullptr)
+    , task_count_(0) {
+}
+
+void MemoryMonitor::start(const char* sk_prefix, const char* const* tasks,
+                          size_t task_count, unsigned int report_ms) {
+    const String prefix(sk_prefix);
+    free_heap_ = new sensesp::SKOutputInt(prefix + "freeHeap");
+    minimum_free_heap_ = new sensesp::SKOutputInt(prefix + "minimumFreeHeap");
+    largest_free_block_ = new sensesp::SKOutputInt(prefix + "largestFreeBlock");
+    
+    task_count_ = task_count < MAX_TASKS ? task_count : MAX_TASKS;
+    for (size_t i = 0; i < task_count_; i++) {
+        task_names_[i] = tasks[i];
+        stack_outputs_[i] = new sensesp::SKOutputInt(
+            prefix + "stackHighWaterMark." + tasks[i]);
+    }
+    
+    report();
+    sensesp::event_loop()->onRepeat(report_ms, [this]() { this->report(); });
+}
+
+void MemoryMonitor::report() {
+    const size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    const size_t minimum = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    const size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    free_heap_->set(static_cast<int>(free_heap));
+    minimum_free_heap_->set(static_cast<int>(minimum));
+    largest_free_block_->set(static_cast<int>(largest));
+    logDeferred(LogEvent::HEAP, free_heap, minimum, largest);
+    
+    for (size_t i = 0; i < task_count_; i++) {
+        // Looked up every time: the websocket task is recreated on reconnect
+        TaskHandle_t task = xTaskGetHandle(task_names_[i]);
+        if (task == nullptr) {
+            continue;
+        }
+        // Bytes on the ESP32, where the stack type is a byte
+        stack_outputs_[i]->set(static_cast<int>(uxTaskGetStackHighWaterMark(task)));
+    }
+}
+
+} // namespace BoatEngine
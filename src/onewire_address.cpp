@@ -0,0 +1,49 @@
+#include "onewire_address.h"
+
+#include <cstdio>
+
+namespace BoatEngine {
+
+void formatOneWireAddress(const OneWireAddress& address, char* out) {
+    snprintf(out, ONEWIRE_ADDRESS_STRING_SIZE,
+             "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+             address[0], address[1], address[2], address[3],
+             address[4], address[5], address[6], address[7]);
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool parseOneWireAddress(const char* text, OneWireAddress* address) {
+    OneWireAddress parsed;
+    for (size_t i = 0; i < parsed.size(); i++) {
+        const char* p = text + i * 3;
+        const int hi = hexValue(p[0]);
+        const int lo = hi < 0 ? -1 : hexValue(p[1]);
+        if (lo < 0) {
+            return false;
+        }
+        const char separator = p[2];
+        if (i + 1 < parsed.size() ? separator != ':' : separator != '\0') {
+            return false;
+        }
+        parsed[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    *address = parsed;
+    return true;
+}
+
+bool isNullOneWireAddress(const OneWireAddress& address) {
+    for (size_t i = 0; i < address.size(); i++) {
+        if (address[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace BoatEngine
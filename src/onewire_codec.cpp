@@ -0,0 +1,93 @@
+#include "onewire_codec.h"
+
+namespace BoatEngine {
+
+constexpr uint16_t OneWireCodec::RESET_LOW_US;
+constexpr uint16_t OneWireCodec::RESET_HIGH_US;
+constexpr uint16_t OneWireCodec::WRITE_1_LOW_US;
+constexpr uint16_t OneWireCodec::WRITE_1_HIGH_US;
+constexpr uint16_t OneWireCodec::WRITE_0_LOW_US;
+constexpr uint16_t OneWireCodec::WRITE_0_HIGH_US;
+constexpr uint16_t OneWireCodec::RESET_DETECT_US;
+constexpr uint16_t OneWireCodec::SAMPLE_US;
+
+size_t OneWireCodec::encode(bool reset, const uint8_t* tx, size_t bit_count,
+                            OneWireSymbol* out) {
+    size_t n = 0;
+    if (reset) {
+        out[n].low_us = RESET_LOW_US;
+        out[n].high_us = RESET_HIGH_US;
+        n++;
+    }
+    for (size_t i = 0; i < bit_count; i++) {
+        const bool one = (tx[i / 8] >> (i % 8)) & 1;
+        out[n].low_us = one ? WRITE_1_LOW_US : WRITE_0_LOW_US;
+        out[n].high_us = one ? WRITE_1_HIGH_US : WRITE_0_HIGH_US;
+        n++;
+    }
+    return n;
+}
+
+OneWireCodec::Decode OneWireCodec::decode(const uint16_t* lows_us, size_t count,
+                                          bool reset, size_t bit_count,
+                                          bool* presence, uint8_t* rx) {
+    size_t pos = 0;
+    *presence = false;
+    
+    if (reset) {
+        if (count == 0 || lows_us[0] < RESET_DETECT_US) {
+            return Decode::FRAMING_ERROR;
+        }
+        pos = 1;
+        // Any extra low between the reset and the slots is the presence pulse
+        if (count == bit_count + 2) {
+            *presence = true;
+            pos = 2;
+        }
+    }
+    if (count - pos != bit_count) {
+        return Decode::FRAMING_ERROR;
+    }
+    
+    for (size_t i = 0; i < (bit_count + 7) / 8; i++) {
+        rx[i] = 0;
+    }
+    for (size_t i = 0; i < bit_count; i++) {
+        const uint16_t low = lows_us[pos + i];
+        if (low >= RESET_DETECT_US) {
+            // Line held low for a whole slot: short to ground or a device
+            // stuck mid-transfer
+            return Decode::FRAMING_ERROR;
+        }
+        if (low <= SAMPLE_US) {
+            rx[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+    }
+    return Decode::OK;
+}
+
+uint32_t OneWireCodec::duration(const OneWireSymbol* symbols, size_t count) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += symbols[i].low_us + symbols[i].high_us;
+    }
+    return total;
+}
+
+uint8_t oneWireCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            const uint8_t mix = (crc ^ byte) & 0x01;
+            crc >>= 1;
+            if (mix) {
+                crc ^= 0x8C;
+            }
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
+
+} // namespace BoatEngine
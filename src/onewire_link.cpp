@@ -0,0 +1,52 @@
+#include "onewire_link.h"
+
+namespace BoatEngine {
+
+constexpr size_t OneWireLink::MAX_BYTES;
+constexpr size_t OneWireLink::MAX_BITS;
+constexpr size_t OneWireLink::MAX_LOWS;
+
+OneWireLink::OneWireLink()
+    : busy_(false)
+    , reset_(false)
+    , bit_count_(0) {
+}
+
+bool OneWireLink::start(bool reset, const uint8_t* tx, size_t bit_count) {
+    if (busy_ || bit_count > MAX_BITS || (!reset && bit_count == 0)) {
+        return false;
+    }
+    const size_t count = OneWireCodec::encode(reset, tx, bit_count, symbols_);
+    if (!transmit(symbols_, count)) {
+        return false;
+    }
+    busy_ = true;
+    reset_ = reset;
+    bit_count_ = bit_count;
+    return true;
+}
+
+OneWireLink::Status OneWireLink::poll(Result* result, uint32_t wait_ms) {
+    if (!busy_) {
+        return Status::TIMEOUT;
+    }
+    
+    size_t count = 0;
+    const Status status = capture(lows_, MAX_LOWS, &count, wait_ms);
+    if (status == Status::BUSY) {
+        return status;
+    }
+    busy_ = false;
+    if (status != Status::DONE) {
+        return status;
+    }
+    
+    if (OneWireCodec::decode(lows_, count, reset_, bit_count_,
+                             &result->presence, result->rx) !=
+        OneWireCodec::Decode::OK) {
+        return Status::FRAMING_ERROR;
+    }
+    return Status::DONE;
+}
+
+} // namespace BoatEngine
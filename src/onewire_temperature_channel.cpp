@@ -0,0 +1,88 @@
+#include "onewire_temperature_channel.h"
+
+#include <cmath>
+
+#include "deferred_log_manager.h"
+
+namespace BoatEngine {
+
+OneWireTemperatureChannel::OneWireTemperatureChannel(
+    TemperatureBus* bus, const TemperatureHealth::Limits& limits,
+    const String& config_path)
+    : sensesp::FloatSensor(config_path)
+    , bus_(bus)
+    , health_(limits)
+    , found_(false) {
+    address_.fill(0);
+    this->load();
+    
+    if (isNullOneWireAddress(address_)) {
+        // Previously unconfigured sensor: claim the next unassigned device
+        found_ = bus_->claimNextAddress(&address_);
+    } else {
+        found_ = bus_->registerAddress(address_);
+    }
+    
+    char address_str[ONEWIRE_ADDRESS_STRING_SIZE];
+    formatOneWireAddress(address_, address_str);
+    if (found_) {
+        ESP_LOGI("OneWireTemperatureChannel", "Using sensor %s", address_str);
+    } else {
+        ESP_LOGW("OneWireTemperatureChannel", "Sensor %s not found", address_str);
+    }
+}
+
+TemperatureHealth::Verdict OneWireTemperatureChannel::publish(
+    const TemperatureReading& reading, uint64_t acquired_ms) {
+    const TemperatureHealth::Verdict verdict = health_.assess(reading);
+    if (verdict == TemperatureHealth::Verdict::VALID ||
+        verdict == TemperatureHealth::Verdict::INVALID) {
+        stamp_.mark(acquired_ms);
+    }
+    if (verdict == TemperatureHealth::Verdict::VALID) {
+        this->emit(reading.celsius + 273.15f);
+    } else if (verdict == TemperatureHealth::Verdict::INVALID) {
+        // Repeats on every read while the sensor is bad, so keep it off the UART
+        const uint32_t high = (static_cast<uint32_t>(address_[0]) << 24) |
+                              (static_cast<uint32_t>(address_[1]) << 16) |
+                              (static_cast<uint32_t>(address_[2]) << 8) | address_[3];
+        const uint32_t low = (static_cast<uint32_t>(address_[4]) << 24) |
+                             (static_cast<uint32_t>(address_[5]) << 16) |
+                             (static_cast<uint32_t>(address_[6]) << 8) | address_[7];
+        logDeferred(LogEvent::TEMPERATURE_INVALID, high, low, static_cast<int>(reading.status),
+                    reading.celsius);
+        this->emit(NAN);
+    }
+    return verdict;
+}
+
+const char* OneWireTemperatureChannel::getStatusText() const {
+    if (!found_) {
+        return "notFound";
+    }
+    if (health_.getCounters().reads == 0) {
+        return "waiting";
+    }
+    return health_.isValid() ? "ok" : "invalid";
+}
+
+bool OneWireTemperatureChannel::to_json(JsonObject& root) {
+    char address_str[ONEWIRE_ADDRESS_STRING_SIZE];
+    formatOneWireAddress(address_, address_str);
+    root["address"] = address_str;
+    root["found"] = found_;
+    return true;
+}
+
+bool OneWireTemperatureChannel::from_json(const JsonObject& config) {
+    if (!config["address"].is<const char*>()) {
+        return false;
+    }
+    return parseOneWireAddress(config["address"].as<const char*>(), &address_);
+}
+
+const String ConfigSchema(const OneWireTemperatureChannel& obj) {
+    return R"###({"type":"object","properties":{"address":{"title":"OneWire address","description":"Sensor ROM code, e.g. 28:ff:64:1e:8d:16:04:3c","type":"string"},"found":{"title":"Sensor found","type":"boolean","readOnly":true}}})###";
+}
+
+} // namespace BoatEngine
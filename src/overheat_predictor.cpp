@@ -0,0 +1,75 @@
+#include "overheat_predictor.h"
+
+#include <cmath>
+
+namespace BoatEngine {
+
+OverheatPredictor::OverheatPredictor(const Settings& settings)
+    : settings_(settings)
+    , trend_(settings.window_ms)
+    , state_(State::NORMAL)
+    , rate_k_per_s_(0.0f)
+    , time_to_limit_s_(INFINITY) {
+}
+
+void OverheatPredictor::setSettings(const Settings& settings) {
+    settings_ = settings;
+    trend_.setWindow(settings.window_ms);
+}
+
+bool OverheatPredictor::update(float kelvin, uint32_t now_ms) {
+    if (std::isnan(kelvin)) {
+        trend_.reset();
+        rate_k_per_s_ = 0.0f;
+        time_to_limit_s_ = INFINITY;
+        return false;
+    }
+    trend_.add(kelvin, now_ms);
+    
+    float fitted = kelvin;
+    rate_k_per_s_ = 0.0f;
+    if (trend_.getCount() >= settings_.min_samples) {
+        trend_.getSlope(&rate_k_per_s_);
+        trend_.getFittedLatest(&fitted);
+    }
+    
+    // Project from the fitted value, which is less noisy than the reading
+    if (kelvin >= settings_.limit_k) {
+        time_to_limit_s_ = 0.0f;
+    } else if (rate_k_per_s_ >= settings_.min_rate_k_per_s && rate_k_per_s_ > 0.0f) {
+        const float remaining = settings_.limit_k - fitted;
+        time_to_limit_s_ = remaining > 0.0f ? remaining / rate_k_per_s_ : 0.0f;
+    } else {
+        time_to_limit_s_ = INFINITY;
+    }
+    
+    State next = state_;
+    if (kelvin >= settings_.limit_k) {
+        next = State::OVER_LIMIT;
+    } else if (state_ == State::OVER_LIMIT &&
+               kelvin > settings_.limit_k - settings_.limit_hysteresis_k) {
+        next = State::OVER_LIMIT;
+    } else if (time_to_limit_s_ < settings_.horizon_s) {
+        next = State::WARNING;
+    } else if (state_ == State::WARNING &&
+               time_to_limit_s_ < settings_.horizon_s * settings_.clear_factor) {
+        next = State::WARNING;
+    } else {
+        next = State::NORMAL;
+    }
+    
+    const bool changed = next != state_;
+    state_ = next;
+    return changed;
+}
+
+const char* OverheatPredictor::stateName(State state) {
+    switch (state) {
+        case State::NORMAL:     return "normal";
+        case State::WARNING:    return "warning";
+        case State::OVER_LIMIT: return "overLimit";
+    }
+    return "unknown";
+}
+
+} // namespace BoatEngine
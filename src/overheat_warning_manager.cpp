@@ -0,0 +1,129 @@
+#include "overheat_warning_manager.h"
+
+#include <cmath>
+
+#include "sensesp/system/lambda_consumer.h"
+#include "sensesp/ui/config_item.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+OverheatWarningManager::OverheatWarningManager(
+    const OverheatPredictor::Settings& defaults, const String& config_path)
+    : FileSystemSaveable(config_path)
+    , predictor_(defaults)
+    , coolant_(nullptr)
+    , notification_(nullptr)
+    , rate_output_(nullptr)
+    , time_to_limit_output_(nullptr) {
+    this->load();
+}
+
+void OverheatWarningManager::start(const OneWireTempChain* coolant) {
+    coolant_ = coolant;
+    
+    ConfigItem(this)
+        ->set_title("Coolant Overheat Warning")
+        ->set_description("Warns when the coolant trend will reach the limit soon")
+        ->set_sort_order(BoatSensorConfig::OVERHEAT_SORT_ORDER);
+    
+    notification_ = new SKOutputRawJson(BoatSensorConfig::OVERHEAT_NOTIFICATION_SK_PATH);
+    rate_output_ = new SKOutputFloat(BoatSensorConfig::COOLANT_RATE_SK_PATH);
+    time_to_limit_output_ = new SKOutputFloat(BoatSensorConfig::COOLANT_TIME_TO_LIMIT_SK_PATH);
+    
+    coolant_->calibration->connect_to(new LambdaConsumer<float>(
+        [this](float kelvin) { this->onCoolant(kelvin); }));
+}
+
+void OverheatWarningManager::onCoolant(float kelvin) {
+    // Time the trend by when the value was sampled, not when it arrived
+    const uint32_t sampled_ms =
+        static_cast<uint32_t>(coolant_->sensor->getStamp()->monotonic_ms);
+    if (predictor_.update(kelvin, sampled_ms)) {
+        notify();
+    }
+    
+    rate_output_->set(predictor_.getRate());
+    const float time_to_limit = predictor_.getTimeToLimit();
+    // Not rising: null rather than infinity
+    time_to_limit_output_->set(std::isinf(time_to_limit) ? NAN : time_to_limit);
+}
+
+void OverheatWarningManager::notify() {
+    const OverheatPredictor::State state = predictor_.getState();
+    const float limit_c = predictor_.getSettings().limit_k - 273.15f;
+    char message[128];
+    const char* level = "normal";
+    const char* method = "[]";
+    
+    switch (state) {
+        case OverheatPredictor::State::WARNING:
+            level = "warn";
+            method = "[\"visual\",\"sound\"]";
+            snprintf(message, sizeof(message),
+                     "Coolant rising %.1f C/min, %.0f C in about %.0f min",
+                     predictor_.getRate() * 60.0f, limit_c,
+                     ceilf(predictor_.getTimeToLimit() / 60.0f));
+            break;
+        case OverheatPredictor::State::OVER_LIMIT:
+            level = "alarm";
+            method = "[\"visual\",\"sound\"]";
+            snprintf(message, sizeof(message), "Coolant above %.0f C", limit_c);
+            break;
+        default:
+            snprintf(message, sizeof(message), "Coolant temperature normal");
+            break;
+    }
+    
+    ESP_LOGW("OverheatWarningManager", "%s: %s", level, message);
+    char json[224];
+    snprintf(json, sizeof(json), "{\"state\":\"%s\",\"method\":%s,\"message\":\"%s\"}",
+             level, method, message);
+    notification_->set(json);
+}
+
+bool OverheatWarningManager::to_json(JsonObject& root) {
+    const OverheatPredictor::Settings& settings = predictor_.getSettings();
+    root["limit_c"] = settings.limit_k - 273.15f;
+    root["horizon_min"] = settings.horizon_s / 60.0f;
+    root["window_s"] = settings.window_ms / 1000;
+    root["min_rate_c_per_min"] = settings.min_rate_k_per_s * 60.0f;
+    return true;
+}
+
+bool OverheatWarningManager::from_json(const JsonObject& config) {
+    if (!config["limit_c"].is<float>() || !config["horizon_min"].is<float>() ||
+        !config["window_s"].is<unsigned int>() ||
+        !config["min_rate_c_per_min"].is<float>()) {
+        return false;
+    }
+    unsigned int window_s = config["window_s"].as<unsigned int>();
+    if (window_s == 0) {
+        return false;
+    }
+    if (window_s > BoatSensorConfig::OVERHEAT_MAX_WINDOW_S) {
+        // The estimator would silently drop the oldest samples instead
+        ESP_LOGW("OverheatWarningManager", "Trend window %u s clamped to %u s",
+                 window_s, BoatSensorConfig::OVERHEAT_MAX_WINDOW_S);
+        window_s = BoatSensorConfig::OVERHEAT_MAX_WINDOW_S;
+    }
+    
+    OverheatPredictor::Settings settings = predictor_.getSettings();
+    settings.limit_k = config["limit_c"].as<float>() + 273.15f;
+    settings.horizon_s = config["horizon_min"].as<float>() * 60.0f;
+    settings.window_ms = window_s * 1000;
+    settings.min_rate_k_per_s = config["min_rate_c_per_min"].as<float>() / 60.0f;
+    predictor_.setSettings(settings);
+    return true;
+}
+
+const String ConfigSchema(const OverheatWarningManager& obj) {
+    const String max_window(BoatSensorConfig::OVERHEAT_MAX_WINDOW_S);
+    return String(R"###({"type":"object","properties":{"limit_c":{"title":"Coolant limit (C)","description":"Temperature the warning looks ahead to; an alarm is raised at it","type":"number"},"horizon_min":{"title":"Warning horizon (min)","description":"Warn when the trend reaches the limit within this time","type":"number"},"window_s":{"title":"Trend window (s)","description":"Time over which the rise rate is fitted; longer is steadier but slower to react. At most )###") +
+           max_window + R"###(","type":"integer","minimum":1,"maximum":)###" + max_window +
+           R"###(},"min_rate_c_per_min":{"title":"Minimum rise (C/min)","description":"Slower rises are not projected","type":"number"}}})###";
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,182 @@
+#include "phase_scheduler.h"
+
+namespace BoatEngine {
+
+constexpr size_t PhaseScheduler::MAX_TASKS;
+constexpr uint64_t PhaseScheduler::NEVER;
+constexpr uint32_t PhaseScheduler::MAX_HORIZON_SLOTS;
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        const uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+// Saturates at limit, which is all the callers need
+static uint32_t lcm(uint32_t a, uint32_t b, uint32_t limit) {
+    const uint64_t result = static_cast<uint64_t>(a / gcd(a, b)) * b;
+    return result > limit ? limit : static_cast<uint32_t>(result);
+}
+
+PhaseScheduler::PhaseScheduler(uint32_t slot_ms, bool stagger)
+    : slot_ms_(slot_ms > 0 ? slot_ms : 1)
+    , stagger_(stagger)
+    , task_count_(0)
+    , next_slot_(0)
+    , running_(false) {
+}
+
+int PhaseScheduler::addTask(uint32_t period_ms, Callback callback, uint16_t weight) {
+    if (task_count_ >= MAX_TASKS) {
+        return -1;
+    }
+    Task& task = tasks_[task_count_];
+    task.period_slots = 0;
+    task.phase = 0;
+    task.weight = weight;
+    task.callback = callback;
+    task_count_++;
+    setPeriod(task_count_ - 1, period_ms);
+    return static_cast<int>(task_count_ - 1);
+}
+
+void PhaseScheduler::setPeriod(size_t task, uint32_t period_ms) {
+    if (task >= task_count_) {
+        return;
+    }
+    tasks_[task].period_slots = toSlots(period_ms);
+    tasks_[task].phase = choosePhase(task);
+}
+
+uint32_t PhaseScheduler::toSlots(uint32_t period_ms) const {
+    if (period_ms == 0) {
+        return 0;
+    }
+    const uint32_t slots = (period_ms + slot_ms_ / 2) / slot_ms_;
+    return slots > 0 ? slots : 1;
+}
+
+uint32_t PhaseScheduler::choosePhase(size_t task) const {
+    const uint32_t period = tasks_[task].period_slots;
+    if (!stagger_ || period <= 1) {
+        return 0;
+    }
+    
+    // The cost repeats with the lcm of the gcds, so only that many
+    // candidates need checking
+    uint32_t candidates = 1;
+    for (size_t j = 0; j < task_count_; j++) {
+        if (j != task && tasks_[j].period_slots > 0) {
+            candidates = lcm(candidates, gcd(period, tasks_[j].period_slots), period);
+        }
+    }
+    
+    uint32_t best_phase = 0;
+    uint32_t best_cost = UINT32_MAX;
+    for (uint32_t phase = 0; phase < candidates; phase++) {
+        uint32_t cost = 0;
+        for (size_t j = 0; j < task_count_; j++) {
+            const Task& other = tasks_[j];
+            if (j == task || other.period_slots == 0) {
+                continue;
+            }
+            const uint32_t g = gcd(period, other.period_slots);
+            if (phase % g == other.phase % g) {
+                cost += other.weight;
+            }
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_phase = phase;
+        }
+    }
+    return best_phase;
+}
+
+uint64_t PhaseScheduler::firstDueFrom(const Task& task, uint64_t slot) const {
+    if (task.period_slots == 0) {
+        return NEVER;
+    }
+    const uint32_t into = static_cast<uint32_t>(slot % task.period_slots);
+    return slot + (task.phase + task.period_slots - into) % task.period_slots;
+}
+
+size_t PhaseScheduler::runDue(uint64_t now_ms) {
+    const uint64_t current = now_ms / slot_ms_;
+    if (!running_) {
+        next_slot_ = current;
+        running_ = true;
+    }
+    if (current < next_slot_) {
+        return 0;
+    }
+    
+    const uint64_t first = next_slot_;
+    next_slot_ = current + 1;
+    size_t run = 0;
+    for (size_t i = 0; i < task_count_; i++) {
+        if (firstDueFrom(tasks_[i], first) <= current) {
+            tasks_[i].callback();
+            run++;
+        }
+    }
+    return run;
+}
+
+uint64_t PhaseScheduler::nextDueMs(uint64_t now_ms) const {
+    uint64_t from = now_ms / slot_ms_;
+    if (running_ && next_slot_ > from) {
+        from = next_slot_;
+    }
+    uint64_t next = NEVER;
+    for (size_t i = 0; i < task_count_; i++) {
+        const uint64_t due = firstDueFrom(tasks_[i], from);
+        if (due < next) {
+            next = due;
+        }
+    }
+    return next == NEVER ? NEVER : next * slot_ms_;
+}
+
+uint32_t PhaseScheduler::getSlotLoad(uint64_t slot) const {
+    uint32_t load = 0;
+    for (size_t i = 0; i < task_count_; i++) {
+        const Task& task = tasks_[i];
+        if (task.period_slots > 0 && slot % task.period_slots == task.phase) {
+            load += task.weight;
+        }
+    }
+    return load;
+}
+
+uint32_t PhaseScheduler::getPeakLoad() const {
+    uint32_t horizon = 1;
+    for (size_t i = 0; i < task_count_; i++) {
+        if (tasks_[i].period_slots > 0) {
+            horizon = lcm(horizon, tasks_[i].period_slots, MAX_HORIZON_SLOTS);
+        }
+    }
+    uint32_t peak = 0;
+    for (uint32_t slot = 0; slot < horizon; slot++) {
+        const uint32_t load = getSlotLoad(slot);
+        if (load > peak) {
+            peak = load;
+        }
+    }
+    return peak;
+}
+
+uint32_t PhaseScheduler::getAlignedLoad() const {
+    uint32_t load = 0;
+    for (size_t i = 0; i < task_count_; i++) {
+        if (tasks_[i].period_slots > 0) {
+            load += tasks_[i].weight;
+        }
+    }
+    return load;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,22 @@
+#include "pulse_counter_bank.h"
+
+namespace BoatEngine {
+
+constexpr size_t PulseCounterBank::MAX_CHANNELS;
+
+PulseCounterBank::PulseCounterBank() {
+    for (size_t i = 0; i < MAX_CHANNELS; i++) {
+        counts_[i] = 0;
+        last_[i] = 0;
+    }
+}
+
+uint32_t PulseCounterBank::takeDelta(size_t channel) {
+    const uint32_t now = counts_[channel];
+    // Unsigned subtraction stays correct across counter wrap-around
+    const uint32_t delta = now - last_[channel];
+    last_[channel] = now;
+    return delta;
+}
+
+} // namespace BoatEngine
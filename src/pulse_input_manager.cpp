@@ -0,0 +1,195 @@
+#include "pulse_input_manager.h"
+
+#include "sensesp.h"
+#include "sensesp/signalk/signalk_value_listener.h"
+#include "sensesp/system/lambda_consumer.h"
+#include "sensesp/ui/config_item.h"
+#include "timestamped_sk_output.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+// Shared by every pulse pin: the argument is that channel's counter slot
+static void IRAM_ATTR onPulseEdge(void* counter) {
+    volatile uint32_t* count = static_cast<volatile uint32_t*>(counter);
+    *count = *count + 1;
+}
+
+PulseInputManager::PulseInputManager(AcquisitionScheduler* scheduler,
+                                     unsigned int read_delay_ms)
+    : read_delay_ms_(read_delay_ms)
+    , last_update_ms_(0)
+    , started_(false)
+    , scheduler_(scheduler)
+    , task_(-1)
+    , recorder_(nullptr)
+    , channel_count_(0)
+    , net_rate_output_(nullptr)
+    , per_distance_output_(nullptr) {
+}
+
+void PulseInputManager::setupSensors(const SensorTopology& topology) {
+    const Channel* supply = nullptr;
+    const Channel* fuel_return = nullptr;
+    for (size_t i = 0; i < topology.getPulseCount(); i++) {
+        const SensorTopology::PulseEntry& entry = topology.getPulse(i);
+        if (entry.role == SensorTopology::PulseRole::RPM) {
+            continue;
+        }
+        const Channel* channel = addChannel(entry.def);
+        if (entry.role == SensorTopology::PulseRole::FUEL_SUPPLY) {
+            supply = channel;
+        } else if (entry.role == SensorTopology::PulseRole::FUEL_RETURN) {
+            fuel_return = channel;
+        }
+    }
+    if (supply != nullptr && fuel_return != nullptr) {
+        setupFuelConsumption(supply, fuel_return);
+    }
+}
+
+const PulseInputManager::Channel* PulseInputManager::addChannel(
+    const BoatSensorConfig::PulseChannelDef& config) {
+    if (channel_count_ >= PulseCounterBank::MAX_CHANNELS || started_) {
+        ESP_LOGE("PulseInputManager", "Cannot add %s", config.human_label);
+        return nullptr;
+    }
+    
+    Channel& channel = channels_[channel_count_];
+    channel.index = channel_count_;
+    channel.pin = config.pin;
+    channel.signal_k_path = config.signal_k_path;
+    channel.edge_handler = onPulseEdge;
+    channel.edge_arg = const_cast<uint32_t*>(counters_.counterFor(channel_count_));
+    channel.scaling = new PulseRateScaling(config.pulses_per_unit, config.ratio,
+                                           config.scaling_config_path);
+    ConfigItem(channel.scaling)
+        ->set_title(config.human_label)
+        ->set_description((String("Pulse scaling for the ") + config.human_label).c_str())
+        ->set_sort_order(config.scaling_sort_order);
+    
+    channel.sk_output = new TimestampedSKOutputFloat(config.signal_k_path,
+                                                     config.sk_config_path, &stamp_);
+    ConfigItem(channel.sk_output)
+        ->set_title((String(config.human_label) + " Signal K Path").c_str())
+        ->set_description((String("Signal K path for the ") + config.human_label).c_str())
+        ->set_sort_order(config.sk_sort_order);
+    
+    // Pipeline: edges -> frequency -> scaling, emitted to the consumers of
+    // the channel and set on the SK output
+    channel.pipeline = Pipeline(EdgeRateStage(),
+                                PulseScaleStage<PulseRateScaling>{channel.scaling},
+                                EmitStage<PulseRateScaling>{channel.scaling},
+                                OutputStage<TimestampedSKOutputFloat>{channel.sk_output});
+    
+    channel_count_++;
+    return &channel;
+}
+
+void PulseInputManager::setupFuelConsumption(const Channel* supply,
+                                             const Channel* fuel_return) {
+    net_rate_output_ = new TimestampedSKOutputFloat(
+        BoatSensorConfig::FUEL_NET_RATE_SK_PATH,
+        BoatSensorConfig::FUEL_NET_RATE_CONFIG_PATH, &stamp_);
+    ConfigItem(net_rate_output_)
+        ->set_title("Fuel Rate Signal K Path")
+        ->set_description("Signal K path for net fuel consumption (supply - return)")
+        ->set_sort_order(BoatSensorConfig::FUEL_NET_RATE_SORT_ORDER);
+    
+    per_distance_output_ = new TimestampedSKOutputFloat(
+        BoatSensorConfig::FUEL_PER_DISTANCE_SK_PATH,
+        BoatSensorConfig::FUEL_PER_DISTANCE_CONFIG_PATH, &stamp_);
+    ConfigItem(per_distance_output_)
+        ->set_title("Fuel Per Distance Signal K Path")
+        ->set_description("Signal K path for fuel used per metre over ground")
+        ->set_sort_order(BoatSensorConfig::FUEL_PER_DISTANCE_SORT_ORDER);
+    
+    auto* speed = new SKValueListener<float>(
+        BoatSensorConfig::SPEED_OVER_GROUND_SK_PATH);
+    speed->connect_to(new LambdaConsumer<float>(
+        [this](float sog) { fuel_.setSpeedOverGround(sog); }));
+    
+    // Published by update() once every channel has been read, so the two
+    // flows are from the same read whatever order the topology lists them
+    supply->scaling->connect_to(new LambdaConsumer<float>(
+        [this](float flow) { fuel_.setSupplyFlow(flow); }));
+    fuel_return->scaling->connect_to(new LambdaConsumer<float>(
+        [this](float flow) { fuel_.setReturnFlow(flow); }));
+}
+
+void PulseInputManager::publishFuelConsumption() {
+    net_rate_output_->set(fuel_.getNetFlow());
+    float consumption;
+    if (fuel_.getConsumptionPerDistance(&consumption)) {
+        per_distance_output_->set(consumption);
+    }
+}
+
+bool PulseInputManager::setEdgeHandler(size_t index, EdgeHandler handler, void* arg) {
+    if (index >= channel_count_ || started_) {
+        return false;
+    }
+    channels_[index].edge_handler = handler;
+    channels_[index].edge_arg = arg;
+    return true;
+}
+
+void PulseInputManager::start() {
+    if (started_ || channel_count_ == 0) {
+        return;
+    }
+    started_ = true;
+    
+    for (size_t i = 0; i < channel_count_; i++) {
+        pinMode(channels_[i].pin, INPUT_PULLUP);
+        attachInterruptArg(channels_[i].pin, channels_[i].edge_handler,
+                           channels_[i].edge_arg, RISING);
+    }
+    
+    last_update_ms_ = millis();
+    task_ = scheduler_->addTask("pulse", read_delay_ms_, [this]() { this->update(); });
+}
+
+void PulseInputManager::setSamplingInterval(unsigned int interval_ms) {
+    read_delay_ms_ = interval_ms;
+    scheduler_->setPeriod(task_, interval_ms);
+}
+
+void PulseInputManager::update() {
+    // Use the measured interval, not the nominal one, so a late tick does
+    // not read as a frequency spike
+    const uint32_t now = millis();
+    const uint32_t elapsed = now - last_update_ms_;
+    last_update_ms_ = now;
+    stamp_.mark(acquisitionNowMs());
+    
+    for (size_t i = 0; i < channel_count_; i++) {
+        const uint32_t edges = counters_.takeDelta(i);
+        if (recorder_ != nullptr) {
+            recorder_->recordPulses(static_cast<uint8_t>(i), edges, elapsed);
+        }
+        channels_[i].pipeline(PulseSample{edges, elapsed});
+    }
+    if (net_rate_output_ != nullptr) {
+        publishFuelConsumption();
+    }
+}
+
+void PulseInputManager::setRecorder(SensorRecorder* recorder) {
+    recorder_ = recorder;
+    if (recorder_ == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < channel_count_; i++) {
+        recorder_->declarePulseChannel(static_cast<uint8_t>(i), channels_[i].signal_k_path,
+                                       channels_[i].scaling->getPulsesPerUnit(),
+                                       channels_[i].scaling->getRatio());
+    }
+}
+
+const PulseInputManager::Channel* PulseInputManager::getChannel(size_t index) const {
+    return index < channel_count_ ? &channels_[index] : nullptr;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,43 @@
+#include "pulse_rate_scaling.h"
+
+#include "pulse_counter_bank.h"
+
+namespace BoatEngine {
+
+PulseRateScaling::PulseRateScaling(float pulses_per_unit, float ratio,
+                                   const String& config_path)
+    : sensesp::FloatTransform(config_path)
+    , pulses_per_unit_(pulses_per_unit)
+    , ratio_(ratio) {
+    this->load();
+}
+
+bool PulseRateScaling::to_json(JsonObject& root) {
+    root["pulses_per_unit"] = pulses_per_unit_;
+    root["ratio"] = ratio_;
+    return true;
+}
+
+bool PulseRateScaling::from_json(const JsonObject& config) {
+    // Configs saved by the former Frequency transform only have a multiplier
+    if (config["multiplier"].is<float>() && !config["ratio"].is<float>()) {
+        ratio_ = config["multiplier"].as<float>();
+        return true;
+    }
+    if (!config["pulses_per_unit"].is<float>() || !config["ratio"].is<float>()) {
+        return false;
+    }
+    const float pulses_per_unit = config["pulses_per_unit"].as<float>();
+    if (pulses_per_unit <= 0.0f) {
+        return false;
+    }
+    pulses_per_unit_ = pulses_per_unit;
+    ratio_ = config["ratio"].as<float>();
+    return true;
+}
+
+const String ConfigSchema(const PulseRateScaling& obj) {
+    return R"###({"type":"object","properties":{"pulses_per_unit":{"title":"Pulses per unit","description":"Pulses per revolution, or meter K-factor in pulses per cubic metre","type":"number"},"ratio":{"title":"Ratio","description":"Gear ratio or other multiplier applied after division","type":"number"}}})###";
+}
+
+} // namespace BoatEngine
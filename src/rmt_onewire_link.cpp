@@ -0,0 +1,135 @@
+#include "rmt_onewire_link.h"
+
+#include <driver/gpio.h>
+#include <esp_log.h>
+#include <esp_rom_gpio.h>
+#include <esp_timer.h>
+#include <soc/gpio_sig_map.h>
+
+namespace BoatEngine {
+
+static const char* LOG_TAG = "RmtOneWire";
+
+constexpr uint16_t RmtOneWireLink::IDLE_THRESHOLD_US;
+constexpr uint8_t RmtOneWireLink::GLITCH_FILTER_TICKS;
+constexpr size_t RmtOneWireLink::RX_RINGBUF_BYTES;
+constexpr uint32_t RmtOneWireLink::TIMEOUT_MARGIN_US;
+
+RmtOneWireLink::RmtOneWireLink(uint8_t pin, rmt_channel_t tx_channel,
+                               rmt_channel_t rx_channel)
+    : pin_(pin)
+    , tx_channel_(tx_channel)
+    , rx_channel_(rx_channel)
+    , rx_ringbuf_(nullptr)
+    , installed_(false)
+    , deadline_us_(0) {
+}
+
+RmtOneWireLink::~RmtOneWireLink() {
+    if (installed_) {
+        rmt_driver_uninstall(tx_channel_);
+        rmt_driver_uninstall(rx_channel_);
+    }
+}
+
+bool RmtOneWireLink::begin() {
+    const gpio_num_t gpio = static_cast<gpio_num_t>(pin_);
+    
+    rmt_config_t tx_config = RMT_DEFAULT_CONFIG_TX(gpio, tx_channel_);
+    tx_config.clk_div = 80;  // 1 us ticks
+    tx_config.mem_block_num = 1;
+    tx_config.tx_config.idle_output_en = true;
+    tx_config.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+    tx_config.tx_config.carrier_en = false;
+    tx_config.tx_config.loop_en = false;
+    
+    rmt_config_t rx_config = RMT_DEFAULT_CONFIG_RX(gpio, rx_channel_);
+    rx_config.clk_div = 80;
+    rx_config.mem_block_num = 2;
+    rx_config.rx_config.filter_en = true;
+    rx_config.rx_config.filter_ticks_thresh = GLITCH_FILTER_TICKS;
+    rx_config.rx_config.idle_threshold = IDLE_THRESHOLD_US;
+    
+    if (rmt_config(&tx_config) != ESP_OK ||
+        rmt_driver_install(tx_channel_, 0, 0) != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "TX channel %d setup failed", tx_channel_);
+        return false;
+    }
+    if (rmt_config(&rx_config) != ESP_OK ||
+        rmt_driver_install(rx_channel_, RX_RINGBUF_BYTES, 0) != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "RX channel %d setup failed", rx_channel_);
+        rmt_driver_uninstall(tx_channel_);
+        return false;
+    }
+    rmt_get_ringbuf_handle(rx_channel_, &rx_ringbuf_);
+    installed_ = true;
+    
+    // Both channels share the pin: TX pulls it low through the open-drain
+    // driver, RX listens to the line itself
+    gpio_set_direction(gpio, GPIO_MODE_INPUT_OUTPUT_OD);
+    esp_rom_gpio_connect_out_signal(pin_, RMT_SIG_OUT0_IDX + tx_channel_, false, false);
+    esp_rom_gpio_connect_in_signal(pin_, RMT_SIG_IN0_IDX + rx_channel_, false);
+    
+    ESP_LOGI(LOG_TAG, "OneWire on GPIO %u, RMT TX %d / RX %d",
+             pin_, tx_channel_, rx_channel_);
+    return true;
+}
+
+bool RmtOneWireLink::transmit(const OneWireSymbol* symbols, size_t count) {
+    if (!installed_) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        items_[i].level0 = 0;
+        items_[i].duration0 = symbols[i].low_us;
+        items_[i].level1 = 1;
+        items_[i].duration1 = symbols[i].high_us;
+    }
+    
+    // Drop anything left over from a transfer that timed out
+    size_t stale_size = 0;
+    void* stale;
+    while ((stale = xRingbufferReceive(rx_ringbuf_, &stale_size, 0)) != nullptr) {
+        vRingbufferReturnItem(rx_ringbuf_, stale);
+    }
+    
+    rmt_rx_start(rx_channel_, true);
+    if (rmt_write_items(tx_channel_, items_, count, false) != ESP_OK) {
+        rmt_rx_stop(rx_channel_);
+        return false;
+    }
+    deadline_us_ = esp_timer_get_time() + OneWireCodec::duration(symbols, count) +
+                   IDLE_THRESHOLD_US + TIMEOUT_MARGIN_US;
+    return true;
+}
+
+OneWireLink::Status RmtOneWireLink::capture(uint16_t* lows_us, size_t max,
+                                            size_t* count, uint32_t wait_ms) {
+    size_t size = 0;
+    rmt_item32_t* items = static_cast<rmt_item32_t*>(
+        xRingbufferReceive(rx_ringbuf_, &size, pdMS_TO_TICKS(wait_ms)));
+    if (items == nullptr) {
+        if (esp_timer_get_time() < deadline_us_) {
+            return Status::BUSY;
+        }
+        rmt_rx_stop(rx_channel_);
+        return Status::TIMEOUT;
+    }
+    
+    size_t n = 0;
+    const size_t item_count = size / sizeof(rmt_item32_t);
+    for (size_t i = 0; i < item_count && n < max; i++) {
+        // A zero duration marks the end of the capture
+        if (items[i].duration0 == 0) break;
+        if (items[i].level0 == 0) lows_us[n++] = items[i].duration0;
+        if (items[i].duration1 == 0) break;
+        if (items[i].level1 == 0 && n < max) lows_us[n++] = items[i].duration1;
+    }
+    vRingbufferReturnItem(rx_ringbuf_, items);
+    rmt_rx_stop(rx_channel_);
+    
+    *count = n;
+    return Status::DONE;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,125 @@
+#include "rolling_statistics.h"
+
+#include <cmath>
+
+namespace BoatEngine {
+
+RollingStatistics::Deque::Deque(uint16_t capacity)
+    : slots_(capacity)
+    , head_(0)
+    , count_(0) {
+}
+
+void RollingStatistics::Deque::popFront() {
+    head_ = (head_ + 1) % slots_.size();
+    count_--;
+}
+
+void RollingStatistics::Deque::pushBack(uint16_t position) {
+    slots_[(head_ + count_) % slots_.size()] = position;
+    count_++;
+}
+
+RollingStatistics::RollingStatistics(uint32_t window_ms, uint16_t capacity)
+    : window_ms_(window_ms)
+    , capacity_(capacity > 0 ? capacity : 1)
+    , samples_(capacity_)
+    , overflows_(0)
+    , min_(capacity_)
+    , max_(capacity_) {
+    reset();
+}
+
+void RollingStatistics::reset() {
+    head_ = 0;
+    count_ = 0;
+    min_.clear();
+    max_.clear();
+    mean_ = 0.0;
+    m2_ = 0.0;
+}
+
+void RollingStatistics::add(float value, uint32_t time_ms) {
+    if (std::isnan(value)) {
+        return;
+    }
+    expire(time_ms);
+    if (count_ == capacity_) {
+        removeOldest();
+        overflows_++;
+    }
+    
+    const uint16_t position = static_cast<uint16_t>((head_ + count_) % capacity_);
+    samples_[position] = Sample{time_ms, value};
+    count_++;
+    
+    // A newer sample that is as low outlives every higher one before it
+    while (!min_.empty() && samples_[min_.back()].value >= value) {
+        min_.popBack();
+    }
+    min_.pushBack(position);
+    while (!max_.empty() && samples_[max_.back()].value <= value) {
+        max_.popBack();
+    }
+    max_.pushBack(position);
+    
+    const double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+}
+
+void RollingStatistics::expire(uint32_t now_ms) {
+    while (count_ > 0 && now_ms - samples_[head_].time_ms > window_ms_) {
+        removeOldest();
+    }
+}
+
+void RollingStatistics::removeOldest() {
+    const uint16_t position = static_cast<uint16_t>(head_);
+    const double value = samples_[position].value;
+    if (min_.front() == position) {
+        min_.popFront();
+    }
+    if (max_.front() == position) {
+        max_.popFront();
+    }
+    head_ = (head_ + 1) % capacity_;
+    count_--;
+    
+    if (count_ == 0) {
+        // Start clean rather than carry rounding residue
+        reset();
+        return;
+    }
+    // Welford in reverse
+    const double delta = value - mean_;
+    mean_ -= delta / count_;
+    m2_ -= delta * (value - mean_);
+    if (m2_ < 0.0) {
+        m2_ = 0.0;
+    }
+}
+
+float RollingStatistics::getMin() const {
+    return count_ > 0 ? samples_[min_.front()].value : NAN;
+}
+
+float RollingStatistics::getMax() const {
+    return count_ > 0 ? samples_[max_.front()].value : NAN;
+}
+
+float RollingStatistics::getMean() const {
+    return count_ > 0 ? static_cast<float>(mean_) : NAN;
+}
+
+float RollingStatistics::getStdDev() const {
+    if (count_ == 0) {
+        return NAN;
+    }
+    if (count_ == 1) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::sqrt(m2_ / (count_ - 1)));
+}
+
+} // namespace BoatEngine
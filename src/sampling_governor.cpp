@@ -0,0 +1,146 @@
+#include "sampling_governor.h"
+
+namespace BoatEngine {
+
+constexpr int SamplingGovernor::STATE_COUNT;
+
+SamplingGovernor::SamplingGovernor(const Settings& settings)
+    : settings_(settings)
+    , state_(EngineState::STOPPED)
+    , engine_on_(false)
+    , reached_running_(false)
+    , coolant_known_(false)
+    , coolant_k_(0.0f)
+    , last_running_ms_(0)
+    , stopped_ms_(0) {
+}
+
+const SamplingProfile& SamplingGovernor::getProfile() const {
+    return settings_.profiles[static_cast<int>(state_)];
+}
+
+EngineState SamplingGovernor::runningState() const {
+    // Until the first coolant reading arrives, assume a cold engine
+    if (!coolant_known_ || coolant_k_ < settings_.warm_coolant_k) {
+        return EngineState::WARMING_UP;
+    }
+    return EngineState::RUNNING;
+}
+
+bool SamplingGovernor::setState(EngineState state) {
+    if (state == state_) {
+        return false;
+    }
+    state_ = state;
+    return true;
+}
+
+bool SamplingGovernor::onEngineSpeed(float rev_per_s, uint32_t now_ms) {
+    if (rev_per_s >= settings_.running_rev_per_s) {
+        engine_on_ = true;
+        reached_running_ = true;
+        last_running_ms_ = now_ms;
+        return setState(runningState());
+    }
+    return update(now_ms);
+}
+
+bool SamplingGovernor::onEdgeActivity(uint32_t now_ms) {
+    if (engine_on_) {
+        return false;
+    }
+    // Wake immediately; the next fast RPM read confirms or cancels
+    engine_on_ = true;
+    reached_running_ = false;
+    last_running_ms_ = now_ms;
+    return setState(runningState());
+}
+
+bool SamplingGovernor::onCoolantTemperature(float kelvin) {
+    if (kelvin != kelvin) {
+        // Invalid sensor reading (NaN): keep the last known temperature
+        return false;
+    }
+    coolant_known_ = true;
+    coolant_k_ = kelvin;
+    if (engine_on_) {
+        return setState(runningState());
+    }
+    return false;
+}
+
+bool SamplingGovernor::update(uint32_t now_ms) {
+    if (engine_on_) {
+        if (now_ms - last_running_ms_ < settings_.stop_detect_ms) {
+            return false;
+        }
+        engine_on_ = false;
+        stopped_ms_ = now_ms;
+        // A stray edge that never turned into a running engine goes
+        // straight back to sleep instead of starting a cool-down
+        return setState(reached_running_ ? EngineState::COOLING_DOWN
+                                         : EngineState::STOPPED);
+    }
+    
+    if (state_ == EngineState::COOLING_DOWN &&
+        now_ms - stopped_ms_ >= settings_.cooldown_ms) {
+        return setState(EngineState::STOPPED);
+    }
+    return false;
+}
+
+const char* SamplingGovernor::stateName(EngineState state) {
+    switch (state) {
+        case EngineState::STOPPED:      return "stopped";
+        case EngineState::WARMING_UP:   return "warmingUp";
+        case EngineState::RUNNING:      return "running";
+        case EngineState::COOLING_DOWN: return "coolingDown";
+    }
+    return "unknown";
+}
+
+DutyCycleMeter::DutyCycleMeter(uint32_t busy_threshold_us)
+    : busy_threshold_us_(busy_threshold_us) {
+    reset();
+}
+
+void DutyCycleMeter::recordTick(uint32_t duration_us) {
+    if (duration_us >= busy_threshold_us_) {
+        busy_us_ += duration_us;
+    } else {
+        spin_us_ += duration_us;
+    }
+}
+
+uint64_t DutyCycleMeter::getTotalUs() const {
+    return busy_us_ + spin_us_ + yield_us_ + sleep_us_;
+}
+
+float DutyCycleMeter::getDutyCycle() const {
+    const uint64_t total = getTotalUs();
+    if (total == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(busy_us_) / static_cast<float>(total);
+}
+
+float DutyCycleMeter::getEstimatedCurrentMa(const CurrentModel& model) const {
+    const uint64_t total = getTotalUs();
+    if (total == 0) {
+        return 0.0f;
+    }
+    const float awake = static_cast<float>(busy_us_ + spin_us_);
+    return (awake * model.active_ma +
+            static_cast<float>(yield_us_) * model.idle_ma +
+            static_cast<float>(sleep_us_) * model.sleep_ma) /
+           static_cast<float>(total);
+}
+
+void DutyCycleMeter::reset() {
+    busy_us_ = 0;
+    spin_us_ = 0;
+    yield_us_ = 0;
+    sleep_us_ = 0;
+}
+
+} // namespace BoatEngine
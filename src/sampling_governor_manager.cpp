@@ -0,0 +1,234 @@
+#include "sampling_governor_manager.h"
+
+#include <WiFi.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+#include "sensesp/system/lambda_consumer.h"
+#include "sensesp/ui/config_item.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+constexpr size_t SamplingGovernorManager::MAX_INPUTS;
+
+SamplingGovernorManager::SamplingGovernorManager(
+    const SamplingGovernor::Settings& defaults, const String& config_path)
+    : FileSystemSaveable(config_path)
+    , governor_(defaults)
+    , duty_(BoatSensorConfig::GOVERNOR_BUSY_TICK_US)
+    , suspend_when_stopped_(false)
+    , light_sleep_(false)
+    , input_count_(0)
+    , pulses_(nullptr)
+    , rpm_(nullptr)
+    , last_edge_total_(0)
+    , duty_output_(nullptr)
+    , current_output_(nullptr)
+    , state_output_(nullptr) {
+    this->load();
+}
+
+void SamplingGovernorManager::addSampledInput(SamplingControl* input,
+                                              InputKind kind) {
+    if (input_count_ >= MAX_INPUTS) {
+        ESP_LOGE("SamplingGovernorManager", "Too many sampled inputs");
+        return;
+    }
+    inputs_[input_count_].control = input;
+    inputs_[input_count_].kind = kind;
+    input_count_++;
+}
+
+void SamplingGovernorManager::setEngineSpeedSource(
+    PulseInputManager* pulses, const PulseInputManager::Channel* rpm) {
+    pulses_ = pulses;
+    rpm_ = rpm;
+    last_edge_total_ = pulses_->getCounterBank()->getTotal(rpm_->index);
+    
+    rpm_->scaling->connect_to(new LambdaConsumer<float>([this](float rev_per_s) {
+        if (governor_.onEngineSpeed(rev_per_s, millis())) {
+            applyProfile();
+        }
+    }));
+}
+
+void SamplingGovernorManager::setCoolantSource(ValueProducer<float>* coolant_k) {
+    coolant_k->connect_to(new LambdaConsumer<float>([this](float kelvin) {
+        if (governor_.onCoolantTemperature(kelvin)) {
+            applyProfile();
+        }
+    }));
+}
+
+void SamplingGovernorManager::start() {
+    ConfigItem(this)
+        ->set_title("Sampling Governor")
+        ->set_description("Engine-state adaptive sampling rates and power saving")
+        ->set_sort_order(BoatSensorConfig::GOVERNOR_SORT_ORDER);
+    
+    state_output_ = new SKOutput<String>(BoatSensorConfig::GOVERNOR_STATE_SK_PATH);
+    duty_output_ = new SKOutputFloat(BoatSensorConfig::DUTY_CYCLE_SK_PATH);
+    current_output_ = new SKOutputFloat(BoatSensorConfig::ESTIMATED_CURRENT_SK_PATH);
+    
+    applyProfile();
+    
+    event_loop()->onRepeat(BoatSensorConfig::GOVERNOR_POLL_MS,
+                           [this]() { this->pollEdges(); });
+    event_loop()->onRepeat(BoatSensorConfig::GOVERNOR_REPORT_MS,
+                           [this]() { this->report(); });
+}
+
+void SamplingGovernorManager::applyProfile() {
+    const EngineState state = governor_.getState();
+    const SamplingProfile& profile = governor_.getProfile();
+    const bool suspend = suspend_when_stopped_ && state == EngineState::STOPPED;
+    
+    for (size_t i = 0; i < input_count_; i++) {
+        unsigned int interval = 0;
+        if (!suspend) {
+            switch (inputs_[i].kind) {
+                case InputKind::PULSE:       interval = profile.pulse_ms; break;
+                case InputKind::TEMPERATURE: interval = profile.temperature_ms; break;
+                case InputKind::ANALOG:      interval = profile.analog_ms; break;
+            }
+        }
+        inputs_[i].control->setSamplingInterval(interval);
+    }
+    
+    ESP_LOGI("SamplingGovernorManager", "Engine %s",
+             SamplingGovernor::stateName(state));
+    if (state_output_ != nullptr) {
+        state_output_->set(SamplingGovernor::stateName(state));
+    }
+}
+
+void SamplingGovernorManager::pollEdges() {
+    const uint32_t now = millis();
+    bool changed = false;
+    
+    if (rpm_ != nullptr) {
+        // Reading the free-running total leaves the pulse manager's
+        // delta bookkeeping untouched
+        const uint32_t total = pulses_->getCounterBank()->getTotal(rpm_->index);
+        if (total != last_edge_total_) {
+            last_edge_total_ = total;
+            changed = governor_.onEdgeActivity(now);
+        }
+    }
+    
+    changed = governor_.update(now) || changed;
+    if (changed) {
+        applyProfile();
+    }
+}
+
+void SamplingGovernorManager::report() {
+    static const DutyCycleMeter::CurrentModel model = {
+        BoatSensorConfig::CURRENT_ACTIVE_MA,
+        BoatSensorConfig::CURRENT_IDLE_MA,
+        BoatSensorConfig::CURRENT_LIGHT_SLEEP_MA
+    };
+    
+    duty_output_->set(duty_.getDutyCycle());
+    current_output_->set(duty_.getEstimatedCurrentMa(model) / 1000.0f);  // A
+    state_output_->set(SamplingGovernor::stateName(governor_.getState()));
+    duty_.reset();
+}
+
+void SamplingGovernorManager::afterTick(uint32_t tick_us) {
+    duty_.recordTick(tick_us);
+    
+    if (governor_.getState() != EngineState::STOPPED) {
+        return;
+    }
+    
+    // Light sleep powers the radio down; while associated the access
+    // point and Signal K server would see the device drop out
+    if (light_sleep_ && rpm_ != nullptr && !WiFi.isConnected()) {
+        lightSleep();
+        return;
+    }
+    
+    // Let the idle task halt the CPU instead of spinning on tick()
+    const uint32_t start = micros();
+    delay(BoatSensorConfig::GOVERNOR_IDLE_YIELD_MS);
+    duty_.recordYield(micros() - start);
+}
+
+void SamplingGovernorManager::lightSleep() {
+    const gpio_num_t pin = static_cast<gpio_num_t>(rpm_->pin);
+    
+    // gpio_wakeup_enable makes the pin a level interrupt; with the counter
+    // ISR armed it would fire for as long as the level holds, before the
+    // sleep and until the edge interrupt is back. Disarm it meanwhile
+    gpio_intr_disable(pin);
+    
+    // Wake on the opposite of the current pickup level, i.e. the next edge
+    const gpio_int_type_t wake_level =
+        gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL;
+    gpio_wakeup_enable(pin, wake_level);
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup(
+        static_cast<uint64_t>(BoatSensorConfig::GOVERNOR_LIGHT_SLEEP_MS) * 1000);
+    
+    const int64_t start = esp_timer_get_time();
+    esp_light_sleep_start();
+    duty_.recordSleep(static_cast<uint32_t>(esp_timer_get_time() - start));
+    
+    // gpio_wakeup_enable replaced the pin's edge interrupt; put it back
+    // before rearming the counter
+    gpio_wakeup_disable(pin);
+    gpio_set_intr_type(pin, GPIO_INTR_POSEDGE);
+    gpio_intr_enable(pin);
+    
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO &&
+        governor_.onEdgeActivity(millis())) {
+        // The waking edge itself was not counted; switch over right away
+        applyProfile();
+    }
+}
+
+bool SamplingGovernorManager::to_json(JsonObject& root) {
+    const SamplingGovernor::Settings& settings = governor_.getSettings();
+    root["running_rpm"] = settings.running_rev_per_s * 60.0f;
+    root["warm_coolant_c"] = settings.warm_coolant_k - 273.15f;
+    root["stop_detect_s"] = settings.stop_detect_ms / 1000;
+    root["cooldown_s"] = settings.cooldown_ms / 1000;
+    root["suspend_when_stopped"] = suspend_when_stopped_;
+    root["light_sleep"] = light_sleep_;
+    return true;
+}
+
+bool SamplingGovernorManager::from_json(const JsonObject& config) {
+    if (!config["running_rpm"].is<float>() ||
+        !config["warm_coolant_c"].is<float>() ||
+        !config["stop_detect_s"].is<unsigned int>() ||
+        !config["cooldown_s"].is<unsigned int>()) {
+        return false;
+    }
+    
+    SamplingGovernor::Settings settings = governor_.getSettings();
+    settings.running_rev_per_s = config["running_rpm"].as<float>() / 60.0f;
+    settings.warm_coolant_k = config["warm_coolant_c"].as<float>() + 273.15f;
+    settings.stop_detect_ms = config["stop_detect_s"].as<unsigned int>() * 1000;
+    settings.cooldown_ms = config["cooldown_s"].as<unsigned int>() * 1000;
+    governor_.setSettings(settings);
+    
+    // Optional switches, absent in configs saved before they existed
+    if (config["suspend_when_stopped"].is<bool>()) {
+        suspend_when_stopped_ = config["suspend_when_stopped"].as<bool>();
+    }
+    if (config["light_sleep"].is<bool>()) {
+        light_sleep_ = config["light_sleep"].as<bool>();
+    }
+    return true;
+}
+
+const String ConfigSchema(const SamplingGovernorManager& obj) {
+    return R"###({"type":"object","properties":{"running_rpm":{"title":"Running RPM","description":"Engine speed above which the engine is considered running","type":"number"},"warm_coolant_c":{"title":"Warm coolant (C)","description":"Coolant temperature that ends the warm-up phase","type":"number"},"stop_detect_s":{"title":"Stop detect (s)","description":"Time below running speed before the engine is considered stopped","type":"integer"},"cooldown_s":{"title":"Cool-down (s)","description":"How long temperatures are watched closely after stopping","type":"integer"},"suspend_when_stopped":{"title":"Suspend when stopped","description":"Stop all sampling while stopped; only the RPM pickup is watched","type":"boolean"},"light_sleep":{"title":"Light sleep when stopped","description":"Sleep between ticks while stopped and WiFi is not connected, waking on the RPM pickup","type":"boolean"}}})###";
+}
+
+} // namespace BoatEngine
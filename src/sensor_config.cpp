@@ -3,29 +3,270 @@
 namespace BoatEngine {
 
 // Static member definitions
+constexpr size_t BoatSensorConfig::ONEWIRE_BUS_COUNT;
+constexpr size_t BoatSensorConfig::MEMORY_TASK_COUNT;
+constexpr size_t BoatSensorConfig::STATISTICS_WINDOW_COUNT;
+
 const char BoatSensorConfig::RPM_CONFIG_PATH_CALIBRATE[] = "/engineRPM/calibrate";
 const char BoatSensorConfig::RPM_CONFIG_PATH_SKPATH[] = "/engineRPM/sk_path";
 const char BoatSensorConfig::RPM_SK_PATH[] = "propulsion.main.revolutions";
 
+const BoatSensorConfig::PulseChannelDef BoatSensorConfig::ENGINE_RPM = {
+    RPM_SK_PATH,
+    "Engine RPM",
+    RPM_CONFIG_PATH_CALIBRATE,
+    RPM_CONFIG_PATH_SKPATH,
+    RPM_PIN,
+    1.0f,            // Pulses per revolution
+    RPM_MULTIPLIER,  // Gear ratio
+    RPM_CONFIG_SORT_ORDER, RPM_SK_PATH_SORT_ORDER
+};
+
+// 2000 pulses per litre
+const BoatSensorConfig::PulseChannelDef BoatSensorConfig::FUEL_SUPPLY_FLOW = {
+    "propulsion.main.fuel.supplyRate",
+    "Fuel Supply Flow",
+    "/fuelSupplyFlow/scaling",
+    "/fuelSupplyFlow/skPath",
+    FUEL_SUPPLY_PIN,
+    2.0e6f, 1.0f,
+    220, 230
+};
+
+const BoatSensorConfig::PulseChannelDef BoatSensorConfig::FUEL_RETURN_FLOW = {
+    "propulsion.main.fuel.returnRate",
+    "Fuel Return Flow",
+    "/fuelReturnFlow/scaling",
+    "/fuelReturnFlow/skPath",
+    FUEL_RETURN_PIN,
+    2.0e6f, 1.0f,
+    240, 250
+};
+
+const char BoatSensorConfig::FUEL_NET_RATE_SK_PATH[] = "propulsion.main.fuel.rate";
+const char BoatSensorConfig::FUEL_NET_RATE_CONFIG_PATH[] = "/fuelRate/skPath";
+const char BoatSensorConfig::FUEL_PER_DISTANCE_SK_PATH[] =
+    "propulsion.main.fuel.consumptionPerDistance";
+const char BoatSensorConfig::FUEL_PER_DISTANCE_CONFIG_PATH[] =
+    "/fuelPerDistance/skPath";
+const char BoatSensorConfig::SPEED_OVER_GROUND_SK_PATH[] =
+    "navigation.speedOverGround";
+
+// Profiles indexed by EngineState: STOPPED, WARMING_UP, RUNNING, COOLING_DOWN
+const SamplingGovernor::Settings BoatSensorConfig::GOVERNOR_DEFAULTS = {
+    5.0f,      // Running above 300 RPM
+    333.15f,   // Warm above 60 C coolant
+    5000,      // Stopped after 5 s below running speed
+    300000,    // Watch heat soak for 5 minutes
+    {
+        {10000, GOVERNOR_STOPPED_TEMPERATURE_MS, 30000},
+        {RPM_READ_DELAY_MS, GOVERNOR_WARMING_TEMPERATURE_MS, ANALOG_READ_DELAY_MS},
+        {RPM_READ_DELAY_MS, TEMPERATURE_READ_DELAY_MS, ANALOG_READ_DELAY_MS},
+        {RPM_READ_DELAY_MS, TEMPERATURE_READ_DELAY_MS, 2000}
+    }
+};
+
+const char BoatSensorConfig::MAX_INTERRUPT_LATENCY_SK_PATH[] =
+    "sensors.engineController.maxInterruptLatency";
+
+const char BoatSensorConfig::RECORDING_CONFIG_PATH[] = "/sensorRecording";
+const char BoatSensorConfig::RECORDING_FILE[] = "/recording.bin";
+const char BoatSensorConfig::RECORDING_HTTP_PATH[] = "/api/recording";
+
+const char BoatSensorConfig::SCHEDULER_SK_PREFIX[] = "sensors.engineController.scheduler.";
+
+const char BoatSensorConfig::TOPOLOGY_CONFIG_PATH[] = "/sensorTopology";
+
+const char BoatSensorConfig::SNTP_SERVER[] = "pool.ntp.org";
+
+const char BoatSensorConfig::MEMORY_SK_PREFIX[] = "sensors.engineController.memory.";
+const char* const BoatSensorConfig::MEMORY_TASKS[MEMORY_TASK_COUNT] = {
+    "loopTask",         // setup(), loop() and every SensESP callback
+    "tiT",              // lwIP TCP/IP
+    "wifi",
+    "sys_evt",
+    "arduino_events",
+    "esp_timer",
+    "httpd",            // Web configuration UI
+    "websocket_task",   // Signal K connection
+    "deferredLog",      // DeferredLogManager drain, idle priority
+    "vibration"         // VibrationSensorManager drain and FFT
+};
+
+const char BoatSensorConfig::DEFERRED_LOG_TASK_NAME[] = "deferredLog";
+const char BoatSensorConfig::DEFERRED_LOG_HTTP_PATH[] = "/api/log";
+
+const OverheatPredictor::Settings BoatSensorConfig::OVERHEAT_DEFAULTS = {
+    368.15f,           // Limit 95 C
+    300.0f,            // Warn 5 minutes ahead
+    60000,             // Fit the last minute
+    5,
+    0.5f / 60.0f,      // Ignore rises slower than 0.5 K/min
+    1.5f,              // Clear once the limit is 7.5 minutes away
+    2.0f
+};
+const char BoatSensorConfig::OVERHEAT_CONFIG_PATH[] = "/coolantTemperature/overheatWarning";
+const char BoatSensorConfig::OVERHEAT_NOTIFICATION_SK_PATH[] =
+    "notifications.propulsion.main.coolantTemperature";
+const char BoatSensorConfig::COOLANT_RATE_SK_PATH[] =
+    "sensors.engineController.coolantTrend.rate";
+const char BoatSensorConfig::COOLANT_TIME_TO_LIMIT_SK_PATH[] =
+    "sensors.engineController.coolantTrend.timeToLimit";
+
+const CylinderBalance::Settings BoatSensorConfig::CYLINDER_BALANCE_DEFAULTS = {
+    60,      // Teeth per revolution
+    4,       // Cylinders
+    true     // Four-stroke
+};
+const char BoatSensorConfig::CYLINDER_BALANCE_CONFIG_PATH[] = "/engineRPM/cylinderBalance";
+const char BoatSensorConfig::CYLINDER_BALANCE_SK_PREFIX[] = "propulsion.main.cylinderBalance.";
+
+const char BoatSensorConfig::VIBRATION_TASK_NAME[] = "vibration";
+const char BoatSensorConfig::VIBRATION_SK_PREFIX[] = "propulsion.main.vibration.";
+
+const BoatSensorConfig::StatisticsWindowDef
+    BoatSensorConfig::STATISTICS_WINDOWS[STATISTICS_WINDOW_COUNT] = {
+    {"1min", 60000, 160},       // RPM every 500 ms, with headroom
+    {"10min", 600000, 1280}
+};
+const char BoatSensorConfig::STATISTICS_SK_PREFIX[] = "sensors.engineController.statistics.";
+
+const DurationHistogram::Layout BoatSensorConfig::LOAD_PROFILE_RPM = {
+    500.0f, 250.0f, 14       // 500 .. 4000 rpm; below is stopped or cranking
+};
+const DurationHistogram::Layout BoatSensorConfig::LOAD_PROFILE_COOLANT = {
+    20.0f, 5.0f, 20          // 20 .. 120 C
+};
+const char BoatSensorConfig::LOAD_PROFILE_FILE[] = "/loadProfile.bin";
+const char BoatSensorConfig::LOAD_PROFILE_CSV_HTTP_PATH[] = "/api/loadProfile.csv";
+const char BoatSensorConfig::LOAD_PROFILE_BIN_HTTP_PATH[] = "/api/loadProfile.bin";
+
+const char BoatSensorConfig::LIVE_PAGE_HTTP_PATH[] = "/gauges";
+const char BoatSensorConfig::LIVE_EVENTS_HTTP_PATH[] = "/api/live";
+
+const StressRamp::Settings BoatSensorConfig::STRESS_SETTINGS = {
+    10,       // Start with 10 channels
+    10,       // and add 10 per step
+    500,
+    10.0f,    // Hz per channel
+    2000,     // Settle after adding channels
+    10000,    // Measure each step for 10 s
+    0.98f     // At least 98% of values must arrive
+};
+const char BoatSensorConfig::STRESS_SK_PREFIX[] = "sensors.engineController.stress.";
+
+const char BoatSensorConfig::GOVERNOR_CONFIG_PATH[] = "/samplingGovernor";
+const char BoatSensorConfig::GOVERNOR_STATE_SK_PATH[] =
+    "sensors.engineController.samplingState";
+const char BoatSensorConfig::DUTY_CYCLE_SK_PATH[] =
+    "sensors.engineController.dutyCycle";
+const char BoatSensorConfig::ESTIMATED_CURRENT_SK_PATH[] =
+    "sensors.engineController.estimatedCurrent";
+
+const BoatSensorConfig::OneWireBusDef
+    BoatSensorConfig::ONEWIRE_BUSES[ONEWIRE_BUS_COUNT] = {
+    {ONEWIRE_PIN, OneWireTransport::RMT, 0, 1},
+    {ONEWIRE_EXHAUST_PIN, OneWireTransport::RMT, 3, 4}
+};
+
+const TemperatureHealth::Limits BoatSensorConfig::ONEWIRE_HEALTH_LIMITS = {
+    -55.0f,    // DS18B20 range
+    125.0f,
+    5.0f,      // 85 C is real if the last value was 80-90 C,
+    2,         // or if a new conversion reads it again
+    2          // Retries per cycle
+};
+const char BoatSensorConfig::ONEWIRE_HEALTH_SK_PREFIX[] =
+    "sensors.engineController.temperatureHealth.";
+
 const BoatSensorConfig::TemperatureSensorDef BoatSensorConfig::COOLANT_TEMP = {
     "coolantTemperature",
     "propulsion.main.coolantTemperature",
     "Coolant Temperature",
-    110, 120, 130
+    110, 120, 130,
+    {Calibration::LINEAR, 1.0f, 0.0f, nullptr, 0},
+    0
 };
 
 const BoatSensorConfig::TemperatureSensorDef BoatSensorConfig::SEAWATER_IN_TEMP = {
     "seaWaterInTemperature",
     "propulsion.main.seaWaterInTemperature",
     "Sea Water In Temperature",
-    140, 150, 160
+    140, 150, 160,
+    {Calibration::LINEAR, 1.0f, 0.0f, nullptr, 0},
+    0
 };
 
 const BoatSensorConfig::TemperatureSensorDef BoatSensorConfig::SEAWATER_OUT_TEMP = {
     "seaWaterOutTemperature",
     "propulsion.main.seaWaterOutTemperature",
     "Sea Water Out Temperature",
-    170, 180, 190
+    170, 180, 190,
+    {Calibration::LINEAR, 1.0f, 0.0f, nullptr, 0},
+    0
+};
+
+const BoatSensorConfig::TemperatureSensorDef BoatSensorConfig::EXHAUST_TEMP = {
+    "exhaustTemperature",
+    "propulsion.main.exhaustTemperature",
+    "Exhaust Temperature",
+    192, 194, 196,
+    {Calibration::LINEAR, 1.0f, 0.0f, nullptr, 0},
+    1
+};
+
+const BoatSensorConfig::ThermocoupleSensorDef BoatSensorConfig::EXHAUST_GAS_TEMP = {
+    "exhaustGasTemperature",
+    "propulsion.main.exhaustGasTemperature",
+    "Exhaust Gas Temperature",
+    ThermocoupleChip::MAX31855,
+    EXHAUST_GAS_CS_PIN,
+    ThermocoupleCodec::MAX31856_TYPE_K,
+    197, 198,
+    {Calibration::LINEAR, 1.0f, 0.0f, nullptr, 0}
+};
+const char BoatSensorConfig::THERMOCOUPLE_HEALTH_SK_PREFIX[] =
+    "sensors.engineController.thermocoupleHealth.";
+
+// Pressure [Pa] = (1.5 * mV - 500) / 4000 * 1e6
+const BoatSensorConfig::AnalogSensorDef BoatSensorConfig::OIL_PRESSURE = {
+    "oilPressure",
+    "propulsion.main.oilPressure",
+    "Oil Pressure",
+    OIL_PRESSURE_ADC_CHANNEL,
+    300, 310,
+    {Calibration::LINEAR, 375.0f, -125000.0f, nullptr, 0}
+};
+
+// Voltage [V] = mV / 1000 * (47k + 10k) / 10k
+const BoatSensorConfig::AnalogSensorDef BoatSensorConfig::ALTERNATOR_VOLTAGE = {
+    "alternatorVoltage",
+    "electrical.alternators.main.voltage",
+    "Alternator Voltage",
+    ALTERNATOR_VOLTAGE_ADC_CHANNEL,
+    320, 330,
+    {Calibration::LINEAR, 0.0057f, 0.0f, nullptr, 0}
+};
+
+// Sender (10 ohm empty, 180 ohm full) below a 100 ohm pull-up to 3.3 V:
+// mV = 3300 * R / (R + 100), so level is not linear in the pin voltage
+const CalibrationTable::Point BoatSensorConfig::FUEL_LEVEL_TABLE[] = {
+    {300.0f, 0.0f},
+    {1136.1f, 0.25f},
+    {1607.7f, 0.5f},
+    {1910.5f, 0.75f},
+    {2121.4f, 1.0f}
+};
+const size_t BoatSensorConfig::FUEL_LEVEL_TABLE_SIZE =
+    sizeof(FUEL_LEVEL_TABLE) / sizeof(FUEL_LEVEL_TABLE[0]);
+
+const BoatSensorConfig::AnalogSensorDef BoatSensorConfig::FUEL_LEVEL = {
+    "fuelLevel",
+    "tanks.fuel.main.currentLevel",
+    "Fuel Level",
+    FUEL_LEVEL_ADC_CHANNEL,
+    340, 350,
+    {Calibration::TABLE, 1.0f, 0.0f, FUEL_LEVEL_TABLE, FUEL_LEVEL_TABLE_SIZE}
 };
 
 } // namespace BoatEngine
@@ -0,0 +1,334 @@
+#include "sensor_recording.h"
+
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr uint8_t SensorRecorder::VERSION;
+constexpr size_t SensorRecorder::HEADER_SIZE;
+constexpr size_t SensorRecorder::BUFFER_SIZE;
+constexpr size_t SensorRecord::MAX_PATH;
+
+static const uint8_t MAGIC[4] = {'B', 'E', 'R', 'C'};
+static const size_t SCRATCHPAD_BYTES = 9;
+
+SensorRecorder::SensorRecorder(RecordingSink* sink, Clock clock, size_t max_bytes)
+    : sink_(sink)
+    , clock_(clock)
+    , max_bytes_(max_bytes)
+    , recording_(false)
+    , last_ms_(0)
+    , used_(0)
+    , recorded_(0)
+    , records_(0)
+    , dropped_(0) {
+}
+
+bool SensorRecorder::begin() {
+    if (max_bytes_ < HEADER_SIZE) {
+        return false;
+    }
+    used_ = 0;
+    for (size_t i = 0; i < sizeof(MAGIC); i++) {
+        put(MAGIC[i]);
+    }
+    put(VERSION);
+    recorded_ = used_;
+    records_ = 0;
+    dropped_ = 0;
+    last_ms_ = clock_();
+    recording_ = true;
+    return true;
+}
+
+size_t SensorRecorder::varintSize(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+void SensorRecorder::putVarint(uint32_t value) {
+    while (value >= 0x80) {
+        put(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    put(static_cast<uint8_t>(value));
+}
+
+bool SensorRecorder::startRecord(RecordType type, size_t size) {
+    if (!recording_) {
+        dropped_++;
+        return false;
+    }
+    const uint32_t now = clock_();
+    const uint32_t delta = now - last_ms_;
+    size += 1 + varintSize(delta);
+    if (recorded_ + size > max_bytes_) {
+        // Full: keep what was recorded so far intact
+        flush();
+        recording_ = false;
+        dropped_++;
+        return false;
+    }
+    if (used_ + size > BUFFER_SIZE && !flush()) {
+        dropped_++;
+        return false;
+    }
+    
+    last_ms_ = now;
+    put(static_cast<uint8_t>(type));
+    putVarint(delta);
+    recorded_ += size;
+    records_++;
+    return true;
+}
+
+void SensorRecorder::putFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        put(static_cast<uint8_t>(bits >> shift));
+    }
+}
+
+bool SensorRecorder::startChannel(RecordChannelKind kind, uint8_t channel,
+                                  const char* sk_path, size_t definition_size) {
+    size_t length = strlen(sk_path);
+    if (length > SensorRecord::MAX_PATH) {
+        length = SensorRecord::MAX_PATH;
+    }
+    if (!startRecord(RecordType::CHANNEL, 3 + length + definition_size)) {
+        return false;
+    }
+    put(channel);
+    put(static_cast<uint8_t>(kind));
+    put(static_cast<uint8_t>(length));
+    memcpy(&buffer_[used_], sk_path, length);
+    used_ += length;
+    return true;
+}
+
+void SensorRecorder::declarePulseChannel(uint8_t channel, const char* sk_path,
+                                         float pulses_per_unit, float ratio) {
+    if (!startChannel(RecordChannelKind::PULSE, channel, sk_path, 8)) {
+        return;
+    }
+    putFloat(pulses_per_unit);
+    putFloat(ratio);
+}
+
+void SensorRecorder::declareTemperatureChannel(
+    uint8_t channel, const char* sk_path,
+    const BoatSensorConfig::CalibrationDef& calibration) {
+    if (calibration.type == BoatSensorConfig::Calibration::LINEAR) {
+        if (startChannel(RecordChannelKind::TEMPERATURE, channel, sk_path, 9)) {
+            put(static_cast<uint8_t>(calibration.type));
+            putFloat(calibration.multiplier);
+            putFloat(calibration.offset);
+        }
+        return;
+    }
+    
+    const size_t points = calibration.table_size < CalibrationTable::MAX_POINTS
+        ? calibration.table_size : CalibrationTable::MAX_POINTS;
+    if (!startChannel(RecordChannelKind::TEMPERATURE, channel, sk_path, 2 + 8 * points)) {
+        return;
+    }
+    put(static_cast<uint8_t>(calibration.type));
+    put(static_cast<uint8_t>(points));
+    for (size_t i = 0; i < points; i++) {
+        putFloat(calibration.table[i].input);
+        putFloat(calibration.table[i].output);
+    }
+}
+
+void SensorRecorder::recordPulses(uint8_t channel, uint32_t edges,
+                                  uint32_t elapsed_ms) {
+    if (!startRecord(RecordType::PULSES,
+                     1 + varintSize(edges) + varintSize(elapsed_ms))) {
+        return;
+    }
+    put(channel);
+    putVarint(edges);
+    putVarint(elapsed_ms);
+}
+
+void SensorRecorder::onScratchpad(uint8_t tag, const uint8_t* scratchpad) {
+    if (!startRecord(RecordType::SCRATCHPAD, 1 + SCRATCHPAD_BYTES)) {
+        return;
+    }
+    put(tag);
+    memcpy(&buffer_[used_], scratchpad, SCRATCHPAD_BYTES);
+    used_ += SCRATCHPAD_BYTES;
+}
+
+void SensorRecorder::onReadFailure(uint8_t tag, TemperatureReadStatus status) {
+    if (!startRecord(RecordType::READ_FAILURE, 2)) {
+        return;
+    }
+    put(tag);
+    put(static_cast<uint8_t>(status));
+}
+
+bool SensorRecorder::flush() {
+    if (used_ == 0) {
+        return true;
+    }
+    const bool written = sink_->write(buffer_, used_);
+    used_ = 0;
+    if (!written) {
+        recording_ = false;
+    }
+    return written;
+}
+
+SensorRecordingReader::SensorRecordingReader(const uint8_t* data, size_t size)
+    : data_(data)
+    , size_(size)
+    , pos_(0)
+    , time_ms_(0)
+    , corrupt_(false) {
+}
+
+bool SensorRecordingReader::begin() {
+    pos_ = 0;
+    time_ms_ = 0;
+    corrupt_ = false;
+    if (size_ < SensorRecorder::HEADER_SIZE ||
+        memcmp(data_, MAGIC, sizeof(MAGIC)) != 0 ||
+        data_[sizeof(MAGIC)] != SensorRecorder::VERSION) {
+        corrupt_ = true;
+        return false;
+    }
+    pos_ = SensorRecorder::HEADER_SIZE;
+    return true;
+}
+
+bool SensorRecordingReader::get(uint8_t* byte) {
+    if (pos_ >= size_) {
+        return false;
+    }
+    *byte = data_[pos_++];
+    return true;
+}
+
+bool SensorRecordingReader::getFloat(float* value) {
+    if (pos_ + 4 > size_) {
+        return false;
+    }
+    uint32_t bits = 0;
+    for (unsigned i = 0; i < 4; i++) {
+        bits |= static_cast<uint32_t>(data_[pos_++]) << (8 * i);
+    }
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+bool SensorRecordingReader::getDefinition(SensorRecord* record) {
+    if (record->kind == RecordChannelKind::PULSE) {
+        return getFloat(&record->pulses_per_unit) && getFloat(&record->ratio);
+    }
+    if (record->kind != RecordChannelKind::TEMPERATURE) {
+        return false;
+    }
+    uint8_t type;
+    if (!get(&type)) {
+        return false;
+    }
+    record->calibration = static_cast<BoatSensorConfig::Calibration>(type);
+    switch (record->calibration) {
+        case BoatSensorConfig::Calibration::LINEAR:
+            return getFloat(&record->multiplier) && getFloat(&record->offset);
+        case BoatSensorConfig::Calibration::TABLE:
+            if (!get(&record->table_size) ||
+                record->table_size > CalibrationTable::MAX_POINTS) {
+                return false;
+            }
+            for (size_t i = 0; i < record->table_size; i++) {
+                if (!getFloat(&record->table[i].input) ||
+                    !getFloat(&record->table[i].output)) {
+                    return false;
+                }
+            }
+            return true;
+    }
+    return false;
+}
+
+bool SensorRecordingReader::getVarint(uint32_t* value) {
+    *value = 0;
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        uint8_t byte;
+        if (!get(&byte)) {
+            return false;
+        }
+        *value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SensorRecordingReader::next(SensorRecord* record) {
+    if (corrupt_ || pos_ >= size_) {
+        return false;
+    }
+    
+    // Every record starts with its type, time delta and channel
+    uint8_t type;
+    uint32_t delta;
+    bool ok = get(&type) && getVarint(&delta) && get(&record->channel);
+    if (ok) {
+        time_ms_ += delta;
+        record->time_ms = time_ms_;
+        record->type = static_cast<RecordType>(type);
+        
+        switch (record->type) {
+            case RecordType::CHANNEL: {
+                uint8_t kind;
+                uint8_t length;
+                ok = get(&kind) && get(&length) && length <= SensorRecord::MAX_PATH &&
+                     pos_ + length <= size_;
+                if (ok) {
+                    record->kind = static_cast<RecordChannelKind>(kind);
+                    memcpy(record->sk_path, &data_[pos_], length);
+                    record->sk_path[length] = '\0';
+                    pos_ += length;
+                    ok = getDefinition(record);
+                }
+                break;
+            }
+            case RecordType::PULSES:
+                ok = getVarint(&record->edges) && getVarint(&record->elapsed_ms);
+                break;
+            case RecordType::SCRATCHPAD:
+                ok = pos_ + SCRATCHPAD_BYTES <= size_;
+                if (ok) {
+                    memcpy(record->scratchpad, &data_[pos_], SCRATCHPAD_BYTES);
+                    pos_ += SCRATCHPAD_BYTES;
+                }
+                break;
+            case RecordType::READ_FAILURE: {
+                uint8_t status = 0;
+                ok = get(&status);
+                record->status = static_cast<TemperatureReadStatus>(status);
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+    }
+    
+    if (!ok) {
+        // A recording cut short by a reset ends mid-record
+        corrupt_ = true;
+    }
+    return ok;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,155 @@
+#include "sensor_recording_manager.h"
+
+#include <SPIFFS.h>
+
+#include <cstdint>
+
+#include "sensesp/net/http_server.h"
+#include "sensesp/ui/config_item.h"
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+static const size_t DOWNLOAD_CHUNK = 512;
+
+/**
+ * @brief Appends the recording to a SPIFFS file
+ *
+ * Counts the bytes that have reached flash, so the download handler on
+ * the httpd task knows how much of the file is complete.
+ */
+class FileRecordingSink : public RecordingSink {
+public:
+    FileRecordingSink(const char* path, std::atomic<size_t>* flushed)
+        : file_(SPIFFS.open(path, FILE_WRITE))
+        , flushed_(flushed) {
+    }
+    
+    bool isOpen() { return static_cast<bool>(file_); }
+    
+    bool write(const uint8_t* data, size_t size) override {
+        if (!file_ || file_.write(data, size) != size) {
+            return false;
+        }
+        file_.flush();
+        flushed_->fetch_add(size);
+        return true;
+    }
+
+private:
+    fs::File file_;
+    std::atomic<size_t>* flushed_;
+};
+
+static uint32_t recordingClock() {
+    return millis();
+}
+
+SensorRecordingManager::SensorRecordingManager(const String& config_path)
+    : FileSystemSaveable(config_path)
+    , enabled_(false)
+    , max_kb_(BoatSensorConfig::RECORDING_DEFAULT_MAX_KB)
+    , sink_(nullptr)
+    , recorder_(nullptr)
+    , servable_bytes_(SIZE_MAX) {
+    this->load();
+}
+
+void SensorRecordingManager::start(PulseInputManager* pulses,
+                                   TemperatureSensorManager* temperatures) {
+    ConfigItem(this)
+        ->set_title("Sensor Recording")
+        ->set_description("Record raw sensor inputs for replay. Takes effect after a restart")
+        ->set_sort_order(BoatSensorConfig::RECORDING_SORT_ORDER);
+    
+    serveRecording();
+    if (!enabled_) {
+        return;
+    }
+    
+    // The file is truncated below; serve only what the sink completes
+    servable_bytes_.store(0);
+    auto* sink = new FileRecordingSink(BoatSensorConfig::RECORDING_FILE, &servable_bytes_);
+    if (!sink->isOpen()) {
+        ESP_LOGE("SensorRecordingManager", "Cannot create %s",
+                 BoatSensorConfig::RECORDING_FILE);
+        delete sink;
+        servable_bytes_.store(SIZE_MAX);
+        return;
+    }
+    sink_ = sink;
+    recorder_ = new SensorRecorder(sink_, recordingClock,
+                                   static_cast<size_t>(max_kb_) * 1024);
+    recorder_->begin();
+    pulses->setRecorder(recorder_);
+    temperatures->setRecorder(recorder_);
+    ESP_LOGI("SensorRecordingManager", "Recording raw inputs to %s (%u KB max)",
+             BoatSensorConfig::RECORDING_FILE, max_kb_);
+    
+    event_loop()->onRepeat(BoatSensorConfig::RECORDING_FLUSH_MS, [this]() {
+        const bool was_recording = recorder_->isRecording();
+        recorder_->flush();
+        if (was_recording && !recorder_->isRecording()) {
+            ESP_LOGW("SensorRecordingManager", "Recording stopped at %u bytes",
+                     static_cast<unsigned>(recorder_->getBytesRecorded()));
+        }
+    });
+}
+
+void SensorRecordingManager::serveRecording() {
+    auto handler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, BoatSensorConfig::RECORDING_HTTP_PATH,
+        [this](httpd_req_t* req) {
+            // Runs on the httpd task: the recorder belongs to the event
+            // loop, which flushes it every RECORDING_FLUSH_MS, so serve only
+            // the bytes already on flash and leave the recorder alone
+            size_t remaining = servable_bytes_.load();
+            fs::File file = SPIFFS.open(BoatSensorConfig::RECORDING_FILE, FILE_READ);
+            if (!file) {
+                httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No recording");
+                return ESP_FAIL;
+            }
+            httpd_resp_set_type(req, "application/octet-stream");
+            httpd_resp_set_hdr(req, "Content-Disposition",
+                               "attachment; filename=\"recording.bin\"");
+            
+            char chunk[DOWNLOAD_CHUNK];
+            size_t length;
+            while (remaining > 0 &&
+                   (length = file.read(reinterpret_cast<uint8_t*>(chunk),
+                                       remaining < sizeof(chunk) ? remaining
+                                                                 : sizeof(chunk))) > 0) {
+                if (httpd_resp_send_chunk(req, chunk, length) != ESP_OK) {
+                    file.close();
+                    return ESP_FAIL;
+                }
+                remaining -= length;
+            }
+            file.close();
+            return httpd_resp_send_chunk(req, nullptr, 0);
+        });
+    sensesp_app->get_http_server()->add_handler(handler);
+}
+
+bool SensorRecordingManager::to_json(JsonObject& root) {
+    root["enabled"] = enabled_;
+    root["max_kb"] = max_kb_;
+    return true;
+}
+
+bool SensorRecordingManager::from_json(const JsonObject& config) {
+    if (!config["enabled"].is<bool>() || !config["max_kb"].is<unsigned int>()) {
+        return false;
+    }
+    enabled_ = config["enabled"].as<bool>();
+    max_kb_ = config["max_kb"].as<unsigned int>();
+    return true;
+}
+
+const String ConfigSchema(const SensorRecordingManager& obj) {
+    return R"###({"type":"object","properties":{"enabled":{"title":"Record raw inputs","description":"Record pulse counts and temperature scratchpads from boot, replacing the previous recording","type":"boolean"},"max_kb":{"title":"Maximum size (KB)","description":"Recording stops when the file reaches this size. Mind the free SPIFFS space","type":"integer"}}})###";
+}
+
+} // namespace BoatEngine
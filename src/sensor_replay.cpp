@@ -0,0 +1,145 @@
+#include "sensor_replay.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "pulse_counter_bank.h"
+
+namespace BoatEngine {
+
+constexpr size_t SensorReplay::MAX_CHANNELS;
+
+SensorReplay::TemperaturePipeline::TemperaturePipeline()
+    : defined(false)
+    , calibration(BoatSensorConfig::Calibration::LINEAR)
+    , multiplier(1.0f)
+    , offset(0.0f)
+    , health(BoatSensorConfig::ONEWIRE_HEALTH_LIMITS) {
+}
+
+SensorReplay::SensorReplay(OutputHandler handler, void* context)
+    : handler_(handler)
+    , context_(context)
+    , records_(0)
+    , outputs_(0)
+    , unmatched_(0) {
+    for (size_t i = 0; i < MAX_CHANNELS; i++) {
+        pulses_[i].defined = false;
+    }
+}
+
+bool SensorReplay::run(const uint8_t* data, size_t size) {
+    SensorRecordingReader reader(data, size);
+    if (!reader.begin()) {
+        return false;
+    }
+    
+    SensorRecord record;
+    while (reader.next(&record)) {
+        records_++;
+        switch (record.type) {
+            case RecordType::CHANNEL:
+                declare(record);
+                break;
+            case RecordType::PULSES:
+                replayPulses(record);
+                break;
+            case RecordType::SCRATCHPAD: {
+                TemperatureReading reading;
+                reading.tag = record.channel;
+                reading.celsius = 0.0f;
+                reading.status = decodeDs18b20Scratchpad(record.scratchpad,
+                                                         &reading.celsius);
+                replayTemperature(record, reading);
+                break;
+            }
+            case RecordType::READ_FAILURE: {
+                TemperatureReading reading;
+                reading.tag = record.channel;
+                reading.status = record.status;
+                reading.celsius = 0.0f;
+                replayTemperature(record, reading);
+                break;
+            }
+        }
+    }
+    return !reader.isCorrupt();
+}
+
+void SensorReplay::declare(const SensorRecord& record) {
+    if (record.channel >= MAX_CHANNELS) {
+        return;
+    }
+    if (record.kind == RecordChannelKind::PULSE) {
+        PulsePipeline& pipeline = pulses_[record.channel];
+        pipeline.defined = true;
+        memcpy(pipeline.sk_path, record.sk_path, sizeof(pipeline.sk_path));
+        pipeline.pulses_per_unit = record.pulses_per_unit;
+        pipeline.ratio = record.ratio;
+        return;
+    }
+    
+    TemperaturePipeline& pipeline = temperatures_[record.channel];
+    memcpy(pipeline.sk_path, record.sk_path, sizeof(pipeline.sk_path));
+    pipeline.calibration = record.calibration;
+    pipeline.multiplier = record.multiplier;
+    pipeline.offset = record.offset;
+    // A table the device would not have accepted leaves the channel undefined
+    pipeline.defined = record.calibration != BoatSensorConfig::Calibration::TABLE ||
+                       pipeline.table.setPoints(record.table, record.table_size);
+}
+
+void SensorReplay::replayPulses(const SensorRecord& record) {
+    if (record.channel >= MAX_CHANNELS || !pulses_[record.channel].defined) {
+        unmatched_++;
+        return;
+    }
+    const PulsePipeline& pipeline = pulses_[record.channel];
+    const float frequency = PulseCounterBank::toFrequency(record.edges, record.elapsed_ms);
+    emit(pipeline.sk_path, record.time_ms,
+         scalePulseFrequency(frequency, pipeline.pulses_per_unit, pipeline.ratio));
+}
+
+void SensorReplay::replayTemperature(const SensorRecord& record,
+                                     const TemperatureReading& reading) {
+    if (record.channel >= MAX_CHANNELS || !temperatures_[record.channel].defined) {
+        unmatched_++;
+        return;
+    }
+    TemperaturePipeline& pipeline = temperatures_[record.channel];
+    
+    float kelvin;
+    switch (pipeline.health.assess(reading)) {
+        case TemperatureHealth::Verdict::VALID:
+            kelvin = reading.celsius + 273.15f;
+            break;
+        case TemperatureHealth::Verdict::INVALID:
+            kelvin = NAN;
+            break;
+        default:
+            // The device retried; the retry is the next record
+            return;
+    }
+    
+    const float value = pipeline.calibration == BoatSensorConfig::Calibration::TABLE
+        ? pipeline.table.evaluate(kelvin)
+        : kelvin * pipeline.multiplier + pipeline.offset;
+    emit(pipeline.sk_path, record.time_ms, value);
+}
+
+void SensorReplay::emit(const char* sk_path, uint32_t time_ms, float value) {
+    outputs_++;
+    if (handler_ != nullptr) {
+        Output output = {sk_path, time_ms, value};
+        handler_(output, context_);
+    }
+}
+
+const TemperatureHealth* SensorReplay::getHealth(uint8_t sensor) const {
+    if (sensor >= MAX_CHANNELS || !temperatures_[sensor].defined) {
+        return nullptr;
+    }
+    return &temperatures_[sensor].health;
+}
+
+} // namespace BoatEngine
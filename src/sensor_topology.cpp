@@ -0,0 +1,253 @@
+#include "sensor_topology.h"
+
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr size_t SensorTopology::MAX_TEMPERATURE_SENSORS;
+constexpr size_t SensorTopology::MAX_PULSE_CHANNELS;
+constexpr size_t SensorTopology::STRING_POOL_SIZE;
+
+static bool isEmpty(const char* text) {
+    return text == nullptr || text[0] == '\0';
+}
+
+SensorTopology::SensorTopology()
+    : temperature_count_(0)
+    , pulse_count_(0)
+    , pool_used_(0)
+    , error_(Error::NONE) {
+}
+
+void SensorTopology::clear() {
+    temperature_count_ = 0;
+    pulse_count_ = 0;
+    pool_used_ = 0;
+    error_ = Error::NONE;
+}
+
+void SensorTopology::loadDefaults() {
+    clear();
+    addTemperature(BoatSensorConfig::COOLANT_TEMP);
+    addTemperature(BoatSensorConfig::SEAWATER_IN_TEMP);
+    addTemperature(BoatSensorConfig::SEAWATER_OUT_TEMP);
+    addTemperature(BoatSensorConfig::EXHAUST_TEMP);
+    addPulse(PulseRole::RPM, BoatSensorConfig::ENGINE_RPM);
+    addPulse(PulseRole::FUEL_SUPPLY, BoatSensorConfig::FUEL_SUPPLY_FLOW);
+    addPulse(PulseRole::FUEL_RETURN, BoatSensorConfig::FUEL_RETURN_FLOW);
+    finish();
+}
+
+const char* SensorTopology::intern(const char* text) {
+    const size_t length = strlen(text) + 1;
+    if (length > STRING_POOL_SIZE - pool_used_) {
+        reject(Error::POOL_FULL);
+        return nullptr;
+    }
+    char* copy = &pool_[pool_used_];
+    memcpy(copy, text, length);
+    pool_used_ += length;
+    return copy;
+}
+
+bool SensorTopology::addTemperature(const BoatSensorConfig::TemperatureSensorDef& def) {
+    if (!isValid()) {
+        return false;
+    }
+    if (temperature_count_ >= MAX_TEMPERATURE_SENSORS) {
+        return reject(Error::TOO_MANY_SENSORS);
+    }
+    if (isEmpty(def.base_name) || isEmpty(def.signal_k_path) || isEmpty(def.human_label)) {
+        return reject(Error::MISSING_FIELD);
+    }
+    if (findTemperature(def.base_name) != nullptr) {
+        return reject(Error::DUPLICATE_NAME);
+    }
+    if (!isValidBus(def.onewire_bus)) {
+        return reject(Error::BAD_BUS);
+    }
+    
+    BoatSensorConfig::TemperatureSensorDef entry = def;
+    entry.base_name = intern(def.base_name);
+    entry.signal_k_path = intern(def.signal_k_path);
+    entry.human_label = intern(def.human_label);
+    if (!isValid()) {
+        return false;
+    }
+    temperatures_[temperature_count_++] = entry;
+    return true;
+}
+
+bool SensorTopology::addPulse(PulseRole role, const BoatSensorConfig::PulseChannelDef& def) {
+    if (!isValid()) {
+        return false;
+    }
+    if (pulse_count_ >= MAX_PULSE_CHANNELS) {
+        return reject(Error::TOO_MANY_SENSORS);
+    }
+    if (isEmpty(def.signal_k_path) || isEmpty(def.human_label) ||
+        isEmpty(def.scaling_config_path) || isEmpty(def.sk_config_path)) {
+        return reject(Error::MISSING_FIELD);
+    }
+    if (role != PulseRole::OTHER && findPulse(role) != nullptr) {
+        return reject(Error::DUPLICATE_ROLE);
+    }
+    if (!isUsablePulsePin(def.pin)) {
+        return reject(Error::BAD_PIN);
+    }
+    if (pinInUse(def.pin)) {
+        return reject(Error::DUPLICATE_PIN);
+    }
+    // The config paths name the persisted scaling and path settings
+    for (size_t i = 0; i < pulse_count_; i++) {
+        if (strcmp(pulses_[i].def.scaling_config_path, def.scaling_config_path) == 0 ||
+            strcmp(pulses_[i].def.sk_config_path, def.sk_config_path) == 0) {
+            return reject(Error::DUPLICATE_NAME);
+        }
+    }
+    if (!(def.pulses_per_unit > 0.0f)) {
+        return reject(Error::BAD_SCALING);
+    }
+    
+    PulseEntry entry = {role, def};
+    entry.def.signal_k_path = intern(def.signal_k_path);
+    entry.def.human_label = intern(def.human_label);
+    entry.def.scaling_config_path = intern(def.scaling_config_path);
+    entry.def.sk_config_path = intern(def.sk_config_path);
+    if (!isValid()) {
+        return false;
+    }
+    pulses_[pulse_count_++] = entry;
+    return true;
+}
+
+bool SensorTopology::finish() {
+    if (isValid() && findPulse(PulseRole::RPM) == nullptr) {
+        reject(Error::MISSING_RPM);
+    }
+    return isValid();
+}
+
+const BoatSensorConfig::PulseChannelDef* SensorTopology::findPulse(PulseRole role) const {
+    for (size_t i = 0; i < pulse_count_; i++) {
+        if (pulses_[i].role == role) {
+            return &pulses_[i].def;
+        }
+    }
+    return nullptr;
+}
+
+const BoatSensorConfig::TemperatureSensorDef* SensorTopology::findTemperature(
+    const char* base_name) const {
+    for (size_t i = 0; i < temperature_count_; i++) {
+        if (strcmp(temperatures_[i].base_name, base_name) == 0) {
+            return &temperatures_[i];
+        }
+    }
+    return nullptr;
+}
+
+bool SensorTopology::pinInUse(uint8_t pin) const {
+    for (size_t i = 0; i < pulse_count_; i++) {
+        if (pulses_[i].def.pin == pin) {
+            return true;
+        }
+    }
+    return isReservedPin(pin);
+}
+
+bool SensorTopology::isValidBus(int bus) {
+    return bus >= 0 && static_cast<size_t>(bus) < BoatSensorConfig::ONEWIRE_BUS_COUNT;
+}
+
+bool SensorTopology::isUsablePulsePin(int pin) {
+    // SOC_GPIO_VALID_GPIO_MASK of the ESP32: 0-19, 21-23, 25-27, 32-39
+    static const uint64_t VALID_GPIO_MASK = 0xFF0EEFFFFFull;
+    static const uint64_t FLASH_GPIO_MASK = 0x0FC0ull;         // 6-11
+    static const uint64_t INPUT_ONLY_GPIO_MASK = 0xFC00000000ull;   // 34-39
+    if (pin < 0 || pin > 39) {
+        return false;
+    }
+    const uint64_t bit = 1ull << pin;
+    return (VALID_GPIO_MASK & bit) != 0 && (FLASH_GPIO_MASK & bit) == 0 &&
+           (INPUT_ONLY_GPIO_MASK & bit) == 0;
+}
+
+// GPIO of each ADC1 channel
+static const uint8_t ADC1_CHANNEL_PINS[] = {36, 37, 38, 39, 32, 33, 34, 35};
+
+static uint8_t adcPin(const BoatSensorConfig::AnalogSensorDef& def) {
+    return ADC1_CHANNEL_PINS[def.adc_channel & 7];
+}
+
+bool SensorTopology::isReservedPin(uint8_t pin) {
+    for (size_t i = 0; i < BoatSensorConfig::ONEWIRE_BUS_COUNT; i++) {
+        if (BoatSensorConfig::ONEWIRE_BUSES[i].pin == pin) {
+            return true;
+        }
+    }
+    const uint8_t reserved[] = {
+        BoatSensorConfig::THERMOCOUPLE_SCLK_PIN,
+        BoatSensorConfig::THERMOCOUPLE_MISO_PIN,
+        BoatSensorConfig::THERMOCOUPLE_MOSI_PIN,
+        BoatSensorConfig::EXHAUST_GAS_TEMP.cs_pin,
+        BoatSensorConfig::VIBRATION_SDA_PIN,
+        BoatSensorConfig::VIBRATION_SCL_PIN,
+        adcPin(BoatSensorConfig::OIL_PRESSURE),
+        adcPin(BoatSensorConfig::ALTERNATOR_VOLTAGE),
+        adcPin(BoatSensorConfig::FUEL_LEVEL)
+    };
+    for (uint8_t claimed : reserved) {
+        if (claimed == pin) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SensorTopology::reject(Error error) {
+    if (error_ == Error::NONE) {
+        error_ = error;
+    }
+    return false;
+}
+
+const char* SensorTopology::roleName(PulseRole role) {
+    switch (role) {
+        case PulseRole::RPM: return "rpm";
+        case PulseRole::FUEL_SUPPLY: return "fuelSupply";
+        case PulseRole::FUEL_RETURN: return "fuelReturn";
+        default: return "other";
+    }
+}
+
+bool SensorTopology::parseRole(const char* name, PulseRole* role) {
+    static const PulseRole roles[] = {
+        PulseRole::RPM, PulseRole::FUEL_SUPPLY, PulseRole::FUEL_RETURN, PulseRole::OTHER};
+    for (PulseRole candidate : roles) {
+        if (strcmp(name, roleName(candidate)) == 0) {
+            *role = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* SensorTopology::errorName(Error error) {
+    switch (error) {
+        case Error::NONE: return "ok";
+        case Error::TOO_MANY_SENSORS: return "too many sensors";
+        case Error::POOL_FULL: return "strings too long";
+        case Error::MISSING_FIELD: return "missing field";
+        case Error::DUPLICATE_NAME: return "duplicate name";
+        case Error::DUPLICATE_PIN: return "pin already in use";
+        case Error::DUPLICATE_ROLE: return "duplicate role";
+        case Error::MISSING_RPM: return "no rpm channel";
+        case Error::BAD_BUS: return "no such OneWire bus";
+        case Error::BAD_SCALING: return "pulses per unit must be positive";
+        case Error::BAD_PIN: return "not a usable GPIO";
+    }
+    return "unknown";
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,187 @@
+#include "sensor_topology_manager.h"
+
+#include "sensesp/ui/config_item.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+// Sort orders for entries that do not give their own, after everything
+// built in
+static constexpr int EXTRA_TEMPERATURE_SORT_ORDER = 1000;
+static constexpr int EXTRA_PULSE_SORT_ORDER = 1100;
+
+static const char* textOf(const JsonVariant& value) {
+    return value.is<const char*>() ? value.as<const char*>() : nullptr;
+}
+
+static int intOr(const JsonVariant& value, int fallback) {
+    return value.is<int>() ? value.as<int>() : fallback;
+}
+
+SensorTopologyManager::SensorTopologyManager(const String& config_path)
+    : FileSystemSaveable(config_path)
+    , booted_(false)
+    , has_pending_(false)
+    , from_file_(false)
+    , load_time_us_(0) {
+    topology_.loadDefaults();
+    
+    const uint32_t start_us = micros();
+    this->load();
+    load_time_us_ = micros() - start_us;
+    booted_ = true;
+    
+    if (from_file_) {
+        ESP_LOGI("SensorTopologyManager",
+                 "%u temperature, %u pulse channels from %s in %u us (%u bytes of strings)",
+                 static_cast<unsigned>(topology_.getTemperatureCount()),
+                 static_cast<unsigned>(topology_.getPulseCount()), config_path.c_str(),
+                 static_cast<unsigned>(load_time_us_),
+                 static_cast<unsigned>(topology_.getPoolUsed()));
+    } else {
+        ESP_LOGI("SensorTopologyManager", "Built-in sensors (checked %s in %u us)",
+                 config_path.c_str(), static_cast<unsigned>(load_time_us_));
+    }
+}
+
+void SensorTopologyManager::start() {
+    ConfigItem(this)
+        ->set_title("Sensor Topology")
+        ->set_description("Temperature sensors and pulse channels to set up. "
+                          "Takes effect after a restart")
+        ->set_sort_order(BoatSensorConfig::TOPOLOGY_SORT_ORDER);
+}
+
+bool SensorTopologyManager::to_json(JsonObject& root) {
+    write(has_pending_ ? pending_ : topology_, root);
+    return true;
+}
+
+bool SensorTopologyManager::from_json(const JsonObject& config) {
+    if (booted_) {
+        has_pending_ = parse(config, &pending_);
+        if (!has_pending_) {
+            ESP_LOGW("SensorTopologyManager", "Rejected: %s",
+                     SensorTopology::errorName(pending_.getError()));
+        }
+        return has_pending_;
+    }
+    
+    from_file_ = parse(config, &topology_);
+    if (!from_file_) {
+        ESP_LOGE("SensorTopologyManager", "Saved topology rejected (%s), using built-in sensors",
+                 SensorTopology::errorName(topology_.getError()));
+        topology_.loadDefaults();
+    }
+    return from_file_;
+}
+
+bool SensorTopologyManager::parse(const JsonObject& config, SensorTopology* topology) {
+    topology->clear();
+    if (!config["temperature"].is<JsonArray>() || !config["pulse"].is<JsonArray>()) {
+        return topology->reject(SensorTopology::Error::MISSING_FIELD);
+    }
+    JsonArray temperatures = config["temperature"];
+    JsonArray pulses = config["pulse"];
+    // Refuse oversized arrays before reading them, to bound the boot time
+    if (temperatures.size() > SensorTopology::MAX_TEMPERATURE_SENSORS ||
+        pulses.size() > SensorTopology::MAX_PULSE_CHANNELS) {
+        return topology->reject(SensorTopology::Error::TOO_MANY_SENSORS);
+    }
+    
+    int index = 0;
+    for (JsonObject item : temperatures) {
+        const int sort_order = EXTRA_TEMPERATURE_SORT_ORDER + 10 * index++;
+        // Check before narrowing, so 256 cannot pass as bus 0
+        const int bus = intOr(item["bus"], 0);
+        if (!SensorTopology::isValidBus(bus)) {
+            return topology->reject(SensorTopology::Error::BAD_BUS);
+        }
+        BoatSensorConfig::TemperatureSensorDef def = {
+            textOf(item["name"]),
+            textOf(item["path"]),
+            textOf(item["label"]),
+            intOr(item["sortOrder"], sort_order),
+            intOr(item["calibrationSortOrder"], sort_order + 1),
+            intOr(item["skSortOrder"], sort_order + 2),
+            // DS18B20s read in kelvin; each sensor's calibration stays
+            // editable on its own
+            {BoatSensorConfig::Calibration::LINEAR, 1.0f, 0.0f, nullptr, 0},
+            static_cast<uint8_t>(bus)
+        };
+        if (!topology->addTemperature(def)) {
+            return false;
+        }
+    }
+    
+    index = 0;
+    for (JsonObject item : pulses) {
+        const int sort_order = EXTRA_PULSE_SORT_ORDER + 10 * index++;
+        SensorTopology::PulseRole role = SensorTopology::PulseRole::OTHER;
+        const char* role_name = textOf(item["role"]);
+        if (role_name != nullptr && !SensorTopology::parseRole(role_name, &role)) {
+            return topology->reject(SensorTopology::Error::MISSING_FIELD);
+        }
+        if (!item["pin"].is<int>() || !item["pulsesPerUnit"].is<float>()) {
+            return topology->reject(SensorTopology::Error::MISSING_FIELD);
+        }
+        // Check before narrowing, so 272 cannot pass as GPIO 16
+        if (!SensorTopology::isUsablePulsePin(item["pin"].as<int>())) {
+            return topology->reject(SensorTopology::Error::BAD_PIN);
+        }
+        BoatSensorConfig::PulseChannelDef def = {
+            textOf(item["path"]),
+            textOf(item["label"]),
+            textOf(item["scalingConfig"]),
+            textOf(item["skConfig"]),
+            static_cast<uint8_t>(item["pin"].as<int>()),
+            item["pulsesPerUnit"].as<float>(),
+            item["ratio"].is<float>() ? item["ratio"].as<float>() : 1.0f,
+            intOr(item["sortOrder"], sort_order),
+            intOr(item["skSortOrder"], sort_order + 1)
+        };
+        if (!topology->addPulse(role, def)) {
+            return false;
+        }
+    }
+    return topology->finish();
+}
+
+void SensorTopologyManager::write(const SensorTopology& topology, JsonObject& root) {
+    JsonArray temperatures = root["temperature"].to<JsonArray>();
+    for (size_t i = 0; i < topology.getTemperatureCount(); i++) {
+        const BoatSensorConfig::TemperatureSensorDef& def = topology.getTemperature(i);
+        JsonObject item = temperatures.add<JsonObject>();
+        item["name"] = def.base_name;
+        item["path"] = def.signal_k_path;
+        item["label"] = def.human_label;
+        item["bus"] = def.onewire_bus;
+        item["sortOrder"] = def.sensor_sort_order;
+        item["calibrationSortOrder"] = def.linear_sort_order;
+        item["skSortOrder"] = def.sk_sort_order;
+    }
+    
+    JsonArray pulses = root["pulse"].to<JsonArray>();
+    for (size_t i = 0; i < topology.getPulseCount(); i++) {
+        const SensorTopology::PulseEntry& entry = topology.getPulse(i);
+        JsonObject item = pulses.add<JsonObject>();
+        item["role"] = SensorTopology::roleName(entry.role);
+        item["path"] = entry.def.signal_k_path;
+        item["label"] = entry.def.human_label;
+        item["pin"] = entry.def.pin;
+        item["pulsesPerUnit"] = entry.def.pulses_per_unit;
+        item["ratio"] = entry.def.ratio;
+        item["scalingConfig"] = entry.def.scaling_config_path;
+        item["skConfig"] = entry.def.sk_config_path;
+        item["sortOrder"] = entry.def.scaling_sort_order;
+        item["skSortOrder"] = entry.def.sk_sort_order;
+    }
+}
+
+const String ConfigSchema(const SensorTopologyManager& obj) {
+    return R"###({"type":"object","properties":{"temperature":{"title":"Temperature sensors","description":"DS18B20 sensors, at most 8. The name also names the sensor's own settings","type":"array","format":"table","maxItems":8,"items":{"type":"object","properties":{"name":{"type":"string","title":"Name"},"path":{"type":"string","title":"Signal K path"},"label":{"type":"string","title":"Label"},"bus":{"type":"integer","title":"OneWire bus","minimum":0,"maximum":1},"sortOrder":{"type":"integer","title":"Sort order"},"calibrationSortOrder":{"type":"integer","title":"Calibration sort order"},"skSortOrder":{"type":"integer","title":"Path sort order"}}}},"pulse":{"title":"Pulse channels","description":"RPM pickup and flow meters, at most 8. Exactly one must have the rpm role","type":"array","format":"table","maxItems":8,"items":{"type":"object","properties":{"role":{"type":"string","title":"Role","enum":["rpm","fuelSupply","fuelReturn","other"]},"path":{"type":"string","title":"Signal K path"},"label":{"type":"string","title":"Label"},"pin":{"type":"integer","title":"GPIO pin","description":"Not a flash, input-only or otherwise used pin","minimum":0,"maximum":33},"pulsesPerUnit":{"type":"number","title":"Pulses per unit"},"ratio":{"type":"number","title":"Ratio"},"scalingConfig":{"type":"string","title":"Scaling config path"},"skConfig":{"type":"string","title":"Path config path"},"sortOrder":{"type":"integer","title":"Sort order"},"skSortOrder":{"type":"integer","title":"Path sort order"}}}}}})###";
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,107 @@
+#include "simulated_adc_source.h"
+
+namespace BoatEngine {
+
+constexpr size_t SimulatedAdcSource::MAX_CHANNELS;
+constexpr uint16_t SimulatedAdcSource::FULL_SCALE;
+
+SimulatedAdcSource::SimulatedAdcSource(size_t buffer_samples, uint32_t seed)
+    : capacity_(buffer_samples)
+    , pending_(0)
+    , overflows_(0)
+    , rng_(seed ? seed : 1)
+    , sample_rate_hz_(0)
+    , fractional_(0)
+    , produced_(0)
+    , noise_(0)
+    , spike_interval_(0)
+    , paused_(false)
+    , pattern_len_(0)
+    , pattern_pos_(0) {
+    for (size_t i = 0; i < MAX_CHANNELS; i++) {
+        level_[i] = 0;
+    }
+}
+
+bool SimulatedAdcSource::begin(const uint8_t* channels, size_t count,
+                               uint32_t sample_rate_hz) {
+    if (count == 0 || count > MAX_CHANNELS || sample_rate_hz == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (channels[i] >= MAX_CHANNELS) {
+            return false;
+        }
+        pattern_[i] = channels[i];
+    }
+    pattern_len_ = count;
+    pattern_pos_ = 0;
+    sample_rate_hz_ = sample_rate_hz;
+    pending_ = 0;
+    fractional_ = 0;
+    return true;
+}
+
+void SimulatedAdcSource::advance(uint32_t elapsed_ms) {
+    if (pattern_len_ == 0 || paused_) {
+        return;
+    }
+    const uint64_t total =
+        static_cast<uint64_t>(sample_rate_hz_) * elapsed_ms + fractional_;
+    const uint64_t produced = total / 1000;
+    fractional_ = static_cast<uint32_t>(total % 1000);
+
+    const size_t room = capacity_ - pending_;
+    if (produced > room) {
+        // The DMA pool wraps and the oldest conversions are lost
+        overflows_++;
+        pending_ = capacity_;
+    } else {
+        pending_ += static_cast<size_t>(produced);
+    }
+}
+
+size_t SimulatedAdcSource::read(AdcSample* out, size_t max_samples) {
+    size_t n = pending_ < max_samples ? pending_ : max_samples;
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t channel = pattern_[pattern_pos_];
+        pattern_pos_ = (pattern_pos_ + 1) % pattern_len_;
+        out[i].channel = channel;
+        out[i].raw = nextSample(channel);
+    }
+    pending_ -= n;
+    return n;
+}
+
+float SimulatedAdcSource::toMillivolts(float raw) const {
+    // Idealised 11 dB attenuation transfer: 0..4095 -> 0..3300 mV
+    return raw * (3300.0f / FULL_SCALE);
+}
+
+void SimulatedAdcSource::setLevel(uint8_t channel, uint16_t raw) {
+    if (channel < MAX_CHANNELS) {
+        level_[channel] = raw > FULL_SCALE ? FULL_SCALE : raw;
+    }
+}
+
+uint16_t SimulatedAdcSource::nextSample(uint8_t channel) {
+    produced_++;
+    if (spike_interval_ != 0 && produced_ % spike_interval_ == 0) {
+        return FULL_SCALE;
+    }
+
+    int32_t value = level_[channel];
+    if (noise_ != 0) {
+        // xorshift32: deterministic and cheap
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        const int32_t span = 2 * static_cast<int32_t>(noise_) + 1;
+        value += static_cast<int32_t>(rng_ % static_cast<uint32_t>(span)) - noise_;
+    }
+    if (value < 0) value = 0;
+    if (value > FULL_SCALE) value = FULL_SCALE;
+    return static_cast<uint16_t>(value);
+}
+
+} // namespace BoatEngine
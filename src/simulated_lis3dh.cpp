@@ -0,0 +1,179 @@
+#include "simulated_lis3dh.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "lis3dh_accelerometer.h"
+
+namespace BoatEngine {
+
+constexpr size_t SimulatedLis3dh::MAX_COMPONENTS;
+constexpr size_t SimulatedLis3dh::FIFO_DEPTH;
+
+static const double TWO_PI = 6.283185307179586;
+
+SimulatedLis3dh::SimulatedLis3dh()
+    : component_count_(0)
+    , noise_g_(0.0f)
+    , rate_error_(0.0f)
+    , present_(true)
+    , fifo_head_(0)
+    , fifo_count_(0)
+    , latest_{0, 0, 0}
+    , now_s_(0.0)
+    , next_sample_s_(0.0)
+    , noise_state_(12345)
+    , produced_(0)
+    , overwritten_(0)
+    , reads_(0) {
+    memset(registers_, 0, sizeof(registers_));
+    registers_[Lis3dhAccelerometer::WHO_AM_I] = Lis3dhAccelerometer::WHO_AM_I_VALUE;
+}
+
+bool SimulatedLis3dh::writeRegister(uint8_t reg, uint8_t value) {
+    if (!present_ || reg >= sizeof(registers_)) {
+        return false;
+    }
+    const bool was_streaming = streaming();
+    registers_[reg] = value;
+    if (reg == Lis3dhAccelerometer::FIFO_CTRL_REG && (value & 0xC0) == 0) {
+        // Bypass mode empties the FIFO
+        fifo_count_ = 0;
+    }
+    if (!was_streaming && streaming()) {
+        fifo_count_ = 0;
+    }
+    if (reg == Lis3dhAccelerometer::CTRL_REG1) {
+        // The first sample is one period after the rate is set
+        const float rate = rateHz();
+        next_sample_s_ = now_s_ + (rate > 0.0f ? 1.0 / rate : 0.0);
+    }
+    return true;
+}
+
+bool SimulatedLis3dh::readRegisters(uint8_t reg, uint8_t* data, size_t length) {
+    if (!present_) {
+        return false;
+    }
+    reads_++;
+    const bool increment = (reg & Lis3dhAccelerometer::AUTO_INCREMENT) != 0;
+    uint8_t address = reg & 0x7F;
+    
+    if (address == Lis3dhAccelerometer::OUT_X_L && increment) {
+        for (size_t i = 0; i < length; i += Lis3dhAccelerometer::SAMPLE_BYTES) {
+            AccelSample sample = latest_;
+            if (streaming() && fifo_count_ > 0) {
+                sample = fifo_[fifo_head_];
+                fifo_head_ = (fifo_head_ + 1) % FIFO_DEPTH;
+                fifo_count_--;
+            }
+            uint8_t bytes[Lis3dhAccelerometer::SAMPLE_BYTES];
+            Lis3dhAccelerometer::encodeSample(sample, bytes);
+            const size_t count = length - i < sizeof(bytes) ? length - i : sizeof(bytes);
+            memcpy(&data[i], bytes, count);
+        }
+        return true;
+    }
+    
+    for (size_t i = 0; i < length; i++) {
+        if (address == Lis3dhAccelerometer::FIFO_SRC_REG) {
+            uint8_t source = static_cast<uint8_t>(fifo_count_ & Lis3dhAccelerometer::FIFO_COUNT_MASK);
+            if (fifo_count_ == FIFO_DEPTH) {
+                source = Lis3dhAccelerometer::FIFO_FULL | Lis3dhAccelerometer::FIFO_COUNT_MASK;
+            } else if (fifo_count_ == 0) {
+                source = Lis3dhAccelerometer::FIFO_EMPTY;
+            }
+            data[i] = source;
+        } else {
+            data[i] = address < sizeof(registers_) ? registers_[address] : 0;
+        }
+        if (increment) {
+            address++;
+        }
+    }
+    return true;
+}
+
+bool SimulatedLis3dh::addComponent(const Component& component) {
+    if (component_count_ >= MAX_COMPONENTS) {
+        return false;
+    }
+    components_[component_count_++] = component;
+    return true;
+}
+
+float SimulatedLis3dh::rateHz() const {
+    const uint8_t control = registers_[Lis3dhAccelerometer::CTRL_REG1];
+    if ((control & Lis3dhAccelerometer::AXES_ENABLED) == 0) {
+        return 0.0f;
+    }
+    return Lis3dhAccelerometer::rateForCode(control >> 4) * (1.0f + rate_error_);
+}
+
+bool SimulatedLis3dh::streaming() const {
+    return (registers_[Lis3dhAccelerometer::CTRL_REG5] & Lis3dhAccelerometer::FIFO_ENABLE) &&
+           (registers_[Lis3dhAccelerometer::FIFO_CTRL_REG] & 0xC0) ==
+               Lis3dhAccelerometer::FIFO_STREAM;
+}
+
+float SimulatedLis3dh::noise() {
+    // Sum of four uniform values: close enough to Gaussian, unit variance
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        noise_state_ = noise_state_ * 1664525u + 1013904223u;
+        sum += static_cast<float>(noise_state_ >> 8) / 16777216.0f - 0.5f;
+    }
+    return sum * 1.7320508f;
+}
+
+AccelSample SimulatedLis3dh::sampleAt(double time_s) {
+    float g[3] = {0.0f, 0.0f, 1.0f};
+    for (size_t i = 0; i < component_count_; i++) {
+        const Component& component = components_[i];
+        const float wave = static_cast<float>(sin(TWO_PI * component.frequency_hz * time_s));
+        g[0] += component.x_g * wave;
+        g[1] += component.y_g * wave;
+        g[2] += component.z_g * wave;
+    }
+    
+    float g_per_count;
+    Lis3dhAccelerometer::rangeCode(
+        static_cast<uint8_t>(2 << ((registers_[Lis3dhAccelerometer::CTRL_REG4] >> 4) & 0x03)),
+        &g_per_count);
+    int16_t counts[3];
+    for (size_t axis = 0; axis < 3; axis++) {
+        float value = roundf((g[axis] + noise_g_ * noise()) / g_per_count);
+        // 12 bits
+        value = value > 2047.0f ? 2047.0f : (value < -2048.0f ? -2048.0f : value);
+        counts[axis] = static_cast<int16_t>(value);
+    }
+    return AccelSample{counts[0], counts[1], counts[2]};
+}
+
+void SimulatedLis3dh::advance(uint32_t elapsed_us) {
+    now_s_ += elapsed_us * 1e-6;
+    const float rate = rateHz();
+    if (rate <= 0.0f) {
+        next_sample_s_ = now_s_;
+        return;
+    }
+    while (next_sample_s_ <= now_s_) {
+        const AccelSample sample = sampleAt(next_sample_s_);
+        next_sample_s_ += 1.0 / rate;
+        produced_++;
+        latest_ = sample;
+        if (!streaming()) {
+            continue;
+        }
+        if (fifo_count_ == FIFO_DEPTH) {
+            // Stream mode: the newest replaces the oldest
+            fifo_head_ = (fifo_head_ + 1) % FIFO_DEPTH;
+            fifo_count_--;
+            overwritten_++;
+        }
+        fifo_[(fifo_head_ + fifo_count_) % FIFO_DEPTH] = sample;
+        fifo_count_++;
+    }
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,247 @@
+#include "simulated_onewire_bus.h"
+
+namespace BoatEngine {
+
+constexpr size_t SimulatedOneWireBus::MAX_DEVICES;
+constexpr uint16_t SimulatedOneWireBus::PRESENCE_US;
+constexpr uint16_t SimulatedOneWireBus::DEVICE_ZERO_US;
+
+static const uint8_t DS18B20_FAMILY = 0x28;
+static const uint8_t CMD_SKIP_ROM = 0xCC;
+static const uint8_t CMD_MATCH_ROM = 0x55;
+static const uint8_t CMD_SEARCH_ROM = 0xF0;
+static const uint8_t CMD_CONVERT_T = 0x44;
+static const uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+static const uint8_t CORRUPT_BIT = 3;   // In the temperature LSB
+
+// Power-on scratchpad: 85 C, default alarms, 12-bit resolution
+static void powerOnScratchpad(uint8_t* scratchpad) {
+    const uint8_t power_on[8] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10};
+    for (size_t i = 0; i < 8; i++) {
+        scratchpad[i] = power_on[i];
+    }
+    scratchpad[8] = oneWireCrc8(scratchpad, 8);
+}
+
+SimulatedOneWireBus::SimulatedOneWireBus()
+    : device_count_(0)
+    , now_us_(0)
+    , done_at_us_(0)
+    , busy_us_(0)
+    , transfers_(0)
+    , captured_count_(0) {
+}
+
+int SimulatedOneWireBus::addDevice(uint64_t serial) {
+    if (device_count_ >= MAX_DEVICES) {
+        return -1;
+    }
+    Device& device = devices_[device_count_];
+    device.rom[0] = DS18B20_FAMILY;
+    for (size_t i = 0; i < 6; i++) {
+        device.rom[1 + i] = static_cast<uint8_t>(serial >> (8 * i));
+    }
+    device.rom[7] = oneWireCrc8(device.rom.data(), 7);
+    
+    powerOnScratchpad(device.scratchpad);
+    device.pending_raw = 0x0550;
+    device.state = DeviceState::IDLE;
+    device.shift = 0;
+    device.bit = 0;
+    device.search_phase = 0;
+    device.fault = DeviceFault::NONE;
+    device.fault_count = 0;
+    device.corrupt = false;
+    return static_cast<int>(device_count_++);
+}
+
+void SimulatedOneWireBus::setTemperature(size_t device, float celsius) {
+    if (device < device_count_) {
+        // 12-bit resolution: 1/16 C per count
+        const float scaled = celsius * 16.0f;
+        devices_[device].pending_raw =
+            static_cast<int16_t>(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+    }
+}
+
+void SimulatedOneWireBus::injectFault(size_t device, DeviceFault fault,
+                                      uint8_t count) {
+    if (device < device_count_) {
+        devices_[device].fault = fault;
+        devices_[device].fault_count = count;
+    }
+}
+
+bool SimulatedOneWireBus::consumeFault(Device& device, DeviceFault fault) {
+    if (device.fault != fault || device.fault_count == 0) {
+        return false;
+    }
+    if (--device.fault_count == 0) {
+        device.fault = DeviceFault::NONE;
+    }
+    return true;
+}
+
+bool SimulatedOneWireBus::romBit(const Device& device, size_t bit) {
+    return (device.rom[bit / 8] >> (bit % 8)) & 1;
+}
+
+void SimulatedOneWireBus::resetDevice(Device& device) {
+    device.state = DeviceState::ROM_COMMAND;
+    device.shift = 0;
+    device.bit = 0;
+    device.search_phase = 0;
+}
+
+bool SimulatedOneWireBus::deviceOutput(const Device& device) {
+    switch (device.state) {
+        case DeviceState::SEARCH_ROM:
+            if (device.search_phase == 0) return romBit(device, device.bit);
+            if (device.search_phase == 1) return !romBit(device, device.bit);
+            return true;
+        case DeviceState::SEND_SCRATCHPAD: {
+            const bool bit = (device.scratchpad[device.bit / 8] >> (device.bit % 8)) & 1;
+            return (device.corrupt && device.bit == CORRUPT_BIT) ? !bit : bit;
+        }
+        default:
+            return true;  // Released
+    }
+}
+
+void SimulatedOneWireBus::onFunctionCommand(Device& device, uint8_t command) {
+    if (command == CMD_CONVERT_T) {
+        if (consumeFault(device, DeviceFault::POWER_ON)) {
+            powerOnScratchpad(device.scratchpad);
+            device.state = DeviceState::IDLE;
+            return;
+        }
+        device.scratchpad[0] = static_cast<uint8_t>(device.pending_raw & 0xFF);
+        device.scratchpad[1] = static_cast<uint8_t>((device.pending_raw >> 8) & 0xFF);
+        device.scratchpad[8] = oneWireCrc8(device.scratchpad, 8);
+        device.state = DeviceState::IDLE;
+    } else if (command == CMD_READ_SCRATCHPAD) {
+        device.state = DeviceState::SEND_SCRATCHPAD;
+        device.bit = 0;
+        // Corrupts the copy on the wire only, as a noisy cable would
+        device.corrupt = consumeFault(device, DeviceFault::CORRUPT_READ);
+    } else {
+        device.state = DeviceState::IDLE;
+    }
+}
+
+void SimulatedOneWireBus::deviceSlot(Device& device, bool line) {
+    switch (device.state) {
+        case DeviceState::ROM_COMMAND:
+        case DeviceState::FUNCTION_COMMAND: {
+            device.shift = static_cast<uint8_t>((device.shift >> 1) | (line ? 0x80 : 0));
+            if (++device.bit < 8) {
+                break;
+            }
+            const uint8_t command = device.shift;
+            device.shift = 0;
+            device.bit = 0;
+            if (device.state == DeviceState::FUNCTION_COMMAND) {
+                onFunctionCommand(device, command);
+            } else if (command == CMD_SKIP_ROM) {
+                device.state = DeviceState::FUNCTION_COMMAND;
+            } else if (command == CMD_MATCH_ROM) {
+                device.state = DeviceState::MATCH_ROM;
+            } else if (command == CMD_SEARCH_ROM) {
+                device.state = DeviceState::SEARCH_ROM;
+                device.search_phase = 0;
+            } else {
+                device.state = DeviceState::IDLE;
+            }
+            break;
+        }
+        case DeviceState::MATCH_ROM:
+            if (line != romBit(device, device.bit)) {
+                device.state = DeviceState::IDLE;
+            } else if (++device.bit == 64) {
+                device.state = DeviceState::FUNCTION_COMMAND;
+                device.bit = 0;
+            }
+            break;
+        case DeviceState::SEARCH_ROM:
+            if (device.search_phase < 2) {
+                device.search_phase++;
+            } else if (line != romBit(device, device.bit)) {
+                // The master took the other branch
+                device.state = DeviceState::IDLE;
+            } else {
+                device.search_phase = 0;
+                if (++device.bit == 64) {
+                    device.state = DeviceState::FUNCTION_COMMAND;
+                    device.bit = 0;
+                }
+            }
+            break;
+        case DeviceState::SEND_SCRATCHPAD:
+            if (++device.bit == 72) {
+                device.state = DeviceState::IDLE;
+            }
+            break;
+        case DeviceState::IDLE:
+            break;
+    }
+}
+
+bool SimulatedOneWireBus::transmit(const OneWireSymbol* symbols, size_t count) {
+    captured_count_ = 0;
+    for (size_t s = 0; s < count; s++) {
+        const OneWireSymbol& symbol = symbols[s];
+        
+        if (symbol.low_us >= OneWireCodec::RESET_DETECT_US) {
+            captured_[captured_count_++] = symbol.low_us;
+            size_t present = 0;
+            for (size_t d = 0; d < device_count_; d++) {
+                if (consumeFault(devices_[d], DeviceFault::ABSENT)) {
+                    devices_[d].state = DeviceState::IDLE;
+                } else {
+                    resetDevice(devices_[d]);
+                    present++;
+                }
+            }
+            if (present > 0) {
+                captured_[captured_count_++] = PRESENCE_US;
+            }
+            continue;
+        }
+        
+        // Wired AND: any device sending 0 holds the line low past the sample
+        const bool master = symbol.low_us <= OneWireCodec::SAMPLE_US;
+        bool line = master;
+        for (size_t d = 0; d < device_count_; d++) {
+            line = line && deviceOutput(devices_[d]);
+        }
+        for (size_t d = 0; d < device_count_; d++) {
+            deviceSlot(devices_[d], line);
+        }
+        captured_[captured_count_++] =
+            (master && !line) ? DEVICE_ZERO_US : symbol.low_us;
+    }
+    
+    const uint32_t duration = OneWireCodec::duration(symbols, count);
+    done_at_us_ = now_us_ + duration;
+    busy_us_ += duration;
+    transfers_++;
+    return true;
+}
+
+OneWireLink::Status SimulatedOneWireBus::capture(uint16_t* lows_us, size_t max,
+                                                 size_t* count, uint32_t wait_ms) {
+    if (now_us_ < done_at_us_) {
+        if (wait_ms == 0) {
+            return Status::BUSY;
+        }
+        now_us_ = done_at_us_;  // Blocking wait: let the transfer finish
+    }
+    const size_t n = captured_count_ < max ? captured_count_ : max;
+    for (size_t i = 0; i < n; i++) {
+        lows_us[i] = captured_[i];
+    }
+    *count = n;
+    return Status::DONE;
+}
+
+} // namespace BoatEngine
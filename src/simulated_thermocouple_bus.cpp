@@ -0,0 +1,153 @@
+#include "simulated_thermocouple_bus.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr size_t SimulatedThermocoupleBus::MAX_DEVICES;
+constexpr size_t SimulatedThermocoupleBus::QUEUE_DEPTH;
+constexpr uint32_t SimulatedThermocoupleBus::OVERHEAD_US;
+constexpr size_t SimulatedThermocoupleBus::MAX_TRANSFERS;
+
+SimulatedThermocoupleBus::SimulatedThermocoupleBus()
+    : device_count_(0)
+    , head_(0)
+    , pending_(0)
+    , finished_(0)
+    , elapsed_us_(0)
+    , transfers_(0) {
+}
+
+int SimulatedThermocoupleBus::addDevice(uint8_t cs_pin, uint8_t mode, uint32_t clock_hz) {
+    (void)cs_pin;
+    if (device_count_ == MAX_DEVICES || mode > 3 || clock_hz == 0) {
+        return -1;
+    }
+    Device& device = devices_[device_count_];
+    device.clock_hz = clock_hz;
+    device.chip = ThermocoupleChip::MAX31855;
+    device.reading = ThermocoupleReading{ThermocoupleFault::NONE, 20.0f, 20.0f};
+    memset(device.registers, 0, sizeof(device.registers));
+    device.queued = 0;
+    return static_cast<int>(device_count_++);
+}
+
+void SimulatedThermocoupleBus::setChip(int device, ThermocoupleChip chip) {
+    if (device >= 0 && static_cast<size_t>(device) < device_count_) {
+        devices_[device].chip = chip;
+    }
+}
+
+void SimulatedThermocoupleBus::setReading(int device, const ThermocoupleReading& reading) {
+    if (device >= 0 && static_cast<size_t>(device) < device_count_) {
+        devices_[device].reading = reading;
+    }
+}
+
+void SimulatedThermocoupleBus::powerCycle(int device) {
+    if (device >= 0 && static_cast<size_t>(device) < device_count_) {
+        memset(devices_[device].registers, 0, sizeof(devices_[device].registers));
+    }
+}
+
+bool SimulatedThermocoupleBus::isConverting(int device) const {
+    return device >= 0 && static_cast<size_t>(device) < device_count_ &&
+           (devices_[device].registers[ThermocoupleCodec::MAX31856_CR0] &
+            ThermocoupleCodec::MAX31856_AUTO_CONVERT) != 0;
+}
+
+bool SimulatedThermocoupleBus::queue(int device, const uint8_t* tx, uint8_t* rx,
+                                     size_t length) {
+    if (device < 0 || static_cast<size_t>(device) >= device_count_ ||
+        devices_[device].queued == QUEUE_DEPTH || length == 0) {
+        return false;
+    }
+    devices_[device].queued++;
+    queue_[(head_ + finished_ + pending_) % MAX_TRANSFERS] = Transfer{device, tx, rx, length};
+    pending_++;
+    return true;
+}
+
+uint32_t SimulatedThermocoupleBus::durationUs(const Transfer& transfer) const {
+    const uint64_t bits = transfer.length * 8;
+    return OVERHEAD_US + static_cast<uint32_t>(
+        (bits * 1000000 + devices_[transfer.device].clock_hz - 1) /
+        devices_[transfer.device].clock_hz);
+}
+
+void SimulatedThermocoupleBus::advance(uint32_t elapsed_us) {
+    elapsed_us_ += elapsed_us;
+    while (pending_ > 0) {
+        const Transfer& transfer = queue_[(head_ + finished_) % MAX_TRANSFERS];
+        const uint32_t duration = durationUs(transfer);
+        if (elapsed_us_ < duration) {
+            return;
+        }
+        elapsed_us_ -= duration;
+        run(transfer);
+        pending_--;
+        finished_++;
+    }
+    // An idle bus does not bank time for later transfers
+    elapsed_us_ = 0;
+}
+
+void SimulatedThermocoupleBus::run(const Transfer& transfer) {
+    Device& device = devices_[transfer.device];
+    transfers_++;
+    
+    if (device.chip == ThermocoupleChip::MAX31855) {
+        uint8_t frame[4];
+        ThermocoupleCodec::encode(device.chip, device.reading, frame);
+        for (size_t i = 0; i < transfer.length; i++) {
+            transfer.rx[i] = i < sizeof(frame) ? frame[i] : 0;
+        }
+        return;
+    }
+    
+    // MAX31856: address byte, then registers with auto-increment
+    const uint8_t address = transfer.tx[0];
+    const uint8_t first = address & 0x0F;
+    transfer.rx[0] = 0xFF;
+    if (address & ThermocoupleCodec::MAX31856_WRITE) {
+        for (size_t i = 1; i < transfer.length; i++) {
+            device.registers[(first + i - 1) & 0x0F] = transfer.tx[i];
+            transfer.rx[i] = 0xFF;
+        }
+        return;
+    }
+    
+    if (isConverting(transfer.device)) {
+        // Refresh the result registers from the current reading
+        uint8_t frame[ThermocoupleCodec::MAX_FRAME];
+        ThermocoupleCodec::encode(device.chip, device.reading, frame);
+        memcpy(&device.registers[ThermocoupleCodec::MAX31856_CJTO], frame + 1, 7);
+    }
+    for (size_t i = 1; i < transfer.length; i++) {
+        transfer.rx[i] = device.registers[(first + i - 1) & 0x0F];
+    }
+}
+
+bool SimulatedThermocoupleBus::collect(Completion* completion) {
+    if (finished_ == 0) {
+        return false;
+    }
+    const Transfer& transfer = queue_[head_];
+    completion->device = transfer.device;
+    completion->rx = transfer.rx;
+    devices_[transfer.device].queued--;
+    head_ = (head_ + 1) % MAX_TRANSFERS;
+    finished_--;
+    return true;
+}
+
+uint8_t* SimulatedThermocoupleBus::allocateBuffer(size_t length) {
+    return new uint8_t[length]();
+}
+
+void SimulatedThermocoupleBus::freeBuffer(uint8_t* buffer) {
+    delete[] buffer;
+}
+
+} // namespace BoatEngine
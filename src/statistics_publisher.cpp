@@ -0,0 +1,64 @@
+#include "statistics_publisher.h"
+
+#include "sensesp.h"
+#include "sensesp/system/lambda_consumer.h"
+
+namespace BoatEngine {
+
+constexpr size_t StatisticsPublisher::MAX_WINDOWS;
+
+StatisticsPublisher::StatisticsPublisher(
+    const BoatSensorConfig::StatisticsWindowDef* windows, size_t window_count)
+    : defs_(windows)
+    , window_count_(window_count < MAX_WINDOWS ? window_count : MAX_WINDOWS)
+    , name_("") {
+    // Allocated once, up front, so the heap does not change as samples come
+    for (size_t i = 0; i < window_count_; i++) {
+        windows_[i] = Window{
+            new RollingStatistics(windows[i].window_ms, windows[i].capacity),
+            nullptr, nullptr, nullptr, nullptr, 0};
+    }
+}
+
+void StatisticsPublisher::start(sensesp::ValueProducer<float>* source,
+                                const char* sk_prefix, const char* name,
+                                unsigned int publish_ms) {
+    name_ = name;
+    for (size_t i = 0; i < window_count_; i++) {
+        const String path = String(sk_prefix) + name + "." + defs_[i].name + ".";
+        windows_[i].min = new sensesp::SKOutputFloat(path + "min");
+        windows_[i].max = new sensesp::SKOutputFloat(path + "max");
+        windows_[i].mean = new sensesp::SKOutputFloat(path + "mean");
+        windows_[i].stddev = new sensesp::SKOutputFloat(path + "stdDev");
+    }
+    
+    source->connect_to(new sensesp::LambdaConsumer<float>([this](float value) {
+        const uint32_t now = millis();
+        for (size_t i = 0; i < window_count_; i++) {
+            windows_[i].statistics->add(value, now);
+        }
+    }));
+    sensesp::event_loop()->onRepeat(publish_ms, [this]() { this->publish(); });
+}
+
+void StatisticsPublisher::publish() {
+    const uint32_t now = millis();
+    for (size_t i = 0; i < window_count_; i++) {
+        Window& window = windows_[i];
+        window.statistics->expire(now);
+        if (window.statistics->getOverflowCount() != window.reported_overflows) {
+            window.reported_overflows = window.statistics->getOverflowCount();
+            ESP_LOGW("StatisticsPublisher", "%s %s window full, covers less than %u ms",
+                     name_, defs_[i].name, static_cast<unsigned>(defs_[i].window_ms));
+        }
+        if (window.statistics->getCount() == 0) {
+            continue;
+        }
+        window.min->set(window.statistics->getMin());
+        window.max->set(window.statistics->getMax());
+        window.mean->set(window.statistics->getMean());
+        window.stddev->set(window.statistics->getStdDev());
+    }
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,112 @@
+#include "stress_ramp.h"
+
+namespace BoatEngine {
+
+static StressRamp::Step emptyStep() {
+    StressRamp::Step step = {0, 0, 0, 0, 0, 0.0f, UINT32_MAX, false};
+    return step;
+}
+
+StressRamp::StressRamp(const Settings& settings)
+    : settings_(settings)
+    , running_(false)
+    , measuring_(false)
+    , step_start_ms_(0)
+    , measure_start_ms_(0)
+    , busy_us_(0)
+    , period_us_(settings.rate_hz > 0.0f
+                     ? static_cast<uint32_t>(1.0e6f / settings.rate_hz)
+                     : UINT32_MAX)
+    , current_(emptyStep())
+    , last_good_(emptyStep())
+    , failed_(emptyStep()) {
+}
+
+void StressRamp::begin(uint32_t now_ms) {
+    last_good_ = emptyStep();
+    failed_ = emptyStep();
+    running_ = true;
+    startStep(settings_.start_channels, now_ms);
+}
+
+void StressRamp::startStep(uint16_t channels, uint32_t now_ms) {
+    current_ = emptyStep();
+    current_.channels = channels;
+    step_start_ms_ = now_ms;
+    measuring_ = false;
+    busy_us_ = 0;
+}
+
+void StressRamp::onDelivered(uint32_t count) {
+    if (measuring_) {
+        current_.delivered += count;
+    }
+}
+
+void StressRamp::onTick(uint32_t busy_us) {
+    if (!measuring_) {
+        return;
+    }
+    busy_us_ += busy_us;
+    if (busy_us > current_.max_tick_us) {
+        current_.max_tick_us = busy_us;
+    }
+    if (busy_us > period_us_) {
+        current_.overruns++;
+    }
+}
+
+void StressRamp::onFreeHeap(uint32_t bytes) {
+    if (measuring_ && bytes < current_.min_free_heap) {
+        current_.min_free_heap = bytes;
+    }
+}
+
+bool StressRamp::update(uint32_t now_ms) {
+    if (!running_) {
+        return false;
+    }
+    if (!measuring_) {
+        if (now_ms - step_start_ms_ >= settings_.settle_ms) {
+            measuring_ = true;
+            measure_start_ms_ = now_ms;
+        }
+        return false;
+    }
+    if (now_ms - measure_start_ms_ < settings_.step_ms) {
+        return false;
+    }
+    
+    finishStep(now_ms);
+    if (current_.saturated) {
+        failed_ = current_;
+        running_ = false;
+        return false;
+    }
+    last_good_ = current_;
+    
+    const uint32_t next = static_cast<uint32_t>(current_.channels) + settings_.channel_step;
+    if (settings_.channel_step == 0 || next > settings_.max_channels) {
+        running_ = false;
+        return false;
+    }
+    startStep(static_cast<uint16_t>(next), now_ms);
+    return true;
+}
+
+void StressRamp::finishStep(uint32_t now_ms) {
+    const uint32_t elapsed_ms = now_ms - measure_start_ms_;
+    current_.expected = static_cast<uint32_t>(
+        current_.channels * settings_.rate_hz * elapsed_ms / 1000.0f);
+    current_.cpu_load = elapsed_ms > 0
+        ? static_cast<float>(busy_us_) / (elapsed_ms * 1000.0f) : 0.0f;
+    current_.saturated =
+        current_.overruns > 0 ||
+        current_.delivered < settings_.min_delivery * current_.expected;
+}
+
+float StressRamp::getSaturationChannelHz() const {
+    return last_good_.channels * settings_.rate_hz;
+}
+
+} // namespace BoatEngine
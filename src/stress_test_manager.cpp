@@ -0,0 +1,112 @@
+#include "stress_test_manager.h"
+
+#include <esp_heap_caps.h>
+
+#include "sensesp/system/lambda_consumer.h"
+#include "sensesp/transforms/linear.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+StressTestManager::StressTestManager(const StressRamp::Settings& settings)
+    : ramp_(settings)
+    , update_timer_(nullptr)
+    , stopped_(false) {
+}
+
+void StressTestManager::start(const char* sk_prefix) {
+    prefix_ = sk_prefix;
+    ESP_LOGI("StressTestManager", "Ramping synthetic channels at %.1f Hz, %u to %u",
+             ramp_.getSettings().rate_hz, ramp_.getSettings().start_channels,
+             ramp_.getSettings().max_channels);
+    
+    ramp_.begin(millis());
+    addChannels(ramp_.getChannels());
+    update_timer_ = event_loop()->onRepeat(BoatSensorConfig::STRESS_UPDATE_MS,
+                                           [this]() { this->update(); });
+}
+
+void StressTestManager::addChannels(uint16_t count) {
+    const unsigned int period_ms =
+        static_cast<unsigned int>(1000.0f / ramp_.getSettings().rate_hz);
+    
+    while (channels_.size() < count) {
+        const size_t index = channels_.size();
+        Channel* channel = new Channel();
+        channel->source = new ObservableValue<float>();
+        channel->timer = nullptr;
+        channel->value = 273.15f + static_cast<float>(index % 100);
+        
+        // Same shape as add_onewire_temp, without config UI entries
+        auto* calibration = new Linear(1.0f, 0.0f);
+        auto* sk_output = new SKOutputFloat(prefix_ + "channel" + String(index));
+        channel->source->connect_to(calibration)->connect_to(sk_output);
+        sk_output->connect_to(new LambdaConsumer<float>(
+            [this](float) { ramp_.onDelivered(); }));
+        
+        // Spread the channels over the period instead of firing together
+        const unsigned int phase_ms = period_ms * index / count;
+        event_loop()->onDelay(phase_ms, [this, channel, period_ms]() {
+            if (stopped_) {
+                return;
+            }
+            channel->timer = event_loop()->onRepeat(period_ms, [channel]() {
+                channel->source->set(channel->value);
+            });
+        });
+        channels_.push_back(channel);
+    }
+}
+
+void StressTestManager::update() {
+    ramp_.onFreeHeap(heap_caps_get_free_size(MALLOC_CAP_8BIT));
+    if (ramp_.update(millis())) {
+        logStep(ramp_.getLastGoodStep());
+        addChannels(ramp_.getChannels());
+    } else if (!ramp_.isRunning()) {
+        finish();
+    }
+}
+
+void StressTestManager::logStep(const StressRamp::Step& step) const {
+    ESP_LOGI("StressTestManager",
+             "%u channels: %u/%u values, %u overruns, max tick %u us, CPU %.0f%%, heap %u",
+             step.channels, step.delivered, step.expected, step.overruns,
+             step.max_tick_us, step.cpu_load * 100.0f, step.min_free_heap);
+}
+
+void StressTestManager::finish() {
+    stopped_ = true;
+    event_loop()->remove(update_timer_);
+    update_timer_ = nullptr;
+    for (Channel* channel : channels_) {
+        if (channel->timer != nullptr) {
+            event_loop()->remove(channel->timer);
+            channel->timer = nullptr;
+        }
+    }
+    
+    // If even the first step saturated, report what it measured
+    const StressRamp::Step& good = ramp_.getLastGoodStep().channels > 0
+        ? ramp_.getLastGoodStep() : ramp_.getSaturatedStep();
+    if (ramp_.isSaturated()) {
+        logStep(ramp_.getSaturatedStep());
+        ESP_LOGW("StressTestManager", "Saturated above %.0f channel Hz",
+                 ramp_.getSaturationChannelHz());
+    } else {
+        logStep(good);
+        ESP_LOGI("StressTestManager", "No saturation up to %.0f channel Hz",
+                 ramp_.getSaturationChannelHz());
+    }
+    
+    // Published once; the synthetic channel outputs stay silent from now on
+    (new SKOutputFloat(prefix_ + "saturation"))->set(ramp_.getSaturationChannelHz());
+    (new SKOutputInt(prefix_ + "channels"))->set(good.channels);
+    (new SKOutputFloat(prefix_ + "cpuLoad"))->set(good.cpu_load);
+    (new SKOutputInt(prefix_ + "minimumFreeHeap"))->set(
+        static_cast<int>(good.min_free_heap));
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,107 @@
+#include "temperature_bus.h"
+
+#include "onewire_codec.h"
+
+namespace BoatEngine {
+
+constexpr size_t TemperatureBus::MAX_DEVICES;
+constexpr size_t TemperatureBus::MAX_READINGS;
+
+TemperatureBus::TemperatureBus()
+    : observer_(nullptr)
+    , device_count_(0)
+    , reading_head_(0)
+    , reading_count_(0) {
+}
+
+bool TemperatureBus::addDevice(const OneWireAddress& address) {
+    if (device_count_ >= MAX_DEVICES) {
+        return false;
+    }
+    devices_[device_count_] = address;
+    claimed_[device_count_] = false;
+    device_count_++;
+    return true;
+}
+
+bool TemperatureBus::claimNextAddress(OneWireAddress* address) {
+    for (size_t i = 0; i < device_count_; i++) {
+        if (!claimed_[i]) {
+            claimed_[i] = true;
+            *address = devices_[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TemperatureBus::registerAddress(const OneWireAddress& address) {
+    for (size_t i = 0; i < device_count_; i++) {
+        if (devices_[i] == address) {
+            claimed_[i] = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TemperatureBus::pushReading(const TemperatureReading& reading) {
+    if (observer_ != nullptr && reading.status != TemperatureReadStatus::OK) {
+        observer_->onReadFailure(reading.tag, reading.status);
+    }
+    return queueReading(reading);
+}
+
+bool TemperatureBus::pushScratchpad(uint8_t tag, const uint8_t* scratchpad) {
+    if (observer_ != nullptr) {
+        observer_->onScratchpad(tag, scratchpad);
+    }
+    TemperatureReading reading;
+    reading.tag = tag;
+    reading.celsius = 0.0f;
+    reading.status = decodeDs18b20Scratchpad(scratchpad, &reading.celsius);
+    return queueReading(reading);
+}
+
+bool TemperatureBus::queueReading(const TemperatureReading& reading) {
+    if (reading_count_ >= MAX_READINGS) {
+        return false;
+    }
+    readings_[(reading_head_ + reading_count_) % MAX_READINGS] = reading;
+    reading_count_++;
+    return true;
+}
+
+bool TemperatureBus::takeReading(TemperatureReading* reading) {
+    if (reading_count_ == 0) {
+        return false;
+    }
+    *reading = readings_[reading_head_];
+    reading_head_ = (reading_head_ + 1) % MAX_READINGS;
+    reading_count_--;
+    return true;
+}
+
+TemperatureReadStatus decodeDs18b20Scratchpad(const uint8_t* scratchpad,
+                                              float* celsius) {
+    bool all_ones = true;
+    bool all_zeros = true;
+    for (size_t i = 0; i < 9; i++) {
+        all_ones = all_ones && scratchpad[i] == 0xFF;
+        all_zeros = all_zeros && scratchpad[i] == 0x00;
+    }
+    if (all_ones || all_zeros) {
+        // Nothing drove the line, or it was held low; all zeros would
+        // even pass the CRC
+        return TemperatureReadStatus::BUS_ERROR;
+    }
+    if (oneWireCrc8(scratchpad, 9) != 0) {
+        return TemperatureReadStatus::CRC_ERROR;
+    }
+    const int16_t raw = static_cast<int16_t>(
+        static_cast<uint16_t>(scratchpad[1]) << 8 | scratchpad[0]);
+    *celsius = raw / 16.0f;
+    return TemperatureReadStatus::OK;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,65 @@
+#include "temperature_bus_group.h"
+
+namespace BoatEngine {
+
+constexpr size_t TemperatureBusGroup::MAX_BUSES;
+
+TemperatureBusGroup::TemperatureBusGroup()
+    : bus_count_(0)
+    , next_take_(0) {
+}
+
+int TemperatureBusGroup::addBus(TemperatureBus* bus) {
+    if (bus_count_ >= MAX_BUSES) {
+        return -1;
+    }
+    buses_[bus_count_] = bus;
+    return static_cast<int>(bus_count_++);
+}
+
+size_t TemperatureBusGroup::startConversions() {
+    size_t started = 0;
+    for (size_t i = 0; i < bus_count_; i++) {
+        if (buses_[i]->startConversion()) {
+            started++;
+        }
+    }
+    return started;
+}
+
+bool TemperatureBusGroup::requestRead(size_t bus, const OneWireAddress& address,
+                                      uint8_t tag) {
+    if (bus >= bus_count_) {
+        return false;
+    }
+    return buses_[bus]->requestRead(address, tag);
+}
+
+void TemperatureBusGroup::service() {
+    for (size_t i = 0; i < bus_count_; i++) {
+        buses_[i]->service();
+    }
+}
+
+bool TemperatureBusGroup::isIdle() const {
+    for (size_t i = 0; i < bus_count_; i++) {
+        if (!buses_[i]->isIdle()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TemperatureBusGroup::takeReading(TemperatureReading* reading, size_t* bus) {
+    for (size_t n = 0; n < bus_count_; n++) {
+        const size_t i = (next_take_ + n) % bus_count_;
+        if (buses_[i]->takeReading(reading)) {
+            *bus = i;
+            next_take_ = (i + 1) % bus_count_;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,85 @@
+#include "temperature_health.h"
+
+namespace BoatEngine {
+
+static const float POWER_ON_C = 85.0f;
+
+TemperatureHealth::TemperatureHealth(const Limits& limits)
+    : limits_(limits)
+    , counters_()
+    , attempt_(0)
+    , valid_(false)
+    , have_last_(false)
+    , last_c_(0.0f)
+    , power_on_reads_(0) {
+}
+
+TemperatureHealth::Verdict TemperatureHealth::assess(const TemperatureReading& reading) {
+    counters_.reads++;
+    
+    switch (reading.status) {
+        case TemperatureReadStatus::OK:
+            break;
+        case TemperatureReadStatus::CRC_ERROR:
+            counters_.crc_errors++;
+            return fail(Verdict::RETRY);
+        case TemperatureReadStatus::TIMEOUT:
+            counters_.timeouts++;
+            return fail(Verdict::RETRY);
+        case TemperatureReadStatus::NO_DEVICE:
+        case TemperatureReadStatus::BUS_ERROR:
+            counters_.disconnects++;
+            return fail(Verdict::RETRY);
+        case TemperatureReadStatus::DROPPED:
+            counters_.dropped++;
+            return fail(Verdict::RETRY);
+    }
+    
+    if (reading.celsius != POWER_ON_C) {
+        power_on_reads_ = 0;
+    } else if (power_on_reads_ < UINT8_MAX) {
+        power_on_reads_++;
+    }
+    if (!isPlausible(reading.celsius)) {
+        counters_.implausible++;
+        // The power-on value stays in the scratchpad until a conversion
+        // completes, so reading it again would not help
+        return fail(reading.celsius == POWER_ON_C ? Verdict::RECONVERT
+                                                  : Verdict::RETRY);
+    }
+    
+    attempt_ = 0;
+    valid_ = true;
+    have_last_ = true;
+    last_c_ = reading.celsius;
+    return Verdict::VALID;
+}
+
+bool TemperatureHealth::isPlausible(float celsius) const {
+    if (!(celsius >= limits_.min_c && celsius <= limits_.max_c)) {
+        // Also catches NaN
+        return false;
+    }
+    if (celsius != POWER_ON_C || power_on_reads_ >= limits_.power_on_confirm_reads) {
+        return true;
+    }
+    if (!have_last_) {
+        return false;
+    }
+    const float step = celsius - last_c_;
+    return step <= limits_.power_on_window_c && -step <= limits_.power_on_window_c;
+}
+
+TemperatureHealth::Verdict TemperatureHealth::fail(Verdict retry) {
+    if (attempt_ < limits_.max_retries) {
+        attempt_++;
+        counters_.retries++;
+        return retry;
+    }
+    attempt_ = 0;
+    valid_ = false;
+    counters_.invalid++;
+    return Verdict::INVALID;
+}
+
+} // namespace BoatEngine
@@ -1,32 +1,292 @@
 #include "temperature_sensor_manager.h"
-#include "onewire_helper.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "timestamped_sk_output.h"
+
+using namespace sensesp;
 
 namespace BoatEngine {
 
-TemperatureSensorManager::TemperatureSensorManager(uint8_t onewire_pin, 
+constexpr size_t TemperatureSensorManager::MAX_SENSORS;
+
+TemperatureSensorManager::TemperatureSensorManager(AcquisitionScheduler* scheduler,
                                                    unsigned int read_delay_ms)
-    : dts_(new sensesp::onewire::DallasTemperatureSensors(onewire_pin))
-    , read_delay_ms_(read_delay_ms) {
+    : read_delay_ms_(read_delay_ms)
+    , scheduler_(scheduler)
+    , task_(-1)
+    , service_timer_(nullptr)
+    , cycle_pending_(false)
+    , cycle_active_(false)
+    , cycle_start_ms_(0)
+    , last_cycle_ms_(0)
+    , sensor_count_(0)
+    , health_output_count_(0)
+    , reconvert_sensors_(0)
+    , reconvert_buses_(0) {
 }
 
-void TemperatureSensorManager::setupSensors() {
-    // Set up all pre-configured temperature sensors
-    addSensor(BoatSensorConfig::COOLANT_TEMP);
-    addSensor(BoatSensorConfig::SEAWATER_IN_TEMP);
-    addSensor(BoatSensorConfig::SEAWATER_OUT_TEMP);
+int TemperatureSensorManager::addBus(TemperatureBus* bus) {
+    const int index = buses_.addBus(bus);
+    if (index < 0) {
+        ESP_LOGE("TemperatureSensorManager", "Too many OneWire buses");
+        return index;
+    }
+    
+    // Sensors claim their addresses from the discovered list when added
+    if (!bus->begin()) {
+        ESP_LOGW("TemperatureSensorManager", "No OneWire sensors found on bus %d",
+                 index);
+    }
+    return index;
+}
+
+void TemperatureSensorManager::setupSensors(const SensorTopology& topology) {
+    // Set up all configured temperature sensors
+    for (size_t i = 0; i < topology.getTemperatureCount(); i++) {
+        addSensor(topology.getTemperature(i));
+    }
+    
+    start();
 }
 
 void TemperatureSensorManager::addSensor(const BoatSensorConfig::TemperatureSensorDef& config) {
-    add_onewire_temp(
-        dts_,
-        read_delay_ms_,
+    if (sensor_count_ >= MAX_SENSORS) {
+        ESP_LOGE("TemperatureSensorManager", "Cannot add %s", config.base_name);
+        return;
+    }
+    TemperatureBus* bus = buses_.getBus(config.onewire_bus);
+    if (bus == nullptr) {
+        ESP_LOGE("TemperatureSensorManager", "No OneWire bus %u for %s",
+                 config.onewire_bus, config.base_name);
+        return;
+    }
+    
+    sensors_[sensor_count_] = add_onewire_temp(
+        bus,
         config.base_name,
         config.signal_k_path,
         config.human_label,
         config.sensor_sort_order,
         config.linear_sort_order,
-        config.sk_sort_order
+        config.sk_sort_order,
+        &config.calibration
     );
+    base_names_[sensor_count_] = config.base_name;
+    sk_paths_[sensor_count_] = config.signal_k_path;
+    calibrations_[sensor_count_] = &config.calibration;
+    sensor_bus_[sensor_count_] = config.onewire_bus;
+    acquired_ms_[sensor_count_] = 0;
+    sensor_count_++;
+}
+
+void TemperatureSensorManager::start() {
+    startHealthReports();
+    task_ = scheduler_->addTask("temperature", cyclePeriod(read_delay_ms_),
+                                [this]() { this->update(); });
+}
+
+void TemperatureSensorManager::setSamplingInterval(unsigned int interval_ms) {
+    read_delay_ms_ = interval_ms;
+    scheduler_->setPeriod(task_, cyclePeriod(interval_ms));
+}
+
+unsigned int TemperatureSensorManager::cyclePeriod(unsigned int interval_ms) {
+    // A conversion takes ONEWIRE_CONVERSION_TIME_MS; never ask for more
+    if (interval_ms != 0 && interval_ms < BoatSensorConfig::ONEWIRE_CONVERSION_TIME_MS) {
+        return BoatSensorConfig::ONEWIRE_CONVERSION_TIME_MS;
+    }
+    return interval_ms;
+}
+
+void TemperatureSensorManager::update() {
+    if (cycle_pending_ || sensor_count_ == 0) {
+        return;
+    }
+    
+    // Skip ROM convert: every sensor on every bus converts in parallel
+    if (buses_.startConversions() == 0) {
+        return;
+    }
+    cycle_pending_ = true;
+    cycle_active_ = true;
+    cycle_start_ms_ = millis();
+    startServicing();
+    event_loop()->onDelay(BoatSensorConfig::ONEWIRE_CONVERSION_TIME_MS,
+                          [this]() { this->readAll(); });
+}
+
+void TemperatureSensorManager::readAll() {
+    const uint64_t now = acquisitionNowMs();
+    for (size_t i = 0; i < sensor_count_; i++) {
+        if (sensors_[i].sensor->isFound()) {
+            acquired_ms_[i] = now;
+            // Each bus works through its own queue, so reads on different
+            // buses overlap
+            requestRead(i);
+        }
+    }
+    cycle_pending_ = false;
+    startServicing();
+}
+
+void TemperatureSensorManager::startServicing() {
+    // Synchronous buses finish inside the request; drain them right away
+    service();
+    if (!buses_.isIdle() && service_timer_ == nullptr) {
+        service_timer_ = event_loop()->onRepeat(
+            BoatSensorConfig::ONEWIRE_SERVICE_MS, [this]() { this->service(); });
+    }
+}
+
+void TemperatureSensorManager::requestRead(size_t sensor) {
+    if (!buses_.requestRead(sensor_bus_[sensor], sensors_[sensor].sensor->getAddress(),
+                            static_cast<uint8_t>(sensor))) {
+        handleDropped(sensor);
+    }
+}
+
+void TemperatureSensorManager::handleDropped(size_t sensor) {
+    // A refused request counts as a failed read, so the sensor's retries
+    // still run out and its cycle ends with a verdict
+    TemperatureReading reading;
+    reading.tag = static_cast<uint8_t>(sensor);
+    reading.status = TemperatureReadStatus::DROPPED;
+    reading.celsius = NAN;
+    if (sensors_[sensor].sensor->publish(reading, acquired_ms_[sensor]) ==
+        TemperatureHealth::Verdict::RETRY) {
+        requestRead(sensor);
+    }
+}
+
+void TemperatureSensorManager::service() {
+    buses_.service();
+    
+    TemperatureReading reading;
+    size_t bus;
+    while (buses_.takeReading(&reading, &bus)) {
+        if (reading.tag >= sensor_count_) {
+            continue;
+        }
+        const size_t i = reading.tag;
+        switch (sensors_[i].sensor->publish(reading, acquired_ms_[i])) {
+            case TemperatureHealth::Verdict::RETRY:
+                // Bounded by the channel; the bus queues it behind the others
+                requestRead(i);
+                break;
+            case TemperatureHealth::Verdict::RECONVERT:
+                retryAfterConversion(i);
+                break;
+            default:
+                break;
+        }
+    }
+    
+    if (!buses_.isIdle()) {
+        return;
+    }
+    if (cycle_active_ && !cycle_pending_ && reconvert_sensors_ == 0) {
+        last_cycle_ms_ = millis() - cycle_start_ms_;
+        cycle_active_ = false;
+    }
+    if (service_timer_ != nullptr) {
+        event_loop()->remove(service_timer_);
+        service_timer_ = nullptr;
+    }
+}
+
+void TemperatureSensorManager::retryAfterConversion(size_t sensor) {
+    const uint8_t bus = sensor_bus_[sensor];
+    if ((reconvert_buses_ & (1 << bus)) == 0) {
+        if (!buses_.getBus(bus)->startConversion()) {
+            handleDropped(sensor);
+            return;
+        }
+        reconvert_buses_ |= static_cast<uint8_t>(1 << bus);
+    }
+    
+    const bool scheduled = reconvert_sensors_ != 0;
+    reconvert_sensors_ |= static_cast<uint8_t>(1 << sensor);
+    if (!scheduled) {
+        event_loop()->onDelay(BoatSensorConfig::ONEWIRE_CONVERSION_TIME_MS,
+                              [this]() { this->readReconverted(); });
+    }
+}
+
+void TemperatureSensorManager::readReconverted() {
+    const uint64_t now = acquisitionNowMs();
+    for (size_t i = 0; i < sensor_count_; i++) {
+        if (reconvert_sensors_ & (1 << i)) {
+            acquired_ms_[i] = now;
+            requestRead(i);
+        }
+    }
+    reconvert_sensors_ = 0;
+    reconvert_buses_ = 0;
+    startServicing();
+}
+
+void TemperatureSensorManager::startHealthReports() {
+    if (health_output_count_ > 0) {
+        return;
+    }
+    for (size_t i = 0; i < sensor_count_; i++) {
+        const std::string prefix =
+            std::string(BoatSensorConfig::ONEWIRE_HEALTH_SK_PREFIX) + base_names_[i];
+        HealthOutputs& outputs = health_outputs_[i];
+        outputs.crc_errors = new SKOutputInt((prefix + ".crcErrors").c_str());
+        outputs.timeouts = new SKOutputInt((prefix + ".timeouts").c_str());
+        outputs.disconnects = new SKOutputInt((prefix + ".disconnects").c_str());
+        outputs.implausible = new SKOutputInt((prefix + ".implausibleValues").c_str());
+        outputs.retries = new SKOutputInt((prefix + ".retries").c_str());
+        outputs.dropped = new SKOutputInt((prefix + ".droppedRequests").c_str());
+        outputs.status = new SKOutput<String>((prefix + ".status").c_str());
+    }
+    health_output_count_ = sensor_count_;
+    if (health_output_count_ > 0) {
+        event_loop()->onRepeat(BoatSensorConfig::ONEWIRE_HEALTH_REPORT_MS,
+                               [this]() { this->reportHealth(); });
+    }
+}
+
+void TemperatureSensorManager::reportHealth() {
+    for (size_t i = 0; i < health_output_count_; i++) {
+        const TemperatureHealthCounters& counters =
+            sensors_[i].sensor->getHealth().getCounters();
+        HealthOutputs& outputs = health_outputs_[i];
+        outputs.crc_errors->set(static_cast<int>(counters.crc_errors));
+        outputs.timeouts->set(static_cast<int>(counters.timeouts));
+        outputs.disconnects->set(static_cast<int>(counters.disconnects));
+        outputs.implausible->set(static_cast<int>(counters.implausible));
+        outputs.retries->set(static_cast<int>(counters.retries));
+        outputs.dropped->set(static_cast<int>(counters.dropped));
+        outputs.status->set(sensors_[i].sensor->getStatusText());
+    }
+}
+
+void TemperatureSensorManager::setRecorder(SensorRecorder* recorder) {
+    // Reads are tagged with the sensor index on every bus
+    for (size_t i = 0; i < buses_.getBusCount(); i++) {
+        buses_.getBus(i)->setObserver(recorder);
+    }
+    if (recorder == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < sensor_count_; i++) {
+        recorder->declareTemperatureChannel(static_cast<uint8_t>(i), sk_paths_[i],
+                                            *calibrations_[i]);
+    }
+}
+
+const OneWireTempChain* TemperatureSensorManager::findSensor(const char* base_name) const {
+    for (size_t i = 0; i < sensor_count_; i++) {
+        if (strcmp(base_names_[i], base_name) == 0) {
+            return &sensors_[i];
+        }
+    }
+    return nullptr;
 }
 
 } // namespace BoatEngine
@@ -0,0 +1,182 @@
+#include "thermocouple_codec.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace BoatEngine {
+
+constexpr size_t ThermocoupleCodec::MAX_FRAME;
+constexpr uint8_t ThermocoupleCodec::MAX31856_CR0;
+constexpr uint8_t ThermocoupleCodec::MAX31856_CJTO;
+constexpr uint8_t ThermocoupleCodec::MAX31856_WRITE;
+constexpr uint8_t ThermocoupleCodec::MAX31856_AUTO_CONVERT;
+constexpr uint8_t ThermocoupleCodec::MAX31856_OPEN_DETECT;
+constexpr uint8_t ThermocoupleCodec::MAX31856_TYPE_K;
+
+// MAX31855 frame bits
+static constexpr uint32_t MAX31855_RESERVED = (1u << 17) | (1u << 3);   ///< Always read 0
+static constexpr uint32_t MAX31855_FAULT = 1u << 16;
+static constexpr uint32_t MAX31855_SCV = 1u << 2;
+static constexpr uint32_t MAX31855_SCG = 1u << 1;
+static constexpr uint32_t MAX31855_OC = 1u << 0;
+
+// MAX31856 fault status register bits
+static constexpr uint8_t MAX31856_SR_OPEN = 0x01;
+static constexpr uint8_t MAX31856_SR_OVUV = 0x02;
+static constexpr uint8_t MAX31856_SR_RANGE = 0xFC;   ///< TC/CJ high, low or range
+
+// Read from CJTO: address, CJTO CJTH CJTL LTCBH LTCBM LTCBL SR
+static constexpr size_t MAX31856_READ_BYTES = 8;
+
+// Sign-extend the top `bits` of a left-aligned 32-bit field
+static int32_t signedField(uint32_t left_aligned, unsigned bits) {
+    return static_cast<int32_t>(left_aligned) >> (32 - bits);
+}
+
+size_t ThermocoupleCodec::readLength(ThermocoupleChip chip) {
+    return chip == ThermocoupleChip::MAX31855 ? 4 : MAX31856_READ_BYTES;
+}
+
+void ThermocoupleCodec::prepareRead(ThermocoupleChip chip, uint8_t* tx) {
+    memset(tx, 0, readLength(chip));
+    if (chip == ThermocoupleChip::MAX31856) {
+        tx[0] = MAX31856_CJTO;
+    }
+}
+
+size_t ThermocoupleCodec::prepareSetup(ThermocoupleChip chip, uint8_t tc_type,
+                                       uint8_t* tx) {
+    if (chip != ThermocoupleChip::MAX31856) {
+        return 0;
+    }
+    // CR0 and CR1 in one auto-incrementing write; 60 Hz rejection converts
+    // fastest, and there is no mains on a DC engine harness anyway
+    tx[0] = MAX31856_WRITE | MAX31856_CR0;
+    tx[1] = MAX31856_AUTO_CONVERT | MAX31856_OPEN_DETECT;
+    tx[2] = tc_type & 0x0F;   // No averaging
+    return 3;
+}
+
+ThermocoupleReading ThermocoupleCodec::decode(ThermocoupleChip chip, const uint8_t* rx) {
+    ThermocoupleReading reading = {ThermocoupleFault::NONE, NAN, NAN};
+    
+    if (chip == ThermocoupleChip::MAX31855) {
+        const uint32_t frame = (static_cast<uint32_t>(rx[0]) << 24) |
+                               (static_cast<uint32_t>(rx[1]) << 16) |
+                               (static_cast<uint32_t>(rx[2]) << 8) | rx[3];
+        // All zeros is a valid 0 C reading; MISO held high sets the reserved bits
+        if (frame & MAX31855_RESERVED) {
+            reading.fault = ThermocoupleFault::NO_RESPONSE;
+            return reading;
+        }
+        reading.cold_c = signedField(frame << 16, 12) * 0.0625f;
+        if (frame & MAX31855_FAULT) {
+            if (frame & MAX31855_OC) {
+                reading.fault = ThermocoupleFault::OPEN;
+            } else if (frame & MAX31855_SCG) {
+                reading.fault = ThermocoupleFault::SHORT_TO_GND;
+            } else if (frame & MAX31855_SCV) {
+                reading.fault = ThermocoupleFault::SHORT_TO_VCC;
+            } else {
+                reading.fault = ThermocoupleFault::OUT_OF_RANGE;
+            }
+            return reading;
+        }
+        reading.hot_c = signedField(frame, 14) * 0.25f;
+        return reading;
+    }
+    
+    // MAX31856; rx[0] was clocked in while the address went out. Its result
+    // registers read zero until it converts, and a real reading cannot be
+    // zero at both its resolutions, so all zeros is a chip without setup
+    const uint8_t* data = rx + 2;
+    bool all_zero = true;
+    bool all_ones = true;
+    for (size_t i = 0; i < MAX31856_READ_BYTES - 2; i++) {
+        all_zero = all_zero && data[i] == 0x00;
+        all_ones = all_ones && data[i] == 0xFF;
+    }
+    if (all_zero || all_ones) {
+        reading.fault = ThermocoupleFault::NO_RESPONSE;
+        return reading;
+    }
+    const uint32_t cold = (static_cast<uint32_t>(data[0]) << 24) |
+                          (static_cast<uint32_t>(data[1]) << 16);
+    reading.cold_c = signedField(cold, 14) * 0.015625f;
+    
+    const uint8_t status = data[5];
+    if (status & MAX31856_SR_OPEN) {
+        reading.fault = ThermocoupleFault::OPEN;
+        return reading;
+    }
+    if (status & (MAX31856_SR_OVUV | MAX31856_SR_RANGE)) {
+        // The MAX31856 cannot tell a short to ground from one to supply
+        reading.fault = ThermocoupleFault::OUT_OF_RANGE;
+        return reading;
+    }
+    const uint32_t hot = (static_cast<uint32_t>(data[2]) << 24) |
+                         (static_cast<uint32_t>(data[3]) << 16) |
+                         (static_cast<uint32_t>(data[4]) << 8);
+    reading.hot_c = signedField(hot, 19) * 0.0078125f;
+    return reading;
+}
+
+void ThermocoupleCodec::encode(ThermocoupleChip chip, const ThermocoupleReading& reading,
+                               uint8_t* rx) {
+    const float cold_c = std::isnan(reading.cold_c) ? 0.0f : reading.cold_c;
+    const float hot_c = std::isnan(reading.hot_c) ? 0.0f : reading.hot_c;
+    
+    if (reading.fault == ThermocoupleFault::NO_RESPONSE) {
+        memset(rx, 0xFF, readLength(chip));
+        return;
+    }
+    
+    if (chip == ThermocoupleChip::MAX31855) {
+        uint32_t frame = (static_cast<uint32_t>(lroundf(cold_c / 0.0625f)) & 0x0FFF) << 4;
+        switch (reading.fault) {
+            case ThermocoupleFault::NONE:
+                frame |= (static_cast<uint32_t>(lroundf(hot_c / 0.25f)) & 0x3FFF) << 18;
+                break;
+            case ThermocoupleFault::OPEN:         frame |= MAX31855_FAULT | MAX31855_OC; break;
+            case ThermocoupleFault::SHORT_TO_GND: frame |= MAX31855_FAULT | MAX31855_SCG; break;
+            case ThermocoupleFault::SHORT_TO_VCC: frame |= MAX31855_FAULT | MAX31855_SCV; break;
+            default:                              frame |= MAX31855_FAULT; break;
+        }
+        rx[0] = frame >> 24;
+        rx[1] = frame >> 16;
+        rx[2] = frame >> 8;
+        rx[3] = frame;
+        return;
+    }
+    
+    const uint32_t cold = (static_cast<uint32_t>(lroundf(cold_c / 0.015625f)) & 0x3FFF) << 2;
+    const uint32_t hot = (static_cast<uint32_t>(lroundf(hot_c / 0.0078125f)) & 0x7FFFF) << 5;
+    uint8_t status = 0;
+    if (reading.fault == ThermocoupleFault::OPEN) {
+        status = MAX31856_SR_OPEN;
+    } else if (reading.fault != ThermocoupleFault::NONE) {
+        status = MAX31856_SR_OVUV;
+    }
+    rx[0] = 0xFF;   // Don't care while the address is sent
+    rx[1] = 0;      // No cold junction offset
+    rx[2] = cold >> 8;
+    rx[3] = cold;
+    rx[4] = hot >> 16;
+    rx[5] = hot >> 8;
+    rx[6] = hot;
+    rx[7] = status;
+}
+
+const char* ThermocoupleCodec::faultName(ThermocoupleFault fault) {
+    switch (fault) {
+        case ThermocoupleFault::NONE:         return "ok";
+        case ThermocoupleFault::OPEN:         return "open";
+        case ThermocoupleFault::SHORT_TO_GND: return "shortToGround";
+        case ThermocoupleFault::SHORT_TO_VCC: return "shortToSupply";
+        case ThermocoupleFault::OUT_OF_RANGE: return "outOfRange";
+        case ThermocoupleFault::NO_RESPONSE:  return "noResponse";
+    }
+    return "unknown";
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,140 @@
+#include "thermocouple_scanner.h"
+
+namespace BoatEngine {
+
+constexpr size_t ThermocoupleScanner::MAX_SENSORS;
+constexpr uint32_t ThermocoupleScanner::CLOCK_HZ;
+constexpr uint8_t ThermocoupleScanner::SETUP_AFTER_FAULTS;
+constexpr size_t ThermocoupleScanner::BUFFERS_PER_SENSOR;
+
+static_assert(ThermocoupleCodec::MAX_FRAME % 4 == 0, "Each buffer must stay word aligned");
+
+ThermocoupleScanner::ThermocoupleScanner(SpiDeviceBus* bus)
+    : bus_(bus)
+    , buffers_(bus->allocateBuffer(MAX_SENSORS * BUFFERS_PER_SENSOR *
+                                   ThermocoupleCodec::MAX_FRAME))
+    , sensor_count_(0)
+    , in_flight_(0) {
+}
+
+ThermocoupleScanner::~ThermocoupleScanner() {
+    bus_->freeBuffer(buffers_);
+}
+
+int ThermocoupleScanner::addSensor(ThermocoupleChip chip, uint8_t cs_pin, uint8_t tc_type) {
+    if (sensor_count_ == MAX_SENSORS || buffers_ == nullptr) {
+        return -1;
+    }
+    // MAX31855 samples on the rising edge (mode 0), MAX31856 on the falling (mode 1)
+    const uint8_t mode = chip == ThermocoupleChip::MAX31855 ? 0 : 1;
+    const int device = bus_->addDevice(cs_pin, mode, CLOCK_HZ);
+    if (device < 0) {
+        return -1;
+    }
+    
+    Sensor& sensor = sensors_[sensor_count_];
+    sensor.chip = chip;
+    sensor.tc_type = tc_type;
+    sensor.device = device;
+    sensor.needs_setup = chip == ThermocoupleChip::MAX31856;
+    sensor.setup_busy = false;
+    sensor.read_busy = false;
+    sensor.no_response = 0;
+    sensor.fault = ThermocoupleFault::NO_RESPONSE;   // Until the first read
+    sensor.counters = Counters{0, 0, 0};
+    uint8_t* buffers =
+        &buffers_[sensor_count_ * BUFFERS_PER_SENSOR * ThermocoupleCodec::MAX_FRAME];
+    sensor.setup_tx = buffers;
+    sensor.setup_rx = buffers + ThermocoupleCodec::MAX_FRAME;
+    sensor.read_tx = buffers + 2 * ThermocoupleCodec::MAX_FRAME;
+    sensor.read_rx = buffers + 3 * ThermocoupleCodec::MAX_FRAME;
+    ThermocoupleCodec::prepareRead(chip, sensor.read_tx);
+    return static_cast<int>(sensor_count_++);
+}
+
+size_t ThermocoupleScanner::startScan() {
+    size_t queued = 0;
+    for (size_t i = 0; i < sensor_count_; i++) {
+        Sensor& sensor = sensors_[i];
+        if (sensor.read_busy || sensor.setup_busy) {
+            sensor.counters.missed++;
+            continue;
+        }
+        if (sensor.needs_setup) {
+            const size_t length = ThermocoupleCodec::prepareSetup(
+                sensor.chip, sensor.tc_type, sensor.setup_tx);
+            if (!bus_->queue(sensor.device, sensor.setup_tx, sensor.setup_rx, length)) {
+                continue;
+            }
+            sensor.needs_setup = false;
+            sensor.setup_busy = true;
+            in_flight_++;
+        }
+        // Transfers to one device run in order, so the read follows the setup
+        if (!bus_->queue(sensor.device, sensor.read_tx, sensor.read_rx,
+                         ThermocoupleCodec::readLength(sensor.chip))) {
+            continue;
+        }
+        sensor.read_busy = true;
+        in_flight_++;
+        queued++;
+    }
+    return queued;
+}
+
+ThermocoupleScanner::Sensor* ThermocoupleScanner::findSensor(int device) {
+    for (size_t i = 0; i < sensor_count_; i++) {
+        if (sensors_[i].device == device) {
+            return &sensors_[i];
+        }
+    }
+    return nullptr;
+}
+
+bool ThermocoupleScanner::takeResult(Result* result) {
+    SpiDeviceBus::Completion completion;
+    while (bus_->collect(&completion)) {
+        Sensor* sensor = findSensor(completion.device);
+        if (sensor == nullptr) {
+            continue;
+        }
+        in_flight_--;
+        if (completion.rx == sensor->setup_rx) {
+            sensor->setup_busy = false;
+            continue;
+        }
+        sensor->read_busy = false;
+        
+        const ThermocoupleReading reading = ThermocoupleCodec::decode(sensor->chip,
+                                                                      sensor->read_rx);
+        sensor->fault = reading.fault;
+        sensor->counters.reads++;
+        if (reading.fault != ThermocoupleFault::NONE) {
+            sensor->counters.faults++;
+        }
+        if (reading.fault == ThermocoupleFault::NO_RESPONSE) {
+            // A MAX31856 reads zero until it converts: it may have lost its setup
+            if (sensor->no_response < UINT8_MAX) {
+                sensor->no_response++;
+            }
+            if (sensor->no_response >= SETUP_AFTER_FAULTS &&
+                sensor->chip == ThermocoupleChip::MAX31856) {
+                sensor->needs_setup = true;
+                sensor->no_response = 0;
+            }
+        } else {
+            sensor->no_response = 0;
+        }
+        
+        result->index = static_cast<uint8_t>(sensor - sensors_);
+        result->reading = reading;
+        return true;
+    }
+    return false;
+}
+
+ThermocoupleFault ThermocoupleScanner::getFault(size_t index) const {
+    return index < sensor_count_ ? sensors_[index].fault : ThermocoupleFault::NO_RESPONSE;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,124 @@
+#include "thermocouple_sensor_manager.h"
+#include "calibration_transform.h"
+
+#include <cstring>
+#include <string>
+
+#include "sensesp/ui/config_item.h"
+#include "timestamped_sk_output.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+constexpr size_t ThermocoupleSensorManager::MAX_SENSORS;
+
+ThermocoupleSensorManager::ThermocoupleSensorManager(SpiDeviceBus* bus,
+                                                     AcquisitionScheduler* scheduler,
+                                                     unsigned int read_delay_ms)
+    : scanner_(bus)
+    , scheduler_(scheduler)
+    , read_delay_ms_(read_delay_ms)
+    , channel_count_(0) {
+}
+
+void ThermocoupleSensorManager::setupSensors() {
+    // Set up all pre-configured thermocouples
+    addSensor(BoatSensorConfig::EXHAUST_GAS_TEMP);
+    
+    start();
+}
+
+bool ThermocoupleSensorManager::addSensor(
+    const BoatSensorConfig::ThermocoupleSensorDef& config) {
+    const int index = scanner_.addSensor(config.chip, config.cs_pin, config.tc_type);
+    if (index < 0) {
+        ESP_LOGE("ThermocoupleSensorManager", "Cannot add %s on CS %u",
+                 config.base_name, config.cs_pin);
+        return false;
+    }
+    
+    const std::string base_cfg = std::string("/") + config.base_name;
+    const std::string sk_cfg = std::string("/") + config.base_name + "/skPath";
+    const std::string health_prefix =
+        std::string(BoatSensorConfig::THERMOCOUPLE_HEALTH_SK_PREFIX) + config.base_name;
+    
+    auto* kelvin = new ObservableValue<float>();
+    
+    auto* calibration = create_calibration(&config.calibration, base_cfg.c_str(),
+                                           config.human_label,
+                                           config.linear_sort_order);
+    
+    auto* sk_output = new TimestampedSKOutputFloat(config.signal_k_path, sk_cfg.c_str(),
+                                                   &stamp_);
+    ConfigItem(sk_output)
+        ->set_title((std::string(config.human_label) + " Signal K Path").c_str())
+        ->set_description((std::string("Signal K path for the ") +
+                           config.human_label).c_str())
+        ->set_sort_order(config.sk_sort_order);
+    
+    kelvin->connect_to(calibration)->connect_to(sk_output);
+    
+    Channel& channel = channels_[index];
+    channel.base_name = config.base_name;
+    channel.kelvin = kelvin;
+    channel.calibration = calibration;
+    channel.status = new SKOutput<String>((health_prefix + ".status").c_str());
+    channel.faults = new SKOutputInt((health_prefix + ".faults").c_str());
+    channel.reported = ThermocoupleFault::NONE;
+    channel.status_sent = false;
+    channel_count_ = index + 1;
+    return true;
+}
+
+bool ThermocoupleSensorManager::start() {
+    if (channel_count_ == 0) {
+        return false;
+    }
+    scheduler_->addTask("thermocouple", read_delay_ms_, [this]() { this->scan(); });
+    return true;
+}
+
+void ThermocoupleSensorManager::scan() {
+    // Anything the last collect missed belongs to the last scan's stamp
+    collect();
+    stamp_.mark(acquisitionNowMs());
+    if (scanner_.startScan() > 0) {
+        event_loop()->onDelay(BoatSensorConfig::THERMOCOUPLE_COLLECT_DELAY_MS,
+                              [this]() { this->collect(); });
+    }
+}
+
+void ThermocoupleSensorManager::collect() {
+    ThermocoupleScanner::Result result;
+    while (scanner_.takeResult(&result)) {
+        Channel& channel = channels_[result.index];
+        const ThermocoupleReading& reading = result.reading;
+        channel.kelvin->set(reading.fault == ThermocoupleFault::NONE
+                                ? reading.hot_c + 273.15f : NAN);
+        
+        if (!channel.status_sent || reading.fault != channel.reported) {
+            channel.reported = reading.fault;
+            channel.status_sent = true;
+            const char* status = ThermocoupleCodec::faultName(reading.fault);
+            if (reading.fault == ThermocoupleFault::NONE) {
+                ESP_LOGI("ThermocoupleSensorManager", "%s: ok", channel.base_name);
+            } else {
+                ESP_LOGW("ThermocoupleSensorManager", "%s: %s", channel.base_name, status);
+            }
+            channel.status->set(status);
+            channel.faults->set(static_cast<int>(scanner_.getCounters(result.index).faults));
+        }
+    }
+}
+
+FloatTransform* ThermocoupleSensorManager::findSensor(const char* base_name) const {
+    for (size_t i = 0; i < channel_count_; i++) {
+        if (strcmp(channels_[i].base_name, base_name) == 0) {
+            return channels_[i].calibration;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,154 @@
+#include "timestamped_sk_output.h"
+
+#include <sys/time.h>
+
+#include <cmath>
+#include <vector>
+
+#include "esp_timer.h"
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+uint64_t acquisitionNowMs() {
+    return static_cast<uint64_t>(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Sends the pending values of all timestamped outputs together
+ *
+ * Once per event loop tick with anything pending: one websocket frame
+ * instead of one per output.
+ */
+class TimestampedDeltaBatch {
+public:
+    TimestampedDeltaBatch() : scheduled_(false) {}
+    
+    void add(TimestampedSKOutputFloat* output) {
+        if (!output->pending_) {
+            output->pending_ = true;
+            pending_.push_back(output);
+        }
+        if (!scheduled_) {
+            scheduled_ = true;
+            event_loop()->onDelay(0, [this]() { this->send(); });
+        }
+    }
+
+private:
+    void send() {
+        scheduled_ = false;
+        // Keep the values for the first tick after reconnecting
+        if (pending_.empty() || !sensesp_app->get_ws_client()->is_connected()) {
+            return;
+        }
+        
+        JsonDocument doc;
+        JsonArray updates = doc["updates"].to<JsonArray>();
+        // The label SensESP's delta queue gives its updates
+        const String label = sensesp_app->get_hostname();
+        for (size_t i = 0; i < pending_.size(); i++) {
+            const int64_t epoch_ms = pending_[i]->pending_epoch_ms_;
+            if (!isFirstWithTimestamp(i)) {
+                continue;
+            }
+            JsonObject update = updates.add<JsonObject>();
+            update["source"]["label"] = label;
+            if (epoch_ms >= 0) {
+                char timestamp[SIGNALK_TIMESTAMP_SIZE];
+                formatSignalKTimestamp(epoch_ms, timestamp);
+                update["timestamp"] = timestamp;
+            }
+            JsonArray values = update["values"].to<JsonArray>();
+            for (size_t j = i; j < pending_.size(); j++) {
+                TimestampedSKOutputFloat* output = pending_[j];
+                if (output->pending_epoch_ms_ != epoch_ms) {
+                    continue;
+                }
+                JsonObject entry = values.add<JsonObject>();
+                entry["path"] = output->sk_path_;
+                if (std::isnan(output->pending_value_)) {
+                    entry["value"] = nullptr;
+                } else {
+                    entry["value"] = output->pending_value_;
+                }
+            }
+        }
+        for (TimestampedSKOutputFloat* output : pending_) {
+            output->pending_ = false;
+        }
+        pending_.clear();
+        
+        String payload;
+        serializeJson(doc, payload);
+        sensesp_app->get_ws_client()->sendTXT(payload);
+    }
+    
+    bool isFirstWithTimestamp(size_t index) const {
+        for (size_t i = 0; i < index; i++) {
+            if (pending_[i]->pending_epoch_ms_ == pending_[index]->pending_epoch_ms_) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    std::vector<TimestampedSKOutputFloat*> pending_;
+    bool scheduled_;
+};
+
+static TimestampedDeltaBatch& deltaBatch() {
+    static TimestampedDeltaBatch batch;
+    return batch;
+}
+
+TimestampedSKOutputFloat::TimestampedSKOutputFloat(const String& sk_path,
+                                                   const String& config_path,
+                                                   const AcquisitionStamp* stamp)
+    : FloatTransform(config_path)
+    , sk_path_(sk_path)
+    , stamp_(stamp)
+    , pending_value_(NAN)
+    , pending_epoch_ms_(-1)
+    , pending_(false) {
+    this->load();
+}
+
+void TimestampedSKOutputFloat::set(const float& value) {
+    this->emit(value);
+    
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    const int64_t wall_now_ms =
+        static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_usec / 1000;
+    
+    int64_t epoch_ms;
+    if (stamp_ == nullptr ||
+        !acquisitionToEpochMs(*stamp_, wall_now_ms, acquisitionNowMs(), &epoch_ms)) {
+        epoch_ms = -1;
+    }
+    pending_value_ = value;
+    pending_epoch_ms_ = epoch_ms;
+    deltaBatch().add(this);
+}
+
+bool TimestampedSKOutputFloat::to_json(JsonObject& root) {
+    root["sk_path"] = sk_path_;
+    return true;
+}
+
+bool TimestampedSKOutputFloat::from_json(const JsonObject& config) {
+    if (!config["sk_path"].is<String>()) {
+        return false;
+    }
+    sk_path_ = config["sk_path"].as<String>();
+    return true;
+}
+
+const String ConfigSchema(const TimestampedSKOutputFloat& obj) {
+    return R"###({"type":"object","properties":{"sk_path":{"title":"Signal K Path","type":"string"}}})###";
+}
+
+} // namespace BoatEngine
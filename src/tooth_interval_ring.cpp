@@ -0,0 +1,27 @@
+#include "tooth_interval_ring.h"
+
+namespace BoatEngine {
+
+constexpr size_t ToothIntervalRing::BUFFER_SIZE;
+
+ToothIntervalRing::ToothIntervalRing()
+    : active_(0)
+    , overruns_(0)
+    , fill_(0)
+    , last_us_(0)
+    , has_last_(false) {
+    full_[0] = false;
+    full_[1] = false;
+}
+
+const uint32_t* ToothIntervalRing::takeFull() const {
+    // Only the ISR switches buffers, and it never switches to a full one
+    const uint8_t filled = active_ ^ 1;
+    return full_[filled] ? buffers_[filled] : nullptr;
+}
+
+void ToothIntervalRing::release() {
+    full_[active_ ^ 1] = false;
+}
+
+} // namespace BoatEngine
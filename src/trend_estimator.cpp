@@ -0,0 +1,124 @@
+#include "trend_estimator.h"
+
+#include <cmath>
+
+namespace BoatEngine {
+
+constexpr size_t TrendEstimator::MAX_SAMPLES;
+
+TrendEstimator::TrendEstimator(uint32_t window_ms)
+    : window_ms_(window_ms) {
+    reset();
+}
+
+void TrendEstimator::reset() {
+    head_ = 0;
+    count_ = 0;
+    base_ms_ = 0;
+    sum_t_ = 0.0;
+    sum_y_ = 0.0;
+    sum_tt_ = 0.0;
+    sum_ty_ = 0.0;
+}
+
+void TrendEstimator::add(float value, uint32_t time_ms) {
+    if (std::isnan(value)) {
+        return;
+    }
+    expire(time_ms);
+    if (count_ == MAX_SAMPLES) {
+        removeOldest();
+    }
+    if (count_ == 0) {
+        base_ms_ = time_ms;
+    }
+    
+    samples_[(head_ + count_) % MAX_SAMPLES] = Sample{time_ms, value};
+    count_++;
+    
+    const double t = (time_ms - base_ms_) / 1000.0;
+    sum_t_ += t;
+    sum_y_ += value;
+    sum_tt_ += t * t;
+    sum_ty_ += t * value;
+    
+    // Keep t near zero so the sums do not lose precision
+    if (samples_[head_].time_ms - base_ms_ > window_ms_) {
+        rebase(samples_[head_].time_ms);
+    }
+}
+
+void TrendEstimator::expire(uint32_t now_ms) {
+    while (count_ > 0 && now_ms - samples_[head_].time_ms > window_ms_) {
+        removeOldest();
+    }
+}
+
+void TrendEstimator::removeOldest() {
+    const Sample& oldest = samples_[head_];
+    const double t = (oldest.time_ms - base_ms_) / 1000.0;
+    sum_t_ -= t;
+    sum_y_ -= oldest.value;
+    sum_tt_ -= t * t;
+    sum_ty_ -= t * oldest.value;
+    head_ = (head_ + 1) % MAX_SAMPLES;
+    count_--;
+    if (count_ == 0) {
+        // Start clean rather than carry rounding residue
+        reset();
+    }
+}
+
+void TrendEstimator::rebase(uint32_t base_ms) {
+    // t' = t - d for every sample
+    const double d = (base_ms - base_ms_) / 1000.0;
+    const double n = static_cast<double>(count_);
+    sum_tt_ += -2.0 * d * sum_t_ + n * d * d;
+    sum_ty_ -= d * sum_y_;
+    sum_t_ -= n * d;
+    base_ms_ = base_ms;
+}
+
+uint32_t TrendEstimator::getSpanMs() const {
+    if (count_ == 0) {
+        return 0;
+    }
+    return samples_[(head_ + count_ - 1) % MAX_SAMPLES].time_ms - samples_[head_].time_ms;
+}
+
+bool TrendEstimator::fit(double* slope, double* intercept) const {
+    if (count_ < 2 || getSpanMs() == 0) {
+        return false;
+    }
+    const double n = static_cast<double>(count_);
+    const double denominator = n * sum_tt_ - sum_t_ * sum_t_;
+    if (denominator <= 0.0) {
+        return false;
+    }
+    *slope = (n * sum_ty_ - sum_t_ * sum_y_) / denominator;
+    *intercept = (sum_y_ - *slope * sum_t_) / n;
+    return true;
+}
+
+bool TrendEstimator::getSlope(float* per_second) const {
+    double slope;
+    double intercept;
+    if (!fit(&slope, &intercept)) {
+        return false;
+    }
+    *per_second = static_cast<float>(slope);
+    return true;
+}
+
+bool TrendEstimator::getFittedLatest(float* value) const {
+    double slope;
+    double intercept;
+    if (!fit(&slope, &intercept)) {
+        return false;
+    }
+    const uint32_t latest = samples_[(head_ + count_ - 1) % MAX_SAMPLES].time_ms;
+    *value = static_cast<float>(intercept + slope * ((latest - base_ms_) / 1000.0));
+    return true;
+}
+
+} // namespace BoatEngine
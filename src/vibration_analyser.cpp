@@ -0,0 +1,166 @@
+#include "vibration_analyser.h"
+
+#include <cmath>
+
+namespace BoatEngine {
+
+constexpr size_t VibrationAnalyser::WINDOW;
+constexpr float VibrationAnalyser::MIN_PEAK_HZ;
+constexpr size_t VibrationAnalyser::BINS;
+
+static const float TWO_PI = 6.2831853f;
+
+static_assert((VibrationAnalyser::WINDOW & (VibrationAnalyser::WINDOW - 1)) == 0,
+              "WINDOW must be a power of two");
+
+VibrationAnalyser::VibrationAnalyser(float sample_rate_hz)
+    : sample_rate_hz_(sample_rate_hz)
+    , rpm_(0.0f)
+    , g_per_count_(1.0f)
+    , fill_(0)
+    , sum_square_g_(0.0)
+    , rpm_sum_(0.0)
+    , windows_(0)
+    , total_windows_(0)
+    , resyncs_(0) {
+    for (size_t i = 0; i < WINDOW; i++) {
+        hann_[i] = 0.5f - 0.5f * cosf(TWO_PI * i / WINDOW);
+    }
+    for (size_t i = 0; i < WINDOW / 2; i++) {
+        cos_[i] = cosf(TWO_PI * i / WINDOW);
+        sin_[i] = -sinf(TWO_PI * i / WINDOW);
+    }
+    for (size_t i = 0; i < BINS; i++) {
+        power_[i] = 0.0f;
+    }
+}
+
+void VibrationAnalyser::add(const AccelSample* samples, size_t count, float g_per_count) {
+    g_per_count_ = g_per_count;
+    for (size_t i = 0; i < count; i++) {
+        samples_[0][fill_] = samples[i].x;
+        samples_[1][fill_] = samples[i].y;
+        samples_[2][fill_] = samples[i].z;
+        if (++fill_ == WINDOW) {
+            analyseWindow();
+            fill_ = 0;
+        }
+    }
+}
+
+void VibrationAnalyser::resync() {
+    if (fill_ > 0) {
+        resyncs_++;
+    }
+    fill_ = 0;
+}
+
+void VibrationAnalyser::transform(float* re, float* im) const {
+    // Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < WINDOW; i++) {
+        size_t bit = WINDOW >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float swap = re[i];
+            re[i] = re[j];
+            re[j] = swap;
+            swap = im[i];
+            im[i] = im[j];
+            im[j] = swap;
+        }
+    }
+    // Butterflies, twiddles from the table
+    for (size_t length = 2; length <= WINDOW; length <<= 1) {
+        const size_t half = length >> 1;
+        const size_t step = WINDOW / length;
+        for (size_t start = 0; start < WINDOW; start += length) {
+            for (size_t k = 0; k < half; k++) {
+                const float wr = cos_[k * step];
+                const float wi = sin_[k * step];
+                const size_t a = start + k;
+                const size_t b = a + half;
+                const float tr = re[b] * wr - im[b] * wi;
+                const float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+void VibrationAnalyser::analyseWindow() {
+    double square_sum = 0.0;
+    for (size_t axis = 0; axis < 3; axis++) {
+        int32_t sum = 0;
+        for (size_t i = 0; i < WINDOW; i++) {
+            sum += samples_[axis][i];
+        }
+        const float mean = static_cast<float>(sum) / WINDOW;
+        for (size_t i = 0; i < WINDOW; i++) {
+            const float g = (samples_[axis][i] - mean) * g_per_count_;
+            square_sum += g * g;
+            re_[i] = g * hann_[i];
+            im_[i] = 0.0f;
+        }
+        transform(re_, im_);
+        for (size_t bin = 0; bin < BINS; bin++) {
+            power_[bin] += re_[bin] * re_[bin] + im_[bin] * im_[bin];
+        }
+    }
+    sum_square_g_ += square_sum / WINDOW;
+    rpm_sum_ += rpm_;
+    windows_++;
+    total_windows_++;
+}
+
+bool VibrationAnalyser::takeResult(Result* result) {
+    if (windows_ == 0) {
+        return false;
+    }
+    const float bin_hz = sample_rate_hz_ / WINDOW;
+    size_t first = static_cast<size_t>(ceilf(MIN_PEAK_HZ / bin_hz));
+    if (first < 1) {
+        first = 1;
+    }
+    size_t peak = first;
+    for (size_t bin = first + 1; bin < BINS - 1; bin++) {
+        if (power_[bin] > power_[peak]) {
+            peak = bin;
+        }
+    }
+    
+    // Gaussian interpolation of the log magnitudes either side, which is
+    // close to exact for the Hann window's main lobe
+    float offset = 0.0f;
+    if (peak > 0 && peak < BINS - 1) {
+        const float floor = 1e-20f;
+        const float left = logf(power_[peak - 1] + floor);
+        const float centre = logf(power_[peak] + floor);
+        const float right = logf(power_[peak + 1] + floor);
+        const float curvature = left - 2.0f * centre + right;
+        if (curvature < 0.0f) {
+            offset = 0.5f * (left - right) / curvature;
+        }
+    }
+    
+    result->rms_g = static_cast<float>(sqrt(sum_square_g_ / windows_));
+    result->peak_hz = (peak + offset) * bin_hz;
+    result->rpm = static_cast<float>(rpm_sum_ / windows_);
+    result->order = result->rpm > 0.0f ? result->peak_hz / (result->rpm / 60.0f) : NAN;
+    result->windows = windows_;
+    
+    for (size_t i = 0; i < BINS; i++) {
+        power_[i] = 0.0f;
+    }
+    sum_square_g_ = 0.0;
+    rpm_sum_ = 0.0;
+    windows_ = 0;
+    return true;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,132 @@
+#include "vibration_sensor_manager.h"
+
+#include <cmath>
+
+#include <freertos/task.h>
+
+#include "deferred_log_manager.h"
+#include "sensesp/system/lambda_consumer.h"
+#include "sensor_config.h"
+
+using namespace sensesp;
+
+namespace BoatEngine {
+
+static const float STANDARD_GRAVITY = 9.80665f;
+
+// Measured rates further than this from nominal are taken as a glitch
+static const float MAX_RATE_ERROR = 0.2f;
+
+// Deepest hardware FIFO drained in one pass
+static const size_t DRAIN_SAMPLES = 32;
+
+VibrationSensorManager::VibrationSensorManager(Accelerometer* accelerometer)
+    : accelerometer_(accelerometer)
+    , revolutions_(0.0f)
+    , analyser_(accelerometer->getSampleRateHz())
+    , overruns_(0)
+    , report_samples_(0)
+    , report_start_ms_(0)
+    , result_lock_(xSemaphoreCreateMutex())
+    , result_overruns_(0)
+    , has_result_(false)
+    , rms_output_(nullptr)
+    , frequency_output_(nullptr)
+    , order_output_(nullptr) {
+}
+
+bool VibrationSensorManager::start(ValueProducer<float>* revolutions) {
+    if (!accelerometer_->begin()) {
+        ESP_LOGE("VibrationSensorManager", "No accelerometer");
+        return false;
+    }
+    
+    revolutions->connect_to(new LambdaConsumer<float>([this](float value) {
+        revolutions_.store(std::isnan(value) ? 0.0f : value);
+    }));
+    
+    const String prefix(BoatSensorConfig::VIBRATION_SK_PREFIX);
+    rms_output_ = new SKOutputFloat(prefix + "rms");
+    frequency_output_ = new SKOutputFloat(prefix + "dominantFrequency");
+    order_output_ = new SKOutputFloat(prefix + "dominantOrder");
+    
+    report_start_ms_ = millis();
+    xTaskCreatePinnedToCore(drainTask, BoatSensorConfig::VIBRATION_TASK_NAME,
+                            BoatSensorConfig::VIBRATION_TASK_STACK, this,
+                            BoatSensorConfig::VIBRATION_TASK_PRIORITY, nullptr,
+                            BoatSensorConfig::VIBRATION_TASK_CORE);
+    event_loop()->onRepeat(BoatSensorConfig::VIBRATION_REPORT_MS, [this]() { this->publish(); });
+    ESP_LOGI("VibrationSensorManager", "Sampling at %.0f Hz",
+             accelerometer_->getSampleRateHz());
+    return true;
+}
+
+void VibrationSensorManager::drainTask(void* arg) {
+    VibrationSensorManager* self = static_cast<VibrationSensorManager*>(arg);
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(BoatSensorConfig::VIBRATION_DRAIN_MS));
+        self->drain();
+    }
+}
+
+void VibrationSensorManager::drain() {
+    AccelSample samples[DRAIN_SAMPLES];
+    bool overrun = false;
+    const size_t count = accelerometer_->readFifo(samples, DRAIN_SAMPLES, &overrun);
+    if (overrun) {
+        // Samples may be missing before these; the window would not be one run
+        overruns_++;
+        analyser_.resync();
+    }
+    analyser_.setRpm(revolutions_.load() * 60.0f);
+    analyser_.add(samples, count, accelerometer_->getGPerCount());
+    report_samples_ += count;
+    
+    const uint32_t now = millis();
+    if (now - report_start_ms_ >= BoatSensorConfig::VIBRATION_REPORT_MS) {
+        handOver(now);
+    }
+}
+
+void VibrationSensorManager::handOver(uint32_t now_ms) {
+    // Correct the chip's oscillator error for the next report's windows
+    const float measured = report_samples_ * 1000.0f / (now_ms - report_start_ms_);
+    const float nominal = accelerometer_->getSampleRateHz();
+    if (fabsf(measured - nominal) < nominal * MAX_RATE_ERROR) {
+        analyser_.setSampleRate(measured);
+    }
+    report_samples_ = 0;
+    report_start_ms_ = now_ms;
+    
+    VibrationAnalyser::Result result;
+    if (!analyser_.takeResult(&result)) {
+        return;
+    }
+    xSemaphoreTake(result_lock_, portMAX_DELAY);
+    result_ = result;
+    result_overruns_ = overruns_;
+    has_result_ = true;
+    xSemaphoreGive(result_lock_);
+}
+
+void VibrationSensorManager::publish() {
+    xSemaphoreTake(result_lock_, portMAX_DELAY);
+    const bool ready = has_result_;
+    const VibrationAnalyser::Result result = result_;
+    const uint32_t overruns = result_overruns_;
+    has_result_ = false;
+    xSemaphoreGive(result_lock_);
+    if (!ready) {
+        return;
+    }
+    
+    rms_output_->set(result.rms_g * STANDARD_GRAVITY);
+    frequency_output_->set(result.peak_hz);
+    if (!std::isnan(result.order)) {
+        order_output_->set(result.order);
+    }
+    logDeferred(LogEvent::VIBRATION, result.rms_g, result.peak_hz, result.rpm, overruns);
+}
+
+} // namespace BoatEngine
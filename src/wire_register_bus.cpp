@@ -0,0 +1,29 @@
+#include "wire_register_bus.h"
+
+namespace BoatEngine {
+
+WireRegisterBus::WireRegisterBus(TwoWire* wire, uint8_t address)
+    : wire_(wire)
+    , address_(address) {
+}
+
+bool WireRegisterBus::writeRegister(uint8_t reg, uint8_t value) {
+    wire_->beginTransmission(address_);
+    wire_->write(reg);
+    wire_->write(value);
+    return wire_->endTransmission() == 0;
+}
+
+bool WireRegisterBus::readRegisters(uint8_t reg, uint8_t* data, size_t length) {
+    wire_->beginTransmission(address_);
+    wire_->write(reg);
+    if (wire_->endTransmission(false) != 0) {
+        return false;
+    }
+    if (wire_->requestFrom(address_, length, true) != length) {
+        return false;
+    }
+    return wire_->readBytes(data, length) == length;
+}
+
+} // namespace BoatEngine
@@ -0,0 +1,107 @@
+#include <unity.h>
+
+#include "acquisition_time.h"
+
+// Host-runnable tests for acquisition timestamps on Signal K deltas
+
+using namespace BoatEngine;
+
+static const int64_t WALL_NOW_MS = 1792326896789LL;   // 2026-10-18T12:34:56.789Z
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test RFC 3339 formatting, including leap days and century rules
+void test_format_timestamp(void) {
+    char timestamp[SIGNALK_TIMESTAMP_SIZE];
+    
+    formatSignalKTimestamp(0, timestamp);
+    TEST_ASSERT_EQUAL_STRING("1970-01-01T00:00:00.000Z", timestamp);
+    
+    formatSignalKTimestamp(WALL_NOW_MS, timestamp);
+    TEST_ASSERT_EQUAL_STRING("2026-10-18T12:34:56.789Z", timestamp);
+    
+    formatSignalKTimestamp(1709251199999LL, timestamp);
+    TEST_ASSERT_EQUAL_STRING("2024-02-29T23:59:59.999Z", timestamp);
+    
+    formatSignalKTimestamp(4107542400000LL, timestamp);
+    TEST_ASSERT_EQUAL_STRING("2100-03-01T00:00:00.000Z", timestamp);
+}
+
+// Test that a sample's age on the monotonic clock is subtracted
+void test_stamp_to_epoch(void) {
+    AcquisitionStamp stamp;
+    stamp.mark(100000);
+    
+    int64_t epoch_ms = 0;
+    TEST_ASSERT_TRUE(acquisitionToEpochMs(stamp, WALL_NOW_MS, 100750, &epoch_ms));
+    TEST_ASSERT_TRUE(epoch_ms == WALL_NOW_MS - 750);
+    
+    TEST_ASSERT_TRUE(acquisitionToEpochMs(stamp, WALL_NOW_MS, 100000, &epoch_ms));
+    TEST_ASSERT_TRUE(epoch_ms == WALL_NOW_MS);
+}
+
+// Test that samples taken 1 ms apart stay 1 ms apart, however late sent
+void test_stamps_keep_order(void) {
+    AcquisitionStamp rpm;
+    AcquisitionStamp coolant;
+    rpm.mark(50000);
+    coolant.mark(50001);
+    
+    // Coolant is sent a conversion later than RPM
+    int64_t rpm_ms = 0;
+    int64_t coolant_ms = 0;
+    TEST_ASSERT_TRUE(acquisitionToEpochMs(rpm, WALL_NOW_MS, 50002, &rpm_ms));
+    TEST_ASSERT_TRUE(acquisitionToEpochMs(coolant, WALL_NOW_MS + 748, 50750, &coolant_ms));
+    TEST_ASSERT_TRUE(coolant_ms - rpm_ms == 1);
+}
+
+// Test that nothing is converted without a set clock or a sample
+void test_unusable_stamps(void) {
+    AcquisitionStamp stamp;
+    int64_t epoch_ms = 0;
+    
+    // Never marked
+    TEST_ASSERT_FALSE(acquisitionToEpochMs(stamp, WALL_NOW_MS, 1000, &epoch_ms));
+    
+    // Wall clock still counting from 1970
+    stamp.mark(500);
+    TEST_ASSERT_FALSE(acquisitionToEpochMs(stamp, 1000, 1000, &epoch_ms));
+    
+    // Marked after "now"
+    TEST_ASSERT_FALSE(acquisitionToEpochMs(stamp, WALL_NOW_MS, 400, &epoch_ms));
+    TEST_ASSERT_TRUE(epoch_ms == 0);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_format_timestamp);
+    RUN_TEST(test_stamp_to_epoch);
+    RUN_TEST(test_stamps_keep_order);
+    RUN_TEST(test_unusable_stamps);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,249 @@
+#include <unity.h>
+
+#include "adc_block_filter.h"
+#include "simulated_adc_source.h"
+
+// Host-runnable tests for the analog acquisition path: the decimating
+// block filter fed from the simulated continuous ADC source
+
+using namespace BoatEngine;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that a block of constant samples decimates to that constant
+void test_filter_constant_input(void) {
+    AdcBlockFilter filter(8);
+    AdcSample samples[8];
+    for (int i = 0; i < 8; i++) {
+        samples[i].channel = 3;
+        samples[i].raw = 1000;
+    }
+    AdcBlockFilter::Result results[4];
+    
+    TEST_ASSERT_EQUAL(1, filter.process(samples, 8, results, 4));
+    TEST_ASSERT_EQUAL(3, results[0].channel);
+    TEST_ASSERT_EQUAL_FLOAT(1000.0f, results[0].raw);
+}
+
+// Test that no output is produced until a block is complete
+void test_filter_partial_block(void) {
+    AdcBlockFilter filter(8);
+    AdcSample samples[7];
+    for (int i = 0; i < 7; i++) {
+        samples[i].channel = 0;
+        samples[i].raw = 500;
+    }
+    AdcBlockFilter::Result results[4];
+    
+    TEST_ASSERT_EQUAL(0, filter.process(samples, 7, results, 4));
+    TEST_ASSERT_EQUAL(1, filter.process(samples, 1, results, 4));
+}
+
+// Test that a single spike is trimmed out of the block mean
+void test_filter_rejects_spike(void) {
+    AdcBlockFilter filter(6);
+    AdcSample samples[6] = {
+        {1, 2000}, {1, 2002}, {1, 4095}, {1, 1998}, {1, 2000}, {1, 1990}
+    };
+    AdcBlockFilter::Result results[2];
+    
+    TEST_ASSERT_EQUAL(1, filter.process(samples, 6, results, 2));
+    // 4095 and 1990 are discarded: (2000 + 2002 + 1998 + 2000) / 4
+    TEST_ASSERT_EQUAL_FLOAT(2000.0f, results[0].raw);
+}
+
+// Test that interleaved channels are accumulated independently
+void test_filter_interleaved_channels(void) {
+    AdcBlockFilter filter(4);
+    AdcSample samples[8];
+    for (int i = 0; i < 8; i++) {
+        samples[i].channel = (i % 2) ? 7 : 6;
+        samples[i].raw = (i % 2) ? 300 : 100;
+    }
+    AdcBlockFilter::Result results[4];
+    
+    TEST_ASSERT_EQUAL(2, filter.process(samples, 8, results, 4));
+    TEST_ASSERT_EQUAL(6, results[0].channel);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, results[0].raw);
+    TEST_ASSERT_EQUAL(7, results[1].channel);
+    TEST_ASSERT_EQUAL_FLOAT(300.0f, results[1].raw);
+}
+
+// Test that out-of-range channels are counted and ignored
+void test_filter_rejects_bad_channel(void) {
+    AdcBlockFilter filter(4);
+    AdcSample sample = {AdcBlockFilter::MAX_CHANNELS, 123};
+    AdcBlockFilter::Result results[1];
+    
+    TEST_ASSERT_EQUAL(0, filter.process(&sample, 1, results, 1));
+    TEST_ASSERT_EQUAL(1, filter.getRejectedCount());
+}
+
+// Test that the block size is clamped to the trimming minimum
+void test_filter_minimum_block_size(void) {
+    AdcBlockFilter filter(1);
+    TEST_ASSERT_EQUAL(AdcBlockFilter::MIN_BLOCK_SIZE, filter.getBlockSize());
+}
+
+// Test that the simulated source produces samples at the configured rate
+void test_simulated_source_rate(void) {
+    SimulatedAdcSource source(4096);
+    const uint8_t channels[] = {6, 7, 0};
+    TEST_ASSERT_TRUE(source.begin(channels, 3, 20000));
+    
+    source.advance(50);
+    TEST_ASSERT_EQUAL(1000, source.getPendingCount());
+    
+    AdcSample samples[16];
+    TEST_ASSERT_EQUAL(16, source.read(samples, 16));
+    TEST_ASSERT_EQUAL(6, samples[0].channel);
+    TEST_ASSERT_EQUAL(7, samples[1].channel);
+    TEST_ASSERT_EQUAL(0, samples[2].channel);
+    TEST_ASSERT_EQUAL(6, samples[3].channel);
+}
+
+// Test that draining too slowly overflows the simulated DMA pool
+void test_simulated_source_overflow(void) {
+    SimulatedAdcSource source(256);
+    const uint8_t channels[] = {0};
+    TEST_ASSERT_TRUE(source.begin(channels, 1, 20000));
+    
+    source.advance(100);
+    TEST_ASSERT_EQUAL(256, source.getPendingCount());
+    TEST_ASSERT_EQUAL(1, source.getOverflowCount());
+}
+
+// Test the full path: noisy, spiky source through the filter
+void test_filter_on_noisy_source(void) {
+    SimulatedAdcSource source(16384, 42);
+    const uint8_t channels[] = {6, 7};
+    TEST_ASSERT_TRUE(source.begin(channels, 2, 20000));
+    source.setLevel(6, 1500);
+    source.setLevel(7, 3000);
+    source.setNoise(40);
+    source.setSpikeInterval(997);
+    
+    // 500 ms of data per channel at 10 kHz
+    AdcBlockFilter filter(5000);
+    AdcSample samples[256];
+    AdcBlockFilter::Result results[8];
+    float last[8] = {0};
+    int outputs = 0;
+    
+    source.advance(500);
+    size_t count;
+    while ((count = source.read(samples, 256)) > 0) {
+        size_t produced = filter.process(samples, count, results, 8);
+        for (size_t i = 0; i < produced; i++) {
+            last[results[i].channel] = results[i].raw;
+            outputs++;
+        }
+    }
+    
+    TEST_ASSERT_EQUAL(2, outputs);
+    // Oversampled noise averages out well below one count of the noise band
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 1500.0f, last[6]);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 3000.0f, last[7]);
+}
+
+// Source that hands out at most one short frame per read, like the
+// device driver's DMA frames
+class ShortReadSource : public AdcSource {
+public:
+    ShortReadSource(AdcSource* inner, size_t frame) : inner_(inner), frame_(frame), reads_(0) {}
+    bool begin(const uint8_t* channels, size_t count, uint32_t rate) override {
+        return inner_->begin(channels, count, rate);
+    }
+    void pause() override { inner_->pause(); }
+    void resume() override { inner_->resume(); }
+    size_t read(AdcSample* out, size_t max_samples) override {
+        reads_++;
+        return inner_->read(out, max_samples < frame_ ? max_samples : frame_);
+    }
+    float toMillivolts(float raw) const override { return inner_->toMillivolts(raw); }
+    uint32_t getOverflowCount() const override { return inner_->getOverflowCount(); }
+    size_t getReadCount() const { return reads_; }
+
+private:
+    AdcSource* inner_;
+    size_t frame_;
+    size_t reads_;
+};
+
+// Test that a drain empties the source even when every read comes back short
+void test_drain_short_reads(void) {
+    SimulatedAdcSource simulated(4096);
+    ShortReadSource source(&simulated, 128);
+    const uint8_t channels[] = {6, 7};
+    TEST_ASSERT_TRUE(source.begin(channels, 2, 20000));
+    simulated.setLevel(6, 1200);
+    simulated.setLevel(7, 2400);
+    
+    // One 50 ms drain interval at 20 kS/s
+    AdcBlockFilter filter(100);
+    AdcSample samples[256];
+    AdcBlockFilter::Result results[8];
+    int outputs[8] = {0};
+    
+    simulated.advance(50);
+    const size_t drained = filter.drain(&source, samples, 256, results, 8,
+                                        [&outputs](const AdcBlockFilter::Result& result) {
+        outputs[result.channel]++;
+    });
+    
+    TEST_ASSERT_EQUAL(1000, drained);
+    TEST_ASSERT_EQUAL(0, simulated.getPendingCount());
+    TEST_ASSERT_EQUAL(0, simulated.getOverflowCount());
+    // 1000 samples in 128-sample frames, plus the empty read that ends it
+    TEST_ASSERT_EQUAL(9, source.getReadCount());
+    TEST_ASSERT_EQUAL(5, outputs[6]);
+    TEST_ASSERT_EQUAL(5, outputs[7]);
+}
+
+// Test the simulated millivolt conversion endpoints
+void test_simulated_source_millivolts(void) {
+    SimulatedAdcSource source;
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, source.toMillivolts(0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(3300.0f, source.toMillivolts(4095.0f));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_filter_constant_input);
+    RUN_TEST(test_filter_partial_block);
+    RUN_TEST(test_filter_rejects_spike);
+    RUN_TEST(test_filter_interleaved_channels);
+    RUN_TEST(test_filter_rejects_bad_channel);
+    RUN_TEST(test_filter_minimum_block_size);
+    RUN_TEST(test_simulated_source_rate);
+    RUN_TEST(test_simulated_source_overflow);
+    RUN_TEST(test_filter_on_noisy_source);
+    RUN_TEST(test_drain_short_reads);
+    RUN_TEST(test_simulated_source_millivolts);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,159 @@
+#include <unity.h>
+
+#include "calibration_table.h"
+#include "sensor_config.h"
+
+// Host-runnable tests for the piecewise-linear calibration table
+
+using namespace BoatEngine;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that a default-constructed table is the identity on [0, 1]
+void test_default_is_identity(void) {
+    CalibrationTable table;
+    TEST_ASSERT_EQUAL(2, table.size());
+    TEST_ASSERT_EQUAL_FLOAT(0.25f, table.evaluate(0.25f));
+    TEST_ASSERT_EQUAL_FLOAT(0.75f, table.evaluate(0.75f));
+}
+
+// Test interpolation between breakpoints and exact hits on breakpoints
+void test_interpolation(void) {
+    CalibrationTable table;
+    const CalibrationTable::Point points[] = {
+        {0.0f, 0.0f}, {10.0f, 100.0f}, {20.0f, 150.0f}, {40.0f, 350.0f}
+    };
+    TEST_ASSERT_TRUE(table.setPoints(points, 4));
+    
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, table.evaluate(5.0f));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, table.evaluate(10.0f));
+    TEST_ASSERT_EQUAL_FLOAT(125.0f, table.evaluate(15.0f));
+    TEST_ASSERT_EQUAL_FLOAT(250.0f, table.evaluate(30.0f));
+}
+
+// Test that inputs outside the table clamp to the end outputs
+void test_clamps_outside_range(void) {
+    CalibrationTable table;
+    const CalibrationTable::Point points[] = {{1.0f, 10.0f}, {2.0f, 20.0f}};
+    TEST_ASSERT_TRUE(table.setPoints(points, 2));
+    
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, table.evaluate(-5.0f));
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, table.evaluate(99.0f));
+}
+
+// Test that unsorted points are accepted and sorted
+void test_unsorted_points(void) {
+    CalibrationTable table;
+    const CalibrationTable::Point points[] = {
+        {30.0f, 3.0f}, {10.0f, 1.0f}, {20.0f, 2.0f}
+    };
+    TEST_ASSERT_TRUE(table.setPoints(points, 3));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, table.point(0).input);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, table.evaluate(15.0f));
+}
+
+// Test that invalid point sets are rejected and leave the table unchanged
+void test_rejects_invalid_points(void) {
+    CalibrationTable table;
+    const CalibrationTable::Point single[] = {{1.0f, 1.0f}};
+    const CalibrationTable::Point duplicate[] = {{1.0f, 1.0f}, {1.0f, 2.0f}};
+    CalibrationTable::Point too_many[CalibrationTable::MAX_POINTS + 1];
+    for (size_t i = 0; i <= CalibrationTable::MAX_POINTS; i++) {
+        too_many[i].input = static_cast<float>(i);
+        too_many[i].output = 0.0f;
+    }
+    
+    TEST_ASSERT_FALSE(table.setPoints(single, 1));
+    TEST_ASSERT_FALSE(table.setPoints(duplicate, 2));
+    TEST_ASSERT_FALSE(table.setPoints(too_many, CalibrationTable::MAX_POINTS + 1));
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, table.evaluate(0.5f));
+}
+
+// Test clustered breakpoints where several share one index bucket
+void test_clustered_points(void) {
+    CalibrationTable table;
+    CalibrationTable::Point points[CalibrationTable::MAX_POINTS];
+    // 15 points packed into [0, 0.15], one far away at 1000
+    for (size_t i = 0; i < CalibrationTable::MAX_POINTS - 1; i++) {
+        points[i].input = 0.01f * static_cast<float>(i);
+        points[i].output = static_cast<float>(i);
+    }
+    points[CalibrationTable::MAX_POINTS - 1].input = 1000.0f;
+    points[CalibrationTable::MAX_POINTS - 1].output = 1000.0f;
+    TEST_ASSERT_TRUE(table.setPoints(points, CalibrationTable::MAX_POINTS));
+    
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 3.5f, table.evaluate(0.035f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 12.5f, table.evaluate(0.125f));
+}
+
+// Test the index against a brute-force linear search across the range
+void test_matches_linear_search(void) {
+    CalibrationTable table;
+    const CalibrationTable::Point points[] = {
+        {-40.0f, -38.0f}, {-10.0f, -9.5f}, {0.0f, 0.2f}, {25.0f, 25.0f},
+        {60.0f, 59.1f}, {85.0f, 83.0f}, {100.0f, 97.5f}, {125.0f, 120.0f}
+    };
+    const size_t n = sizeof(points) / sizeof(points[0]);
+    TEST_ASSERT_TRUE(table.setPoints(points, n));
+    
+    for (float x = -40.0f; x <= 125.0f; x += 0.37f) {
+        size_t s = 0;
+        while (s < n - 2 && points[s + 1].input <= x) {
+            s++;
+        }
+        const float expected = points[s].output +
+            (x - points[s].input) * (points[s + 1].output - points[s].output) /
+            (points[s + 1].input - points[s].input);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected, table.evaluate(x));
+    }
+}
+
+// Test the built-in fuel sender table maps its endpoints to empty and full
+void test_fuel_level_default_table(void) {
+    CalibrationTable table;
+    TEST_ASSERT_TRUE(table.setPoints(BoatSensorConfig::FUEL_LEVEL_TABLE,
+                                     BoatSensorConfig::FUEL_LEVEL_TABLE_SIZE));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, table.evaluate(300.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, table.evaluate(1607.7f));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, table.evaluate(2121.4f));
+    TEST_ASSERT_EQUAL(BoatSensorConfig::Calibration::TABLE,
+                      BoatSensorConfig::FUEL_LEVEL.calibration.type);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_default_is_identity);
+    RUN_TEST(test_interpolation);
+    RUN_TEST(test_clamps_outside_range);
+    RUN_TEST(test_unsorted_points);
+    RUN_TEST(test_rejects_invalid_points);
+    RUN_TEST(test_clustered_points);
+    RUN_TEST(test_matches_linear_search);
+    RUN_TEST(test_fuel_level_default_table);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,327 @@
+#include <unity.h>
+
+#include <cmath>
+#include <vector>
+
+#include "cylinder_balance.h"
+#include "tooth_interval_ring.h"
+
+// Host-runnable tests for cylinder balance analysis on synthetic crank
+// speed signals, and for the ISR interval buffers that feed it
+
+using namespace BoatEngine;
+
+// Four-cylinder four-stroke, 60-tooth flywheel pickup
+static const CylinderBalance::Settings FOUR_CYLINDER = {60, 4, true};
+
+/**
+ * Tooth intervals for cycles at a mean RPM. Each firing adds a speed
+ * ripple at the firing order; a misfiring cylinder's sector loses
+ * `misfire` of its speed, easing in and out over the sector.
+ */
+static std::vector<uint32_t> syntheticCycles(const CylinderBalance::Settings& settings,
+                                             float rpm, size_t cycles, int misfire_sector,
+                                             float misfire, unsigned jitter_us = 0) {
+    const size_t teeth = settings.teeth_per_rev * (settings.four_stroke ? 2 : 1);
+    const size_t per_sector = teeth / settings.cylinders;
+    const double nominal_us = 60.0e6 / (rpm * settings.teeth_per_rev);
+    const double two_pi = 6.283185307179586;
+    uint32_t noise = 12345;
+    std::vector<uint32_t> intervals;
+    for (size_t c = 0; c < cycles; c++) {
+        for (size_t n = 0; n < teeth; n++) {
+            double speed = 1.0 + 0.02 * sin(two_pi * settings.cylinders * n / teeth);
+            if (misfire_sector >= 0 && n / per_sector == static_cast<size_t>(misfire_sector)) {
+                const double into = static_cast<double>(n % per_sector) / per_sector;
+                speed -= misfire * 0.5 * (1.0 - cos(two_pi * into));
+            }
+            double interval = nominal_us / speed;
+            if (jitter_us > 0) {
+                noise = noise * 1103515245u + 12345u;
+                interval += static_cast<double>((noise >> 16) % (2 * jitter_us + 1)) - jitter_us;
+            }
+            intervals.push_back(static_cast<uint32_t>(interval + 0.5));
+        }
+    }
+    return intervals;
+}
+
+static size_t slowestSector(const CylinderBalance::Result& result, size_t cylinders) {
+    size_t slowest = 0;
+    for (size_t k = 1; k < cylinders; k++) {
+        if (result.contribution[k] < result.contribution[slowest]) {
+            slowest = k;
+        }
+    }
+    return slowest;
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that identical cylinders read as balanced and smooth
+void test_balanced_engine(void) {
+    CylinderBalance balance(FOUR_CYLINDER);
+    const std::vector<uint32_t> intervals = syntheticCycles(FOUR_CYLINDER, 1500.0f, 20, -1, 0.0f);
+    balance.addIntervals(intervals.data(), intervals.size());
+    
+    CylinderBalance::Result result;
+    TEST_ASSERT_TRUE(balance.analyse(&result));
+    TEST_ASSERT_EQUAL(20, result.cycles);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, 1500.0f, result.rpm);
+    for (size_t k = 0; k < 4; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.002f, 1.0f, result.contribution[k]);
+    }
+    TEST_ASSERT_TRUE(result.roughness < 0.001f);
+    
+    // The cycles were consumed
+    TEST_ASSERT_FALSE(balance.analyse(&result));
+}
+
+// Test that a misfire shows in its sector and raises roughness
+void test_misfire_located(void) {
+    CylinderBalance balance(FOUR_CYLINDER);
+    const std::vector<uint32_t> intervals = syntheticCycles(FOUR_CYLINDER, 1500.0f, 20, 2, 0.04f);
+    balance.addIntervals(intervals.data(), intervals.size());
+    
+    CylinderBalance::Result result;
+    TEST_ASSERT_TRUE(balance.analyse(&result));
+    TEST_ASSERT_EQUAL(2, slowestSector(result, 4));
+    TEST_ASSERT_TRUE(result.contribution[2] < 0.99f);
+    TEST_ASSERT_TRUE(result.contribution[0] > 1.0f);
+    TEST_ASSERT_TRUE(result.roughness > 0.01f);
+}
+
+// Test that roughness grows with the severity of the misfire
+void test_roughness_tracks_severity(void) {
+    float previous = 0.0f;
+    const float severities[] = {0.0f, 0.01f, 0.03f, 0.1f};
+    for (size_t i = 0; i < 4; i++) {
+        CylinderBalance balance(FOUR_CYLINDER);
+        const std::vector<uint32_t> intervals =
+            syntheticCycles(FOUR_CYLINDER, 2200.0f, 10, 1, severities[i]);
+        balance.addIntervals(intervals.data(), intervals.size());
+        CylinderBalance::Result result;
+        TEST_ASSERT_TRUE(balance.analyse(&result));
+        if (i > 0) {
+            TEST_ASSERT_TRUE(result.roughness > previous);
+        }
+        previous = result.roughness;
+    }
+}
+
+// Test that averaging over cycles keeps tooth jitter out of the result
+void test_jitter_averaged_out(void) {
+    CylinderBalance balance(FOUR_CYLINDER);
+    const std::vector<uint32_t> smooth =
+        syntheticCycles(FOUR_CYLINDER, 1500.0f, 200, -1, 0.0f, 20);
+    balance.addIntervals(smooth.data(), smooth.size());
+    CylinderBalance::Result healthy;
+    TEST_ASSERT_TRUE(balance.analyse(&healthy));
+    
+    const std::vector<uint32_t> misfiring =
+        syntheticCycles(FOUR_CYLINDER, 1500.0f, 200, 3, 0.02f, 20);
+    balance.addIntervals(misfiring.data(), misfiring.size());
+    CylinderBalance::Result faulty;
+    TEST_ASSERT_TRUE(balance.analyse(&faulty));
+    
+    TEST_ASSERT_EQUAL(3, slowestSector(faulty, 4));
+    TEST_ASSERT_TRUE(faulty.roughness > healthy.roughness * 5.0f);
+}
+
+// Test that sectors are numbered from the first tooth after a resync
+void test_sectors_follow_sync(void) {
+    CylinderBalance balance(FOUR_CYLINDER);
+    const std::vector<uint32_t> intervals = syntheticCycles(FOUR_CYLINDER, 1500.0f, 20, 2, 0.04f);
+    
+    // Start one sector late: the misfire moves to sector 1
+    const size_t per_sector = 30;
+    balance.addIntervals(intervals.data() + per_sector, intervals.size() - per_sector);
+    CylinderBalance::Result result;
+    TEST_ASSERT_TRUE(balance.analyse(&result));
+    TEST_ASSERT_EQUAL(1, slowestSector(result, 4));
+}
+
+// Test that a stall resyncs instead of folding the gap into a cycle
+void test_long_interval_resyncs(void) {
+    CylinderBalance balance(FOUR_CYLINDER);
+    std::vector<uint32_t> intervals = syntheticCycles(FOUR_CYLINDER, 1500.0f, 3, -1, 0.0f);
+    intervals.insert(intervals.begin() + 50, CylinderBalance::MAX_INTERVAL_US + 1);
+    balance.addIntervals(intervals.data(), intervals.size());
+    
+    // The partial cycle before the stall is dropped
+    TEST_ASSERT_EQUAL(1, balance.getResyncCount());
+    TEST_ASSERT_EQUAL(2, balance.getCycleCount());
+}
+
+// Test that cycles from before a resync are not averaged with those after
+void test_resync_discards_old_cycles(void) {
+    const std::vector<uint32_t> intervals = syntheticCycles(FOUR_CYLINDER, 1500.0f, 20, 2, 0.04f);
+    const size_t teeth = 120;
+    const size_t per_sector = 30;
+    
+    // Ten cycles in phase, a stall, then ten cycles one sector late
+    std::vector<uint32_t> resynced(intervals.begin(), intervals.begin() + 10 * teeth);
+    resynced.push_back(CylinderBalance::MAX_INTERVAL_US + 1);
+    resynced.insert(resynced.end(), intervals.begin() + 10 * teeth + per_sector, intervals.end());
+    CylinderBalance balance(FOUR_CYLINDER);
+    balance.addIntervals(resynced.data(), resynced.size());
+    
+    // Only the cycles after the stall count, as if they were all it saw
+    CylinderBalance fresh(FOUR_CYLINDER);
+    fresh.addIntervals(intervals.data() + 10 * teeth + per_sector,
+                       intervals.size() - 10 * teeth - per_sector);
+    
+    CylinderBalance::Result result;
+    CylinderBalance::Result expected;
+    TEST_ASSERT_TRUE(balance.analyse(&result));
+    TEST_ASSERT_TRUE(fresh.analyse(&expected));
+    TEST_ASSERT_EQUAL(1, balance.getResyncCount());
+    TEST_ASSERT_EQUAL(expected.cycles, result.cycles);
+    TEST_ASSERT_EQUAL(9, result.cycles);
+    for (size_t k = 0; k < 4; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected.contribution[k], result.contribution[k]);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected.roughness, result.roughness);
+    TEST_ASSERT_EQUAL(1, slowestSector(result, 4));
+}
+
+// Test a two-stroke, where the cycle is one revolution
+void test_two_stroke(void) {
+    const CylinderBalance::Settings two_stroke = {36, 3, false};
+    CylinderBalance balance(two_stroke);
+    TEST_ASSERT_EQUAL(36, balance.getTeethPerCycle());
+    const std::vector<uint32_t> intervals = syntheticCycles(two_stroke, 3000.0f, 30, 0, 0.05f);
+    balance.addIntervals(intervals.data(), intervals.size());
+    
+    CylinderBalance::Result result;
+    TEST_ASSERT_TRUE(balance.analyse(&result));
+    // Mean speed is a little lower with one weak cylinder
+    TEST_ASSERT_FLOAT_WITHIN(50.0f, 3000.0f, result.rpm);
+    TEST_ASSERT_EQUAL(0, slowestSector(result, 3));
+}
+
+// Test that teeth that do not divide into sectors are rejected
+void test_invalid_settings(void) {
+    const CylinderBalance::Settings uneven = {35, 3, false};
+    CylinderBalance balance(uneven);
+    TEST_ASSERT_FALSE(balance.isValid());
+    const uint32_t intervals[] = {1000, 1000, 1000};
+    balance.addIntervals(intervals, 3);
+    CylinderBalance::Result result;
+    TEST_ASSERT_FALSE(balance.analyse(&result));
+    
+    const CylinderBalance::Settings too_many = {200, 4, true};
+    balance.setSettings(too_many);
+    TEST_ASSERT_FALSE(balance.isValid());
+    balance.setSettings(FOUR_CYLINDER);
+    TEST_ASSERT_TRUE(balance.isValid());
+}
+
+// Test that the ring hands over full buffers of consecutive intervals
+void test_ring_double_buffers(void) {
+    static ToothIntervalRing ring;
+    const size_t size = ToothIntervalRing::BUFFER_SIZE;
+    uint32_t now = 0xFFFFFF00u;   // Across the clock wrap
+    ring.recordEdge(now);
+    for (size_t i = 0; i < size - 1; i++) {
+        now += 100 + i % 3;
+        ring.recordEdge(now);
+    }
+    TEST_ASSERT_NULL(ring.takeFull());
+    now += 100;
+    ring.recordEdge(now);
+    
+    const uint32_t* full = ring.takeFull();
+    TEST_ASSERT_NOT_NULL(full);
+    TEST_ASSERT_EQUAL_UINT32(100, full[0]);
+    TEST_ASSERT_EQUAL_UINT32(101, full[1]);
+    TEST_ASSERT_EQUAL_UINT32(100, full[size - 1]);
+    
+    // The ISR fills the other buffer meanwhile
+    for (size_t i = 0; i < 10; i++) {
+        now += 200;
+        ring.recordEdge(now);
+    }
+    ring.release();
+    TEST_ASSERT_NULL(ring.takeFull());
+    for (size_t i = 10; i < size; i++) {
+        now += 200;
+        ring.recordEdge(now);
+    }
+    full = ring.takeFull();
+    TEST_ASSERT_NOT_NULL(full);
+    TEST_ASSERT_EQUAL_UINT32(200, full[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.getOverruns());
+}
+
+// Test that a slow consumer costs a buffer, not a corrupt one
+void test_ring_overrun(void) {
+    static ToothIntervalRing ring;
+    const size_t size = ToothIntervalRing::BUFFER_SIZE;
+    uint32_t now = 0;
+    ring.recordEdge(now);
+    for (size_t i = 0; i < size; i++) {
+        now += 100;
+        ring.recordEdge(now);
+    }
+    const uint32_t* held = ring.takeFull();
+    TEST_ASSERT_NOT_NULL(held);
+    
+    // A whole buffer arrives while the first is still held
+    for (size_t i = 0; i < size; i++) {
+        now += 300;
+        ring.recordEdge(now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, ring.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(100, held[size - 1]);
+    ring.release();
+    
+    for (size_t i = 0; i < size; i++) {
+        now += 400;
+        ring.recordEdge(now);
+    }
+    const uint32_t* next = ring.takeFull();
+    TEST_ASSERT_NOT_NULL(next);
+    TEST_ASSERT_EQUAL_UINT32(400, next[0]);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_balanced_engine);
+    RUN_TEST(test_misfire_located);
+    RUN_TEST(test_roughness_tracks_severity);
+    RUN_TEST(test_jitter_averaged_out);
+    RUN_TEST(test_sectors_follow_sync);
+    RUN_TEST(test_long_interval_resyncs);
+    RUN_TEST(test_resync_discards_old_cycles);
+    RUN_TEST(test_two_stroke);
+    RUN_TEST(test_invalid_settings);
+    RUN_TEST(test_ring_double_buffers);
+    RUN_TEST(test_ring_overrun);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,255 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "deferred_log.h"
+#include "log_events.h"
+
+// Host-runnable tests for the deferred binary log and its decoder. Dumps
+// downloaded from the device are printed with scripts/deferred_log_decode.py
+
+using namespace BoatEngine;
+
+// Shared by the tests that leave it empty; the others use their own
+static DeferredLog log_ring;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that records come back in order with their arguments
+void test_write_and_read_in_order(void) {
+    DeferredLog* log = new DeferredLog();
+    TEST_ASSERT_TRUE(log->write(100, LogEvent::HEAP, 150000u, 120000u, 65536u));
+    TEST_ASSERT_TRUE(log->write(200, LogEvent::SCHEDULER_TICKS, 1000, 350, 3));
+    
+    DeferredLog::Record record;
+    TEST_ASSERT_TRUE(log->pop(record));
+    TEST_ASSERT_EQUAL_UINT32(100, record.time_us);
+    TEST_ASSERT_EQUAL(static_cast<uint16_t>(LogEvent::HEAP), record.event);
+    TEST_ASSERT_EQUAL(3, record.arg_count);
+    TEST_ASSERT_EQUAL_UINT32(150000, record.args[0]);
+    TEST_ASSERT_EQUAL_UINT32(65536, record.args[2]);
+    
+    TEST_ASSERT_TRUE(log->pop(record));
+    TEST_ASSERT_EQUAL_UINT32(200, record.time_us);
+    TEST_ASSERT_EQUAL_UINT32(350, record.args[1]);
+    TEST_ASSERT_FALSE(log->pop(record));
+    delete log;
+}
+
+// Test that a full ring drops new records, counts them and never blocks
+void test_full_ring_drops_newest(void) {
+    DeferredLog* log = new DeferredLog();
+    for (size_t i = 0; i < DeferredLog::CAPACITY; i++) {
+        TEST_ASSERT_TRUE(log->write(static_cast<uint32_t>(i), LogEvent::HEAP, i));
+    }
+    TEST_ASSERT_FALSE(log->write(999, LogEvent::HEAP, 999));
+    TEST_ASSERT_FALSE(log->write(999, LogEvent::HEAP, 999));
+    TEST_ASSERT_EQUAL_UINT32(2, log->getDropped());
+    
+    // Reading one frees one slot
+    DeferredLog::Record record;
+    TEST_ASSERT_TRUE(log->pop(record));
+    TEST_ASSERT_EQUAL_UINT32(0, record.time_us);
+    TEST_ASSERT_TRUE(log->write(1000, LogEvent::HEAP, 1000));
+    TEST_ASSERT_FALSE(log->write(1001, LogEvent::HEAP, 1001));
+    
+    size_t count = 0;
+    uint32_t last = 0;
+    while (log->pop(record)) {
+        last = record.time_us;
+        count++;
+    }
+    TEST_ASSERT_EQUAL(DeferredLog::CAPACITY, count);
+    TEST_ASSERT_EQUAL_UINT32(1000, last);
+    TEST_ASSERT_EQUAL_UINT32(3, log->getDropped());
+    delete log;
+}
+
+// Test many laps of the ring with the reader a little behind
+void test_many_laps(void) {
+    DeferredLog::Record record;
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < 100000; i++) {
+        TEST_ASSERT_TRUE(log_ring.write(i, LogEvent::SCHEDULER_TICKS, i, i * 2, i * 3));
+        if (i % 7 == 6) {
+            while (log_ring.pop(record)) {
+                TEST_ASSERT_EQUAL_UINT32(expected, record.time_us);
+                TEST_ASSERT_EQUAL_UINT32(expected * 3, record.args[2]);
+                expected++;
+            }
+        }
+    }
+    while (log_ring.pop(record)) {
+        expected++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(100000, expected);
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring.getDropped());
+}
+
+// Test that records read back as the text ESP_LOG would have printed
+void test_format(void) {
+    DeferredLog* log = new DeferredLog();
+    const uint8_t status = 2;
+    log->write(12345678, LogEvent::CYLINDER_BALANCE, 40u, 1800.4f, 0.0125f, 0u);
+    log->write(3000001, LogEvent::TEMPERATURE_INVALID, 0x28ff641eu, 0x0316a2c1u, status,
+               -127.0);
+    
+    DeferredLog::Record record;
+    char text[128];
+    log->pop(record);
+    DeferredLog::format(record, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING(
+        "[  12.345678] CylinderBalanceManager: 40 cycles at 1800 rpm, roughness 0.0125, "
+        "0 overruns", text);
+    
+    log->pop(record);
+    DeferredLog::format(record, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING(
+        "[   3.000001] OneWireTemperatureChannel: Sensor 28ff641e0316a2c1 invalid "
+        "(status 2, -127.00 C)", text);
+    
+    // Negative integers survive the 32-bit words
+    record.event = static_cast<uint16_t>(LogEvent::SCHEDULER_TICKS);
+    record.arg_count = 3;
+    record.args[0] = static_cast<uint32_t>(-5);
+    DeferredLog::format(record, text, sizeof(text));
+    TEST_ASSERT_NOT_NULL(strstr(text, "4294967291 ticks"));
+    
+    // Truncated to the buffer, always terminated
+    const size_t length = DeferredLog::format(record, text, 20);
+    TEST_ASSERT_EQUAL(19, length);
+    TEST_ASSERT_EQUAL(19, strlen(text));
+    delete log;
+}
+
+// Test that unknown events and missing arguments are shown
+void test_format_unknown_and_short(void) {
+    DeferredLog::Record record;
+    record.time_us = 0;
+    record.event = 999;
+    record.arg_count = 2;
+    record.args[0] = 1;
+    record.args[1] = 0xdeadbeef;
+    char text[128];
+    DeferredLog::format(record, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("[   0.000000] Unknown event 999 00000001 deadbeef", text);
+    
+    record.event = static_cast<uint16_t>(LogEvent::HEAP);
+    record.arg_count = 1;
+    record.args[0] = 150000;
+    DeferredLog::format(record, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING(
+        "[   0.000000] MemoryMonitor: Heap free 150000, minimum ?, largest block ?", text);
+}
+
+// Test the wire form round trip
+void test_wire_form(void) {
+    DeferredLog* log = new DeferredLog();
+    log->write(1, LogEvent::HEAP, 1u, 2u, 3u);
+    log->write(2, LogEvent::CYLINDER_BALANCE, 10u, 900.0f, 0.5f, 7u);
+    log->write(3, LogEvent::HEAP);
+    for (size_t i = 0; i < DeferredLog::CAPACITY; i++) {
+        log->write(4, LogEvent::HEAP);
+    }
+    
+    uint8_t data[DeferredLog::HEADER_SIZE + 3 * DeferredLog::MAX_RECORD_SIZE];
+    size_t size = log->writeHeader(data, sizeof(data));
+    TEST_ASSERT_EQUAL(DeferredLog::HEADER_SIZE, size);
+    TEST_ASSERT_EQUAL(0, log->writeHeader(data, DeferredLog::HEADER_SIZE - 1));
+    DeferredLog::Record record;
+    for (int i = 0; i < 3; i++) {
+        log->pop(record);
+        size += DeferredLog::encode(record, &data[size], sizeof(data) - size);
+    }
+    // Header, then timestamp, event and count plus 4 bytes per argument
+    TEST_ASSERT_EQUAL(9 + (7 + 12) + (7 + 16) + 7, size);
+    
+    uint32_t dropped = 0;
+    size_t offset = DeferredLog::readHeader(data, size, dropped);
+    TEST_ASSERT_EQUAL(DeferredLog::HEADER_SIZE, offset);
+    TEST_ASSERT_EQUAL_UINT32(3, dropped);
+    offset += DeferredLog::decode(&data[offset], size - offset, record);
+    TEST_ASSERT_EQUAL_UINT32(3, record.args[2]);
+    offset += DeferredLog::decode(&data[offset], size - offset, record);
+    float rpm;
+    memcpy(&rpm, &record.args[1], sizeof(rpm));
+    TEST_ASSERT_EQUAL_FLOAT(900.0f, rpm);
+    TEST_ASSERT_EQUAL(0, DeferredLog::decode(&data[offset], 6, record));
+    offset += DeferredLog::decode(&data[offset], size - offset, record);
+    TEST_ASSERT_EQUAL(0, record.arg_count);
+    TEST_ASSERT_EQUAL(size, offset);
+    
+    data[0] = 'X';
+    TEST_ASSERT_EQUAL(0, DeferredLog::readHeader(data, size, dropped));
+    delete log;
+}
+
+// Compare the cost of a deferred record with formatting the text in place
+void test_write_cost(void) {
+    const unsigned iterations = 200000;
+    DeferredLog::Record record;
+    char text[128];
+    
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        log_ring.write(i, LogEvent::CYLINDER_BALANCE, i, 1800.0f, 0.0125f, 0u);
+        log_ring.pop(record);
+    }
+    const double write_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / iterations;
+    
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        snprintf(text, sizeof(text),
+                 "CylinderBalanceManager: %u cycles at %.0f rpm, roughness %.4f, %u overruns",
+                 i, 1800.0, 0.0125, 0u);
+    }
+    const double format_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / iterations;
+    
+    char message[128];
+    snprintf(message, sizeof(message),
+             "deferred record %.1f ns, formatting alone %.1f ns (before any UART wait)",
+             write_ns, format_ns);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring.getDropped());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_write_and_read_in_order);
+    RUN_TEST(test_full_ring_drops_newest);
+    RUN_TEST(test_many_laps);
+    RUN_TEST(test_format);
+    RUN_TEST(test_format_unknown_and_short);
+    RUN_TEST(test_wire_form);
+    RUN_TEST(test_write_cost);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,111 @@
+#include <unity.h>
+
+#include <cmath>
+#include <string>
+
+#include "live_frame.h"
+
+// Host-runnable tests for the live gauge event frame
+
+using namespace BoatEngine;
+
+static std::string text(const LiveFrame& frame) {
+    return std::string(frame.data(), frame.size());
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+void test_empty_frame() {
+    LiveFrame frame;
+    TEST_ASSERT_EQUAL(0, frame.getFieldCount());
+    TEST_ASSERT_EQUAL_STRING("data: \n\n", text(frame).c_str());
+}
+
+void test_fields_start_unknown() {
+    LiveFrame frame;
+    TEST_ASSERT_EQUAL(0, frame.addField(0));
+    TEST_ASSERT_EQUAL(1, frame.addField(1));
+    TEST_ASSERT_EQUAL_STRING("data:        -,       -\n\n", text(frame).c_str());
+}
+
+void test_set_rewrites_slot() {
+    LiveFrame frame;
+    frame.addField(0);     // RPM
+    frame.addField(1);     // Coolant C
+    const size_t size = frame.size();
+    
+    frame.set(0, 1834.4f);
+    frame.set(1, 82.46f);
+    TEST_ASSERT_EQUAL_STRING("data:     1834,    82.5\n\n", text(frame).c_str());
+    
+    frame.set(0, 650.0f);
+    TEST_ASSERT_EQUAL_STRING("data:      650,    82.5\n\n", text(frame).c_str());
+    frame.set(1, -3.0f);
+    TEST_ASSERT_EQUAL_STRING("data:      650,    -3.0\n\n", text(frame).c_str());
+    TEST_ASSERT_EQUAL(size, frame.size());
+    
+    // Out of range index is ignored
+    frame.set(2, 1.0f);
+    TEST_ASSERT_EQUAL_STRING("data:      650,    -3.0\n\n", text(frame).c_str());
+}
+
+void test_unrepresentable_values() {
+    LiveFrame frame;
+    frame.addField(2);
+    frame.set(0, NAN);
+    TEST_ASSERT_EQUAL_STRING("data:        -\n\n", text(frame).c_str());
+    frame.set(0, 12345.678f);            // Needs 8 characters: fits
+    TEST_ASSERT_EQUAL_STRING("data: 12345.68\n\n", text(frame).c_str());
+    frame.set(0, 123456.78f);            // Too wide for the slot
+    TEST_ASSERT_EQUAL_STRING("data:        -\n\n", text(frame).c_str());
+    frame.set(0, INFINITY);
+    TEST_ASSERT_EQUAL_STRING("data:        -\n\n", text(frame).c_str());
+}
+
+void test_field_limit() {
+    LiveFrame frame;
+    for (size_t i = 0; i < LiveFrame::MAX_FIELDS; i++) {
+        TEST_ASSERT_EQUAL(static_cast<int>(i), frame.addField(1));
+        frame.set(i, -999.9f);
+    }
+    TEST_ASSERT_EQUAL(-1, frame.addField(1));
+    TEST_ASSERT_EQUAL(LiveFrame::MAX_SIZE, frame.size());
+    const std::string frame_text = text(frame);
+    TEST_ASSERT_EQUAL(0, frame_text.compare(0, 15, "data:   -999.9,"));
+    TEST_ASSERT_EQUAL(0, frame_text.compare(frame_text.size() - 10, 10, "  -999.9\n\n"));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_empty_frame);
+    RUN_TEST(test_fields_start_unknown);
+    RUN_TEST(test_set_rewrites_slot);
+    RUN_TEST(test_unrepresentable_values);
+    RUN_TEST(test_field_limit);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,223 @@
+#include <unity.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "duration_histogram.h"
+#include "load_profile.h"
+
+// Host-runnable tests for the time-at-RPM and time-at-temperature
+// histograms and their saved and CSV forms
+
+using namespace BoatEngine;
+
+// 500 .. 4000 rpm in 250 rpm bands
+static const DurationHistogram::Layout RPM_LAYOUT = {500.0f, 250.0f, 14};
+// 20 .. 120 C in 5 C bands
+static const DurationHistogram::Layout COOLANT_LAYOUT = {20.0f, 5.0f, 20};
+static const uint32_t MAX_GAP_MS = 30000;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that values land in the right bins, below and above included
+void test_bins(void) {
+    DurationHistogram histogram(RPM_LAYOUT, MAX_GAP_MS);
+    TEST_ASSERT_EQUAL(16, histogram.getBinCount());
+    TEST_ASSERT_EQUAL(0, histogram.binFor(0.0f));
+    TEST_ASSERT_EQUAL(0, histogram.binFor(499.9f));
+    TEST_ASSERT_EQUAL(1, histogram.binFor(500.0f));
+    TEST_ASSERT_EQUAL(7, histogram.binFor(2000.0f));
+    TEST_ASSERT_EQUAL(14, histogram.binFor(3999.0f));
+    TEST_ASSERT_EQUAL(15, histogram.binFor(4000.0f));
+    TEST_ASSERT_EQUAL(15, histogram.binFor(INFINITY));
+    
+    TEST_ASSERT_TRUE(std::isinf(histogram.getBinLower(0)));
+    TEST_ASSERT_EQUAL_FLOAT(500.0f, histogram.getBinUpper(0));
+    TEST_ASSERT_EQUAL_FLOAT(2000.0f, histogram.getBinLower(7));
+    TEST_ASSERT_EQUAL_FLOAT(2250.0f, histogram.getBinUpper(7));
+    TEST_ASSERT_TRUE(std::isinf(histogram.getBinUpper(15)));
+}
+
+// Test that each interval goes to the value held during it
+void test_time_attributed_to_held_value(void) {
+    DurationHistogram histogram(RPM_LAYOUT, MAX_GAP_MS);
+    uint32_t now = 0xFFFFF000u;   // Across the millisecond clock wrap
+    
+    // Idle for a minute, then cruise for an hour, at 500 ms reads
+    for (int i = 0; i < 120; i++, now += 500) {
+        histogram.update(750.0f, now);
+    }
+    for (int i = 0; i < 7200; i++, now += 500) {
+        histogram.update(2100.0f, now);
+    }
+    histogram.update(0.0f, now);
+    
+    TEST_ASSERT_EQUAL_UINT32(60, histogram.getSeconds(histogram.binFor(750.0f)));
+    TEST_ASSERT_EQUAL_UINT32(3600, histogram.getSeconds(histogram.binFor(2100.0f)));
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getSeconds(0));
+    TEST_ASSERT_TRUE(histogram.getTotalMs() == 3660000u);
+}
+
+// Test that gaps and invalid readings are not counted
+void test_gaps_and_nan_skipped(void) {
+    DurationHistogram histogram(COOLANT_LAYOUT, MAX_GAP_MS);
+    histogram.update(80.0f, 0);
+    histogram.update(80.0f, 10000);
+    // Device off for an hour
+    histogram.update(80.0f, 3610000);
+    histogram.update(80.0f, 3620000);
+    TEST_ASSERT_EQUAL_UINT32(20, histogram.getSeconds(histogram.binFor(80.0f)));
+    
+    // The time after a failed read is unknown
+    histogram.update(NAN, 3630000);
+    histogram.update(90.0f, 3640000);
+    histogram.update(90.0f, 3650000);
+    TEST_ASSERT_EQUAL_UINT32(30, histogram.getSeconds(histogram.binFor(80.0f)));
+    TEST_ASSERT_EQUAL_UINT32(10, histogram.getSeconds(histogram.binFor(90.0f)));
+}
+
+// Test that memory does not grow: totals only, however long it runs
+void test_constant_memory(void) {
+    DurationHistogram histogram(RPM_LAYOUT, MAX_GAP_MS);
+    const size_t size = sizeof(histogram);
+    uint32_t now = 0;
+    // Ten thousand hours at one read every 10 s, sweeping every band
+    for (uint32_t i = 0; i < 3600000u; i++, now += 10000) {
+        histogram.update(static_cast<float>(250 + i % 4000), now);
+    }
+    TEST_ASSERT_EQUAL(size, sizeof(histogram));
+    TEST_ASSERT_TRUE(histogram.getTotalMs() == 35999990000ull);
+}
+
+static void fillProfile(LoadProfile& profile) {
+    TEST_ASSERT_EQUAL(0, profile.add("rpm", RPM_LAYOUT, MAX_GAP_MS));
+    TEST_ASSERT_EQUAL(1, profile.add("coolantTemperature", COOLANT_LAYOUT, MAX_GAP_MS));
+    for (uint32_t now = 0; now <= 7200000; now += 1000) {
+        profile.get(0).update(now < 3600000 ? 1800.0f : 2600.0f, now);
+        profile.get(1).update(now < 600000 ? 40.0f : 82.0f, now);
+    }
+}
+
+// Test that saved totals come back after a restart
+void test_save_and_restore(void) {
+    LoadProfile saved;
+    fillProfile(saved);
+    uint8_t buffer[512];
+    const size_t size = saved.serialize(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(saved.serializedSize(), size);
+    // Header, then name, layout and 4 bytes per bin for each
+    TEST_ASSERT_EQUAL(6 + (1 + 3 + 9 + 16 * 4) + (1 + 18 + 9 + 22 * 4), size);
+    TEST_ASSERT_EQUAL(0, saved.serialize(buffer, size - 1));
+    
+    LoadProfile restored;
+    restored.add("rpm", RPM_LAYOUT, MAX_GAP_MS);
+    restored.add("coolantTemperature", COOLANT_LAYOUT, MAX_GAP_MS);
+    TEST_ASSERT_EQUAL(2, restored.restore(buffer, size));
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t bin = 0; bin < saved.get(i).getBinCount(); bin++) {
+            TEST_ASSERT_EQUAL_UINT32(saved.get(i).getSeconds(bin), restored.get(i).getSeconds(bin));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(3600, restored.get(0).getSeconds(restored.get(0).binFor(1800.0f)));
+    TEST_ASSERT_FALSE(restored.hasChanged());
+    
+    // Counting carries on from the restored totals
+    restored.get(0).update(1800.0f, 0);
+    restored.get(0).update(1800.0f, 2000);
+    TEST_ASSERT_TRUE(restored.hasChanged());
+    TEST_ASSERT_EQUAL_UINT32(3602, restored.get(0).getSeconds(restored.get(0).binFor(1800.0f)));
+    restored.markSaved();
+    TEST_ASSERT_FALSE(restored.hasChanged());
+}
+
+// Test that a changed layout restarts only that histogram
+void test_restore_layout_change(void) {
+    LoadProfile saved;
+    fillProfile(saved);
+    uint8_t buffer[512];
+    const size_t size = saved.serialize(buffer, sizeof(buffer));
+    
+    const DurationHistogram::Layout finer = {500.0f, 100.0f, 32};
+    LoadProfile restored;
+    restored.add("coolantTemperature", COOLANT_LAYOUT, MAX_GAP_MS);
+    restored.add("rpm", finer, MAX_GAP_MS);
+    TEST_ASSERT_EQUAL(1, restored.restore(buffer, size));
+    TEST_ASSERT_TRUE(restored.get(0).getTotalMs() == 7200000u);
+    TEST_ASSERT_TRUE(restored.get(1).getTotalMs() == 0u);
+    
+    // Truncated or foreign data restores nothing it cannot read
+    LoadProfile other;
+    other.add("rpm", RPM_LAYOUT, MAX_GAP_MS);
+    TEST_ASSERT_EQUAL(1, other.restore(buffer, 6 + 1 + 3 + 9 + 16 * 4));
+    TEST_ASSERT_EQUAL(0, other.restore(buffer, 6 + 1 + 3 + 9 + 16 * 4 - 1));
+    buffer[0] = 'X';
+    TEST_ASSERT_EQUAL(0, other.restore(buffer, size));
+}
+
+// Test the CSV rows
+void test_csv(void) {
+    LoadProfile profile;
+    fillProfile(profile);
+    TEST_ASSERT_EQUAL_STRING("histogram,from,to,seconds\n", LoadProfile::csvHeader());
+    
+    char row[64];
+    profile.formatCsvRow(0, 0, row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("rpm,,500,0\n", row);
+    profile.formatCsvRow(0, profile.get(0).binFor(1800.0f), row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("rpm,1750,2000,3600\n", row);
+    profile.formatCsvRow(1, 21, row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("coolantTemperature,120,,0\n", row);
+    profile.formatCsvRow(1, profile.get(1).binFor(82.0f), row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("coolantTemperature,80,85,6600\n", row);
+}
+
+// Test that invalid layouts and too many histograms are refused
+void test_limits(void) {
+    LoadProfile profile;
+    const DurationHistogram::Layout no_width = {0.0f, 0.0f, 4};
+    const DurationHistogram::Layout too_many = {0.0f, 1.0f, 33};
+    TEST_ASSERT_EQUAL(-1, profile.add("a", no_width, MAX_GAP_MS));
+    TEST_ASSERT_EQUAL(-1, profile.add("a", too_many, MAX_GAP_MS));
+    for (size_t i = 0; i < LoadProfile::MAX_HISTOGRAMS; i++) {
+        TEST_ASSERT_EQUAL(static_cast<int>(i), profile.add("a", RPM_LAYOUT, MAX_GAP_MS));
+    }
+    TEST_ASSERT_EQUAL(-1, profile.add("a", RPM_LAYOUT, MAX_GAP_MS));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_bins);
+    RUN_TEST(test_time_attributed_to_held_value);
+    RUN_TEST(test_gaps_and_nan_skipped);
+    RUN_TEST(test_constant_memory);
+    RUN_TEST(test_save_and_restore);
+    RUN_TEST(test_restore_layout_change);
+    RUN_TEST(test_csv);
+    RUN_TEST(test_limits);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,300 @@
+#include <unity.h>
+
+#include "ds18b20_bus.h"
+#include "onewire_address.h"
+#include "onewire_codec.h"
+#include "simulated_onewire_bus.h"
+
+// Host-runnable tests for the asynchronous OneWire stack: slot encoding,
+// the DS18B20 protocol and device discovery, run against a bit-level
+// simulated bus
+
+using namespace BoatEngine;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Run the bus until idle, advancing simulated time in small steps
+static uint32_t runUntilIdle(Ds18b20Bus& bus, SimulatedOneWireBus& sim) {
+    uint32_t polls = 0;
+    while (!bus.isIdle() && polls < 100000) {
+        sim.advance(100);
+        bus.service();
+        polls++;
+    }
+    return polls;
+}
+
+// Test the CRC-8 against the Maxim application note example ROM
+void test_crc8(void) {
+    const uint8_t rom[8] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2};
+    TEST_ASSERT_EQUAL_HEX8(0xA2, oneWireCrc8(rom, 7));
+    TEST_ASSERT_EQUAL_HEX8(0x00, oneWireCrc8(rom, 8));
+}
+
+// Test address formatting and parsing round trip
+void test_address_text(void) {
+    OneWireAddress address = {{0x28, 0xff, 0x64, 0x1e, 0x8d, 0x16, 0x04, 0x3c}};
+    char text[ONEWIRE_ADDRESS_STRING_SIZE];
+    formatOneWireAddress(address, text);
+    TEST_ASSERT_EQUAL_STRING("28:ff:64:1e:8d:16:04:3c", text);
+    
+    OneWireAddress parsed;
+    TEST_ASSERT_TRUE(parseOneWireAddress(text, &parsed));
+    TEST_ASSERT_TRUE(parsed == address);
+    TEST_ASSERT_FALSE(parseOneWireAddress("28:ff:64", &parsed));
+    TEST_ASSERT_FALSE(parseOneWireAddress("28-ff-64-1e-8d-16-04-3c", &parsed));
+}
+
+// Test that slots encode to standard timings and decode back
+void test_codec_round_trip(void) {
+    const uint8_t tx = 0xA5;
+    OneWireSymbol symbols[9];
+    TEST_ASSERT_EQUAL_size_t(9, OneWireCodec::encode(true, &tx, 8, symbols));
+    TEST_ASSERT_EQUAL_UINT16(OneWireCodec::RESET_LOW_US, symbols[0].low_us);
+    TEST_ASSERT_EQUAL_UINT16(OneWireCodec::WRITE_1_LOW_US, symbols[1].low_us);
+    TEST_ASSERT_EQUAL_UINT16(OneWireCodec::WRITE_0_LOW_US, symbols[2].low_us);
+    
+    // Capture with a presence pulse: reset, presence, then the 8 slots
+    uint16_t lows[10] = {480, 120};
+    for (size_t i = 0; i < 8; i++) {
+        lows[2 + i] = symbols[1 + i].low_us;
+    }
+    bool presence;
+    uint8_t rx;
+    TEST_ASSERT_TRUE(OneWireCodec::decode(lows, 10, true, 8, &presence, &rx) ==
+                     OneWireCodec::Decode::OK);
+    TEST_ASSERT_TRUE(presence);
+    TEST_ASSERT_EQUAL_HEX8(tx, rx);
+    
+    // Without presence the capture is one low shorter
+    TEST_ASSERT_TRUE(OneWireCodec::decode(&lows[1], 9, true, 8, &presence, &rx) ==
+                     OneWireCodec::Decode::FRAMING_ERROR);
+    lows[1] = 480;
+    TEST_ASSERT_TRUE(OneWireCodec::decode(&lows[1], 9, true, 8, &presence, &rx) ==
+                     OneWireCodec::Decode::OK);
+    TEST_ASSERT_FALSE(presence);
+    
+    // A slot held low for a reset's length means the line is stuck
+    lows[5] = 600;
+    TEST_ASSERT_TRUE(OneWireCodec::decode(&lows[1], 9, true, 8, &presence, &rx) ==
+                     OneWireCodec::Decode::FRAMING_ERROR);
+}
+
+// Test that the ROM search finds every device on the bus
+void test_search_finds_all_devices(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x000001B81C02ull);
+    sim.addDevice(0x0000A5A5A5A5ull);
+    sim.addDevice(0x0000A5A5A5A4ull);  // Differs only in the first serial bit
+    sim.addDevice(0xFFFFFFFFFFFFull);
+    
+    Ds18b20Bus bus(&sim);
+    TEST_ASSERT_TRUE(bus.begin());
+    TEST_ASSERT_EQUAL_size_t(4, bus.getDeviceCount());
+    
+    for (size_t d = 0; d < sim.getDeviceCount(); d++) {
+        bool seen = false;
+        for (size_t i = 0; i < bus.getDeviceCount(); i++) {
+            seen = seen || bus.getDeviceAddress(i) == sim.getAddress(d);
+        }
+        TEST_ASSERT_TRUE(seen);
+    }
+}
+
+// Test that an empty bus reports no devices
+void test_search_empty_bus(void) {
+    SimulatedOneWireBus sim;
+    Ds18b20Bus bus(&sim);
+    TEST_ASSERT_FALSE(bus.begin());
+    TEST_ASSERT_EQUAL_size_t(0, bus.getDeviceCount());
+}
+
+// Test a conversion and reads, completing only as bus time passes
+void test_convert_and_read(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x111111111111ull);
+    sim.addDevice(0x222222222222ull);
+    Ds18b20Bus bus(&sim);
+    TEST_ASSERT_TRUE(bus.begin());
+    sim.setTemperature(0, 82.5f);
+    sim.setTemperature(1, -10.125f);
+    
+    TEST_ASSERT_TRUE(bus.startConversion());
+    bus.service();
+    TEST_ASSERT_FALSE(bus.isIdle());  // Nothing completes without bus time
+    runUntilIdle(bus, sim);
+    
+    TEST_ASSERT_TRUE(bus.requestRead(sim.getAddress(0), 7));
+    TEST_ASSERT_TRUE(bus.requestRead(sim.getAddress(1), 3));
+    TemperatureReading reading;
+    TEST_ASSERT_FALSE(bus.takeReading(&reading));
+    runUntilIdle(bus, sim);
+    
+    TEST_ASSERT_TRUE(bus.takeReading(&reading));
+    TEST_ASSERT_EQUAL_UINT8(7, reading.tag);
+    TEST_ASSERT_TRUE(reading.status == TemperatureReadStatus::OK);
+    TEST_ASSERT_EQUAL_FLOAT(82.5f, reading.celsius);
+    
+    TEST_ASSERT_TRUE(bus.takeReading(&reading));
+    TEST_ASSERT_EQUAL_UINT8(3, reading.tag);
+    TEST_ASSERT_EQUAL_FLOAT(-10.125f, reading.celsius);
+    TEST_ASSERT_FALSE(bus.takeReading(&reading));
+}
+
+// Test that a full bus queues a conversion plus a read and a retry per device
+void test_queue_depth(void) {
+    SimulatedOneWireBus sim;
+    for (uint64_t i = 1; i <= TemperatureBus::MAX_DEVICES; i++) {
+        sim.addDevice(0x100000000000ull * i);
+    }
+    Ds18b20Bus bus(&sim);
+    TEST_ASSERT_TRUE(bus.begin());
+    TEST_ASSERT_EQUAL_size_t(TemperatureBus::MAX_DEVICES, bus.getDeviceCount());
+    
+    TEST_ASSERT_TRUE(bus.startConversion());
+    for (size_t i = 0; i < 2 * TemperatureBus::MAX_DEVICES; i++) {
+        TEST_ASSERT_TRUE(bus.requestRead(bus.getDeviceAddress(i % bus.getDeviceCount()),
+                                         static_cast<uint8_t>(i)));
+    }
+    TEST_ASSERT_FALSE(bus.requestRead(bus.getDeviceAddress(0), 99));
+    TEST_ASSERT_FALSE(bus.startConversion());
+}
+
+// Test that a read before any conversion returns the 85 C power-on value
+void test_power_on_value(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x333333333333ull);
+    Ds18b20Bus bus(&sim);
+    bus.begin();
+    
+    bus.requestRead(sim.getAddress(0), 0);
+    runUntilIdle(bus, sim);
+    TemperatureReading reading;
+    TEST_ASSERT_TRUE(bus.takeReading(&reading));
+    TEST_ASSERT_EQUAL_FLOAT(85.0f, reading.celsius);
+}
+
+// Test reads of devices that are not there
+void test_missing_device(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x444444444444ull);
+    Ds18b20Bus bus(&sim);
+    bus.begin();
+    
+    // Another device answers the reset, but nobody sends a scratchpad
+    OneWireAddress absent = sim.getAddress(0);
+    absent[3] ^= 0x01;
+    bus.requestRead(absent, 1);
+    runUntilIdle(bus, sim);
+    TemperatureReading reading;
+    TEST_ASSERT_TRUE(bus.takeReading(&reading));
+    TEST_ASSERT_TRUE(reading.status == TemperatureReadStatus::BUS_ERROR);
+    
+    // Nobody on the bus at all
+    SimulatedOneWireBus empty_sim;
+    Ds18b20Bus empty_bus(&empty_sim);
+    empty_bus.requestRead(absent, 2);
+    runUntilIdle(empty_bus, empty_sim);
+    TEST_ASSERT_TRUE(empty_bus.takeReading(&reading));
+    TEST_ASSERT_TRUE(reading.status == TemperatureReadStatus::NO_DEVICE);
+}
+
+// Test that a corrupted scratchpad fails the CRC
+void test_scratchpad_crc(void) {
+    uint8_t scratchpad[9] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0};
+    scratchpad[8] = oneWireCrc8(scratchpad, 8);
+    float celsius = 0.0f;
+    TEST_ASSERT_TRUE(decodeDs18b20Scratchpad(scratchpad, &celsius) ==
+                     TemperatureReadStatus::OK);
+    TEST_ASSERT_EQUAL_FLOAT(85.0f, celsius);
+    
+    scratchpad[0] ^= 0x04;
+    TEST_ASSERT_TRUE(decodeDs18b20Scratchpad(scratchpad, &celsius) ==
+                     TemperatureReadStatus::CRC_ERROR);
+    
+    // All zeros passes the CRC but is a shorted line
+    uint8_t zeros[9] = {0};
+    TEST_ASSERT_TRUE(decodeDs18b20Scratchpad(zeros, &celsius) ==
+                     TemperatureReadStatus::BUS_ERROR);
+}
+
+// Test that addresses are claimed once and configured ones are registered
+void test_address_assignment(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x555555555555ull);
+    sim.addDevice(0x666666666666ull);
+    Ds18b20Bus bus(&sim);
+    bus.begin();
+    
+    // A configured sensor registers first; the next unconfigured one
+    // must get the other device
+    TEST_ASSERT_TRUE(bus.registerAddress(sim.getAddress(1)));
+    OneWireAddress claimed;
+    TEST_ASSERT_TRUE(bus.claimNextAddress(&claimed));
+    TEST_ASSERT_TRUE(claimed == sim.getAddress(0));
+    TEST_ASSERT_FALSE(bus.claimNextAddress(&claimed));
+    
+    OneWireAddress unknown = {{0x28, 1, 2, 3, 4, 5, 6, 7}};
+    TEST_ASSERT_FALSE(bus.registerAddress(unknown));
+}
+
+// Test bus occupancy of one read: command plus scratchpad slots
+void test_read_bus_time(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x777777777777ull);
+    Ds18b20Bus bus(&sim);
+    bus.begin();
+    const uint64_t before = sim.getBusyUs();
+    const uint32_t transfers = sim.getTransferCount();
+    
+    bus.requestRead(sim.getAddress(0), 0);
+    runUntilIdle(bus, sim);
+    
+    // Two transfers: reset + 80 command slots, then 72 read slots
+    TEST_ASSERT_EQUAL_UINT32(transfers + 2, sim.getTransferCount());
+    const uint64_t busy = sim.getBusyUs() - before;
+    TEST_ASSERT_GREATER_THAN(960 + 152 * 70 - 1, static_cast<uint32_t>(busy));
+    TEST_ASSERT_LESS_THAN(960 + 152 * 70 + 1, static_cast<uint32_t>(busy));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_crc8);
+    RUN_TEST(test_address_text);
+    RUN_TEST(test_codec_round_trip);
+    RUN_TEST(test_search_finds_all_devices);
+    RUN_TEST(test_search_empty_bus);
+    RUN_TEST(test_convert_and_read);
+    RUN_TEST(test_queue_depth);
+    RUN_TEST(test_power_on_value);
+    RUN_TEST(test_missing_device);
+    RUN_TEST(test_scratchpad_crc);
+    RUN_TEST(test_address_assignment);
+    RUN_TEST(test_read_bus_time);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
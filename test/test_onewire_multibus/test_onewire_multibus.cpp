@@ -0,0 +1,265 @@
+#include <unity.h>
+
+#include <stdio.h>
+
+#include "ds18b20_bus.h"
+#include "simulated_onewire_bus.h"
+#include "temperature_bus_group.h"
+
+// Host-runnable tests and benchmark for acquiring several OneWire buses at
+// once: every bus runs on its own simulated line, advanced in lock-step as
+// the transports would on separate GPIOs
+
+using namespace BoatEngine;
+
+static const uint32_t STEP_US = 100;
+static const uint32_t CONVERSION_US = 750000;  // 12-bit DS18B20
+
+// A set of simulated buses, each with its own devices
+struct SimulatedBuses {
+    SimulatedOneWireBus sims[TemperatureBusGroup::MAX_BUSES];
+    Ds18b20Bus* buses[TemperatureBusGroup::MAX_BUSES];
+    size_t count;
+    
+    explicit SimulatedBuses(const size_t* sensors_per_bus, size_t bus_count)
+        : count(bus_count) {
+        uint64_t serial = 0x100000000000ull;
+        for (size_t b = 0; b < count; b++) {
+            for (size_t d = 0; d < sensors_per_bus[b]; d++) {
+                sims[b].addDevice(serial++);
+                sims[b].setTemperature(d, 20.0f + b * 10 + d);
+            }
+            buses[b] = new Ds18b20Bus(&sims[b]);
+            buses[b]->begin();
+        }
+    }
+    
+    ~SimulatedBuses() {
+        for (size_t b = 0; b < count; b++) {
+            delete buses[b];
+        }
+    }
+    
+    void advance() {
+        for (size_t b = 0; b < count; b++) {
+            sims[b].advance(STEP_US);
+        }
+    }
+};
+
+// Service the group until idle, advancing every line together
+static uint32_t runUntilIdle(TemperatureBusGroup& group, SimulatedBuses& sim) {
+    uint32_t elapsed_us = 0;
+    group.service();
+    while (!group.isIdle() && elapsed_us < 10000000) {
+        sim.advance();
+        elapsed_us += STEP_US;
+        group.service();
+    }
+    return elapsed_us;
+}
+
+// One full cycle as TemperatureSensorManager runs it: convert on every
+// bus, wait for the conversion, then read every sensor on its own bus
+static uint32_t runCycle(TemperatureBusGroup& group, SimulatedBuses& sim,
+                         size_t* readings) {
+    uint32_t elapsed_us = 0;
+    group.startConversions();
+    elapsed_us += runUntilIdle(group, sim);
+    elapsed_us += CONVERSION_US;
+    
+    uint8_t tag = 0;
+    for (size_t b = 0; b < group.getBusCount(); b++) {
+        TemperatureBus* bus = group.getBus(b);
+        for (size_t d = 0; d < bus->getDeviceCount(); d++) {
+            group.requestRead(b, bus->getDeviceAddress(d), tag++);
+        }
+    }
+    elapsed_us += runUntilIdle(group, sim);
+    
+    TemperatureReading reading;
+    size_t bus;
+    *readings = 0;
+    while (group.takeReading(&reading, &bus)) {
+        if (reading.status == TemperatureReadStatus::OK) {
+            (*readings)++;
+        }
+    }
+    return elapsed_us;
+}
+
+// Cycle time for a layout with all buses in one group
+static uint32_t parallelCycle(const size_t* layout, size_t bus_count,
+                              size_t* readings) {
+    SimulatedBuses sim(layout, bus_count);
+    TemperatureBusGroup group;
+    for (size_t b = 0; b < bus_count; b++) {
+        group.addBus(sim.buses[b]);
+    }
+    return runCycle(group, sim, readings);
+}
+
+// Cycle time for the same layout acquired one bus after another
+static uint32_t serialCycle(const size_t* layout, size_t bus_count) {
+    uint32_t elapsed_us = 0;
+    for (size_t b = 0; b < bus_count; b++) {
+        size_t readings;
+        elapsed_us += parallelCycle(&layout[b], 1, &readings);
+    }
+    return elapsed_us;
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that readings come back from every bus with their tags intact
+void test_reads_every_bus(void) {
+    const size_t layout[] = {2, 1};
+    SimulatedBuses sim(layout, 2);
+    TemperatureBusGroup group;
+    TEST_ASSERT_EQUAL_INT(0, group.addBus(sim.buses[0]));
+    TEST_ASSERT_EQUAL_INT(1, group.addBus(sim.buses[1]));
+    
+    TEST_ASSERT_EQUAL_size_t(2, group.startConversions());
+    runUntilIdle(group, sim);
+    TEST_ASSERT_TRUE(group.requestRead(0, sim.sims[0].getAddress(1), 5));
+    TEST_ASSERT_TRUE(group.requestRead(1, sim.sims[1].getAddress(0), 9));
+    TEST_ASSERT_FALSE(group.requestRead(2, sim.sims[1].getAddress(0), 1));
+    runUntilIdle(group, sim);
+    
+    TemperatureReading reading;
+    size_t bus;
+    bool seen[2] = {false, false};
+    while (group.takeReading(&reading, &bus)) {
+        TEST_ASSERT_TRUE(reading.status == TemperatureReadStatus::OK);
+        if (reading.tag == 5) {
+            TEST_ASSERT_EQUAL_size_t(0, bus);
+            TEST_ASSERT_EQUAL_FLOAT(21.0f, reading.celsius);
+            seen[0] = true;
+        } else {
+            TEST_ASSERT_EQUAL_UINT8(9, reading.tag);
+            TEST_ASSERT_EQUAL_size_t(1, bus);
+            TEST_ASSERT_EQUAL_FLOAT(30.0f, reading.celsius);
+            seen[1] = true;
+        }
+    }
+    TEST_ASSERT_TRUE(seen[0] && seen[1]);
+}
+
+// Test that completed readings are taken from the buses in turn
+void test_take_round_robin(void) {
+    const size_t layout[] = {2, 2};
+    SimulatedBuses sim(layout, 2);
+    TemperatureBusGroup group;
+    group.addBus(sim.buses[0]);
+    group.addBus(sim.buses[1]);
+    
+    uint8_t tag = 0;
+    for (size_t b = 0; b < 2; b++) {
+        for (size_t d = 0; d < 2; d++) {
+            group.requestRead(b, sim.sims[b].getAddress(d), tag++);
+        }
+    }
+    runUntilIdle(group, sim);
+    
+    TemperatureReading reading;
+    size_t order[4];
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(group.takeReading(&reading, &order[i]));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, order[0]);
+    TEST_ASSERT_EQUAL_size_t(1, order[1]);
+    TEST_ASSERT_EQUAL_size_t(0, order[2]);
+    TEST_ASSERT_EQUAL_size_t(1, order[3]);
+    TEST_ASSERT_FALSE(group.takeReading(&reading, &order[0]));
+}
+
+// Test that a full group refuses further buses
+void test_group_capacity(void) {
+    const size_t layout[] = {0};
+    SimulatedBuses sim(layout, 1);
+    TemperatureBusGroup group;
+    for (size_t i = 0; i < TemperatureBusGroup::MAX_BUSES; i++) {
+        TEST_ASSERT_EQUAL_INT(static_cast<int>(i), group.addBus(sim.buses[0]));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, group.addBus(sim.buses[0]));
+    TEST_ASSERT_NULL(group.getBus(TemperatureBusGroup::MAX_BUSES));
+}
+
+// Test that an uneven layout takes as long as its busiest bus
+void test_cycle_matches_slowest_bus(void) {
+    const size_t layout[] = {1, 3, 2};
+    const size_t slowest[] = {3};
+    size_t readings;
+    const uint32_t parallel = parallelCycle(layout, 3, &readings);
+    TEST_ASSERT_EQUAL_size_t(6, readings);
+    const uint32_t single = parallelCycle(slowest, 1, &readings);
+    
+    // Within a couple of service steps of the busiest bus alone
+    TEST_ASSERT_UINT32_WITHIN(2 * STEP_US, single, parallel);
+    TEST_ASSERT_LESS_THAN(serialCycle(layout, 3), parallel);
+}
+
+// Benchmark: six sensors spread over one, two and three buses
+void test_benchmark_layouts(void) {
+    const size_t one_bus[] = {6};
+    const size_t two_buses[] = {3, 3};
+    const size_t three_buses[] = {2, 2, 2};
+    const size_t* layouts[] = {one_bus, two_buses, three_buses};
+    const size_t bus_counts[] = {1, 2, 3};
+    
+    uint32_t read_us[3];
+    for (size_t i = 0; i < 3; i++) {
+        size_t readings;
+        const uint32_t parallel = parallelCycle(layouts[i], bus_counts[i], &readings);
+        TEST_ASSERT_EQUAL_size_t(6, readings);
+        read_us[i] = parallel - CONVERSION_US;
+        
+        char message[96];
+        snprintf(message, sizeof(message),
+                 "%u bus(es): cycle %.1f ms, bus time %.1f ms (serial %.1f ms)",
+                 static_cast<unsigned>(bus_counts[i]), parallel / 1000.0,
+                 read_us[i] / 1000.0,
+                 (serialCycle(layouts[i], bus_counts[i]) -
+                  bus_counts[i] * CONVERSION_US) / 1000.0);
+        TEST_MESSAGE(message);
+    }
+    
+    // Bus time scales with the sensors on the busiest bus
+    TEST_ASSERT_UINT32_WITHIN(read_us[0] / 10, read_us[0] / 2, read_us[1]);
+    TEST_ASSERT_UINT32_WITHIN(read_us[0] / 10, read_us[0] / 3, read_us[2]);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_reads_every_bus);
+    RUN_TEST(test_take_round_robin);
+    RUN_TEST(test_group_capacity);
+    RUN_TEST(test_cycle_matches_slowest_bus);
+    RUN_TEST(test_benchmark_layouts);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,323 @@
+#include <unity.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "onewire_codec.h"
+#include "overheat_predictor.h"
+#include "sensor_config.h"
+#include "sensor_recording.h"
+#include "sensor_replay.h"
+#include "trend_estimator.h"
+
+// Host-runnable tests for the coolant trend estimator and overheat
+// warning. Coolant profiles are recorded as DS18B20 scratchpads, as the
+// device would record them, and replayed through the coolant pipeline
+// into the predictor.
+
+using namespace BoatEngine;
+
+static const uint32_t SAMPLE_MS = 2000;   // TEMPERATURE_READ_DELAY_MS
+
+// Recording kept in memory
+class MemorySink : public RecordingSink {
+public:
+    MemorySink() : size(0) {}
+    
+    bool write(const uint8_t* bytes, size_t count) override {
+        if (size + count > sizeof(data)) {
+            return false;
+        }
+        memcpy(&data[size], bytes, count);
+        size += count;
+        return true;
+    }
+    
+    uint8_t data[32768];
+    size_t size;
+};
+
+static uint32_t fake_now_ms = 0;
+
+static uint32_t fakeClock() {
+    return fake_now_ms;
+}
+
+typedef float (*CoolantProfile)(float seconds);   // Returns Celsius
+
+// Record a coolant profile at the sensor's sampling rate
+static void recordProfile(CoolantProfile profile, uint32_t duration_s, MemorySink* sink) {
+    fake_now_ms = 0;
+    SensorRecorder recorder(sink, fakeClock, sizeof(sink->data));
+    recorder.begin();
+    recorder.declareTemperatureChannel(0, BoatSensorConfig::COOLANT_TEMP.signal_k_path,
+                                       BoatSensorConfig::COOLANT_TEMP.calibration);
+    
+    for (uint32_t t = SAMPLE_MS; t <= duration_s * 1000; t += SAMPLE_MS) {
+        fake_now_ms = t;
+        // 12-bit DS18B20 resolution
+        const int16_t raw = static_cast<int16_t>(lroundf(profile(t / 1000.0f) * 16.0f));
+        uint8_t scratchpad[9] = {static_cast<uint8_t>(raw & 0xFF),
+                                 static_cast<uint8_t>((raw >> 8) & 0xFF),
+                                 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0};
+        scratchpad[8] = oneWireCrc8(scratchpad, 8);
+        recorder.onScratchpad(0, scratchpad);
+    }
+    recorder.flush();
+}
+
+// What the predictor did during a replay
+struct Outcome {
+    OverheatPredictor* predictor;
+    uint32_t first_warning_ms;
+    uint32_t first_over_ms;
+    uint32_t back_to_normal_ms;
+    float time_to_limit_at_warning;
+};
+
+static void feedPredictor(const SensorReplay::Output& output, void* context) {
+    Outcome* outcome = static_cast<Outcome*>(context);
+    if (!outcome->predictor->update(output.value, output.time_ms)) {
+        return;
+    }
+    switch (outcome->predictor->getState()) {
+        case OverheatPredictor::State::WARNING:
+            if (outcome->first_warning_ms == 0) {
+                outcome->first_warning_ms = output.time_ms;
+                outcome->time_to_limit_at_warning = outcome->predictor->getTimeToLimit();
+            }
+            break;
+        case OverheatPredictor::State::OVER_LIMIT:
+            if (outcome->first_over_ms == 0) {
+                outcome->first_over_ms = output.time_ms;
+            }
+            break;
+        case OverheatPredictor::State::NORMAL:
+            outcome->back_to_normal_ms = output.time_ms;
+            break;
+    }
+}
+
+static Outcome replayProfile(CoolantProfile profile, uint32_t duration_s,
+                             OverheatPredictor* predictor) {
+    static MemorySink sink;
+    sink.size = 0;
+    recordProfile(profile, duration_s, &sink);
+    
+    Outcome outcome = {predictor, 0, 0, 0, 0.0f};
+    SensorReplay replay(feedPredictor, &outcome);
+    replay.run(sink.data, sink.size);
+    return outcome;
+}
+
+// Running at 80 C; the impeller fails at 10 min and coolant climbs 4 K/min
+static float impellerFailure(float t) {
+    return t < 600.0f ? 80.0f : 80.0f + (t - 600.0f) * 4.0f / 60.0f;
+}
+
+// Cold start: exponential approach to the 82 C thermostat, tau 5 min
+static float warmUp(float t) {
+    return 82.0f - 62.0f * expf(-t / 300.0f);
+}
+
+// Hot day, heavy load: 0.2 K/min drift
+static float slowDrift(float t) {
+    return 85.0f + t * 0.2f / 60.0f;
+}
+
+// Blocked intake cleared: climbs 3 K/min for 2 min, then recovers
+static float clearedBlockage(float t) {
+    if (t < 300.0f) {
+        return 80.0f;
+    }
+    if (t < 420.0f) {
+        return 80.0f + (t - 300.0f) * 3.0f / 60.0f;
+    }
+    return 80.0f + 6.0f * expf(-(t - 420.0f) / 120.0f);
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that a straight line gives its exact slope
+void test_trend_line(void) {
+    TrendEstimator trend(60000);
+    for (uint32_t t = 0; t <= 20000; t += 2000) {
+        trend.add(300.0f + 0.05f * (t / 1000.0f), t);
+    }
+    float slope = 0.0f;
+    float fitted = 0.0f;
+    TEST_ASSERT_TRUE(trend.getSlope(&slope));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.05f, slope);
+    TEST_ASSERT_TRUE(trend.getFittedLatest(&fitted));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 301.0f, fitted);
+    TEST_ASSERT_EQUAL_UINT32(20000, trend.getSpanMs());
+}
+
+// Test that old samples leave the window and take their slope with them
+void test_trend_window_slides(void) {
+    TrendEstimator trend(30000);
+    uint32_t t = 0;
+    float value = 350.0f;
+    for (; t < 60000; t += 1000) {
+        value -= 0.1f;        // Falling...
+        trend.add(value, t);
+    }
+    for (; t < 100000; t += 1000) {
+        value += 0.2f;        // ...then rising for longer than the window
+        trend.add(value, t);
+    }
+    float slope = 0.0f;
+    TEST_ASSERT_TRUE(trend.getSlope(&slope));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.2f, slope);
+    TEST_ASSERT_EQUAL_size_t(31, trend.getCount());
+}
+
+// Test that the longest window fits in MAX_SAMPLES at the fastest read
+// interval and a longer one is cut short, as the configured limit assumes
+void test_trend_max_window(void) {
+    const uint32_t period = BoatSensorConfig::MIN_TEMPERATURE_READ_DELAY_MS;
+    const uint32_t max_window = TrendEstimator::maxWindowMs(period);
+    TEST_ASSERT_EQUAL_UINT32(BoatSensorConfig::OVERHEAT_MAX_WINDOW_S * 1000, max_window);
+    TEST_ASSERT_TRUE(BoatSensorConfig::OVERHEAT_DEFAULTS.window_ms <= max_window);
+    
+    TrendEstimator fits(max_window);
+    TrendEstimator cut(max_window + 10 * period);
+    for (uint32_t t = 0; t < 600000; t += period) {
+        fits.add(350.0f, t);
+        cut.add(350.0f, t);
+    }
+    TEST_ASSERT_EQUAL_size_t(TrendEstimator::MAX_SAMPLES, fits.getCount());
+    TEST_ASSERT_EQUAL_UINT32(max_window, fits.getSpanMs());
+    TEST_ASSERT_EQUAL_size_t(TrendEstimator::MAX_SAMPLES, cut.getCount());
+    TEST_ASSERT_EQUAL_UINT32(max_window, cut.getSpanMs());
+}
+
+// Test edge cases: too few samples, NaN, flat input and clock wrap
+void test_trend_edge_cases(void) {
+    TrendEstimator trend(60000);
+    float slope = 1.0f;
+    TEST_ASSERT_FALSE(trend.getSlope(&slope));
+    trend.add(300.0f, 1000);
+    TEST_ASSERT_FALSE(trend.getSlope(&slope));
+    trend.add(NAN, 2000);
+    TEST_ASSERT_EQUAL_size_t(1, trend.getCount());
+    trend.add(300.0f, 3000);
+    TEST_ASSERT_TRUE(trend.getSlope(&slope));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, slope);
+    
+    trend.reset();
+    const uint32_t start = 0xFFFFFFFFu - 5000;
+    for (uint32_t i = 0; i < 10; i++) {
+        trend.add(10.0f + i, start + i * 1000);   // Wraps after 6 samples
+    }
+    TEST_ASSERT_TRUE(trend.getSlope(&slope));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, slope);
+}
+
+// Test that the sums stay accurate over a month of samples
+void test_trend_long_run(void) {
+    TrendEstimator trend(60000);
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < 1300000; i++, t += SAMPLE_MS) {
+        trend.add(350.0f + 5.0f * sinf(i * 0.001f), t);
+    }
+    for (uint32_t i = 0; i < 40; i++, t += SAMPLE_MS) {
+        trend.add(350.0f + 0.01f * i, t);
+    }
+    float slope = 0.0f;
+    TEST_ASSERT_TRUE(trend.getSlope(&slope));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.005f, slope);
+}
+
+// Test that a failed impeller is flagged minutes before the limit
+void test_warns_before_overheat(void) {
+    OverheatPredictor predictor(BoatSensorConfig::OVERHEAT_DEFAULTS);
+    const Outcome outcome = replayProfile(impellerFailure, 1200, &predictor);
+    
+    // 95 C is crossed 225 s after the failure
+    const uint32_t crossing_ms = 600000 + 225000;
+    TEST_ASSERT_TRUE(outcome.first_warning_ms > 600000);
+    TEST_ASSERT_TRUE(outcome.first_warning_ms + 150000 < crossing_ms);
+    TEST_ASSERT_TRUE(outcome.time_to_limit_at_warning < 300.0f);
+    TEST_ASSERT_UINT32_WITHIN(SAMPLE_MS, crossing_ms, outcome.first_over_ms);
+    TEST_ASSERT_TRUE(predictor.getState() == OverheatPredictor::State::OVER_LIMIT);
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, 4.0f / 60.0f, predictor.getRate());
+}
+
+// Test that normal warm-up and slow drift never warn
+void test_no_false_warnings(void) {
+    OverheatPredictor warm(BoatSensorConfig::OVERHEAT_DEFAULTS);
+    Outcome outcome = replayProfile(warmUp, 2400, &warm);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.first_warning_ms);
+    TEST_ASSERT_TRUE(warm.getState() == OverheatPredictor::State::NORMAL);
+    
+    OverheatPredictor drift(BoatSensorConfig::OVERHEAT_DEFAULTS);
+    outcome = replayProfile(slowDrift, 1800, &drift);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.first_warning_ms);
+    TEST_ASSERT_TRUE(std::isinf(drift.getTimeToLimit()));
+}
+
+// Test that the warning clears once the temperature recovers
+void test_warning_clears(void) {
+    OverheatPredictor predictor(BoatSensorConfig::OVERHEAT_DEFAULTS);
+    const Outcome outcome = replayProfile(clearedBlockage, 1200, &predictor);
+    
+    TEST_ASSERT_TRUE(outcome.first_warning_ms > 300000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.first_over_ms);
+    TEST_ASSERT_TRUE(outcome.back_to_normal_ms > outcome.first_warning_ms);
+    TEST_ASSERT_TRUE(predictor.getState() == OverheatPredictor::State::NORMAL);
+}
+
+// Test that an invalid reading restarts the trend without clearing state
+void test_invalid_reading(void) {
+    OverheatPredictor predictor(BoatSensorConfig::OVERHEAT_DEFAULTS);
+    uint32_t t = 0;
+    for (int i = 0; i < 30; i++, t += SAMPLE_MS) {
+        predictor.update(353.15f + i * 0.2f, t);   // 6 K/min
+    }
+    TEST_ASSERT_TRUE(predictor.getState() == OverheatPredictor::State::WARNING);
+    
+    TEST_ASSERT_FALSE(predictor.update(NAN, t));
+    TEST_ASSERT_TRUE(predictor.getState() == OverheatPredictor::State::WARNING);
+    TEST_ASSERT_TRUE(std::isinf(predictor.getTimeToLimit()));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, predictor.getRate());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_trend_line);
+    RUN_TEST(test_trend_window_slides);
+    RUN_TEST(test_trend_max_window);
+    RUN_TEST(test_trend_edge_cases);
+    RUN_TEST(test_trend_long_run);
+    RUN_TEST(test_warns_before_overheat);
+    RUN_TEST(test_no_false_warnings);
+    RUN_TEST(test_warning_clears);
+    RUN_TEST(test_invalid_reading);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
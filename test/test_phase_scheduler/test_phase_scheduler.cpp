@@ -0,0 +1,190 @@
+#include <unity.h>
+
+#include "phase_scheduler.h"
+
+// Host-runnable tests for the phase-staggered acquisition scheduler
+
+using namespace BoatEngine;
+
+// Analog drain, thermocouple scan, pulse read and temperature cycle
+static const uint32_t PERIODS_MS[] = {50, 100, 500, 2000};
+static const size_t PERIOD_COUNT = sizeof(PERIODS_MS) / sizeof(PERIODS_MS[0]);
+
+static void addSensorTasks(PhaseScheduler& scheduler, unsigned* runs) {
+    for (size_t i = 0; i < PERIOD_COUNT; i++) {
+        scheduler.addTask(PERIODS_MS[i], [runs, i]() { runs[i]++; });
+    }
+}
+
+// Most tasks run by any one call, ticking every millisecond for duration_ms
+static size_t busiestTick(PhaseScheduler& scheduler, uint64_t start_ms, uint32_t duration_ms) {
+    size_t busiest = 0;
+    for (uint64_t now = start_ms; now < start_ms + duration_ms; now++) {
+        const size_t run = scheduler.runDue(now);
+        if (run > busiest) {
+            busiest = run;
+        }
+    }
+    return busiest;
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+void test_staggered_tasks_never_share_a_slot() {
+    PhaseScheduler scheduler(10, true);
+    unsigned runs[PERIOD_COUNT] = {};
+    addSensorTasks(scheduler, runs);
+    
+    TEST_ASSERT_EQUAL(1, scheduler.getPeakLoad());
+    TEST_ASSERT_EQUAL(4, scheduler.getAlignedLoad());
+    TEST_ASSERT_EQUAL(1, busiestTick(scheduler, 120000, 10000));
+    
+    // Every task still runs at its own rate
+    TEST_ASSERT_EQUAL(200, runs[0]);
+    TEST_ASSERT_EQUAL(100, runs[1]);
+    TEST_ASSERT_EQUAL(20, runs[2]);
+    TEST_ASSERT_EQUAL(5, runs[3]);
+}
+
+void test_aligned_tasks_pile_up() {
+    PhaseScheduler scheduler(10, false);
+    unsigned runs[PERIOD_COUNT] = {};
+    addSensorTasks(scheduler, runs);
+    
+    for (size_t i = 0; i < PERIOD_COUNT; i++) {
+        TEST_ASSERT_EQUAL(0, scheduler.getPhase(i));
+    }
+    TEST_ASSERT_EQUAL(4, scheduler.getPeakLoad());
+    TEST_ASSERT_EQUAL(4, busiestTick(scheduler, 0, 10000));
+    TEST_ASSERT_EQUAL(200, runs[0]);
+    TEST_ASSERT_EQUAL(5, runs[3]);
+}
+
+void test_heavy_tasks_kept_apart() {
+    // Three tasks in two slots: the light ones share
+    PhaseScheduler scheduler(10, true);
+    scheduler.addTask(20, []() {}, 5);
+    scheduler.addTask(20, []() {}, 1);
+    scheduler.addTask(20, []() {}, 1);
+    
+    TEST_ASSERT_EQUAL(0, scheduler.getPhase(0));
+    TEST_ASSERT_EQUAL(1, scheduler.getPhase(1));
+    TEST_ASSERT_EQUAL(1, scheduler.getPhase(2));
+    TEST_ASSERT_EQUAL(5, scheduler.getPeakLoad());
+}
+
+void test_missed_slots_run_once() {
+    PhaseScheduler scheduler(10, true);
+    unsigned runs = 0;
+    scheduler.addTask(50, [&runs]() { runs++; });
+    
+    scheduler.runDue(0);
+    TEST_ASSERT_EQUAL(1, runs);
+    
+    // A 1 s stall covers 20 periods; the task catches up with one run
+    TEST_ASSERT_EQUAL(1, scheduler.runDue(1000));
+    TEST_ASSERT_EQUAL(2, runs);
+    
+    // Same slot again: nothing to do
+    TEST_ASSERT_EQUAL(0, scheduler.runDue(1005));
+    TEST_ASSERT_EQUAL(1050, scheduler.nextDueMs(1005));
+}
+
+void test_suspend_and_resume() {
+    PhaseScheduler scheduler(10, true);
+    unsigned runs = 0;
+    const int task = scheduler.addTask(100, [&runs]() { runs++; });
+    
+    scheduler.setPeriod(task, 0);
+    TEST_ASSERT_EQUAL(0, scheduler.getPeriodSlots(task));
+    TEST_ASSERT_EQUAL(PhaseScheduler::NEVER, scheduler.nextDueMs(0));
+    busiestTick(scheduler, 0, 1000);
+    TEST_ASSERT_EQUAL(0, runs);
+    TEST_ASSERT_EQUAL(0, scheduler.getAlignedLoad());
+    
+    scheduler.setPeriod(task, 200);
+    busiestTick(scheduler, 1000, 1000);
+    TEST_ASSERT_EQUAL(5, runs);
+}
+
+void test_new_period_is_rephased() {
+    PhaseScheduler scheduler(10, true);
+    scheduler.addTask(100, []() {});
+    const int slow = scheduler.addTask(500, []() {});
+    TEST_ASSERT_NOT_EQUAL(scheduler.getPhase(0) % 10, scheduler.getPhase(slow) % 10);
+    
+    // Slowed down by the governor: still clear of the other task
+    scheduler.setPeriod(slow, 10000);
+    TEST_ASSERT_EQUAL(1000, scheduler.getPeriodSlots(slow));
+    TEST_ASSERT_EQUAL(1, scheduler.getPeakLoad());
+}
+
+void test_next_due_follows_phases() {
+    PhaseScheduler scheduler(10, true);
+    scheduler.addTask(100, []() {});   // Phase 0
+    scheduler.addTask(100, []() {});   // Phase 1
+    TEST_ASSERT_EQUAL(1, scheduler.getPhase(1));
+    
+    // The current slot is due until it has run
+    TEST_ASSERT_EQUAL(1000, scheduler.nextDueMs(1001));
+    TEST_ASSERT_EQUAL(1, scheduler.runDue(1001));
+    TEST_ASSERT_EQUAL(1010, scheduler.nextDueMs(1001));
+    TEST_ASSERT_EQUAL(1, scheduler.runDue(1011));
+    TEST_ASSERT_EQUAL(1100, scheduler.nextDueMs(1011));
+}
+
+void test_periods_round_to_slots() {
+    PhaseScheduler scheduler(10, true);
+    scheduler.addTask(2, []() {});
+    scheduler.addTask(754, []() {});
+    TEST_ASSERT_EQUAL(1, scheduler.getPeriodSlots(0));
+    TEST_ASSERT_EQUAL(75, scheduler.getPeriodSlots(1));
+}
+
+void test_task_limit() {
+    PhaseScheduler scheduler(10, true);
+    for (size_t i = 0; i < PhaseScheduler::MAX_TASKS; i++) {
+        TEST_ASSERT_EQUAL(static_cast<int>(i), scheduler.addTask(1000, []() {}));
+    }
+    TEST_ASSERT_EQUAL(-1, scheduler.addTask(1000, []() {}));
+    TEST_ASSERT_EQUAL(1, scheduler.getPeakLoad());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_staggered_tasks_never_share_a_slot);
+    RUN_TEST(test_aligned_tasks_pile_up);
+    RUN_TEST(test_heavy_tasks_kept_apart);
+    RUN_TEST(test_missed_slots_run_once);
+    RUN_TEST(test_suspend_and_resume);
+    RUN_TEST(test_new_period_is_rephased);
+    RUN_TEST(test_next_due_follows_phases);
+    RUN_TEST(test_periods_round_to_slots);
+    RUN_TEST(test_task_limit);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
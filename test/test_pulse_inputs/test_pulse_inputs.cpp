@@ -0,0 +1,143 @@
+#include <unity.h>
+
+#include "fuel_consumption.h"
+#include "pulse_counter_bank.h"
+#include "sensor_config.h"
+
+// Host-runnable tests for the pulse counting and fuel consumption logic
+// behind PulseInputManager
+
+using namespace BoatEngine;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that deltas are per channel and reset after each read
+void test_counter_bank_deltas(void) {
+    PulseCounterBank bank;
+    for (int i = 0; i < 5; i++) bank.recordEdge(0);
+    for (int i = 0; i < 3; i++) bank.recordEdge(2);
+    
+    TEST_ASSERT_EQUAL_UINT32(5, bank.takeDelta(0));
+    TEST_ASSERT_EQUAL_UINT32(0, bank.takeDelta(1));
+    TEST_ASSERT_EQUAL_UINT32(3, bank.takeDelta(2));
+    TEST_ASSERT_EQUAL_UINT32(0, bank.takeDelta(0));
+    
+    bank.recordEdge(0);
+    TEST_ASSERT_EQUAL_UINT32(1, bank.takeDelta(0));
+    TEST_ASSERT_EQUAL_UINT32(6, bank.getTotal(0));
+}
+
+// Test that the delta survives the free-running counter wrapping
+void test_counter_bank_wraparound(void) {
+    PulseCounterBank bank;
+    *bank.counterFor(1) = 0xFFFFFFFEu;
+    bank.takeDelta(1);
+    
+    for (int i = 0; i < 4; i++) bank.recordEdge(1);
+    TEST_ASSERT_EQUAL_UINT32(2, bank.getTotal(1));
+    TEST_ASSERT_EQUAL_UINT32(4, bank.takeDelta(1));
+}
+
+// Test edge count to frequency conversion over the measured interval
+void test_frequency_conversion(void) {
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, PulseCounterBank::toFrequency(10, 500));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 18.018f, PulseCounterBank::toFrequency(10, 555));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, PulseCounterBank::toFrequency(10, 0));
+}
+
+// Test pulses-per-revolution and gear ratio scaling for RPM
+void test_rpm_scaling(void) {
+    // 4 pulses per revolution at 100 Hz is 25 rev/s at the pickup
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, scalePulseFrequency(100.0f, 4.0f, 1.0f));
+    // Pickup on a 2:1 reduction: crank turns twice as fast
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, scalePulseFrequency(100.0f, 4.0f, 2.0f));
+    // A zero or negative pulses-per-unit setting is rejected
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, scalePulseFrequency(100.0f, 0.0f, 1.0f));
+}
+
+// Test fuel meter K-factor scaling to m3/s
+void test_fuel_flow_scaling(void) {
+    const BoatSensorConfig::PulseChannelDef& meter = BoatSensorConfig::FUEL_SUPPLY_FLOW;
+    // 10 L/h at 2000 pulses/L is 5.556 Hz
+    const float hz = 10.0f * 2000.0f / 3600.0f;
+    const float m3_per_s = scalePulseFrequency(hz, meter.pulses_per_unit, meter.ratio);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, 10.0f / 1000.0f / 3600.0f, m3_per_s);
+}
+
+// Test net flow is supply minus return and never negative
+void test_net_fuel_flow(void) {
+    FuelConsumptionCalculator fuel;
+    fuel.setSupplyFlow(3.0e-6f);
+    fuel.setReturnFlow(2.0e-6f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-12f, 1.0e-6f, fuel.getNetFlow());
+    
+    fuel.setReturnFlow(4.0e-6f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, fuel.getNetFlow());
+}
+
+// Test consumption per distance and its speed threshold
+void test_consumption_per_distance(void) {
+    FuelConsumptionCalculator fuel;
+    float value = -1.0f;
+    
+    // 6 L/h net at 6 knots is 1 L per nautical mile
+    fuel.setSupplyFlow(8.0e-3f / 3600.0f);
+    fuel.setReturnFlow(2.0e-3f / 3600.0f);
+    fuel.setSpeedOverGround(6.0f * FuelConsumptionCalculator::METERS_PER_NAUTICAL_MILE / 3600.0f);
+    TEST_ASSERT_TRUE(fuel.getConsumptionPerDistance(&value));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0e-3f,
+                             value * FuelConsumptionCalculator::METERS_PER_NAUTICAL_MILE);
+    
+    // At anchor the value is undefined and left untouched
+    value = -1.0f;
+    fuel.setSpeedOverGround(0.1f);
+    TEST_ASSERT_FALSE(fuel.getConsumptionPerDistance(&value));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, value);
+}
+
+// Test that all pulse channels use distinct pins
+void test_pulse_pins_unique(void) {
+    TEST_ASSERT_NOT_EQUAL(BoatSensorConfig::ENGINE_RPM.pin, BoatSensorConfig::FUEL_SUPPLY_FLOW.pin);
+    TEST_ASSERT_NOT_EQUAL(BoatSensorConfig::ENGINE_RPM.pin, BoatSensorConfig::FUEL_RETURN_FLOW.pin);
+    TEST_ASSERT_NOT_EQUAL(BoatSensorConfig::FUEL_SUPPLY_FLOW.pin, BoatSensorConfig::FUEL_RETURN_FLOW.pin);
+    TEST_ASSERT_NOT_EQUAL(BoatSensorConfig::ONEWIRE_PIN, BoatSensorConfig::FUEL_SUPPLY_FLOW.pin);
+    TEST_ASSERT_NOT_EQUAL(BoatSensorConfig::ONEWIRE_PIN, BoatSensorConfig::FUEL_RETURN_FLOW.pin);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_counter_bank_deltas);
+    RUN_TEST(test_counter_bank_wraparound);
+    RUN_TEST(test_frequency_conversion);
+    RUN_TEST(test_rpm_scaling);
+    RUN_TEST(test_fuel_flow_scaling);
+    RUN_TEST(test_net_fuel_flow);
+    RUN_TEST(test_consumption_per_distance);
+    RUN_TEST(test_pulse_pins_unique);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,201 @@
+#include <unity.h>
+
+#include <cmath>
+
+#include "rolling_statistics.h"
+
+// Host-runnable tests for the sliding-window statistics. Results are
+// checked against a brute-force pass over the samples still in the window.
+
+using namespace BoatEngine;
+
+struct Sample {
+    uint32_t time_ms;
+    float value;
+};
+
+// Deterministic pseudo-random sequence (xorshift32)
+static uint32_t rng_state = 1;
+
+static uint32_t nextRandom() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Statistics of samples[first..last) the slow way
+static void bruteForce(const Sample* samples, size_t first, size_t last,
+                       float* min, float* max, double* mean, double* stddev) {
+    *min = samples[first].value;
+    *max = samples[first].value;
+    double sum = 0.0;
+    for (size_t i = first; i < last; i++) {
+        *min = fminf(*min, samples[i].value);
+        *max = fmaxf(*max, samples[i].value);
+        sum += samples[i].value;
+    }
+    const size_t n = last - first;
+    *mean = sum / n;
+    double squares = 0.0;
+    for (size_t i = first; i < last; i++) {
+        squares += (samples[i].value - *mean) * (samples[i].value - *mean);
+    }
+    *stddev = n > 1 ? sqrt(squares / (n - 1)) : 0.0;
+}
+
+void setUp(void) {
+    rng_state = 1;
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+void test_empty_window() {
+    RollingStatistics stats(60000, 16);
+    TEST_ASSERT_EQUAL(0, stats.getCount());
+    TEST_ASSERT_TRUE(std::isnan(stats.getMin()));
+    TEST_ASSERT_TRUE(std::isnan(stats.getMax()));
+    TEST_ASSERT_TRUE(std::isnan(stats.getMean()));
+    TEST_ASSERT_TRUE(std::isnan(stats.getStdDev()));
+    
+    stats.add(42.0f, 1000);
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, stats.getMin());
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, stats.getMax());
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, stats.getMean());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.getStdDev());
+    
+    // Nothing new for longer than the window
+    stats.expire(61001);
+    TEST_ASSERT_EQUAL(0, stats.getCount());
+    TEST_ASSERT_TRUE(std::isnan(stats.getMean()));
+}
+
+void test_known_values() {
+    RollingStatistics stats(10000, 16);
+    const float values[] = {2.0f, 4.0f, 4.0f, 4.0f, 5.0f, 5.0f, 7.0f, 9.0f};
+    for (size_t i = 0; i < 8; i++) {
+        stats.add(values[i], i * 1000);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, stats.getMin());
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, stats.getMax());
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, stats.getMean());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, sqrtf(32.0f / 7.0f), stats.getStdDev());
+    
+    // NaN from a failed read is not a sample
+    stats.add(NAN, 8000);
+    TEST_ASSERT_EQUAL(8, stats.getCount());
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, stats.getMean());
+}
+
+void test_extremes_expire() {
+    RollingStatistics stats(5000, 16);
+    stats.add(10.0f, 0);
+    stats.add(1.0f, 1000);     // Minimum
+    stats.add(20.0f, 2000);    // Maximum
+    stats.add(5.0f, 3000);
+    stats.add(6.0f, 4000);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, stats.getMin());
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, stats.getMax());
+    
+    stats.expire(6001);        // 0 and 1000 have left
+    TEST_ASSERT_EQUAL(3, stats.getCount());
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, stats.getMin());
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, stats.getMax());
+    
+    stats.expire(7001);
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, stats.getMin());
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, stats.getMax());
+    TEST_ASSERT_EQUAL_FLOAT(5.5f, stats.getMean());
+}
+
+void test_matches_brute_force() {
+    static Sample samples[4000];
+    RollingStatistics stats(60000, 256);
+    uint32_t t = 0xFFFF0000u;  // Wraps part way through
+    size_t first = 0;
+    
+    for (size_t i = 0; i < 4000; i++) {
+        t += 100 + nextRandom() % 900;
+        // Engine speed with steps, drift and noise
+        const float value = 1500.0f + (i / 500) * 200.0f +
+                            static_cast<float>(nextRandom() % 1000) / 10.0f;
+        samples[i] = Sample{t, value};
+        stats.add(value, t);
+        while (t - samples[first].time_ms > 60000) {
+            first++;
+        }
+        
+        float min, max;
+        double mean, stddev;
+        bruteForce(samples, first, i + 1, &min, &max, &mean, &stddev);
+        TEST_ASSERT_EQUAL(i + 1 - first, stats.getCount());
+        TEST_ASSERT_EQUAL_FLOAT(min, stats.getMin());
+        TEST_ASSERT_EQUAL_FLOAT(max, stats.getMax());
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, mean, stats.getMean());
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, stddev, stats.getStdDev());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, stats.getOverflowCount());
+}
+
+void test_full_ring_drops_oldest() {
+    RollingStatistics stats(60000, 4);
+    stats.add(100.0f, 0);
+    for (uint32_t i = 1; i <= 4; i++) {
+        stats.add(static_cast<float>(i), i * 100);
+    }
+    TEST_ASSERT_EQUAL(4, stats.getCount());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.getOverflowCount());
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, stats.getMin());
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, stats.getMax());
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, stats.getMean());
+}
+
+void test_long_run() {
+    // A month of 2 Hz RPM: removal must not let the sums drift
+    RollingStatistics stats(600000, 1280);
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < 5000000; i++) {
+        t += 500;
+        const float rpm = (i / 20000) % 2 ? 2400.0f : 800.0f;
+        stats.add(rpm + static_cast<float>(nextRandom() % 11) - 5.0f, t);
+    }
+    // Last 10 minutes, both ends included, all in one speed band
+    TEST_ASSERT_EQUAL(1201, stats.getCount());
+    const float expected = (4999999 / 20000) % 2 ? 2400.0f : 800.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, expected, stats.getMean());
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, sqrtf(10.0f), stats.getStdDev());
+    TEST_ASSERT_TRUE(stats.getMin() >= expected - 5.0f);
+    TEST_ASSERT_TRUE(stats.getMax() <= expected + 5.0f);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_empty_window);
+    RUN_TEST(test_known_values);
+    RUN_TEST(test_extremes_expire);
+    RUN_TEST(test_matches_brute_force);
+    RUN_TEST(test_full_ring_drops_oldest);
+    RUN_TEST(test_long_run);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,212 @@
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+
+#include "sampling_governor.h"
+#include "sensor_config.h"
+
+// Host-runnable tests for the engine-state sampling governor and the
+// duty-cycle accounting behind SamplingGovernorManager
+
+using namespace BoatEngine;
+
+static const float RUNNING = 10.0f;  // rev/s, above the 5 rev/s threshold
+static const float WARM = 353.15f;   // 80 C
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that the governor starts stopped with the slowest profile
+void test_starts_stopped(void) {
+    SamplingGovernor governor(BoatSensorConfig::GOVERNOR_DEFAULTS);
+    
+    TEST_ASSERT_EQUAL(EngineState::STOPPED, governor.getState());
+    TEST_ASSERT_GREATER_THAN(BoatSensorConfig::RPM_READ_DELAY_MS,
+                             governor.getProfile().pulse_ms);
+    TEST_ASSERT_GREATER_THAN(BoatSensorConfig::TEMPERATURE_READ_DELAY_MS,
+                             governor.getProfile().temperature_ms);
+}
+
+// Test that a start goes to warm-up on a cold engine, then to running
+void test_warm_up_then_running(void) {
+    SamplingGovernor governor(BoatSensorConfig::GOVERNOR_DEFAULTS);
+    
+    TEST_ASSERT_TRUE(governor.onEngineSpeed(RUNNING, 1000));
+    TEST_ASSERT_EQUAL(EngineState::WARMING_UP, governor.getState());
+    
+    TEST_ASSERT_FALSE(governor.onCoolantTemperature(300.0f));
+    TEST_ASSERT_TRUE(governor.onCoolantTemperature(WARM));
+    TEST_ASSERT_EQUAL(EngineState::RUNNING, governor.getState());
+    TEST_ASSERT_EQUAL_UINT32(BoatSensorConfig::RPM_READ_DELAY_MS,
+                             governor.getProfile().pulse_ms);
+}
+
+// Test that an invalid (NaN) coolant reading keeps the last known state
+void test_invalid_coolant_ignored(void) {
+    SamplingGovernor governor(BoatSensorConfig::GOVERNOR_DEFAULTS);
+    governor.onEngineSpeed(RUNNING, 1000);
+    governor.onCoolantTemperature(WARM);
+    
+    TEST_ASSERT_FALSE(governor.onCoolantTemperature(NAN));
+    TEST_ASSERT_EQUAL(EngineState::RUNNING, governor.getState());
+}
+
+// Test that coolant readings while stopped do not wake the governor
+void test_coolant_alone_does_not_wake(void) {
+    SamplingGovernor governor(BoatSensorConfig::GOVERNOR_DEFAULTS);
+    
+    TEST_ASSERT_FALSE(governor.onCoolantTemperature(WARM));
+    TEST_ASSERT_EQUAL(EngineState::STOPPED, governor.getState());
+    
+    // But a known warm engine restarts straight into running
+    governor.onEngineSpeed(RUNNING, 0);
+    TEST_ASSERT_EQUAL(EngineState::RUNNING, governor.getState());
+}
+
+// Test that stopping the engine cools down, then returns to stopped
+void test_stop_cooldown_stopped(void) {
+    const SamplingGovernor::Settings& s = BoatSensorConfig::GOVERNOR_DEFAULTS;
+    SamplingGovernor governor(s);
+    governor.onCoolantTemperature(WARM);
+    governor.onEngineSpeed(RUNNING, 0);
+    
+    // A brief dip below running speed is not a stop
+    TEST_ASSERT_FALSE(governor.onEngineSpeed(0.0f, s.stop_detect_ms - 1));
+    TEST_ASSERT_EQUAL(EngineState::RUNNING, governor.getState());
+    
+    TEST_ASSERT_TRUE(governor.onEngineSpeed(0.0f, s.stop_detect_ms));
+    TEST_ASSERT_EQUAL(EngineState::COOLING_DOWN, governor.getState());
+    
+    TEST_ASSERT_FALSE(governor.update(s.stop_detect_ms + s.cooldown_ms - 1));
+    TEST_ASSERT_TRUE(governor.update(s.stop_detect_ms + s.cooldown_ms));
+    TEST_ASSERT_EQUAL(EngineState::STOPPED, governor.getState());
+}
+
+// Test that a pickup edge wakes the governor immediately
+void test_edge_wakes_immediately(void) {
+    SamplingGovernor governor(BoatSensorConfig::GOVERNOR_DEFAULTS);
+    
+    TEST_ASSERT_TRUE(governor.onEdgeActivity(100));
+    TEST_ASSERT_EQUAL(EngineState::WARMING_UP, governor.getState());
+    
+    // Further edges while awake change nothing
+    TEST_ASSERT_FALSE(governor.onEdgeActivity(200));
+    
+    // Cranking into a real start keeps fast sampling
+    TEST_ASSERT_FALSE(governor.onEngineSpeed(RUNNING, 600));
+    TEST_ASSERT_EQUAL(EngineState::WARMING_UP, governor.getState());
+}
+
+// Test that a stray edge without a start goes straight back to stopped
+void test_stray_edge_skips_cooldown(void) {
+    const SamplingGovernor::Settings& s = BoatSensorConfig::GOVERNOR_DEFAULTS;
+    SamplingGovernor governor(s);
+    
+    governor.onEdgeActivity(1000);
+    TEST_ASSERT_FALSE(governor.onEngineSpeed(0.2f, 1500));
+    TEST_ASSERT_TRUE(governor.onEngineSpeed(0.0f, 1000 + s.stop_detect_ms));
+    TEST_ASSERT_EQUAL(EngineState::STOPPED, governor.getState());
+}
+
+// Test that timestamps wrapping past 2^32 ms do not cause a false stop
+void test_millis_wraparound(void) {
+    const SamplingGovernor::Settings& s = BoatSensorConfig::GOVERNOR_DEFAULTS;
+    SamplingGovernor governor(s);
+    
+    governor.onEngineSpeed(RUNNING, 0xFFFFFF00u);
+    TEST_ASSERT_FALSE(governor.update(0x00000100u));
+    TEST_ASSERT_EQUAL(EngineState::WARMING_UP, governor.getState());
+}
+
+// Test that every state has a named, non-suspended default profile whose
+// reads come often enough for the load profile to count them
+void test_default_profiles(void) {
+    const SamplingGovernor::Settings& s = BoatSensorConfig::GOVERNOR_DEFAULTS;
+    for (int i = 0; i < SamplingGovernor::STATE_COUNT; i++) {
+        TEST_ASSERT_GREATER_THAN(0, s.profiles[i].pulse_ms);
+        TEST_ASSERT_GREATER_OR_EQUAL(BoatSensorConfig::ONEWIRE_CONVERSION_TIME_MS,
+                                     s.profiles[i].temperature_ms);
+        TEST_ASSERT_GREATER_THAN(0, s.profiles[i].analog_ms);
+        TEST_ASSERT_GREATER_THAN(s.profiles[i].pulse_ms,
+                                 BoatSensorConfig::LOAD_PROFILE_MAX_GAP_MS);
+        TEST_ASSERT_GREATER_THAN(s.profiles[i].temperature_ms,
+                                 BoatSensorConfig::LOAD_PROFILE_MAX_GAP_MS);
+        TEST_ASSERT_NOT_EQUAL(0, strcmp("unknown", SamplingGovernor::stateName(
+                                                       static_cast<EngineState>(i))));
+    }
+}
+
+// Test the split of wall time into busy, spinning, yielded and asleep
+void test_duty_cycle_and_current(void) {
+    DutyCycleMeter meter(50);
+    const DutyCycleMeter::CurrentModel model = {100.0f, 40.0f, 1.0f};
+    
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, meter.getDutyCycle());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, meter.getEstimatedCurrentMa(model));
+    
+    meter.recordTick(1000);   // Busy
+    meter.recordTick(10);     // Spin, below the threshold
+    meter.recordTick(10);
+    meter.recordYield(980);
+    meter.recordSleep(8000);
+    
+    TEST_ASSERT_EQUAL_UINT32(10000, static_cast<uint32_t>(meter.getTotalUs()));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, meter.getDutyCycle());
+    // (1020 * 100 + 980 * 40 + 8000 * 1) / 10000
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 14.92f, meter.getEstimatedCurrentMa(model));
+    
+    meter.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(meter.getTotalUs()));
+}
+
+// Test that a loop that only spins draws full active current
+void test_spinning_is_not_idle(void) {
+    DutyCycleMeter meter(50);
+    const DutyCycleMeter::CurrentModel model = {100.0f, 40.0f, 1.0f};
+    
+    for (int i = 0; i < 1000; i++) {
+        meter.recordTick(5);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, meter.getDutyCycle());
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, meter.getEstimatedCurrentMa(model));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_starts_stopped);
+    RUN_TEST(test_warm_up_then_running);
+    RUN_TEST(test_invalid_coolant_ignored);
+    RUN_TEST(test_coolant_alone_does_not_wake);
+    RUN_TEST(test_stop_cooldown_stopped);
+    RUN_TEST(test_edge_wakes_immediately);
+    RUN_TEST(test_stray_edge_skips_cooldown);
+    RUN_TEST(test_millis_wraparound);
+    RUN_TEST(test_default_profiles);
+    RUN_TEST(test_duty_cycle_and_current);
+    RUN_TEST(test_spinning_is_not_idle);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
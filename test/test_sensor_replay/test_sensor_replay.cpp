@@ -0,0 +1,480 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ds18b20_bus.h"
+#include "pulse_counter_bank.h"
+#include "sensor_config.h"
+#include "sensor_recording.h"
+#include "sensor_replay.h"
+#include "simulated_onewire_bus.h"
+
+// Host-runnable tests for raw sensor recording and replay. With
+// REPLAY_FILE set to a recording downloaded from the device, the last
+// test replays it and prints a summary of every output path:
+//   REPLAY_FILE=recording.bin pio test -e native -f test_sensor_replay -v
+
+using namespace BoatEngine;
+
+// Recording kept in memory
+class MemorySink : public RecordingSink {
+public:
+    MemorySink() : size(0), fail(false) {}
+    
+    bool write(const uint8_t* bytes, size_t count) override {
+        if (fail || size + count > sizeof(data)) {
+            return false;
+        }
+        memcpy(&data[size], bytes, count);
+        size += count;
+        return true;
+    }
+    
+    uint8_t data[4096];
+    size_t size;
+    bool fail;
+};
+
+static uint32_t fake_now_ms = 0;
+
+static uint32_t fakeClock() {
+    return fake_now_ms;
+}
+
+// Collects replay outputs
+struct Collected {
+    static const size_t MAX = 64;
+    const char* path[MAX];
+    uint32_t time_ms[MAX];
+    float value[MAX];
+    size_t count;
+};
+
+static void collect(const SensorReplay::Output& output, void* context) {
+    Collected* collected = static_cast<Collected*>(context);
+    if (collected->count < Collected::MAX) {
+        collected->path[collected->count] = output.sk_path;
+        collected->time_ms[collected->count] = output.time_ms;
+        collected->value[collected->count] = output.value;
+        collected->count++;
+    }
+}
+
+// A valid DS18B20 scratchpad for a temperature
+static void makeScratchpad(float celsius, uint8_t* scratchpad) {
+    const int16_t raw = static_cast<int16_t>(celsius * 16.0f);
+    const uint8_t bytes[8] = {static_cast<uint8_t>(raw & 0xFF),
+                              static_cast<uint8_t>((raw >> 8) & 0xFF),
+                              0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10};
+    memcpy(scratchpad, bytes, 8);
+    scratchpad[8] = oneWireCrc8(scratchpad, 8);
+}
+
+void setUp(void) {
+    fake_now_ms = 0;
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that every record type survives the round trip with its timestamp
+void test_record_round_trip(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    fake_now_ms = 5000;
+    TEST_ASSERT_TRUE(recorder.begin());
+    
+    uint8_t scratchpad[9];
+    makeScratchpad(42.0f, scratchpad);
+    recorder.declarePulseChannel(0, BoatSensorConfig::RPM_SK_PATH, 2.5f, 0.5f);
+    fake_now_ms += 500;
+    recorder.recordPulses(0, 123456, 500);
+    fake_now_ms += 20;
+    recorder.onScratchpad(3, scratchpad);
+    fake_now_ms += 70000;
+    recorder.onReadFailure(2, TemperatureReadStatus::NO_DEVICE);
+    TEST_ASSERT_TRUE(recorder.flush());
+    TEST_ASSERT_EQUAL_size_t(recorder.getBytesRecorded(), sink.size);
+    TEST_ASSERT_EQUAL_UINT32(4, recorder.getRecordCount());
+    
+    SensorRecordingReader reader(sink.data, sink.size);
+    TEST_ASSERT_TRUE(reader.begin());
+    SensorRecord record;
+    
+    TEST_ASSERT_TRUE(reader.next(&record));
+    TEST_ASSERT_TRUE(record.type == RecordType::CHANNEL);
+    TEST_ASSERT_TRUE(record.kind == RecordChannelKind::PULSE);
+    TEST_ASSERT_EQUAL_STRING(BoatSensorConfig::RPM_SK_PATH, record.sk_path);
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, record.pulses_per_unit);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, record.ratio);
+    TEST_ASSERT_EQUAL_UINT32(0, record.time_ms);
+    
+    TEST_ASSERT_TRUE(reader.next(&record));
+    TEST_ASSERT_TRUE(record.type == RecordType::PULSES);
+    TEST_ASSERT_EQUAL_UINT32(500, record.time_ms);
+    TEST_ASSERT_EQUAL_UINT32(123456, record.edges);
+    TEST_ASSERT_EQUAL_UINT32(500, record.elapsed_ms);
+    
+    TEST_ASSERT_TRUE(reader.next(&record));
+    TEST_ASSERT_TRUE(record.type == RecordType::SCRATCHPAD);
+    TEST_ASSERT_EQUAL_UINT8(3, record.channel);
+    TEST_ASSERT_EQUAL_MEMORY(scratchpad, record.scratchpad, 9);
+    
+    TEST_ASSERT_TRUE(reader.next(&record));
+    TEST_ASSERT_TRUE(record.type == RecordType::READ_FAILURE);
+    TEST_ASSERT_EQUAL_UINT32(70520, record.time_ms);
+    TEST_ASSERT_TRUE(record.status == TemperatureReadStatus::NO_DEVICE);
+    
+    TEST_ASSERT_FALSE(reader.next(&record));
+    TEST_ASSERT_FALSE(reader.isCorrupt());
+}
+
+// Test that the format stays compact: header plus a few bytes per read
+void test_record_size(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    recorder.begin();
+    uint8_t scratchpad[9];
+    makeScratchpad(20.0f, scratchpad);
+    
+    for (int i = 0; i < 10; i++) {
+        fake_now_ms += 500;
+        recorder.recordPulses(0, 200, 500);
+        recorder.onScratchpad(0, scratchpad);
+    }
+    recorder.flush();
+    
+    // Pulses: type, 2-byte delta, channel, 2-byte count, 2-byte interval;
+    // scratchpad: type, delta, tag, 9 bytes
+    TEST_ASSERT_EQUAL_size_t(SensorRecorder::HEADER_SIZE + 10 * (8 + 12), sink.size);
+}
+
+// Test that the size limit stops the recording cleanly
+void test_size_limit(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, 64);
+    recorder.begin();
+    for (int i = 0; i < 20; i++) {
+        recorder.recordPulses(1, 10, 500);
+    }
+    recorder.flush();
+    
+    TEST_ASSERT_FALSE(recorder.isRecording());
+    TEST_ASSERT_TRUE(sink.size <= 64);
+    TEST_ASSERT_EQUAL_UINT32(20, recorder.getRecordCount() + recorder.getDroppedRecords());
+    
+    SensorRecordingReader reader(sink.data, sink.size);
+    TEST_ASSERT_TRUE(reader.begin());
+    SensorRecord record;
+    uint32_t count = 0;
+    while (reader.next(&record)) {
+        count++;
+    }
+    TEST_ASSERT_FALSE(reader.isCorrupt());
+    TEST_ASSERT_EQUAL_UINT32(recorder.getRecordCount(), count);
+}
+
+// Test that a failing sink stops the recording
+void test_sink_failure(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    recorder.begin();
+    sink.fail = true;
+    TEST_ASSERT_FALSE(recorder.flush());
+    TEST_ASSERT_FALSE(recorder.isRecording());
+    recorder.recordPulses(0, 1, 500);
+    TEST_ASSERT_EQUAL_UINT32(1, recorder.getDroppedRecords());
+}
+
+// Test the replayed RPM and temperature pipeline outputs
+void test_replay_pipelines(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    recorder.begin();
+    recorder.declarePulseChannel(0, BoatSensorConfig::ENGINE_RPM.signal_k_path,
+                                 BoatSensorConfig::ENGINE_RPM.pulses_per_unit,
+                                 BoatSensorConfig::ENGINE_RPM.ratio);
+    recorder.declareTemperatureChannel(1, BoatSensorConfig::COOLANT_TEMP.signal_k_path,
+                                       BoatSensorConfig::COOLANT_TEMP.calibration);
+    
+    uint8_t good[9];
+    makeScratchpad(42.0f, good);
+    uint8_t corrupt[9];
+    memcpy(corrupt, good, 9);
+    corrupt[0] ^= 0x08;
+    
+    fake_now_ms = 500;
+    recorder.recordPulses(0, 25, 500);      // 50 Hz
+    recorder.onScratchpad(1, good);
+    recorder.onScratchpad(2, good);         // Never defined
+    fake_now_ms = 2500;
+    recorder.onScratchpad(1, corrupt);      // Retried...
+    recorder.onScratchpad(1, corrupt);
+    recorder.onScratchpad(1, corrupt);      // ...until invalid
+    recorder.flush();
+    
+    Collected out;
+    out.count = 0;
+    SensorReplay replay(collect, &out);
+    TEST_ASSERT_TRUE(replay.run(sink.data, sink.size));
+    
+    TEST_ASSERT_EQUAL_size_t(3, out.count);
+    TEST_ASSERT_EQUAL_STRING(BoatSensorConfig::ENGINE_RPM.signal_k_path, out.path[0]);
+    TEST_ASSERT_EQUAL_UINT32(500, out.time_ms[0]);
+    TEST_ASSERT_EQUAL_FLOAT(
+        scalePulseFrequency(50.0f, BoatSensorConfig::ENGINE_RPM.pulses_per_unit,
+                            BoatSensorConfig::ENGINE_RPM.ratio),
+        out.value[0]);
+    
+    TEST_ASSERT_EQUAL_STRING(BoatSensorConfig::COOLANT_TEMP.signal_k_path, out.path[1]);
+    TEST_ASSERT_EQUAL_FLOAT(315.15f, out.value[1]);
+    TEST_ASSERT_TRUE(std::isnan(out.value[2]));
+    TEST_ASSERT_EQUAL_UINT32(2500, out.time_ms[2]);
+    
+    TEST_ASSERT_EQUAL_UINT32(1, replay.getUnmatchedRecords());
+    TEST_ASSERT_EQUAL_UINT32(3, replay.getHealth(1)->getCounters().crc_errors);
+    TEST_ASSERT_NULL(replay.getHealth(2));
+}
+
+// Test that channels unknown to BoatSensorConfig replay as they were defined
+void test_replay_topology_channels(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    recorder.begin();
+    recorder.declarePulseChannel(0, "propulsion.generator.revolutions", 4.0f, 2.0f);
+    const BoatSensorConfig::CalibrationDef celsius = {
+        BoatSensorConfig::Calibration::LINEAR, 1.0f, -273.15f, nullptr, 0
+    };
+    recorder.declareTemperatureChannel(1, "environment.inside.engineRoom.temperature",
+                                       celsius);
+    static const CalibrationTable::Point DOUBLING[] = {{200.0f, 400.0f}, {400.0f, 800.0f}};
+    const BoatSensorConfig::CalibrationDef table = {
+        BoatSensorConfig::Calibration::TABLE, 1.0f, 0.0f, DOUBLING, 2
+    };
+    recorder.declareTemperatureChannel(2, "propulsion.generator.temperature", table);
+    
+    uint8_t scratchpad[9];
+    makeScratchpad(30.0f, scratchpad);
+    fake_now_ms = 500;
+    recorder.recordPulses(0, 40, 500);     // 80 Hz
+    recorder.onScratchpad(1, scratchpad);
+    recorder.onScratchpad(2, scratchpad);
+    recorder.flush();
+    
+    Collected out;
+    out.count = 0;
+    SensorReplay replay(collect, &out);
+    TEST_ASSERT_TRUE(replay.run(sink.data, sink.size));
+    
+    TEST_ASSERT_EQUAL_size_t(3, out.count);
+    TEST_ASSERT_EQUAL_UINT32(0, replay.getUnmatchedRecords());
+    TEST_ASSERT_EQUAL_STRING("propulsion.generator.revolutions", out.path[0]);
+    TEST_ASSERT_EQUAL_FLOAT(scalePulseFrequency(80.0f, 4.0f, 2.0f), out.value[0]);
+    TEST_ASSERT_EQUAL_STRING("environment.inside.engineRoom.temperature", out.path[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, out.value[1]);
+    TEST_ASSERT_EQUAL_STRING("propulsion.generator.temperature", out.path[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f * (30.0f + 273.15f), out.value[2]);
+}
+
+// Test recording a simulated bus and replaying it, twice, identically
+void test_record_bus_and_replay(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x0a0b0c0d0e0full);
+    sim.addDevice(0x1a1b1c1d1e1full);
+    Ds18b20Bus bus(&sim);
+    bus.begin();
+    
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    recorder.begin();
+    recorder.declareTemperatureChannel(0, BoatSensorConfig::SEAWATER_IN_TEMP.signal_k_path,
+                                       BoatSensorConfig::SEAWATER_IN_TEMP.calibration);
+    recorder.declareTemperatureChannel(1, BoatSensorConfig::SEAWATER_OUT_TEMP.signal_k_path,
+                                       BoatSensorConfig::SEAWATER_OUT_TEMP.calibration);
+    bus.setObserver(&recorder);
+    
+    for (int cycle = 0; cycle < 5; cycle++) {
+        sim.setTemperature(0, 10.0f + cycle);
+        sim.setTemperature(1, 20.0f + cycle);
+        bus.startConversion();
+        fake_now_ms += 750;
+        bus.requestRead(sim.getAddress(0), 0);
+        bus.requestRead(sim.getAddress(1), 1);
+        while (!bus.isIdle()) {
+            sim.advance(100);
+            bus.service();
+        }
+        TemperatureReading reading;
+        while (bus.takeReading(&reading)) {
+        }
+        fake_now_ms += 1250;
+    }
+    recorder.flush();
+    
+    Collected first;
+    first.count = 0;
+    SensorReplay replay(collect, &first);
+    TEST_ASSERT_TRUE(replay.run(sink.data, sink.size));
+    TEST_ASSERT_EQUAL_size_t(10, first.count);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f + 273.15f, first.value[0]);
+    TEST_ASSERT_EQUAL_FLOAT(24.0f + 273.15f, first.value[9]);
+    TEST_ASSERT_EQUAL_UINT32(4 * 2000 + 750, first.time_ms[9]);
+    
+    Collected second;
+    second.count = 0;
+    SensorReplay again(collect, &second);
+    again.run(sink.data, sink.size);
+    TEST_ASSERT_EQUAL_size_t(first.count, second.count);
+    TEST_ASSERT_EQUAL_MEMORY(first.value, second.value, first.count * sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(first.time_ms, second.time_ms, first.count * sizeof(uint32_t));
+}
+
+// Test that a recording cut off mid-record still replays up to the cut
+void test_truncated_recording(void) {
+    MemorySink sink;
+    SensorRecorder recorder(&sink, fakeClock, sizeof(sink.data));
+    recorder.begin();
+    recorder.declarePulseChannel(0, BoatSensorConfig::ENGINE_RPM.signal_k_path,
+                                 BoatSensorConfig::ENGINE_RPM.pulses_per_unit,
+                                 BoatSensorConfig::ENGINE_RPM.ratio);
+    recorder.recordPulses(0, 10, 500);
+    recorder.recordPulses(0, 20, 500);
+    recorder.flush();
+    
+    Collected out;
+    out.count = 0;
+    SensorReplay replay(collect, &out);
+    TEST_ASSERT_FALSE(replay.run(sink.data, sink.size - 2));
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    
+    const uint8_t garbage[] = {'N', 'O', 'P', 'E', 1};
+    TEST_ASSERT_FALSE(replay.run(garbage, sizeof(garbage)));
+}
+
+#ifndef ARDUINO
+// Per-path summary of a field recording
+struct PathStats {
+    const char* path;
+    uint32_t count;
+    uint32_t invalid;
+    float min;
+    float max;
+};
+
+struct ReplaySummary {
+    static const size_t MAX_PATHS = 16;
+    PathStats paths[MAX_PATHS];
+    size_t count;
+};
+
+static void summarize(const SensorReplay::Output& output, void* context) {
+    ReplaySummary* summary = static_cast<ReplaySummary*>(context);
+    PathStats* stats = nullptr;
+    for (size_t i = 0; i < summary->count; i++) {
+        if (strcmp(summary->paths[i].path, output.sk_path) == 0) {
+            stats = &summary->paths[i];
+        }
+    }
+    if (stats == nullptr) {
+        if (summary->count >= ReplaySummary::MAX_PATHS) {
+            return;
+        }
+        stats = &summary->paths[summary->count++];
+        stats->path = output.sk_path;
+        stats->count = 0;
+        stats->invalid = 0;
+        stats->min = INFINITY;
+        stats->max = -INFINITY;
+    }
+    stats->count++;
+    if (std::isnan(output.value)) {
+        stats->invalid++;
+        return;
+    }
+    stats->min = output.value < stats->min ? output.value : stats->min;
+    stats->max = output.value > stats->max ? output.value : stats->max;
+}
+
+// Replay a recording from the device, if one was given
+void test_replay_field_recording(void) {
+    const char* path = getenv("REPLAY_FILE");
+    if (path == nullptr) {
+        TEST_MESSAGE("REPLAY_FILE not set; nothing to replay");
+        return;
+    }
+    FILE* file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = static_cast<uint8_t*>(malloc(size > 0 ? size : 1));
+    const size_t read = fread(data, 1, size, file);
+    fclose(file);
+    
+    ReplaySummary summary;
+    summary.count = 0;
+    SensorReplay replay(summarize, &summary);
+    const auto start = std::chrono::steady_clock::now();
+    const bool complete = replay.run(data, read);
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    free(data);
+    
+    char message[160];
+    snprintf(message, sizeof(message),
+             "%u records, %u outputs, %u unmatched in %.3f ms%s",
+             static_cast<unsigned>(replay.getRecordCount()),
+             static_cast<unsigned>(replay.getOutputCount()),
+             static_cast<unsigned>(replay.getUnmatchedRecords()), seconds * 1000.0,
+             complete ? "" : " (recording ends mid-record)");
+    TEST_MESSAGE(message);
+    for (size_t i = 0; i < summary.count; i++) {
+        const PathStats& stats = summary.paths[i];
+        snprintf(message, sizeof(message), "%s: %u values, %u invalid, %g .. %g",
+                 stats.path, static_cast<unsigned>(stats.count),
+                 static_cast<unsigned>(stats.invalid), stats.min, stats.max);
+        TEST_MESSAGE(message);
+    }
+    TEST_ASSERT_GREATER_THAN(0, replay.getRecordCount());
+}
+#endif
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_record_round_trip);
+    RUN_TEST(test_record_size);
+    RUN_TEST(test_size_limit);
+    RUN_TEST(test_sink_failure);
+    RUN_TEST(test_replay_pipelines);
+    RUN_TEST(test_replay_topology_channels);
+    RUN_TEST(test_record_bus_and_replay);
+    RUN_TEST(test_truncated_recording);
+#ifndef ARDUINO
+    RUN_TEST(test_replay_field_recording);
+#endif
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
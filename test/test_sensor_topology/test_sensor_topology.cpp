@@ -0,0 +1,284 @@
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+
+#include "sensor_topology.h"
+
+// Host-runnable tests for the runtime sensor topology table
+
+using namespace BoatEngine;
+
+using Role = SensorTopology::PulseRole;
+using Error = SensorTopology::Error;
+
+static BoatSensorConfig::TemperatureSensorDef temperature(const char* base_name,
+                                                         uint8_t bus = 0) {
+    BoatSensorConfig::TemperatureSensorDef def = BoatSensorConfig::COOLANT_TEMP;
+    def.base_name = base_name;
+    def.onewire_bus = bus;
+    return def;
+}
+
+static BoatSensorConfig::PulseChannelDef pulse(uint8_t pin, const char* name) {
+    static std::string paths[16];
+    static size_t next = 0;
+    BoatSensorConfig::PulseChannelDef def = BoatSensorConfig::FUEL_SUPPLY_FLOW;
+    def.pin = pin;
+    paths[next % 16] = std::string("/") + name + "/scaling";
+    def.scaling_config_path = paths[next++ % 16].c_str();
+    paths[next % 16] = std::string("/") + name + "/skPath";
+    def.sk_config_path = paths[next++ % 16].c_str();
+    return def;
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+void test_defaults_match_built_in_sensors() {
+    SensorTopology topology;
+    topology.loadDefaults();
+    
+    TEST_ASSERT_TRUE(topology.isValid());
+    TEST_ASSERT_EQUAL(4, topology.getTemperatureCount());
+    TEST_ASSERT_EQUAL(3, topology.getPulseCount());
+    TEST_ASSERT_EQUAL_STRING(BoatSensorConfig::COOLANT_TEMP.base_name,
+                             topology.getTemperature(0).base_name);
+    TEST_ASSERT_EQUAL(1, topology.getTemperature(3).onewire_bus);
+    
+    const BoatSensorConfig::PulseChannelDef* rpm = topology.findPulse(Role::RPM);
+    TEST_ASSERT_NOT_NULL(rpm);
+    TEST_ASSERT_EQUAL(BoatSensorConfig::RPM_PIN, rpm->pin);
+    TEST_ASSERT_EQUAL_STRING(BoatSensorConfig::RPM_CONFIG_PATH_CALIBRATE,
+                             rpm->scaling_config_path);
+    TEST_ASSERT_NOT_NULL(topology.findPulse(Role::FUEL_SUPPLY));
+    TEST_ASSERT_NOT_NULL(topology.findPulse(Role::FUEL_RETURN));
+    TEST_ASSERT_NULL(topology.findPulse(Role::OTHER));
+}
+
+void test_strings_are_copied() {
+    SensorTopology topology;
+    char name[] = "oilTemperature";
+    TEST_ASSERT_TRUE(topology.addTemperature(temperature(name)));
+    strcpy(name, "overwritten");
+    
+    TEST_ASSERT_EQUAL_STRING("oilTemperature", topology.getTemperature(0).base_name);
+    TEST_ASSERT_NOT_NULL(topology.findTemperature("oilTemperature"));
+    TEST_ASSERT_EQUAL(strlen("oilTemperature") + 1 +
+                      strlen(BoatSensorConfig::COOLANT_TEMP.signal_k_path) + 1 +
+                      strlen(BoatSensorConfig::COOLANT_TEMP.human_label) + 1,
+                      topology.getPoolUsed());
+}
+
+void test_rejects_conflicts() {
+    SensorTopology names;
+    names.addTemperature(temperature("a"));
+    TEST_ASSERT_FALSE(names.addTemperature(temperature("a")));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_NAME, names.getError());
+    
+    SensorTopology buses;
+    TEST_ASSERT_FALSE(buses.addTemperature(
+        temperature("a", BoatSensorConfig::ONEWIRE_BUS_COUNT)));
+    TEST_ASSERT_EQUAL(Error::BAD_BUS, buses.getError());
+    
+    // JSON values are checked before they are narrowed to uint8_t
+    TEST_ASSERT_FALSE(SensorTopology::isValidBus(-1));
+    TEST_ASSERT_FALSE(SensorTopology::isValidBus(256));
+    TEST_ASSERT_FALSE(SensorTopology::isValidBus(BoatSensorConfig::ONEWIRE_BUS_COUNT));
+    TEST_ASSERT_TRUE(SensorTopology::isValidBus(0));
+    
+    SensorTopology pins;
+    pins.addPulse(Role::RPM, pulse(16, "rpm"));
+    TEST_ASSERT_FALSE(pins.addPulse(Role::OTHER, pulse(16, "other")));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN, pins.getError());
+    
+    SensorTopology onewire;
+    TEST_ASSERT_FALSE(onewire.addPulse(
+        Role::OTHER, pulse(BoatSensorConfig::ONEWIRE_BUSES[0].pin, "other")));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN, onewire.getError());
+    
+    SensorTopology roles;
+    roles.addPulse(Role::FUEL_SUPPLY, pulse(26, "a"));
+    TEST_ASSERT_FALSE(roles.addPulse(Role::FUEL_SUPPLY, pulse(27, "b")));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_ROLE, roles.getError());
+    
+    SensorTopology scaling;
+    BoatSensorConfig::PulseChannelDef zero = pulse(26, "a");
+    zero.pulses_per_unit = 0.0f;
+    TEST_ASSERT_FALSE(scaling.addPulse(Role::OTHER, zero));
+    TEST_ASSERT_EQUAL(Error::BAD_SCALING, scaling.getError());
+    
+    SensorTopology missing;
+    BoatSensorConfig::TemperatureSensorDef unnamed = temperature("");
+    TEST_ASSERT_FALSE(missing.addTemperature(unnamed));
+    TEST_ASSERT_EQUAL(Error::MISSING_FIELD, missing.getError());
+}
+
+static Error pulseError(uint8_t pin) {
+    // NONE when the pin is accepted
+    SensorTopology topology;
+    topology.addPulse(Role::OTHER, pulse(pin, "other"));
+    return topology.getError();
+}
+
+void test_rejects_invalid_gpio() {
+    // The ESP32 has no GPIO 20, 24, 28-31 or above 39
+    TEST_ASSERT_EQUAL(Error::BAD_PIN, pulseError(20));
+    TEST_ASSERT_EQUAL(Error::BAD_PIN, pulseError(24));
+    TEST_ASSERT_EQUAL(Error::BAD_PIN, pulseError(28));
+    TEST_ASSERT_EQUAL(Error::BAD_PIN, pulseError(40));
+    
+    // JSON values are checked before they are narrowed to uint8_t
+    TEST_ASSERT_FALSE(SensorTopology::isUsablePulsePin(-1));
+    TEST_ASSERT_FALSE(SensorTopology::isUsablePulsePin(256 + 16));
+    TEST_ASSERT_TRUE(SensorTopology::isUsablePulsePin(16));
+}
+
+void test_rejects_flash_pins() {
+    for (uint8_t pin = 6; pin <= 11; pin++) {
+        TEST_ASSERT_EQUAL(Error::BAD_PIN, pulseError(pin));
+    }
+}
+
+void test_rejects_input_only_pins() {
+    // No internal pull-up for INPUT_PULLUP
+    for (uint8_t pin = 34; pin <= 39; pin++) {
+        TEST_ASSERT_EQUAL(Error::BAD_PIN, pulseError(pin));
+    }
+}
+
+void test_rejects_spi_pins() {
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN,
+                      pulseError(BoatSensorConfig::THERMOCOUPLE_SCLK_PIN));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN,
+                      pulseError(BoatSensorConfig::THERMOCOUPLE_MISO_PIN));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN,
+                      pulseError(BoatSensorConfig::THERMOCOUPLE_MOSI_PIN));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN,
+                      pulseError(BoatSensorConfig::EXHAUST_GAS_TEMP.cs_pin));
+}
+
+void test_rejects_i2c_pins() {
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN,
+                      pulseError(BoatSensorConfig::VIBRATION_SDA_PIN));
+    TEST_ASSERT_EQUAL(Error::DUPLICATE_PIN,
+                      pulseError(BoatSensorConfig::VIBRATION_SCL_PIN));
+}
+
+void test_reserves_adc_pins() {
+    // The analog inputs sit on input-only pins, so addPulse already refuses
+    // them as BAD_PIN; the reservation guards a move to ADC1 channel 4 or 5
+    TEST_ASSERT_TRUE(SensorTopology::isReservedPin(36));   // Fuel level, channel 0
+    TEST_ASSERT_TRUE(SensorTopology::isReservedPin(34));   // Oil pressure, channel 6
+    TEST_ASSERT_TRUE(SensorTopology::isReservedPin(35));   // Alternator, channel 7
+    TEST_ASSERT_FALSE(SensorTopology::isReservedPin(32));
+    TEST_ASSERT_FALSE(SensorTopology::isReservedPin(BoatSensorConfig::RPM_PIN));
+}
+
+void test_first_error_is_kept() {
+    SensorTopology topology;
+    topology.addTemperature(temperature("a", 9));
+    
+    // Valid entries after a failure are refused too
+    TEST_ASSERT_FALSE(topology.addTemperature(temperature("b")));
+    TEST_ASSERT_FALSE(topology.addPulse(Role::RPM, pulse(16, "rpm")));
+    TEST_ASSERT_FALSE(topology.finish());
+    TEST_ASSERT_EQUAL(Error::BAD_BUS, topology.getError());
+    TEST_ASSERT_EQUAL(0, topology.getTemperatureCount());
+    TEST_ASSERT_EQUAL(0, topology.getPulseCount());
+}
+
+void test_requires_rpm_channel() {
+    SensorTopology topology;
+    topology.addPulse(Role::FUEL_SUPPLY, pulse(26, "a"));
+    TEST_ASSERT_FALSE(topology.finish());
+    TEST_ASSERT_EQUAL(Error::MISSING_RPM, topology.getError());
+}
+
+void test_capacity_limits() {
+    SensorTopology topology;
+    char names[SensorTopology::MAX_TEMPERATURE_SENSORS + 1][8];
+    for (size_t i = 0; i < SensorTopology::MAX_TEMPERATURE_SENSORS; i++) {
+        snprintf(names[i], sizeof(names[i]), "t%u", static_cast<unsigned>(i));
+        TEST_ASSERT_TRUE(topology.addTemperature(temperature(names[i])));
+    }
+    TEST_ASSERT_FALSE(topology.addTemperature(temperature("extra")));
+    TEST_ASSERT_EQUAL(Error::TOO_MANY_SENSORS, topology.getError());
+    
+    // A string that does not fit leaves the pool usable up to its end
+    SensorTopology pool;
+    std::string long_name(SensorTopology::STRING_POOL_SIZE, 'x');
+    TEST_ASSERT_NULL(pool.intern(long_name.c_str()));
+    TEST_ASSERT_EQUAL(Error::POOL_FULL, pool.getError());
+    TEST_ASSERT_EQUAL(0, pool.getPoolUsed());
+}
+
+void test_clear_and_reload() {
+    SensorTopology topology;
+    topology.addTemperature(temperature("a", 9));
+    TEST_ASSERT_FALSE(topology.isValid());
+    
+    // Fallback after a bad definition
+    topology.loadDefaults();
+    TEST_ASSERT_TRUE(topology.isValid());
+    TEST_ASSERT_EQUAL(4, topology.getTemperatureCount());
+    
+    topology.clear();
+    TEST_ASSERT_EQUAL(0, topology.getTemperatureCount());
+    TEST_ASSERT_EQUAL(0, topology.getPoolUsed());
+    TEST_ASSERT_TRUE(topology.isValid());
+}
+
+void test_role_names_round_trip() {
+    const Role roles[] = {Role::RPM, Role::FUEL_SUPPLY, Role::FUEL_RETURN, Role::OTHER};
+    for (Role role : roles) {
+        Role parsed = Role::OTHER;
+        TEST_ASSERT_TRUE(SensorTopology::parseRole(SensorTopology::roleName(role), &parsed));
+        TEST_ASSERT_EQUAL(static_cast<int>(role), static_cast<int>(parsed));
+    }
+    Role unused;
+    TEST_ASSERT_FALSE(SensorTopology::parseRole("bilge", &unused));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_defaults_match_built_in_sensors);
+    RUN_TEST(test_strings_are_copied);
+    RUN_TEST(test_rejects_conflicts);
+    RUN_TEST(test_rejects_invalid_gpio);
+    RUN_TEST(test_rejects_flash_pins);
+    RUN_TEST(test_rejects_input_only_pins);
+    RUN_TEST(test_rejects_spi_pins);
+    RUN_TEST(test_rejects_i2c_pins);
+    RUN_TEST(test_reserves_adc_pins);
+    RUN_TEST(test_first_error_is_kept);
+    RUN_TEST(test_requires_rpm_channel);
+    RUN_TEST(test_capacity_limits);
+    RUN_TEST(test_clear_and_reload);
+    RUN_TEST(test_role_names_round_trip);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,246 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "pulse_pipeline.h"
+#include "static_pipeline.h"
+
+// Host-runnable tests for the compile-time pulse pipeline, with a
+// ns/sample comparison against an observer chain shaped like SensESP's
+
+using namespace BoatEngine;
+
+// Stand-ins for the SensESP classes on the RPM path. Every node is heap
+// allocated, set() is virtual and each hop goes through a std::function
+// observer, as ObservableValue -> Transform -> SKOutput does on the device.
+class ChainConsumer {
+public:
+    virtual ~ChainConsumer() {}
+    virtual void set(const float& value) = 0;
+};
+
+class ChainProducer {
+public:
+    virtual ~ChainProducer() {}
+    
+    void emit(const float& value) {
+        output_ = value;
+        for (size_t i = 0; i < observers_.size(); i++) {
+            observers_[i]();
+        }
+    }
+    
+    template <typename Consumer>
+    Consumer* connect_to(Consumer* consumer) {
+        observers_.push_back([this, consumer]() { consumer->set(this->output_); });
+        return consumer;
+    }
+
+protected:
+    float output_ = 0.0f;
+
+private:
+    std::vector<std::function<void()>> observers_;
+};
+
+class ChainValue : public ChainProducer {
+public:
+    void set(const float& value) { emit(value); }
+};
+
+// Same settings and emit() as PulseRateScaling; set() scales as well, for
+// the observer chain the benchmark compares against
+class ChainScaling : public ChainConsumer, public ChainProducer {
+public:
+    ChainScaling(float pulses_per_unit, float ratio)
+        : pulses_per_unit_(pulses_per_unit), ratio_(ratio) {}
+    
+    void set(const float& input) override {
+        emit(scalePulseFrequency(input, pulses_per_unit_, ratio_));
+    }
+    
+    float getPulsesPerUnit() const { return pulses_per_unit_; }
+    float getRatio() const { return ratio_; }
+    void configure(float pulses_per_unit, float ratio) {
+        pulses_per_unit_ = pulses_per_unit;
+        ratio_ = ratio;
+    }
+
+private:
+    float pulses_per_unit_;
+    float ratio_;
+};
+
+// Where the SK output would be
+class ChainSink : public ChainConsumer {
+public:
+    void set(const float& value) override {
+        last = value;
+        sum += value;
+        count++;
+    }
+    
+    float last = 0.0f;
+    double sum = 0.0;
+    unsigned count = 0;
+};
+
+using TestPipeline = PulseRatePipeline<ChainScaling, ChainSink>;
+
+static TestPipeline makeRpmPipeline(ChainScaling* scaling, ChainSink* output) {
+    return TestPipeline(EdgeRateStage(), PulseScaleStage<ChainScaling>{scaling},
+                        EmitStage<ChainScaling>{scaling}, OutputStage<ChainSink>{output});
+}
+
+// Edge counts around 2000 RPM at 2 pulses/rev over 100 ms reads
+static PulseSample sampleAt(unsigned i) {
+    return PulseSample{130u + (i * 7u) % 11u, 100u + (i % 3u)};
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that the pipeline gives the same values as the scalar functions
+void test_matches_scalar_path(void) {
+    ChainScaling scaling(2.0f, 1.5f);
+    ChainSink output;
+    TestPipeline pipeline = makeRpmPipeline(&scaling, &output);
+    
+    for (unsigned i = 0; i < 50; i++) {
+        const PulseSample sample = sampleAt(i);
+        const float expected = scalePulseFrequency(
+            PulseCounterBank::toFrequency(sample.edges, sample.elapsed_ms), 2.0f, 1.5f);
+        TEST_ASSERT_EQUAL_FLOAT(expected, pipeline(sample));
+    }
+    
+    // Zero interval and unset scaling read as zero, not inf
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pipeline(PulseSample{10, 0}));
+    scaling.configure(0.0f, 1.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pipeline(PulseSample{10, 100}));
+}
+
+// Test that the value is set on the output and reaches the producer's
+// observers
+void test_emits_to_observers(void) {
+    ChainScaling scaling(2.0f, 1.0f);
+    ChainSink observer;
+    scaling.connect_to(&observer);
+    ChainSink output;
+    TestPipeline pipeline = makeRpmPipeline(&scaling, &output);
+    
+    // 100 edges in 500 ms at 2 pulses/rev: 100 rev/s
+    pipeline(PulseSample{100, 500});
+    TEST_ASSERT_EQUAL(1, output.count);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, output.last);
+    TEST_ASSERT_EQUAL(1, observer.count);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, observer.last);
+}
+
+// Test that settings edited after construction apply to the next sample
+void test_settings_apply_live(void) {
+    ChainScaling scaling(2.0f, 1.0f);
+    ChainSink output;
+    TestPipeline pipeline = makeRpmPipeline(&scaling, &output);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, pipeline(PulseSample{200, 1000}));
+    
+    scaling.configure(4.0f, 3.0f);
+    TEST_ASSERT_EQUAL_FLOAT(150.0f, pipeline(PulseSample{200, 1000}));
+}
+
+// Test that stages may change the value type and compose in any number
+void test_stages_change_type(void) {
+    auto pipeline = makePipeline(
+        [](int x) { return x * 2; },
+        [](int x) { return static_cast<float>(x) / 4.0f; },
+        [](float x) { return x > 1.0f; });
+    TEST_ASSERT_TRUE(pipeline(3));
+    TEST_ASSERT_FALSE(pipeline(2));
+    
+    auto single = makePipeline([](float x) { return x + 1.0f; });
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, single(1.5f));
+}
+
+// Compare ns/sample with the heap-allocated observer chain it replaces
+void test_benchmark_against_observer_chain(void) {
+    const unsigned iterations = 2000000;
+    
+    // Current chain: frequency -> scaling -> sink
+    ChainValue* frequency = new ChainValue();
+    ChainScaling* chain_scaling = new ChainScaling(2.0f, 1.0f);
+    ChainSink* chain_sink = new ChainSink();
+    frequency->connect_to(chain_scaling)->connect_to(chain_sink);
+    
+    // Static pipeline setting the same kind of sink
+    ChainScaling* scaling = new ChainScaling(2.0f, 1.0f);
+    ChainSink* sink = new ChainSink();
+    TestPipeline pipeline = makeRpmPipeline(scaling, sink);
+    
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        const PulseSample sample = sampleAt(i);
+        frequency->set(PulseCounterBank::toFrequency(sample.edges, sample.elapsed_ms));
+    }
+    const double chain_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / iterations;
+    
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        pipeline(sampleAt(i));
+    }
+    const double static_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / iterations;
+    
+    char message[128];
+    snprintf(message, sizeof(message),
+             "static pipeline %.1f ns/sample, observer chain %.1f ns/sample",
+             static_ns, chain_ns);
+    TEST_MESSAGE(message);
+    
+    // Both paths saw the same values
+    TEST_ASSERT_EQUAL(iterations, sink->count);
+    TEST_ASSERT_EQUAL(iterations, chain_sink->count);
+    TEST_ASSERT_TRUE(chain_sink->sum == sink->sum);
+    
+    delete frequency;
+    delete chain_scaling;
+    delete chain_sink;
+    delete scaling;
+    delete sink;
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_matches_scalar_path);
+    RUN_TEST(test_emits_to_observers);
+    RUN_TEST(test_settings_apply_live);
+    RUN_TEST(test_stages_change_type);
+    RUN_TEST(test_benchmark_against_observer_chain);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
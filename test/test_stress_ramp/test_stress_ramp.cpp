@@ -0,0 +1,240 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "calibration_table.h"
+#include "stress_ramp.h"
+#include "temperature_health.h"
+
+// Host-runnable tests for the synthetic channel stress ramp. The ramp runs
+// against a simulated event loop in which every emission costs a fixed
+// time; the last test measures that cost for the portable pipeline stages
+// on this machine (or takes STRESS_COST_US) and prints where it saturates:
+//   STRESS_COST_US=180 pio test -e native -f test_stress_ramp -v
+
+using namespace BoatEngine;
+
+static const StressRamp::Settings SETTINGS = {
+    50,       // start_channels
+    50,       // channel_step
+    1000,     // max_channels
+    10.0f,    // rate_hz
+    500,      // settle_ms
+    2000,     // step_ms
+    0.98f     // min_delivery
+};
+
+static const uint32_t TICK_OVERHEAD_US = 20;
+static const uint32_t HEAP_BYTES = 200000;
+static const uint32_t HEAP_PER_CHANNEL = 300;
+
+/**
+ * @brief Run a ramp on a simulated single-threaded event loop
+ *
+ * Each channel has a repeat timer; a tick runs every timer that is due,
+ * each costing cost_us. Like a repeat timer that fell behind, a late
+ * channel fires once and skips the periods it missed.
+ */
+static void simulateRamp(StressRamp& ramp, uint32_t cost_us) {
+    const uint64_t period_us = static_cast<uint64_t>(1.0e6f / SETTINGS.rate_hz);
+    std::vector<uint64_t> due;
+    uint64_t now_us = 0;
+    uint64_t next_update_us = 0;
+    
+    ramp.begin(0);
+    while (due.size() < ramp.getChannels()) {
+        due.push_back(period_us * due.size() / ramp.getChannels());
+    }
+    
+    while (ramp.isRunning()) {
+        uint32_t busy_us = TICK_OVERHEAD_US;
+        uint64_t next_due = UINT64_MAX;
+        for (size_t i = 0; i < due.size(); i++) {
+            if (due[i] <= now_us) {
+                busy_us += cost_us;
+                ramp.onDelivered();
+                due[i] += period_us;
+                if (due[i] <= now_us) {
+                    due[i] = now_us + period_us;
+                }
+            }
+            next_due = due[i] < next_due ? due[i] : next_due;
+        }
+        ramp.onTick(busy_us);
+        now_us += busy_us;
+        
+        if (now_us >= next_update_us) {
+            ramp.onFreeHeap(HEAP_BYTES - HEAP_PER_CHANNEL * static_cast<uint32_t>(due.size()));
+            if (ramp.update(static_cast<uint32_t>(now_us / 1000))) {
+                const size_t count = ramp.getChannels();
+                while (due.size() < count) {
+                    due.push_back(now_us + period_us * due.size() / count);
+                }
+            }
+            next_update_us += 100000;
+        }
+        // Idle until the next timer or ramp update
+        if (next_due > now_us) {
+            now_us = next_due < next_update_us ? next_due : next_update_us;
+        }
+    }
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that the ramp stops where emissions exceed the loop's capacity
+void test_saturates_at_capacity(void) {
+    // 230 us per value at 10 Hz: the loop is full at 435 channels
+    StressRamp ramp(SETTINGS);
+    simulateRamp(ramp, 230);
+    
+    TEST_ASSERT_FALSE(ramp.isRunning());
+    TEST_ASSERT_TRUE(ramp.isSaturated());
+    TEST_ASSERT_EQUAL_FLOAT(4000.0f, ramp.getSaturationChannelHz());
+    
+    const StressRamp::Step& good = ramp.getLastGoodStep();
+    TEST_ASSERT_TRUE(good.cpu_load > 0.85f && good.cpu_load < 1.0f);
+    TEST_ASSERT_EQUAL_UINT32(HEAP_BYTES - HEAP_PER_CHANNEL * good.channels,
+                             good.min_free_heap);
+    
+    const StressRamp::Step& failed = ramp.getSaturatedStep();
+    TEST_ASSERT_EQUAL_UINT16(good.channels + SETTINGS.channel_step, failed.channels);
+    TEST_ASSERT_TRUE(failed.delivered < SETTINGS.min_delivery * failed.expected);
+}
+
+// Test that a cheap pipeline ramps all the way without saturating
+void test_reaches_max_channels(void) {
+    StressRamp::Settings settings = SETTINGS;
+    settings.max_channels = 200;
+    StressRamp ramp(settings);
+    simulateRamp(ramp, 20);
+    
+    TEST_ASSERT_FALSE(ramp.isRunning());
+    TEST_ASSERT_FALSE(ramp.isSaturated());
+    TEST_ASSERT_EQUAL_UINT16(200, ramp.getLastGoodStep().channels);
+    TEST_ASSERT_EQUAL_FLOAT(2000.0f, ramp.getSaturationChannelHz());
+}
+
+// Test that a single tick longer than the emission period saturates
+void test_tick_overrun(void) {
+    StressRamp ramp(SETTINGS);
+    ramp.begin(0);
+    TEST_ASSERT_FALSE(ramp.update(SETTINGS.settle_ms));
+    
+    // Every value arrives, but one tick blocks for a whole period
+    ramp.onDelivered(SETTINGS.start_channels * 20);
+    ramp.onTick(100001);
+    TEST_ASSERT_FALSE(ramp.update(SETTINGS.settle_ms + SETTINGS.step_ms));
+    
+    TEST_ASSERT_TRUE(ramp.isSaturated());
+    TEST_ASSERT_EQUAL_UINT32(1, ramp.getSaturatedStep().overruns);
+    TEST_ASSERT_EQUAL_UINT32(100001, ramp.getSaturatedStep().max_tick_us);
+    TEST_ASSERT_EQUAL_UINT16(0, ramp.getLastGoodStep().channels);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ramp.getSaturationChannelHz());
+}
+
+// Test that activity while channels are being added is not measured
+void test_settle_time_ignored(void) {
+    StressRamp ramp(SETTINGS);
+    ramp.begin(1000);
+    ramp.onDelivered(5);
+    ramp.onTick(500000);
+    ramp.onFreeHeap(10);
+    TEST_ASSERT_FALSE(ramp.update(1000 + SETTINGS.settle_ms));
+    
+    ramp.onDelivered(SETTINGS.start_channels * 20);
+    ramp.onFreeHeap(150000);
+    TEST_ASSERT_TRUE(ramp.update(1000 + SETTINGS.settle_ms + SETTINGS.step_ms));
+    
+    const StressRamp::Step& step = ramp.getLastGoodStep();
+    TEST_ASSERT_EQUAL_UINT32(SETTINGS.start_channels * 20, step.expected);
+    TEST_ASSERT_EQUAL_UINT32(step.expected, step.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, step.overruns);
+    TEST_ASSERT_EQUAL_UINT32(150000, step.min_free_heap);
+    TEST_ASSERT_EQUAL_UINT16(SETTINGS.start_channels + SETTINGS.channel_step,
+                             ramp.getChannels());
+}
+
+// Find the saturation point for this machine's (or a given) emission cost
+void test_host_pipeline_saturation(void) {
+    double cost_us;
+    const char* given = getenv("STRESS_COST_US");
+    if (given != nullptr) {
+        cost_us = atof(given);
+    } else {
+        // Health check -> calibration -> delta formatting, per value
+        static const TemperatureHealth::Limits limits = {-55.0f, 125.0f, 5.0f, 2, 2};
+        TemperatureHealth health(limits);
+        CalibrationTable table;
+        TemperatureReading reading = {0, TemperatureReadStatus::OK, 80.0f};
+        char delta[96];
+        const int iterations = 200000;
+        volatile size_t sink = 0;
+        
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            reading.celsius = 80.0f + (i % 16) * 0.0625f;
+            health.assess(reading);
+            const float kelvin = table.evaluate(reading.celsius + 273.15f);
+            sink = sink + snprintf(delta, sizeof(delta),
+                                   "{\"path\":\"sensors.stress.channel%d\",\"value\":%g}",
+                                   i % 100, kelvin);
+        }
+        cost_us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+    
+    // Whole microseconds, at least one, keep the simulation bounded
+    const uint32_t whole_us = cost_us < 1.0 ? 1 : static_cast<uint32_t>(cost_us + 0.5);
+    StressRamp::Settings settings = SETTINGS;
+    settings.max_channels = 500;
+    StressRamp ramp(settings);
+    simulateRamp(ramp, whole_us);
+    
+    const StressRamp::Step& good = ramp.getLastGoodStep();
+    char message[160];
+    snprintf(message, sizeof(message),
+             "%.3f us per value: %s %.0f channel Hz (%u channels), CPU %.0f%%",
+             cost_us, ramp.isSaturated() ? "saturates above" : "no saturation up to",
+             ramp.getSaturationChannelHz(), good.channels, good.cpu_load * 100.0f);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FALSE(ramp.isRunning());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_saturates_at_capacity);
+    RUN_TEST(test_reaches_max_channels);
+    RUN_TEST(test_tick_overrun);
+    RUN_TEST(test_settle_time_ignored);
+    RUN_TEST(test_host_pipeline_saturation);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
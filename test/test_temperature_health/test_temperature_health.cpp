@@ -0,0 +1,262 @@
+#include <unity.h>
+
+#include <cmath>
+
+#include "ds18b20_bus.h"
+#include "simulated_onewire_bus.h"
+#include "temperature_health.h"
+
+// Host-runnable tests for OneWire sensor health: failure accounting, the
+// bounded retry policy and plausibility checks, plus recovery from faults
+// injected on a simulated bus
+
+using namespace BoatEngine;
+
+typedef TemperatureHealth::Verdict Verdict;
+
+static const TemperatureHealth::Limits LIMITS = {-55.0f, 125.0f, 5.0f, 2, 2};
+
+static TemperatureReading reading(TemperatureReadStatus status, float celsius = 0.0f) {
+    TemperatureReading r;
+    r.tag = 0;
+    r.status = status;
+    r.celsius = celsius;
+    return r;
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Test that good readings are valid and nothing is counted against them
+void test_valid_reading(void) {
+    TemperatureHealth health(LIMITS);
+    TEST_ASSERT_FALSE(health.isValid());
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::OK, 72.5f)) ==
+                     Verdict::VALID);
+    TEST_ASSERT_TRUE(health.isValid());
+    
+    const TemperatureHealthCounters& counters = health.getCounters();
+    TEST_ASSERT_EQUAL_UINT32(1, counters.reads);
+    TEST_ASSERT_EQUAL_UINT32(0, counters.retries);
+    TEST_ASSERT_EQUAL_UINT32(0, counters.invalid);
+}
+
+// Test that each failure kind lands in its own counter
+void test_failure_counters(void) {
+    TemperatureHealth health(LIMITS);
+    health.assess(reading(TemperatureReadStatus::CRC_ERROR));
+    health.assess(reading(TemperatureReadStatus::TIMEOUT));
+    health.assess(reading(TemperatureReadStatus::OK, 20.0f));
+    health.assess(reading(TemperatureReadStatus::NO_DEVICE));
+    health.assess(reading(TemperatureReadStatus::BUS_ERROR));
+    health.assess(reading(TemperatureReadStatus::OK, 20.0f));
+    health.assess(reading(TemperatureReadStatus::OK, 150.0f));
+    
+    const TemperatureHealthCounters& counters = health.getCounters();
+    TEST_ASSERT_EQUAL_UINT32(7, counters.reads);
+    TEST_ASSERT_EQUAL_UINT32(1, counters.crc_errors);
+    TEST_ASSERT_EQUAL_UINT32(1, counters.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(2, counters.disconnects);
+    TEST_ASSERT_EQUAL_UINT32(1, counters.implausible);
+    TEST_ASSERT_EQUAL_UINT32(5, counters.retries);
+}
+
+// Test that a request the bus refused is counted and retried like a failed read
+void test_dropped_request(void) {
+    TemperatureHealth health(LIMITS);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::DROPPED)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::DROPPED)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::DROPPED)) ==
+                     Verdict::INVALID);
+    
+    const TemperatureHealthCounters& counters = health.getCounters();
+    TEST_ASSERT_EQUAL_UINT32(3, counters.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, counters.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, counters.invalid);
+}
+
+// Test that retries stop after max_retries and the value turns invalid
+void test_bounded_retry(void) {
+    TemperatureHealth health(LIMITS);
+    health.assess(reading(TemperatureReadStatus::OK, 60.0f));
+    
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::CRC_ERROR)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_EQUAL_UINT8(1, health.getAttempt());
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::CRC_ERROR)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_TRUE(health.isValid());  // Still the last completed cycle
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::CRC_ERROR)) ==
+                     Verdict::INVALID);
+    TEST_ASSERT_FALSE(health.isValid());
+    TEST_ASSERT_EQUAL_UINT8(0, health.getAttempt());
+    TEST_ASSERT_EQUAL_UINT32(1, health.getCounters().invalid);
+    
+    // The next cycle starts with a fresh retry budget
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::TIMEOUT)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::OK, 61.0f)) ==
+                     Verdict::VALID);
+    TEST_ASSERT_TRUE(health.isValid());
+}
+
+// Test the range check, including the -127 C disconnect value and NaN
+void test_range_check(void) {
+    TemperatureHealth health(LIMITS);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::OK, -127.0f)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::OK, NAN)) ==
+                     Verdict::RETRY);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::OK, 125.0f)) ==
+                     Verdict::VALID);
+    TEST_ASSERT_TRUE(health.assess(reading(TemperatureReadStatus::OK, -55.0f)) ==
+                     Verdict::VALID);
+    TEST_ASSERT_EQUAL_UINT32(2, health.getCounters().implausible);
+}
+
+// Test that 85 C asks for a new conversion unless the engine is that hot
+// or the new conversion reads it again
+void test_power_on_value(void) {
+    TemperatureHealth cold(LIMITS);
+    TEST_ASSERT_TRUE(cold.assess(reading(TemperatureReadStatus::OK, 85.0f)) ==
+                     Verdict::RECONVERT);
+    cold.assess(reading(TemperatureReadStatus::OK, 40.0f));
+    TEST_ASSERT_TRUE(cold.assess(reading(TemperatureReadStatus::OK, 85.0f)) ==
+                     Verdict::RECONVERT);
+    
+    TemperatureHealth hot(LIMITS);
+    hot.assess(reading(TemperatureReadStatus::OK, 83.5f));
+    TEST_ASSERT_TRUE(hot.assess(reading(TemperatureReadStatus::OK, 85.0f)) ==
+                     Verdict::VALID);
+    TEST_ASSERT_TRUE(hot.assess(reading(TemperatureReadStatus::OK, 85.0625f)) ==
+                     Verdict::VALID);
+    
+    // No earlier value at boot: the reconversion confirms it
+    TemperatureHealth boot(LIMITS);
+    TEST_ASSERT_TRUE(boot.assess(reading(TemperatureReadStatus::OK, 85.0f)) ==
+                     Verdict::RECONVERT);
+    TEST_ASSERT_TRUE(boot.assess(reading(TemperatureReadStatus::OK, 85.0f)) ==
+                     Verdict::VALID);
+    TEST_ASSERT_EQUAL_UINT32(1, boot.getCounters().implausible);
+}
+
+// Run the bus until idle, advancing simulated time in small steps
+static void runUntilIdle(Ds18b20Bus& bus, SimulatedOneWireBus& sim) {
+    uint32_t polls = 0;
+    while (!bus.isIdle() && polls < 100000) {
+        sim.advance(100);
+        bus.service();
+        polls++;
+    }
+}
+
+// Read one device the way TemperatureSensorManager does, retrying while
+// the health check asks to
+static Verdict readWithRetry(Ds18b20Bus& bus, SimulatedOneWireBus& sim,
+                             TemperatureHealth& health, float* celsius) {
+    bus.requestRead(sim.getAddress(0), 0);
+    for (;;) {
+        runUntilIdle(bus, sim);
+        TemperatureReading r = reading(TemperatureReadStatus::TIMEOUT);
+        bus.takeReading(&r);
+        const Verdict verdict = health.assess(r);
+        if (verdict == Verdict::RECONVERT) {
+            bus.startConversion();
+        } else if (verdict != Verdict::RETRY) {
+            *celsius = r.celsius;
+            return verdict;
+        }
+        bus.requestRead(sim.getAddress(0), 0);
+    }
+}
+
+// Test recovery from each injected fault within one cycle
+void test_recovery_on_simulated_bus(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x5a5a5a5a5a5aull);
+    Ds18b20Bus bus(&sim);
+    TEST_ASSERT_TRUE(bus.begin());
+    sim.setTemperature(0, 42.0f);
+    bus.startConversion();
+    runUntilIdle(bus, sim);
+    
+    TemperatureHealth health(LIMITS);
+    float celsius;
+    
+    sim.injectFault(0, SimulatedOneWireBus::DeviceFault::CORRUPT_READ, 1);
+    TEST_ASSERT_TRUE(readWithRetry(bus, sim, health, &celsius) == Verdict::VALID);
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, celsius);
+    TEST_ASSERT_EQUAL_UINT32(1, health.getCounters().crc_errors);
+    
+    sim.injectFault(0, SimulatedOneWireBus::DeviceFault::ABSENT, 2);
+    TEST_ASSERT_TRUE(readWithRetry(bus, sim, health, &celsius) == Verdict::VALID);
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, celsius);
+    TEST_ASSERT_EQUAL_UINT32(2, health.getCounters().disconnects);
+    
+    // A brown-out during the conversion leaves the power-on value
+    sim.injectFault(0, SimulatedOneWireBus::DeviceFault::POWER_ON, 1);
+    bus.startConversion();
+    runUntilIdle(bus, sim);
+    TEST_ASSERT_TRUE(readWithRetry(bus, sim, health, &celsius) == Verdict::VALID);
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, celsius);
+    TEST_ASSERT_EQUAL_UINT32(1, health.getCounters().implausible);
+    TEST_ASSERT_EQUAL_UINT32(4, health.getCounters().retries);
+}
+
+// Test that a persistent fault ends in INVALID after the retry budget
+void test_persistent_fault_invalid(void) {
+    SimulatedOneWireBus sim;
+    sim.addDevice(0x5a5a5a5a5a5aull);
+    Ds18b20Bus bus(&sim);
+    bus.begin();
+    
+    TemperatureHealth health(LIMITS);
+    float celsius;
+    const uint32_t transfers = sim.getTransferCount();
+    sim.injectFault(0, SimulatedOneWireBus::DeviceFault::CORRUPT_READ, 10);
+    TEST_ASSERT_TRUE(readWithRetry(bus, sim, health, &celsius) == Verdict::INVALID);
+    
+    // One read plus two retries, two transfers each
+    TEST_ASSERT_EQUAL_UINT32(transfers + 6, sim.getTransferCount());
+    TEST_ASSERT_EQUAL_UINT32(3, health.getCounters().crc_errors);
+    TEST_ASSERT_FALSE(health.isValid());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_valid_reading);
+    RUN_TEST(test_failure_counters);
+    RUN_TEST(test_dropped_request);
+    RUN_TEST(test_bounded_retry);
+    RUN_TEST(test_range_check);
+    RUN_TEST(test_power_on_value);
+    RUN_TEST(test_recovery_on_simulated_bus);
+    RUN_TEST(test_persistent_fault_invalid);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,285 @@
+#include <unity.h>
+
+#include <cmath>
+
+#include "simulated_thermocouple_bus.h"
+#include "thermocouple_codec.h"
+#include "thermocouple_scanner.h"
+
+// Host-runnable tests for the thermocouple path: MAX31855/MAX31856 frame
+// coding and batched reads through the simulated SPI bus
+
+using namespace BoatEngine;
+
+static ThermocoupleReading reading(float hot_c, float cold_c,
+                                   ThermocoupleFault fault = ThermocoupleFault::NONE) {
+    return ThermocoupleReading{fault, hot_c, cold_c};
+}
+
+// Advance the bus and take every result, keeping the last per sensor
+static size_t drain(SimulatedThermocoupleBus& bus, ThermocoupleScanner& scanner,
+                    ThermocoupleScanner::Result* last, uint32_t elapsed_us = 1000) {
+    bus.advance(elapsed_us);
+    size_t count = 0;
+    ThermocoupleScanner::Result result;
+    while (scanner.takeResult(&result)) {
+        last[result.index] = result;
+        count++;
+    }
+    return count;
+}
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+void test_max31855_round_trip() {
+    const float temperatures[] = {0.25f, 21.5f, 385.75f, 1372.0f, -12.25f, -200.0f};
+    for (float hot_c : temperatures) {
+        uint8_t frame[4];
+        ThermocoupleCodec::encode(ThermocoupleChip::MAX31855, reading(hot_c, 31.0625f), frame);
+        const ThermocoupleReading decoded =
+            ThermocoupleCodec::decode(ThermocoupleChip::MAX31855, frame);
+        TEST_ASSERT_TRUE(decoded.fault == ThermocoupleFault::NONE);
+        TEST_ASSERT_EQUAL_FLOAT(hot_c, decoded.hot_c);
+        TEST_ASSERT_EQUAL_FLOAT(31.0625f, decoded.cold_c);
+    }
+    
+    // Datasheet examples: +100 C and -250 C hot, -0.0625 C cold
+    const uint8_t plus_100[4] = {0x06, 0x40, 0xFF, 0xF0};
+    ThermocoupleReading decoded = ThermocoupleCodec::decode(ThermocoupleChip::MAX31855, plus_100);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, decoded.hot_c);
+    TEST_ASSERT_EQUAL_FLOAT(-0.0625f, decoded.cold_c);
+    const uint8_t minus_250[4] = {0xF0, 0x60, 0x00, 0x00};
+    decoded = ThermocoupleCodec::decode(ThermocoupleChip::MAX31855, minus_250);
+    TEST_ASSERT_EQUAL_FLOAT(-250.0f, decoded.hot_c);
+    
+    // 0 C at both junctions is an all-zero frame, not a missing chip
+    const uint8_t zero[4] = {0x00, 0x00, 0x00, 0x00};
+    decoded = ThermocoupleCodec::decode(ThermocoupleChip::MAX31855, zero);
+    TEST_ASSERT_TRUE(decoded.fault == ThermocoupleFault::NONE);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, decoded.hot_c);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, decoded.cold_c);
+}
+
+void test_max31856_round_trip() {
+    const float temperatures[] = {0.0078125f, 21.5f, 512.3984375f, 1371.0f, -40.5f, -210.0f};
+    for (float hot_c : temperatures) {
+        uint8_t frame[ThermocoupleCodec::MAX_FRAME];
+        ThermocoupleCodec::encode(ThermocoupleChip::MAX31856, reading(hot_c, -5.015625f), frame);
+        const ThermocoupleReading decoded =
+            ThermocoupleCodec::decode(ThermocoupleChip::MAX31856, frame);
+        TEST_ASSERT_TRUE(decoded.fault == ThermocoupleFault::NONE);
+        TEST_ASSERT_EQUAL_FLOAT(hot_c, decoded.hot_c);
+        TEST_ASSERT_EQUAL_FLOAT(-5.015625f, decoded.cold_c);
+    }
+    
+    uint8_t tx[ThermocoupleCodec::MAX_FRAME];
+    TEST_ASSERT_EQUAL(0, ThermocoupleCodec::prepareSetup(ThermocoupleChip::MAX31855, 3, tx));
+    TEST_ASSERT_EQUAL(3, ThermocoupleCodec::prepareSetup(ThermocoupleChip::MAX31856,
+                                                         ThermocoupleCodec::MAX31856_TYPE_K, tx));
+    TEST_ASSERT_EQUAL_HEX8(0x80, tx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x90, tx[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, tx[2]);
+    ThermocoupleCodec::prepareRead(ThermocoupleChip::MAX31856, tx);
+    TEST_ASSERT_EQUAL_HEX8(0x09, tx[0]);
+    TEST_ASSERT_EQUAL(8, ThermocoupleCodec::readLength(ThermocoupleChip::MAX31856));
+}
+
+void test_faults_decode() {
+    const ThermocoupleFault faults[] = {
+        ThermocoupleFault::OPEN, ThermocoupleFault::SHORT_TO_GND,
+        ThermocoupleFault::SHORT_TO_VCC, ThermocoupleFault::NO_RESPONSE};
+    for (ThermocoupleFault fault : faults) {
+        uint8_t frame[4];
+        ThermocoupleCodec::encode(ThermocoupleChip::MAX31855, reading(400.0f, 25.0f, fault), frame);
+        const ThermocoupleReading decoded =
+            ThermocoupleCodec::decode(ThermocoupleChip::MAX31855, frame);
+        TEST_ASSERT_EQUAL_STRING(ThermocoupleCodec::faultName(fault),
+                                 ThermocoupleCodec::faultName(decoded.fault));
+        TEST_ASSERT_TRUE(std::isnan(decoded.hot_c));
+    }
+    // An open circuit still reports the chip temperature
+    uint8_t frame[ThermocoupleCodec::MAX_FRAME];
+    ThermocoupleCodec::encode(ThermocoupleChip::MAX31855,
+                              reading(400.0f, 25.0f, ThermocoupleFault::OPEN), frame);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, ThermocoupleCodec::decode(ThermocoupleChip::MAX31855, frame).cold_c);
+    
+    // The MAX31856 tells open circuit apart, other faults only as out of range
+    ThermocoupleCodec::encode(ThermocoupleChip::MAX31856,
+                              reading(400.0f, 25.0f, ThermocoupleFault::OPEN), frame);
+    TEST_ASSERT_TRUE(ThermocoupleCodec::decode(ThermocoupleChip::MAX31856, frame).fault ==
+                     ThermocoupleFault::OPEN);
+    ThermocoupleCodec::encode(ThermocoupleChip::MAX31856,
+                              reading(400.0f, 25.0f, ThermocoupleFault::SHORT_TO_GND), frame);
+    TEST_ASSERT_TRUE(ThermocoupleCodec::decode(ThermocoupleChip::MAX31856, frame).fault ==
+                     ThermocoupleFault::OUT_OF_RANGE);
+    
+    // A MAX31856 that is not converting reads zeros
+    const uint8_t zeros[ThermocoupleCodec::MAX_FRAME] = {0};
+    TEST_ASSERT_TRUE(ThermocoupleCodec::decode(ThermocoupleChip::MAX31856, zeros).fault ==
+                     ThermocoupleFault::NO_RESPONSE);
+}
+
+void test_scan_reads_all_in_background() {
+    SimulatedThermocoupleBus bus;
+    ThermocoupleScanner scanner(&bus);
+    const int egt = scanner.addSensor(ThermocoupleChip::MAX31855, 5, 0);
+    const int turbo = scanner.addSensor(ThermocoupleChip::MAX31856, 17,
+                                        ThermocoupleCodec::MAX31856_TYPE_K);
+    TEST_ASSERT_EQUAL(0, egt);
+    TEST_ASSERT_EQUAL(1, turbo);
+    bus.setChip(1, ThermocoupleChip::MAX31856);
+    bus.setReading(0, reading(412.5f, 35.0f));
+    bus.setReading(1, reading(388.25f, 35.5f));
+    
+    // Setup write for the MAX31856, then one read of each
+    TEST_ASSERT_EQUAL(2, scanner.startScan());
+    TEST_ASSERT_EQUAL(3, bus.getPendingCount());
+    TEST_ASSERT_TRUE(scanner.isBusy());
+    
+    // Nothing is ready until the transfers have had time to run
+    ThermocoupleScanner::Result result;
+    TEST_ASSERT_FALSE(scanner.takeResult(&result));
+    bus.advance(20);
+    TEST_ASSERT_FALSE(scanner.takeResult(&result));
+    
+    ThermocoupleScanner::Result last[2];
+    TEST_ASSERT_EQUAL(2, drain(bus, scanner, last));
+    TEST_ASSERT_FALSE(scanner.isBusy());
+    TEST_ASSERT_TRUE(bus.isConverting(1));
+    TEST_ASSERT_EQUAL_FLOAT(412.5f, last[0].reading.hot_c);
+    TEST_ASSERT_EQUAL_FLOAT(388.25f, last[1].reading.hot_c);
+    TEST_ASSERT_TRUE(scanner.getFault(1) == ThermocoupleFault::NONE);
+    
+    // Later scans do not set up again
+    TEST_ASSERT_EQUAL(2, scanner.startScan());
+    TEST_ASSERT_EQUAL(2, bus.getPendingCount());
+    TEST_ASSERT_EQUAL(2, drain(bus, scanner, last));
+    TEST_ASSERT_EQUAL_UINT32(2, scanner.getCounters(0).reads);
+    TEST_ASSERT_EQUAL_UINT32(0, scanner.getCounters(0).faults);
+}
+
+void test_ten_hz_batch_timing() {
+    // Eight chips read at 10 Hz take a tiny part of each period
+    SimulatedThermocoupleBus bus;
+    ThermocoupleScanner scanner(&bus);
+    for (uint8_t i = 0; i < ThermocoupleScanner::MAX_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(i, scanner.addSensor(ThermocoupleChip::MAX31855, i, 0));
+        bus.setReading(i, reading(100.0f + i, 30.0f));
+    }
+    TEST_ASSERT_EQUAL(-1, scanner.addSensor(ThermocoupleChip::MAX31855, 9, 0));
+    
+    ThermocoupleScanner::Result last[ThermocoupleScanner::MAX_SENSORS];
+    for (int scan = 0; scan < 50; scan++) {
+        TEST_ASSERT_EQUAL(8, scanner.startScan());
+        // 32 bits at 4 MHz plus overhead, eight times: well under 1 ms
+        TEST_ASSERT_EQUAL(8, drain(bus, scanner, last, 8 * 28));
+    }
+    for (uint8_t i = 0; i < ThermocoupleScanner::MAX_SENSORS; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(100.0f + i, last[i].reading.hot_c);
+        TEST_ASSERT_EQUAL_UINT32(50, scanner.getCounters(i).reads);
+        TEST_ASSERT_EQUAL_UINT32(0, scanner.getCounters(i).missed);
+    }
+}
+
+void test_busy_sensor_is_skipped() {
+    SimulatedThermocoupleBus bus;
+    ThermocoupleScanner scanner(&bus);
+    scanner.addSensor(ThermocoupleChip::MAX31855, 5, 0);
+    
+    TEST_ASSERT_EQUAL(1, scanner.startScan());
+    TEST_ASSERT_EQUAL(0, scanner.startScan());    // Still in flight
+    TEST_ASSERT_EQUAL_UINT32(1, scanner.getCounters(0).missed);
+    TEST_ASSERT_EQUAL(1, bus.getPendingCount());
+    
+    ThermocoupleScanner::Result last[1];
+    TEST_ASSERT_EQUAL(1, drain(bus, scanner, last));
+    TEST_ASSERT_EQUAL(1, scanner.startScan());
+}
+
+void test_fault_and_recovery() {
+    SimulatedThermocoupleBus bus;
+    ThermocoupleScanner scanner(&bus);
+    scanner.addSensor(ThermocoupleChip::MAX31855, 5, 0);
+    ThermocoupleScanner::Result last[1];
+    
+    // Probe wire chafed through
+    bus.setReading(0, reading(450.0f, 40.0f, ThermocoupleFault::OPEN));
+    scanner.startScan();
+    drain(bus, scanner, last);
+    TEST_ASSERT_TRUE(last[0].reading.fault == ThermocoupleFault::OPEN);
+    TEST_ASSERT_TRUE(std::isnan(last[0].reading.hot_c));
+    TEST_ASSERT_TRUE(scanner.getFault(0) == ThermocoupleFault::OPEN);
+    TEST_ASSERT_EQUAL_UINT32(1, scanner.getCounters(0).faults);
+    
+    bus.setReading(0, reading(450.0f, 40.0f));
+    scanner.startScan();
+    drain(bus, scanner, last);
+    TEST_ASSERT_TRUE(scanner.getFault(0) == ThermocoupleFault::NONE);
+    TEST_ASSERT_EQUAL_FLOAT(450.0f, last[0].reading.hot_c);
+}
+
+void test_max31856_set_up_again() {
+    SimulatedThermocoupleBus bus;
+    ThermocoupleScanner scanner(&bus);
+    scanner.addSensor(ThermocoupleChip::MAX31856, 17, ThermocoupleCodec::MAX31856_TYPE_K);
+    bus.setChip(0, ThermocoupleChip::MAX31856);
+    bus.setReading(0, reading(300.0f, 30.0f));
+    ThermocoupleScanner::Result last[1];
+    scanner.startScan();
+    drain(bus, scanner, last);
+    TEST_ASSERT_EQUAL_FLOAT(300.0f, last[0].reading.hot_c);
+    
+    // A brown-out clears the configuration: it reads zeros from then on
+    bus.powerCycle(0);
+    TEST_ASSERT_FALSE(bus.isConverting(0));
+    
+    for (uint8_t i = 0; i < ThermocoupleScanner::SETUP_AFTER_FAULTS; i++) {
+        scanner.startScan();
+        drain(bus, scanner, last);
+        TEST_ASSERT_TRUE(last[0].reading.fault == ThermocoupleFault::NO_RESPONSE);
+    }
+    // The next scan sets it up before reading
+    scanner.startScan();
+    drain(bus, scanner, last);
+    TEST_ASSERT_TRUE(bus.isConverting(0));
+    TEST_ASSERT_TRUE(last[0].reading.fault == ThermocoupleFault::NONE);
+    TEST_ASSERT_EQUAL_FLOAT(300.0f, last[0].reading.hot_c);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_max31855_round_trip);
+    RUN_TEST(test_max31856_round_trip);
+    RUN_TEST(test_faults_decode);
+    RUN_TEST(test_scan_reads_all_in_background);
+    RUN_TEST(test_ten_hz_batch_timing);
+    RUN_TEST(test_busy_sensor_is_skipped);
+    RUN_TEST(test_fault_and_recovery);
+    RUN_TEST(test_max31856_set_up_again);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,279 @@
+#include <unity.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "lis3dh_accelerometer.h"
+#include "simulated_lis3dh.h"
+#include "vibration_analyser.h"
+
+// Host-runnable tests for engine vibration monitoring: the LIS3DH driver
+// against a simulated chip, and the RMS and spectral peak analysis
+
+using namespace BoatEngine;
+
+static const uint16_t RATE_HZ = 1344;
+static const uint8_t RANGE_G = 4;
+static const uint32_t DRAIN_US = 15000;
+
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Drain the simulated chip every DRAIN_US into the analyser, as the task does
+static void run(SimulatedLis3dh& chip, Lis3dhAccelerometer& accelerometer,
+                VibrationAnalyser& analyser, uint32_t duration_us, float rpm) {
+    AccelSample samples[Lis3dhAccelerometer::FIFO_DEPTH];
+    analyser.setRpm(rpm);
+    for (uint32_t t = 0; t < duration_us; t += DRAIN_US) {
+        chip.advance(DRAIN_US);
+        bool overrun = false;
+        const size_t count = accelerometer.readFifo(samples, Lis3dhAccelerometer::FIFO_DEPTH,
+                                                    &overrun);
+        if (overrun) {
+            analyser.resync();
+        }
+        analyser.add(samples, count, accelerometer.getGPerCount());
+    }
+}
+
+// Test the register encoding of samples, rates and ranges
+void test_codec(void) {
+    uint8_t bytes[6];
+    const AccelSample sample = {-2048, 2047, 500};
+    Lis3dhAccelerometer::encodeSample(sample, bytes);
+    // Left-justified 12 bits, little-endian
+    TEST_ASSERT_EQUAL_HEX8(0x00, bytes[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x80, bytes[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xF0, bytes[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, bytes[3]);
+    const AccelSample decoded = Lis3dhAccelerometer::decodeSample(bytes);
+    TEST_ASSERT_EQUAL(-2048, decoded.x);
+    TEST_ASSERT_EQUAL(2047, decoded.y);
+    TEST_ASSERT_EQUAL(500, decoded.z);
+    
+    uint16_t actual;
+    TEST_ASSERT_EQUAL(9, Lis3dhAccelerometer::rateCode(1000, &actual));
+    TEST_ASSERT_EQUAL(1344, actual);
+    TEST_ASSERT_EQUAL(7, Lis3dhAccelerometer::rateCode(400, &actual));
+    TEST_ASSERT_EQUAL(400, actual);
+    TEST_ASSERT_EQUAL(9, Lis3dhAccelerometer::rateCode(5000, &actual));
+    TEST_ASSERT_EQUAL(0, Lis3dhAccelerometer::rateForCode(8));
+    
+    float g_per_count;
+    TEST_ASSERT_EQUAL(1, Lis3dhAccelerometer::rangeCode(4, &g_per_count));
+    TEST_ASSERT_EQUAL_FLOAT(0.002f, g_per_count);
+    TEST_ASSERT_EQUAL(3, Lis3dhAccelerometer::rangeCode(12, &g_per_count));
+}
+
+// Test that begin() sets up the chip and refuses a missing or wrong one
+void test_begin(void) {
+    SimulatedLis3dh chip;
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    TEST_ASSERT_TRUE(accelerometer.begin());
+    TEST_ASSERT_EQUAL_FLOAT(1344.0f, accelerometer.getSampleRateHz());
+    uint8_t value;
+    chip.readRegisters(Lis3dhAccelerometer::CTRL_REG1, &value, 1);
+    TEST_ASSERT_EQUAL_HEX8(0x97, value);
+    chip.readRegisters(Lis3dhAccelerometer::CTRL_REG4, &value, 1);
+    TEST_ASSERT_EQUAL_HEX8(0x18, value);
+    chip.readRegisters(Lis3dhAccelerometer::FIFO_CTRL_REG, &value, 1);
+    TEST_ASSERT_EQUAL_HEX8(0x80, value);
+    
+    SimulatedLis3dh missing;
+    missing.setPresent(false);
+    Lis3dhAccelerometer absent(&missing, RATE_HZ, RANGE_G);
+    TEST_ASSERT_FALSE(absent.begin());
+    
+    SimulatedLis3dh other;
+    other.writeRegister(Lis3dhAccelerometer::WHO_AM_I, 0x44);
+    Lis3dhAccelerometer wrong(&other, RATE_HZ, RANGE_G);
+    TEST_ASSERT_FALSE(wrong.begin());
+}
+
+// Test that the FIFO is drained in bursts without losing samples
+void test_fifo_bursts(void) {
+    SimulatedLis3dh chip;
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    accelerometer.begin();
+    
+    AccelSample samples[Lis3dhAccelerometer::FIFO_DEPTH];
+    uint32_t received = 0;
+    for (int i = 0; i < 1000; i++) {
+        chip.advance(DRAIN_US);
+        bool overrun = true;
+        const uint32_t reads_before = chip.getReadCount();
+        const size_t count = accelerometer.readFifo(samples, Lis3dhAccelerometer::FIFO_DEPTH,
+                                                    &overrun);
+        TEST_ASSERT_FALSE(overrun);
+        // One status read and at most two data reads per drain
+        TEST_ASSERT_TRUE(chip.getReadCount() - reads_before <= 3);
+        received += count;
+        // Flat and still: 1 g on Z, 500 counts at 2 mg
+        TEST_ASSERT_EQUAL(500, samples[0].z);
+        TEST_ASSERT_EQUAL(0, samples[0].x);
+    }
+    TEST_ASSERT_EQUAL_UINT32(chip.getProducedCount(), received);
+    TEST_ASSERT_EQUAL_UINT32(0, chip.getOverwrittenCount());
+    TEST_ASSERT_EQUAL(20160, received);   // 15 s at 1344 Hz
+}
+
+// Test that draining too late is reported as an overrun
+void test_fifo_overrun(void) {
+    SimulatedLis3dh chip;
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    accelerometer.begin();
+    chip.advance(50000);   // 67 samples into 32
+    
+    AccelSample samples[Lis3dhAccelerometer::FIFO_DEPTH];
+    bool overrun = false;
+    TEST_ASSERT_EQUAL(32, accelerometer.readFifo(samples, Lis3dhAccelerometer::FIFO_DEPTH,
+                                                 &overrun));
+    TEST_ASSERT_TRUE(overrun);
+    TEST_ASSERT_TRUE(chip.getOverwrittenCount() > 0);
+    TEST_ASSERT_EQUAL(0, accelerometer.readFifo(samples, Lis3dhAccelerometer::FIFO_DEPTH,
+                                                &overrun));
+    TEST_ASSERT_FALSE(overrun);
+    
+    // A chip that stops answering mid-run loses data too
+    chip.advance(DRAIN_US);
+    chip.setPresent(false);
+    TEST_ASSERT_EQUAL(0, accelerometer.readFifo(samples, Lis3dhAccelerometer::FIFO_DEPTH,
+                                                &overrun));
+    TEST_ASSERT_EQUAL_UINT32(1, accelerometer.getBusErrors());
+}
+
+// Test RMS, dominant frequency and engine order of an out-of-balance shaft
+void test_imbalance_at_engine_speed(void) {
+    SimulatedLis3dh chip;
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    accelerometer.begin();
+    // 2838 rpm: 47.3 Hz, 0.2 g on the transverse axis
+    chip.addComponent(SimulatedLis3dh::Component{47.3f, 0.2f, 0.0f, 0.0f});
+    chip.setNoise(0.01f);
+    
+    VibrationAnalyser analyser(accelerometer.getSampleRateHz());
+    run(chip, accelerometer, analyser, 5000000, 2838.0f);
+    
+    VibrationAnalyser::Result result;
+    TEST_ASSERT_TRUE(analyser.takeResult(&result));
+    TEST_ASSERT_EQUAL_UINT32(13, result.windows);
+    // Sine RMS plus noise on three axes, within the 2 mg counts
+    const float expected_rms = sqrtf(0.2f * 0.2f / 2.0f + 3.0f * 0.01f * 0.01f);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, expected_rms, result.rms_g);
+    // Bins are 2.6 Hz wide; interpolation gets well inside one
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 47.3f, result.peak_hz);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2838.0f, result.rpm);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, result.order);
+    
+    // Averages start again
+    TEST_ASSERT_FALSE(analyser.takeResult(&result));
+}
+
+// Test that the strongest of several components wins, on any axis
+void test_misalignment_second_order(void) {
+    SimulatedLis3dh chip;
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    accelerometer.begin();
+    // 1800 rpm: 1x at 30 Hz weaker than 2x at 60 Hz, plus firing at 4x
+    chip.addComponent(SimulatedLis3dh::Component{30.0f, 0.05f, 0.0f, 0.0f});
+    chip.addComponent(SimulatedLis3dh::Component{60.0f, 0.0f, 0.15f, 0.08f});
+    chip.addComponent(SimulatedLis3dh::Component{120.0f, 0.0f, 0.0f, 0.06f});
+    chip.setNoise(0.02f);
+    
+    VibrationAnalyser analyser(accelerometer.getSampleRateHz());
+    run(chip, accelerometer, analyser, 4000000, 1800.0f);
+    
+    VibrationAnalyser::Result result;
+    TEST_ASSERT_TRUE(analyser.takeResult(&result));
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 60.0f, result.peak_hz);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 2.0f, result.order);
+}
+
+// Test that a stopped engine gives no order, and that gaps restart windows
+void test_stopped_and_gaps(void) {
+    SimulatedLis3dh chip;
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    accelerometer.begin();
+    chip.addComponent(SimulatedLis3dh::Component{25.0f, 0.0f, 0.0f, 0.1f});
+    
+    VibrationAnalyser analyser(accelerometer.getSampleRateHz());
+    run(chip, accelerometer, analyser, 1000000, 0.0f);
+    VibrationAnalyser::Result result;
+    TEST_ASSERT_TRUE(analyser.takeResult(&result));
+    TEST_ASSERT_TRUE(std::isnan(result.order));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, result.rpm);
+    
+    // Drained too late every time: no window ever completes
+    AccelSample samples[Lis3dhAccelerometer::FIFO_DEPTH];
+    const uint32_t windows = analyser.getWindowCount();
+    for (int i = 0; i < 100; i++) {
+        chip.advance(40000);
+        bool overrun = false;
+        const size_t count = accelerometer.readFifo(samples, Lis3dhAccelerometer::FIFO_DEPTH,
+                                                    &overrun);
+        TEST_ASSERT_TRUE(overrun);
+        analyser.resync();
+        analyser.add(samples, count, accelerometer.getGPerCount());
+    }
+    TEST_ASSERT_EQUAL_UINT32(windows, analyser.getWindowCount());
+    TEST_ASSERT_TRUE(analyser.getResyncCount() >= 99);
+    TEST_ASSERT_FALSE(analyser.takeResult(&result));
+}
+
+// Test that a corrected sample rate puts the peak back where it belongs
+void test_measured_rate(void) {
+    SimulatedLis3dh chip;
+    chip.setRateError(0.05f);
+    Lis3dhAccelerometer accelerometer(&chip, RATE_HZ, RANGE_G);
+    accelerometer.begin();
+    chip.addComponent(SimulatedLis3dh::Component{50.0f, 0.1f, 0.0f, 0.0f});
+    
+    VibrationAnalyser analyser(accelerometer.getSampleRateHz());
+    run(chip, accelerometer, analyser, 2000000, 3000.0f);
+    VibrationAnalyser::Result result;
+    analyser.takeResult(&result);
+    // At the nominal rate the peak reads 5% low
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 50.0f / 1.05f, result.peak_hz);
+    
+    analyser.setSampleRate(1344.0f * 1.05f);
+    run(chip, accelerometer, analyser, 2000000, 3000.0f);
+    analyser.takeResult(&result);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 50.0f, result.peak_hz);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_codec);
+    RUN_TEST(test_begin);
+    RUN_TEST(test_fifo_bursts);
+    RUN_TEST(test_fifo_overrun);
+    RUN_TEST(test_imbalance_at_engine_speed);
+    RUN_TEST(test_misalignment_second_order);
+    RUN_TEST(test_stopped_and_gaps);
+    RUN_TEST(test_measured_rate);
+    
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000); // Service delay
+    runUnityTests();
+}
+
+void loop() {
+    // Nothing to do here
+}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif